@@ -17,7 +17,7 @@
 class ANNkd_tree;
 #endif
 
-class MElementOctree;
+class MElementGrid;
 class GFace;
 class GEdge;
 class MElement;
@@ -40,7 +40,7 @@ struct crossField2d
 
 class backgroundMesh : public simpleFunction<double>
 {
-  MElementOctree *_octree;
+  MElementGrid *_grid;
   std::vector<MVertex*> _vertices;
   std::vector<MElement*> _triangles;
   std::map<MVertex*,double> _sizes;
@@ -86,7 +86,7 @@ class backgroundMesh : public simpleFunction<double>
     default : print(filename, gf, _angles); return;
     }
   }
-  MElementOctree* get_octree();
+  MElementGrid* get_grid();
   MElement *getMeshElementByCoord(double u, double v, double w, bool strict=true);
   int getNumMeshElements()const{return _triangles.size();}
   std::vector<MVertex*>::iterator begin_vertices(){return _vertices.begin();}
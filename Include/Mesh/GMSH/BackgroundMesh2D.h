@@ -16,6 +16,7 @@
 #include "BGMBase.h"
 
 class MTriangle;
+class MElementGrid;
 
 using namespace std;
 
@@ -42,6 +43,9 @@ protected:
   // creates a mesh of GFace and store it in local !!!, does not store the mesh in GFace !
   void create_face_mesh();
 
+  // the elements lie in the parametric plane and are found with a bucket
+  // grid rather than with the octree of BGMBase
+  mutable MElementGrid *grid;
   double sizeFactor;
   std::vector<MTriangle*> tempTR;
   vector<MElement*> elements;
@@ -53,6 +57,7 @@ public:
   backgroundMesh2D(GFace *, bool erase_2D3D=true);
   virtual ~backgroundMesh2D();
   virtual MElementOctree* getOctree();
+  virtual const MElement* findElement(double u, double v, double w=0., bool strict=true);
 
   // TODO: only 2D
   virtual void reset(bool erase_2D3D=true);// deletes everything and rebuild with GFace*
@@ -17,6 +17,8 @@ SMetric3 buildMetricTangentToCurve(SVector3 &t, double l_t, double l_n);
 SMetric3 buildMetricTangentToSurface(SVector3 &t1, SVector3 &t2, double l_t1,
                                      double l_t2, double l_n);
 double BGM_MeshSize(GEntity *ge, double U, double V, double X, double Y, double Z);
+void BGM_MeshSize(GEntity *ge, int n, const double *U, const double *V,
+                  const double *X, const double *Y, const double *Z, double *lc);
 SMetric3 BGM_MeshMetric(GEntity *ge, double U, double V, double X, double Y, double Z);
 bool Extend1dMeshIn2dSurfaces();
 bool Extend2dMeshIn3dVolumes();
@@ -98,6 +98,11 @@ class Field {
   virtual bool isotropic () const { return true; }
   // isotropic
   virtual double operator() (double x, double y, double z, GEntity *ge=0) = 0;
+  // isotropic, evaluated at n points at once: the default evaluates the
+  // points one by one, fields that can share work between the points
+  // (distance queries, evaluation of the fields they depend on) override it
+  virtual void operator() (int n, const double *x, const double *y,
+                           const double *z, double *val, GEntity *ge=0);
   // anisotropic
   virtual void operator() (double x, double y, double z, SMetric3 &, GEntity *ge=0){}
   // temporary
@@ -12,11 +12,77 @@
 #include <stdarg.h>
 #include <stdio.h>
 #include <string>
+#include <atomic>
+#include <mutex>
+
+#if defined(_OPENMP)
+#include <omp.h>
+#endif
 
 #include <common/OmniFEMMessage.h>
 
 // a class to manage messages
 class Msg {
+ private:
+	static std::atomic<bool> &debugFilesFlag()
+	{
+		static std::atomic<bool> enabled(false);
+		return enabled;
+	}
+	
+	enum messageLevel { LEVEL_FATAL, LEVEL_ERROR, LEVEL_WARNING, LEVEL_INFO, LEVEL_DEBUG };
+	
+	static std::mutex &queueMutex()
+	{
+		static std::mutex mutex;
+		return mutex;
+	}
+	
+	static std::vector<std::pair<messageLevel, std::string> > &queuedMessages()
+	{
+		static std::vector<std::pair<messageLevel, std::string> > messages;
+		return messages;
+	}
+	
+	static void Write(messageLevel level, const char *str)
+	{
+		switch(level)
+		{
+			case LEVEL_FATAL:
+				OmniFEMMsg::instance()->wxMsgFatal(wxString(str));
+				break;
+			case LEVEL_ERROR:
+				OmniFEMMsg::instance()->wxMsgError(wxString(str));
+				break;
+			case LEVEL_WARNING:
+				OmniFEMMsg::instance()->wxMsgWarning(wxString(str));
+				break;
+			case LEVEL_INFO:
+				OmniFEMMsg::instance()->wxMsgInfo(wxString(str));
+				break;
+			default:
+				OmniFEMMsg::instance()->wxMsgStatus(wxString(str));
+				break;
+		}
+	}
+	
+	// The message windows can only be accessed from the main thread. Messages that are
+	// sent from inside an OpenMP parallel region are queued and written once the main
+	// thread sends the next message or calls FlushQueuedMessages
+	static void Output(messageLevel level, const char *str)
+	{
+#if defined(_OPENMP)
+		if(omp_in_parallel())
+		{
+			std::lock_guard<std::mutex> queueLock(queueMutex());
+			queuedMessages().push_back(std::make_pair(level, std::string(str)));
+			return;
+		}
+#endif
+		FlushQueuedMessages();
+		Write(level, str);
+	}
+	
  public:
 	static void Fatal(const char *fmt, ...)
 	{
@@ -26,7 +92,7 @@ class Msg {
 		vsnprintf(str, sizeof(str), fmt, args);
 		va_end(args);
 		
-		OmniFEMMsg::instance()->wxMsgFatal(wxString(str));
+		Output(LEVEL_FATAL, str);
 	}
 	
 	static void Error(const char *fmt, ...)
@@ -36,8 +102,8 @@ class Msg {
 		va_start(args, fmt);
 		vsnprintf(str, sizeof(str), fmt, args);
 		va_end(args);
-	  
-		OmniFEMMsg::instance()->wxMsgError(wxString(str));
+		
+		Output(LEVEL_ERROR, str);
 	}
 	
 	static void Warning(const char *fmt, ...)
@@ -48,7 +114,7 @@ class Msg {
 		vsnprintf(str, sizeof(str), fmt, args);
 		va_end(args);
 		
-		OmniFEMMsg::instance()->wxMsgWarning(wxString(str));
+		Output(LEVEL_WARNING, str);
 	}
 	
 	static void Info(const char *fmt, ...)
@@ -59,7 +125,7 @@ class Msg {
 		vsnprintf(str, sizeof(str), fmt, args);
 		va_end(args);
 		
-		OmniFEMMsg::instance()->wxMsgInfo(wxString(str));
+		Output(LEVEL_INFO, str);
 	}
 	
 	static void Debug(const char *fmt, ...)
@@ -70,7 +136,22 @@ class Msg {
 		vsnprintf(str, sizeof(str), fmt, args);
 		va_end(args);
 		
-		OmniFEMMsg::instance()->wxMsgStatus(wxString(str));
+		Output(LEVEL_DEBUG, str);
+	}
+	
+	// Writes the messages that were sent from inside the OpenMP parallel regions. Must be
+	// called from the main thread
+	static void FlushQueuedMessages()
+	{
+		std::vector<std::pair<messageLevel, std::string> > messages;
+		
+		{
+			std::lock_guard<std::mutex> queueLock(queueMutex());
+			messages.swap(queuedMessages());
+		}
+		
+		for(unsigned int i = 0; i < messages.size(); i++)
+			Write(messages[i].first, messages[i].second.c_str());
 	}
 	
 	static void ResetProgressMeter()
@@ -82,6 +163,45 @@ class Msg {
 	{
 		
 	}
+	
+	// The debug views (.pos files) of the mesher are only written when the code is
+	// compiled with GMSH_DEBUG_FILES and the files are turned on at runtime. Otherwise
+	// the meshing does not touch the disk
+	static void SetDebugFiles(bool enabled)
+	{
+		debugFilesFlag() = enabled;
+	}
+	
+	static bool GetDebugFiles()
+	{
+#if defined(GMSH_DEBUG_FILES)
+		return debugFilesFlag();
+#else
+		return false;
+#endif
+	}
+	
+	// Opens a debug view for writing. The name is formatted like printf so that the
+	// callers can add the tag of the entity; faces that are meshed at the same time
+	// then write to different files. Returns NULL if the debug files are off
+	static FILE *OpenDebugFile(const char *fmt, ...)
+	{
+		if(!GetDebugFiles())
+			return NULL;
+		
+		char name[1024];
+		va_list args;
+		va_start(args, fmt);
+		vsnprintf(name, sizeof(name), fmt, args);
+		va_end(args);
+		
+		FILE *file = fopen(name, "w");
+		
+		if(!file)
+			Error("Could not open file '%s'", name);
+		
+		return file;
+	}
 };
 
 #endif
@@ -8,4 +8,8 @@
 
 void SortHilbert(std::vector<MVertex*>&);
 
+// Biased randomized insertion order: the vertices are shuffled and then
+// sorted along the Hilbert curve in rounds of increasing size
+void SortBRIO(std::vector<MVertex*>&);
+
 #endif
@@ -24,6 +24,7 @@
 
 class GModel;
 class JacobianBasis;
+class BufferedWriter;
 
 // A mesh element.
 class MElement
@@ -372,21 +373,15 @@ class MElement
   // IO routines
   virtual void writeMSH(FILE *fp, bool binary=false, int elementary=1,
                         std::vector<short> *ghosts=0);
-  virtual void writeMSH2(FILE *fp, double version=1.0, bool binary=false,
+  virtual void writeMSH2(BufferedWriter &out, double version=1.0, bool binary=false,
                          int num=0, int elementary=1, int physical=1,
                          int parentNum=0, int dom1Num = 0, int dom2Num = 0,
                          std::vector<short> *ghosts=0);
   virtual void writePOS(FILE *fp, bool printElementary, bool printElementNumber,
                         bool printSICN, bool printSIGE, bool printGamma,
                         bool printDisto,double scalingFactor=1.0, int elementary=1);
-  virtual void writeSTL(FILE *fp, bool binary=false, double scalingFactor=1.0);
-  virtual void writeVRML(FILE *fp);
-  virtual void writePLY2(FILE *fp);
   virtual void writeUNV(FILE *fp, int num=0, int elementary=1, int physical=1);
-  virtual void writeVTK(FILE *fp, bool binary=false, bool bigEndian=false);
   virtual void writeTOCHNOG(FILE *fp, int num);
-  virtual void writeMESH(FILE *fp, int elementTagType=1, int elementary=1,
-                         int physical=0);
   virtual void writeIR3(FILE *fp, int elementTagType, int num, int elementary,
                         int physical);
   virtual void writeBDF(FILE *fp, int format=0, int elementTagType=1,
@@ -394,7 +389,6 @@ class MElement
   virtual void writeDIFF(FILE *fp, int num, bool binary=false,
                          int physical_property=1);
   virtual void writeINP(FILE *fp, int num);
-  virtual void writeSU2(FILE *fp, int num);
 
   // info for specific IO formats (returning 0 means that the element
   // is not implemented in that format)
@@ -0,0 +1,45 @@
+// Gmsh - Copyright (C) 1997-2017 C. Geuzaine, J.-F. Remacle
+//
+// See the LICENSE.txt file for license information. Please report all
+// bugs and problems to the public mailing list <gmsh@onelab.info>.
+
+#ifndef _MELEMENT_GRID_
+#define _MELEMENT_GRID_
+
+#include <vector>
+
+class MElement;
+
+// Point location in a flat mesh of triangles and quadrangles lying in the
+// plane z = 0, e.g. a mesh in the parametric plane of a face. The elements
+// are sorted in a uniform grid of buckets and a point is tested against the
+// elements of its bucket only, using the barycentric coordinates of their
+// primary vertices. Quadrangles are tested as two triangles. The grid is not
+// modified by the queries so that it can be searched from several threads.
+class MElementGrid{
+ private:
+  std::vector<MElement*> _elems;
+  // the triangles that are tested : element, first vertex and inverse of
+  // the jacobian of the mapping from the reference triangle
+  std::vector<int> _element;
+  std::vector<double> _x0, _y0, _j00, _j01, _j10, _j11;
+  // the buckets, the triangles of bucket i are _list[_start[i] ... _start[i+1]]
+  double _xmin, _ymin, _dx, _dy;
+  int _nx, _ny;
+  std::vector<int> _start, _list;
+  bool _inside(int t, double x, double y, double tol) const;
+  // same as find but does not report the points that are not found
+  MElement *_find(double x, double y, bool strict) const;
+ public:
+  MElementGrid(const std::vector<MElement*> &v);
+  // same tolerance and fallback as MElementOctree::find : if the point is
+  // not found and strict is false, the tolerance is increased up to 0.1
+  MElement *find(double x, double y, bool strict = true) const;
+  // finds the elements of n points, e[i] is 0 if point i is not found. The
+  // points that are not found are reported after the (parallel) search
+  void find(int n, const double *x, const double *y, MElement **e,
+            bool strict = true) const;
+  unsigned int size() const { return _elems.size(); }
+};
+
+#endif
@@ -18,6 +18,7 @@ class GEntity;
 class GEdge;
 class GFace;
 class MVertex;
+class BufferedWriter;
 
 // A mesh vertex.
 class MVertex{
@@ -92,19 +93,13 @@ class MVertex{
   // IO routines
   void writeMSH(FILE *fp, bool binary=false, bool saveParametric=false,
                 double scalingFactor=1.0);
-  void writeMSH2(FILE *fp, bool binary=false, bool saveParametric=false,
+  void writeMSH2(BufferedWriter &out, bool binary=false, bool saveParametric=false,
                  double scalingFactor=1.0);
-  void writePLY2(FILE *fp);
-  void writeVRML(FILE *fp, double scalingFactor=1.0);
   void writeUNV(FILE *fp, double scalingFactor=1.0);
-  void writeVTK(FILE *fp, bool binary=false, double scalingFactor=1.0,
-                bool bigEndian=false);
   void writeTOCHNOG(FILE *fp, int dim, double scalingFactor=1.0);
-  void writeMESH(FILE *fp, double scalingFactor=1.0);
   void writeBDF(FILE *fp, int format=0, double scalingFactor=1.0);
   void writeINP(FILE *fp, double scalingFactor=1.0);
   void writeDIFF(FILE *fp, bool binary, double scalingFactor=1.0);
-  void writeSU2(FILE *fp, int dim, double scalingFactor=1.0);
 };
 
 class MEdgeVertex : public MVertex{
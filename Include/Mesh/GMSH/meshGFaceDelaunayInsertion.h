@@ -14,6 +14,9 @@
 #include <list>
 #include <set>
 #include <map>
+#include <vector>
+#include <algorithm>
+#include <new>
 
 class GModel;
 class GFace;
@@ -28,6 +31,9 @@ struct bidimMeshData
   std::map<MVertex* , MVertex*>* equivalence;
   std::map<MVertex*, SPoint2> * parametricCoordinates;
   std::set<MEdge,Less_Edge> internalEdges; // embedded edges
+  // triangles removed from the mesh during the refinement, kept alive to
+  // be constructed again in place instead of going through new/delete
+  std::vector<MTriangle*> recycledTriangles;
   //  std::set<MVertex*> internalVertices; // embedded vertices
   inline void addVertex (MVertex* mv, double u, double v, double size, double sizeBGM){
     int index = Us.size();
@@ -58,9 +64,25 @@ struct bidimMeshData
     }
     return 0;
   }
+  inline MTriangle *newTriangle (MVertex *v0, MVertex *v1, MVertex *v2){
+    if (recycledTriangles.empty()) return new MTriangle(v0, v1, v2);
+    MTriangle *t = recycledTriangles.back();
+    recycledTriangles.pop_back();
+    t->~MTriangle();
+    return new (t) MTriangle(v0, v1, v2);
+  }
+  // only plain MTriangles that are not referenced anymore may be recycled
+  inline void recycleTriangle (MTriangle *t){
+    recycledTriangles.push_back(t);
+  }
   bidimMeshData (std::map<MVertex* , MVertex*>* e = 0, std::map<MVertex*, SPoint2> *p = 0) : equivalence(e), parametricCoordinates(p)
   {
   }
+  ~bidimMeshData ()
+  {
+    for (unsigned int i = 0; i < recycledTriangles.size(); i++)
+      delete recycledTriangles[i];
+  }
 };
 
 
@@ -100,6 +122,10 @@ class MTri3
     return 0;
   }
   MTri3(MTriangle *t, double lc, SMetric3 *m = 0, bidimMeshData * data = 0, GFace *gf = 0);
+  // MTri3s are created and destroyed by the million during the refinement,
+  // they are taken from a pool of fixed size blocks owned by the thread
+  static void *operator new (size_t size);
+  static void operator delete (void *p);
   inline void setTri(MTriangle *t) { base = t; }
   inline MTriangle *tri() const { return base; }
   inline void  setNeigh(int iN , MTri3 *n) { neigh[iN] = n; }
@@ -137,9 +163,53 @@ class compareTri3Ptr
   {
     if(a->getRadius() > b->getRadius()) return true;
     if(a->getRadius() < b->getRadius()) return false;
-    Less_Face lf;
-    return lf(a->tri()->getFace(0), b->tri()->getFace(0));
+    // element numbers are unique, this avoids building and sorting a MFace
+    // for every comparison of triangles with the same radius
+    return a->tri()->getNum() < b->tri()->getNum();
+  }
+};
+
+// Refinement queue of the Bowyer-Watson algorithm: a binary heap with the
+// worst triangle on top, in the same order as compareTri3Ptr. Triangles that
+// are deleted from the mesh are left in the heap and skipped when they reach
+// the top.
+class MTri3Heap
+{
+ private:
+  std::vector<MTri3*> _heap;
+  struct compareHeap
+  {
+    compareTri3Ptr lt;
+    inline bool operator () (const MTri3 *a, const MTri3 *b) const { return lt(b, a); }
+  };
+ public:
+  typedef std::vector<MTri3*>::iterator iterator;
+  template <class ITERATOR>
+  MTri3Heap(ITERATOR first, ITERATOR last) : _heap(first, last)
+  {
+    std::make_heap(_heap.begin(), _heap.end(), compareHeap());
+  }
+  inline void insert(MTri3 *t)
+  {
+    _heap.push_back(t);
+    std::push_heap(_heap.begin(), _heap.end(), compareHeap());
+  }
+  template <class ITERATOR>
+  inline void insert(ITERATOR first, ITERATOR last)
+  {
+    for(; first != last; ++first) insert(*first);
+  }
+  inline MTri3 *top() const { return _heap.front(); }
+  inline void pop()
+  {
+    std::pop_heap(_heap.begin(), _heap.end(), compareHeap());
+    _heap.pop_back();
   }
+  inline bool empty() const { return _heap.empty(); }
+  inline size_t size() const { return _heap.size(); }
+  inline iterator begin() { return _heap.begin(); }
+  inline iterator end() { return _heap.end(); }
+  inline iterator find(MTri3 *t) { return std::find(_heap.begin(), _heap.end(), t); }
 };
 
 void connectTriangles(std::list<MTri3*> &);
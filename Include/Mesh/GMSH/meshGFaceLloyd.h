@@ -20,7 +20,10 @@ class smoothing{
   int NORM;
  public :
   smoothing(int,int);
+  // Lloyd iterations on the triangulation of the face
   void optimize_face(GFace*);
+  // Lp norm CVT minimized with BFGS, the face is meshed again afterwards
+  void optimize_face_lpcvt(GFace*);
   void optimize_model();
 };
 
@@ -8,6 +8,7 @@
 
 #include <map>
 #include <vector>
+#include <unordered_map>
 #include "Mesh/GMSH/MElement.h"
 #include "Mesh/GMSH/MEdge.h"
 #include "Mesh/GMSH/meshGFaceDelaunayInsertion.h"
@@ -51,6 +52,51 @@ template <class T> void buildVertexToElement(std::vector<T*> &eles, v2t_cont &ad
 
 template <class T> void buildEdgeToElement(std::vector<T*> &eles, e2t_cont &adj);
 
+// Vertex to element adjacency of the triangles and the quadrangles of a face,
+// stored as compressed rows. It is built once per face and kept up to date by
+// the topological cleanups, so that the smoothing and the cleanup passes share
+// it instead of building a v2t_cont each time. The vertices are sorted by
+// number and the elements of a row keep the order of the face, as in a
+// v2t_cont. Each row has spare room so that a vertex can gain elements without
+// a rebuild. The vertices are colored such that no two vertices of one color
+// belong to the same element: all the vertices of one color can be moved at the
+// same time, each one seeing the others at their old position.
+class faceAdjacency {
+ private:
+  std::vector<MVertex*> _vertices;
+  std::unordered_map<MVertex*, int> _index;
+  // row i holds _size[i] elements from _start[i], with room for _capacity[i]
+  std::vector<int> _start, _size, _capacity;
+  std::vector<MElement*> _elements;
+  // the vertices grouped by color, empty when the colors must be recomputed
+  std::vector<int> _colorStart, _colored;
+  void _add(int i, MElement *e);
+  void _remove(int i, MElement *e);
+  void _computeColors();
+ public:
+  faceAdjacency(){}
+  faceAdjacency(GFace *gf){ build(gf); }
+  void build(GFace *gf);
+  int numVertices() const { return _vertices.size(); }
+  // null if the vertex was removed
+  MVertex *getVertex(int i) const { return _vertices[i]; }
+  // -1 if the vertex is not in the adjacency
+  int getIndex(MVertex *v) const;
+  int numElements(int i) const { return _size[i]; }
+  MElement *getElement(int i, int j) const { return _elements[_start[i] + j]; }
+  void getElements(int i, std::vector<MElement*> &lt) const;
+  // local topological operations, the elements must already be modified
+  void addElement(MElement *e);
+  void removeElement(MElement *e);
+  // moves the elements of v1 to v2 once v1 was replaced by v2 in them
+  void mergeVertex(MVertex *v1, MVertex *v2);
+  // to be called before a vertex that has no elements left is deleted
+  void removeVertex(MVertex *v);
+  int numColors();
+  int colorSize(int c) const { return _colorStart[c + 1] - _colorStart[c]; }
+  int colorVertex(int c, int k) const { return _colored[_colorStart[c] + k]; }
+};
+
 void buildVertexToTriangle(std::vector<MTriangle*> &, v2t_cont &adj);
 void buildEdgeToTriangle(std::vector<MTriangle*> &, e2t_cont &adj);
 void buildListOfEdgeAngle(e2t_cont adj, std::vector<edge_angle> &edges_detected,
@@ -58,6 +104,8 @@ void buildListOfEdgeAngle(e2t_cont adj, std::vector<edge_angle> &edges_detected,
 void buildEdgeToElements(std::vector<MElement*> &tris, e2t_cont &adj);
 
 void laplaceSmoothing(GFace *gf, int niter=1, bool infinity_norm = false);
+void laplaceSmoothing(GFace *gf, faceAdjacency &adj, int niter=1,
+                      bool infinity_norm = false);
 
 void _relocateVertex(GFace *gf, MVertex *ver,
                      const std::vector<MElement*> &lt);
@@ -69,6 +117,10 @@ int edgeSwapPass(GFace *gf,
                  std::set<MTri3*, compareTri3Ptr> &allTris,
                  const swapCriterion &cr, bidimMeshData &DATA);
 void removeThreeTrianglesNodes(GFace *gf);
+int removeTwoQuadsNodes(GFace *gf);
+int removeTwoQuadsNodes(GFace *gf, faceAdjacency &adj);
+int removeDiamonds(GFace *gf);
+int removeDiamonds(GFace *gf, faceAdjacency &adj);
 void buildMeshGenerationDataStructures(GFace *gf,
                                        std::set<MTri3*, compareTri3Ptr> &AllTris,
 				       bidimMeshData & data);
@@ -120,8 +172,11 @@ struct RecombineTriangle
   double angle;
   double quality;
   MVertex *n1, *n2, *n3, *n4;
-  RecombineTriangle(const MEdge &me, MElement *_t1, MElement *_t2)
-    : t1(_t1), t2(_t2)
+  // angle and quality are left to the caller if measure is false, e.g. to
+  // compute them for all the pairs at once with qmQuadrangle::eta
+  RecombineTriangle(const MEdge &me, MElement *_t1, MElement *_t2,
+                    bool measure = true)
+    : t1(_t1), t2(_t2), angle(0.), quality(0.)
   {
     n1 = me.getVertex(0);
     n2 = me.getVertex(1);
@@ -135,6 +190,8 @@ struct RecombineTriangle
     else if(t2->getVertex(1) != n1 && t2->getVertex(1) != n2) n4 = t2->getVertex(1);
     else if(t2->getVertex(2) != n1 && t2->getVertex(2) != n2) n4 = t2->getVertex(2);
 
+    if(!measure) return;
+
     MQuadrangle q (n1,n3,n2,n4);
     angle = q.etaShapeMeasure();
 
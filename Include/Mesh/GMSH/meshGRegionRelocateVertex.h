@@ -4,9 +4,11 @@
 //class GRegion;
 class GFace;
 class MElement;
+class faceAdjacency;
 //void RelocateVertices (GRegion* region, int niter, double tol = 1.e-2);
 //void RelocateVertices (std::vector<GRegion*> &regions, int niter, double tol = 1.e-2);
 void RelocateVertices (GFace*, int niter, double tol = 1.e-3);
+void RelocateVertices (GFace*, faceAdjacency &adj, int niter, double tol = 1.e-3);
 void _relocateVertexGolden(MVertex *ver, const std::vector<MElement*> &lt,  double relax, double tol= 1.e-2);
 
 #endif
@@ -8,6 +8,7 @@
 
 //#include "fullMatrix.h"
 #include <vector>
+#include <unordered_map>
 //#include "SPoint3.h"
 
 class SPoint3;
@@ -22,6 +23,25 @@ class MQuadrangle;
 //class MHexahedron;
 class MElement;
 
+// Coordinates of a set of elements stored in separate arrays, for the batch
+// measures below. Each vertex is stored once and the elements refer to their
+// vertices by index in nodes
+class qmElementArrays
+{
+ private:
+  std::unordered_map<const MVertex*, int> _index;
+ public:
+  std::vector<double> x, y, z;
+  std::vector<int> nodes;
+  int addVertex(const MVertex *v);
+  void addElement(const MVertex *v1, const MVertex *v2, const MVertex *v3);
+  void addElement(const MVertex *v1, const MVertex *v2, const MVertex *v3,
+                  const MVertex *v4);
+  void gather(const std::vector<MTriangle*> &ele);
+  void gather(const std::vector<MQuadrangle*> &ele);
+  void clear();
+};
+
 
 class qmTriangle
 {
@@ -35,6 +55,11 @@ public:
                       const double &x2, const double &y2, const double &z2,
                       const double &x3, const double &y3, const double &z3);
   static double eta(MTriangle *el);
+  // batch versions, for n triangles given by 3 indices each in nodes
+  static void gamma(int n, const int *nodes, const double *x, const double *y,
+                    const double *z, double *q);
+  static void eta(int n, const int *nodes, const double *x, const double *y,
+                  const double *z, double *q);
   static double angles(MTriangle *e);
   static double minNCJ(const MTriangle *e);
   static void NCJRange(const MTriangle *e, double &valMin, double &valMax);
@@ -52,6 +77,10 @@ class qmQuadrangle
 public:
   static double gamma(MQuadrangle *el) { return eta(el); }
   static double eta(MQuadrangle *el);
+  // batch version, for n quadrangles given by 4 indices each in nodes ;
+  // maxAngle receives the largest deviation of the angles from 90 degrees
+  static void eta(int n, const int *nodes, const double *x, const double *y,
+                  const double *z, double *q, double *maxAngle = 0);
   static double angles(MQuadrangle *e);
   static double minNCJ(const MQuadrangle *e);
   static void NCJRange(const MQuadrangle *e, double &valMin, double &valMax);
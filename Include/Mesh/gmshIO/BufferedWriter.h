@@ -0,0 +1,94 @@
+// Gmsh - Copyright (C) 1997-2017 C. Geuzaine, J.-F. Remacle
+//
+// See the LICENSE.txt file for license information. Please report all
+// bugs and problems to the public mailing list <gmsh@onelab.info>.
+
+#ifndef _BUFFERED_WRITER_H_
+#define _BUFFERED_WRITER_H_
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+// Output layer for the mesh writers. Text and binary data is collected in a
+// large chunk buffer that is handed to fwrite() once it is full, instead of
+// issuing one fprintf()/fwrite() per vertex and per element. Integers and
+// "%.Ng" floating point numbers are converted to text without going through
+// the printf machinery; the output is identical to the one of fprintf().
+// Anything written to the FILE directly must be preceded by a flush().
+class BufferedWriter {
+ private:
+  FILE *_fp;
+  std::vector<char> _buffer;
+  std::size_t _size;
+  bool _error;
+  // make room for at least n bytes at the end of the buffer
+  char *_reserve(std::size_t n)
+  {
+    if(_size + n > _buffer.size()){
+      flush();
+      if(n > _buffer.size()) _buffer.resize(n);
+    }
+    return &_buffer[_size];
+  }
+ public:
+  BufferedWriter(FILE *fp, std::size_t chunkSize = 1 << 20)
+    : _fp(fp), _buffer(chunkSize), _size(0), _error(false) {}
+  ~BufferedWriter(){ flush(); }
+  FILE *getFile(){ return _fp; }
+  // returns false if any fwrite() failed
+  bool good() const { return !_error; }
+  void flush()
+  {
+    if(_size && fwrite(&_buffer[0], 1, _size, _fp) != _size) _error = true;
+    _size = 0;
+  }
+  void putChar(char c)
+  {
+    *_reserve(1) = c;
+    _size++;
+  }
+  void putString(const char *str, std::size_t length)
+  {
+    if(length >= _buffer.size()){
+      flush();
+      if(fwrite(str, 1, length, _fp) != length) _error = true;
+      return;
+    }
+    memcpy(_reserve(length), str, length);
+    _size += length;
+  }
+  void putString(const char *str){ putString(str, strlen(str)); }
+  void putString(const std::string &str){ putString(str.data(), str.size()); }
+  // same as fprintf("%d")
+  void putInt(int value)
+  {
+    char *out = _reserve(12);
+    unsigned int u = value;
+    if(value < 0){
+      *out++ = '-';
+      u = 0u - u;
+      _size++;
+    }
+    char digits[10];
+    int n = 0;
+    do{
+      digits[n++] = '0' + u % 10;
+      u /= 10;
+    } while(u);
+    for(int i = 0; i < n; i++) out[i] = digits[n - 1 - i];
+    _size += n;
+  }
+  // same as fprintf("%.<precision>g")
+  void putDouble(double value, int precision = 16);
+  // generic fallback for the formats that have no fast path
+  void putFormat(const char *format, ...);
+  // raw bytes, e.g. the sections of binary files
+  void putBinary(const void *data, std::size_t size)
+  {
+    putString((const char*)data, size);
+  }
+};
+
+#endif
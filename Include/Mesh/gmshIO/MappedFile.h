@@ -0,0 +1,77 @@
+// Gmsh - Copyright (C) 1997-2017 C. Geuzaine, J.-F. Remacle
+//
+// See the LICENSE.txt file for license information. Please report all
+// bugs and problems to the public mailing list <gmsh@onelab.info>.
+
+#ifndef _MAPPED_FILE_H_
+#define _MAPPED_FILE_H_
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// Read-only view of a complete file. On POSIX systems the file is mapped
+// into memory, so that the readers can parse it in place (and from several
+// threads) without any copy or stdio call; elsewhere the file is read into a
+// buffer in one call.
+class MappedFile {
+ private:
+  const char *_data;
+  std::size_t _size;
+  bool _mapped;
+  std::vector<char> _buffer;
+ public:
+  MappedFile() : _data(0), _size(0), _mapped(false) {}
+  ~MappedFile(){ close(); }
+  bool open(const std::string &name);
+  void close();
+  const char *begin() const { return _data; }
+  const char *end() const { return _data + _size; }
+  std::size_t size() const { return _size; }
+};
+
+// Cursor over a range of text (or mixed text and binary) data. The numbers
+// are converted by hand: integers directly, and decimal numbers with at most
+// 19 significant digits and a small exponent exactly with a single floating
+// point operation; anything else goes through strtod(), so the values are
+// identical to the ones obtained with fscanf().
+class TextScanner {
+ private:
+  const char *_begin, *_end, *_pos;
+ public:
+  TextScanner(const char *begin, const char *end)
+    : _begin(begin), _end(end), _pos(begin) {}
+  const char *begin() const { return _begin; }
+  const char *end() const { return _end; }
+  const char *position() const { return _pos; }
+  void setPosition(const char *pos){ _pos = pos; }
+  void skipSpaces()
+  {
+    while(_pos < _end && (*_pos == ' ' || *_pos == '\n' || *_pos == '\r' ||
+                          *_pos == '\t' || *_pos == '\f' || *_pos == '\v'))
+      _pos++;
+  }
+  bool atEnd(){ skipSpaces(); return _pos >= _end; }
+  // same as fgets(): the line is returned with its end of line character;
+  // returns false at the end of the data
+  bool getLine(std::string &line);
+  // returns the position of the next occurrence of str, or end()
+  const char *find(const char *str) const;
+  // same as fscanf("%d") and fscanf("%lf")
+  bool get(int &value)
+  {
+    skipSpaces();
+    return parseInt(_pos, _end, value);
+  }
+  bool get(double &value)
+  {
+    skipSpaces();
+    return parseDouble(_pos, _end, value);
+  }
+  // same as fread()
+  bool getBinary(void *data, std::size_t size);
+  static bool parseInt(const char *&pos, const char *end, int &value);
+  static bool parseDouble(const char *&pos, const char *end, double &value);
+};
+
+#endif
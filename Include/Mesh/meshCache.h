@@ -0,0 +1,97 @@
+#ifndef MESH_CACHE_H_
+#define MESH_CACHE_H_
+
+#include <string>
+#include <cstdint>
+
+#include <UI/geometryShapes.h>
+
+#include <common/plfcolony.h>
+#include <common/MeshSettings.h>
+#include <common/ProjectFile.h>
+
+#include <Mesh/meshRegionTable.h>
+
+class GModel;
+
+
+/**
+ * @class meshCache
+ * @author Phillip
+ * @date 18/10/26
+ * @file meshCache.h
+ * @brief 	This class stores the mesh of a simulation in a cache file next to the project so that the geometry does
+ * 			not need to be meshed again when it did not change. The cache is keyed by a hash of everything that the
+ * 			mesh depends on: the nodes, the lines, the arcs, the block labels with their properties and the mesh
+ * 			settings that are passed to GMSH. The cache file uses the chunked layout of the project file and contains
+ * 			the key, the mesh as a binary MSH file and the region table that links the mesh to the materials and the
+ * 			boundary conditions. If the key of the cache file does not match the key of the
+ * 			geometry, the cache is ignored and overwritten once the geometry is meshed.
+ */
+class meshCache
+{
+private:
+
+	//! The version of the key. This is incremented whenever the meshing changes so that older caches are ignored
+	static const uint32_t p_keyVersion = 5;
+
+	//! The path of the cache file
+	std::string p_filePath;
+
+public:
+
+	/**
+	 * @brief The constructor for the class
+	 * @param folderPath The folder that the project is saved in
+	 * @param simulationName The name of the simulation
+	 */
+	meshCache(std::string folderPath, std::string simulationName)
+	{
+		p_filePath = folderPath + "/" + simulationName + ".meshcache";
+	}
+
+	/**
+	 * @brief 	Computes the key of the geometry. The shapes are hashed in the same form that they are saved in the
+	 * 			project file. Only the mesh settings that change the mesh are hashed. The export settings are not
+	 * 			part of the key
+	 * @param nodeList The nodes of the geometry
+	 * @param lineList The lines of the geometry
+	 * @param arcList The arcs of the geometry
+	 * @param blockLabelList The block labels of the geometry
+	 * @param settings The mesh settings set by the user
+	 * @return Returns a 64 bit FNV-1a hash of the geometry and the settings
+	 */
+	static uint64_t computeKey(plf::colony<node> *nodeList, plf::colony<edgeLineShape> *lineList, plf::colony<arcShape> *arcList,
+								plf::colony<blockLabel> *blockLabelList, meshSettings *settings);
+
+	/**
+	 * @brief Reads the mesh from the cache file if the key of the cache file matches
+	 * @param mesh The model that the mesh is read into
+	 * @param key The key of the geometry
+	 * @param regions Set to the region table of the mesh
+	 * @return Returns true if the mesh was read. False if there is no cache file or if it belongs to a different geometry
+	 */
+	bool load(GModel *mesh, uint64_t key, meshRegionTable &regions);
+
+	/**
+	 * @brief Writes the mesh of a model to the cache file
+	 * @param mesh The model that contains the mesh
+	 * @param key The key of the geometry
+	 * @param regions The region table of the mesh
+	 * @param errorMessage Set to the reason if the cache file could not be written
+	 * @return Returns true if the cache file was written
+	 */
+	bool store(GModel *mesh, uint64_t key, const meshRegionTable &regions, std::string &errorMessage);
+
+	/**
+	 * @brief Retrieves the path of the cache file
+	 * @return Returns the path of the cache file
+	 */
+	std::string getFilePath()
+	{
+		return p_filePath;
+	}
+};
+
+
+#endif
@@ -0,0 +1,123 @@
+#ifndef MESH_EXPORTER_H_
+#define MESH_EXPORTER_H_
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <utility>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#include <Mesh/meshSnapshot.h>
+#include <Mesh/meshFileWriter.h>
+
+
+/**
+ * @class meshExporter
+ * @author Phillip
+ * @date 18/10/26
+ * @file meshExporter.h
+ * @brief 	This class writes the mesh file formats that the user selected from a mesh snapshot. Every format is
+ * 			written by its own background thread so that the formats are written concurrently and the UI does not have
+ * 			to wait until the files are on the disk. Each thread streams its file to the disk with a meshFileWriter,
+ * 			which is the same writer that the GModel writers use. Since the threads only read the snapshot, the GMSH
+ * 			model can be modified or deleted while the files are written.
+ */
+class meshExporter
+{
+private:
+
+	//! The number of exports that are currently being written by the background threads
+	static int p_activeExports;
+
+	//! The mutex that protects the number of active exports
+	static std::mutex p_exportMutex;
+
+	//! Condition that is signalled when an export is finished
+	static std::condition_variable p_exportFinished;
+
+	//! The mesh that is written
+	std::shared_ptr<const meshSnapshot> p_snapshot;
+
+	//! A file that is written
+	struct exportFile
+	{
+		//! The format of the file
+		meshExportFormat format;
+
+		//! The path of the file
+		std::string filePath;
+
+		//! Boolean used to indicate if all of the elements are written instead of only the elements of the physical groups
+		bool saveAll;
+
+		//! Boolean used to indicate if the data of the file is compressed. Only used by the VTU format
+		bool compress;
+	};
+
+	//! Boolean used to indicate if the data of the files is compressed
+	bool p_compress = true;
+
+	//! The files that are written
+	std::vector<exportFile> p_exports;
+
+	/**
+	 * @brief 	The function that is executed by each background thread. Writes the file to the disk and posts the
+	 * 			result to the message windows
+	 * @param snapshot The mesh
+	 * @param file The file that is written
+	 */
+	static void runExport(std::shared_ptr<const meshSnapshot> snapshot, exportFile file);
+
+public:
+
+	/**
+	 * @brief The constructor for the class
+	 * @param snapshot The mesh that is written. The snapshot is shared with the background threads
+	 */
+	meshExporter(std::shared_ptr<const meshSnapshot> snapshot)
+	{
+		p_snapshot = snapshot;
+	}
+
+	/**
+	 * @brief Adds a file to the list of files that are written
+	 * @param format The format of the file
+	 * @param filePath The path of the file
+	 * @param saveAll Set to true in order to write all of the elements instead of only the elements of the physical groups
+	 */
+	void addExport(meshExportFormat format, std::string filePath, bool saveAll = false)
+	{
+		p_exports.push_back(exportFile{format, filePath, saveAll, true});
+	}
+
+	/**
+	 * @brief Sets if the data of the files is compressed. Only the VTU format supports compression
+	 * @param state Set to true in order to compress the data
+	 */
+	void setCompressionState(bool state)
+	{
+		p_compress = state;
+	}
+
+	/**
+	 * @brief 	Starts one background thread for each file and returns immediately. The result of each file is
+	 * 			posted to the message windows once the file is written
+	 */
+	void start();
+
+	/**
+	 * @brief Checks if any files are still being written
+	 * @return Returns true if at least one background thread has not finished
+	 */
+	static bool isExporting();
+
+	/**
+	 * @brief Blocks until all of the background threads have finished writing
+	 */
+	static void waitForExports();
+};
+
+
+#endif
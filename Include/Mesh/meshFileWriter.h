@@ -0,0 +1,172 @@
+#ifndef MESH_FILE_WRITER_H_
+#define MESH_FILE_WRITER_H_
+
+#include <string>
+#include <memory>
+#include <cstdio>
+
+#include <Mesh/meshSnapshot.h>
+#include <Mesh/gmshIO/BufferedWriter.h>
+
+
+//! Enum that is used to specify the mesh file formats that can be written from a mesh snapshot
+enum class meshExportFormat
+{
+	VTK,/*!< Legacy VTK unstructured grid (.vtk) */
+	STL,/*!< STL triangulation (.stl) */
+	PLY2,/*!< PLY2 triangulation (.ply2) */
+	VRML,/*!< VRML 1.0 (.vrml) */
+	MESH,/*!< INRIA Medit mesh (.mesh) */
+	MAIL,/*!< CEA triangulation (.mail) */
+	SU2,/*!< SU2 mesh (.su2) */
+	VTU/*!< Compressed binary XML VTK unstructured grid (.vtu) */
+};
+
+
+/**
+ * @class meshFileWriter
+ * @author Phillip
+ * @date 18/10/26
+ * @file meshFileWriter.h
+ * @brief 	This class writes a mesh snapshot in one of the mesh file formats. This is the only writer of these formats:
+ * 			the GModel writers (GModel::writeVTK, GModel::writeSTL, ...) create a snapshot of the model and write it
+ * 			with this class, and the background threads of the meshExporter write the snapshot that the mesh maker
+ * 			created. The text is streamed to the file through a BufferedWriter so that only one chunk of the file is
+ * 			held in memory. The binary VTU format is written by the vtuWriter.
+ */
+class meshFileWriter
+{
+private:
+
+	//! The mesh that is written
+	std::shared_ptr<const meshSnapshot> p_snapshot;
+
+	//! Boolean used to indicate if the VTK and STL files are written in the binary form
+	bool p_binary = false;
+
+	//! Boolean used to indicate if all of the elements are written. Otherwise, only the elements of the physical
+	//! groups are written. All of the elements are always written if the model has no physical groups
+	bool p_saveAll = false;
+
+	//! The factor that the coordinates are multiplied with
+	double p_scalingFactor = 1.0;
+
+	//! Boolean used to indicate if the binary VTK data is already big endian
+	bool p_bigEndian = false;
+
+	//! The tag of the elements in the MESH format. 1 for the elementary entity, 2 for the physical group and 3 for the partition
+	int p_elementTagType = 1;
+
+	//! Boolean used to indicate if the data of the VTU format is compressed with zlib
+	bool p_compress = true;
+
+	//! The output stream of the file that is written
+	BufferedWriter *p_output = nullptr;
+
+	/**
+	 * @brief Checks if the elements of an entity are written
+	 * @param entity The entity
+	 * @param saveAll Set to true if all of the entities are written
+	 * @return Returns true if the elements are written
+	 */
+	bool isEntitySaved(const meshSnapshot::snapshotEntity &entity, bool saveAll) const
+	{
+		return (saveAll || entity.physicals.size() > 0);
+	}
+
+	/**
+	 * @brief Writes the coordinates of a node with the format "%.16g %.16g %.16g"
+	 * @param node The position of the node
+	 */
+	void writeCoordinates(unsigned int node);
+
+	void writeVTK(bool saveAll);
+
+	void writeSTL(bool saveAll);
+
+	void writePLY2();
+
+	void writeVRML(bool saveAll);
+
+	void writeMESH(bool saveAll);
+
+	void writeMAIL(bool saveAll);
+
+	/**
+	 * @brief Writes the mesh in the SU2 format
+	 * @param saveAll Set to true if all of the elements are written
+	 * @return Returns false if the dimension of the mesh is not supported by the format
+	 */
+	bool writeSU2(bool saveAll);
+
+public:
+
+	/**
+	 * @brief The constructor for the class
+	 * @param snapshot The mesh that is written
+	 */
+	meshFileWriter(std::shared_ptr<const meshSnapshot> snapshot)
+	{
+		p_snapshot = snapshot;
+	}
+
+	void setBinaryState(bool state)
+	{
+		p_binary = state;
+	}
+
+	void setSaveAllState(bool state)
+	{
+		p_saveAll = state;
+	}
+
+	void setScalingFactor(double factor)
+	{
+		p_scalingFactor = factor;
+	}
+
+	void setBigEndianState(bool state)
+	{
+		p_bigEndian = state;
+	}
+
+	void setElementTagType(int type)
+	{
+		p_elementTagType = type;
+	}
+
+	void setCompressionState(bool state)
+	{
+		p_compress = state;
+	}
+
+	/**
+	 * @brief 	Writes the file. The VTU format is only written with the elements of the physical groups if the model
+	 * 			has any. Its data is compressed if the compression is turned on and zlib is available
+	 * @param format The format of the file
+	 * @param filePath The path of the file
+	 * @param errorMessage Set to the reason if the file could not be written
+	 * @return Returns true if the file was written
+	 */
+	bool write(meshExportFormat format, std::string filePath, std::string &errorMessage);
+
+	/**
+	 * @brief 	Writes the mesh of a model. This is used by the GModel writers. Must be called from the thread that
+	 * 			owns the model. Afterwards, the vertices of the model are indexed as with GModel::indexMeshVertices(true)
+	 * @param model The model
+	 * @param format The format of the file
+	 * @param filePath The path of the file
+	 * @param errorMessage Set to the reason if the file could not be written
+	 * @param binary Set to true in order to write the binary form of the VTK and STL formats
+	 * @param saveAll Set to true in order to write all of the elements instead of only the elements of the physical groups
+	 * @param scalingFactor The factor that the coordinates are multiplied with
+	 * @param bigEndian Set to true if the binary VTK data is already big endian
+	 * @param elementTagType The tag of the elements in the MESH format
+	 * @return Returns true if the file was written
+	 */
+	static bool writeModel(GModel *model, meshExportFormat format, std::string filePath, std::string &errorMessage, bool binary = false,
+							bool saveAll = false, double scalingFactor = 1.0, bool bigEndian = false, int elementTagType = 1);
+};
+
+
+#endif
@@ -4,8 +4,11 @@
 #include <vector>
 #include <algorithm>
 #include <map>
+#include <list>
 #include <utility>
 #include <iterator>
+#include <memory>
+#include <chrono>
 
 #include <UI/geometryShapes.h>
 #include <UI/ModelDefinition/ModelDefinition.h>
@@ -21,6 +24,11 @@
 
 #include <Mesh/ClosedPath.h>
 #include <Mesh/BoundingBox.h>
+#include <Mesh/meshSnapshot.h>
+#include <Mesh/meshExporter.h>
+#include <Mesh/meshCache.h>
+#include <Mesh/meshRegionTable.h>
+#include <Mesh/meshSizing.h>
 
 #include <Mesh/GMSH/Gmsh.h>
 #include <Mesh/GMSH/Context.h>
@@ -28,6 +36,9 @@
 #include <Mesh/GMSH/GEdge.h>
 #include <Mesh/GMSH/GFace.h>
 #include <Mesh/GMSH/GModel.h>
+#include <Mesh/GMSH/Field.h>
+#include <Mesh/GMSH/meshGFace.h>
+#include <Mesh/GMSH/qualityMeasures.h>
 
 #include <Mesh/GMSH/gmshFace.h>
 #include <Mesh/GMSH/Geo.h>
@@ -84,6 +95,46 @@ private:
 	//! A number to specify the number of block labels that the program used. Used to check if there are any forgotten labels
 	unsigned int p_blockLabelsUsed = 0;
 	
+	//! The materials of the GMSH faces and the boundary conditions of the GMSH edges
+	meshRegionTable p_regions;
+	
+	//! The element sizes computed from the local feature size of the closed contours
+	meshSizing p_sizing;
+	
+	//! The GEdges whose mesh size is computed from the local feature size. The key is the tag of the GEdge
+	std::map<int, edgeLineShape*> p_autoSizedEdges;
+	
+	//! The tag of a GEdge of each edge of the geometry. Edges that are shared between faces have several GEdges
+	std::map<edgeLineShape*, int> p_edgeTags;
+	
+	//! The quality of the worst element that a face must reach so that it is not meshed again in the next pass
+	double p_targetQuality = 0.5;
+	
+	//! The passes stop when neither the worst nor the mean element quality improve by more than this value
+	double p_minimumImprovement = 0.01;
+	
+	//! The passes stop when the number of mesh vertices changes by less than this fraction
+	double p_minimumVertexChange = 0.01;
+	
+	//! The mesh of a face that is kept while the face is meshed again so that it can be restored if the new mesh is worse
+	struct faceMesh
+	{
+		//! The face
+		GFace *face;
+		
+		//! The triangles of the face
+		std::vector<MTriangle*> triangles;
+		
+		//! The quadrangles of the face
+		std::vector<MQuadrangle*> quadrangles;
+		
+		//! The mesh vertices inside of the face
+		std::vector<MVertex*> vertices;
+		
+		//! The quality of the worst element of the mesh
+		double worstQuality;
+	};
+	
 	/**
 	 * @brief 	This algorithm is called in order to find 1 closed contour. If the first parameter is null, then the algorithm
 	 * 			will start at the first avaiable edge in the lineList as the starting edge. If none exists, then the algorithm will look in the 
@@ -115,6 +166,72 @@ private:
 	 */
 	void createGMSHGeometry(std::vector<closedPath> *pathContour = nullptr);
 	
+	/**
+	 * @brief 	Sets the mesh size of a GEdge. If the mesh size of the edge is set to auto, the edge inherits the mesh size of
+	 * 			the block label. If the mesh size of the block label is also set to auto, the mesh size is the element size
+	 * 			of the edge computed from the local feature size of the geometry
+	 * @param addedEdge The GEdge that was created for the edge
+	 * @param edge The edge of the closed path
+	 * @param property The property of the block label of the closed path
+	 */
+	void setEdgeMeshSize(GEdge *addedEdge, edgeLineShape *edge, blockProperty *property);
+	
+	/**
+	 * @brief 	Sets the background size field of the GMSH model from the corner refinement, the gaps of the geometry and the
+	 * 			grading of the automatic edge sizes. The fields of a previous mesh are removed. Must be called after the GMSH
+	 * 			geometry is created
+	 */
+	void createSizeFields();
+	
+	/**
+	 * @brief 	Adds the size field that refines the mesh at the corners of the geometry. A corner is a GMSH vertex where
+	 * 			the edges meet at an angle, where more than two edges meet or where an edge ends. The element size at a
+	 * 			corner is the element size of its edges multiplied by the corner refinement factor of the mesh settings.
+	 * 			The corners are grouped by their element size; each group is a distance field with a threshold and the
+	 * 			minimum of the groups is cached on a grid so that the field costs about the same for any number of corners
+	 * @return Returns the id of the field. Returns -1 if the factor is 1 or if there are no corners
+	 */
+	int addCornerRefinement();
+	
+	/**
+	 * @brief 	Adds the size fields that refine the automatically sized edges in the narrow gaps of the geometry. Along an
+	 * 			edge, the element size is the distance to the edges on the other side of the gap divided by the number of
+	 * 			elements across a gap of the sizing, up to the size of the edge. Each field is restricted to the edge that it refines
+	 * @param sizeFields The list that the ids of the fields are added to
+	 */
+	void addGapRefinement(std::list<int> &sizeFields);
+	
+	/**
+	 * @brief 	Adds the size fields that grade the size of the automatically sized edges towards the smaller element
+	 * 			size of their vertices. The size of a vertex is the smallest size of its edges and of the node computed
+	 * 			from the local feature size. The size along an edge grows away from the vertex at the gradation of the
+	 * 			sizing until it reaches the size of the edge. Each field is restricted to the edges that it grades
+	 * @param sizeFields The list that the ids of the fields are added to
+	 */
+	void addVertexGrading(std::list<int> &sizeFields);
+	
+	/**
+	 * @brief 	Runs the mesh passes of the mesh settings. The first pass meshes all of the faces. After each pass, the
+	 * 			element quality and the number of mesh vertices are measured and reported with the time of the pass.
+	 * 			The next pass only meshes again the faces whose worst element is below the target quality; the other
+	 * 			faces keep their mesh. Each pass meshes these faces with a meshing algorithm that was not used yet. A
+	 * 			face whose new mesh is worse keeps its previous mesh. The passes stop early when every face reaches the
+	 * 			target quality, when a pass barely changes the number of mesh vertices of the faces that are meshed
+	 * 			again, when a pass does not improve the quality or when every algorithm was used. The passes create
+	 * 			linear meshes. The mesh is subdivided into quadrangles and the high order elements are created once
+	 * 			after the last pass
+	 */
+	void meshPasses();
+	
+	/**
+	 * @brief Computes the quality of the elements of a face. The quality of a triangle is gamma and the quality of a quadrangle is eta
+	 * @param face The face
+	 * @param worstQuality Returns the quality of the worst element. Returns 1 if the face has no elements
+	 * @param sumQuality Returns the sum of the quality of the elements
+	 * @return Returns the number of elements of the face
+	 */
+	unsigned int faceQuality(GFace *face, double &worstQuality, double &sumQuality);
+	
 	/**
 	 * @brief Algorithm that is ran in order to locate the holes of a closed contour. This alogorithm will first 
 	 * locate all of the holes and then find the top level holes belonging to the closed contour. This is a requirement
@@ -196,6 +313,12 @@ private:
 	 */
 	closedPath recreatePath(closedPath &path, closedPath holeIterator, std::vector<edgeLineShape*> commonEdges);
 	
+	/**
+	 * @brief 	Writes the mesh file formats that the user selected in the mesh settings. The formats are written to
+	 * 			the folder specified in the mesh settings. Nothing is written if the folder does not exist
+	 */
+	void exportMesh();
+	
 public:
 	
 	/**
@@ -229,6 +352,15 @@ public:
 	 */
 	void mesh();
 	
+	/**
+	 * @brief Retrieves the materials of the GMSH faces and the boundary conditions of the GMSH edges of the mesh
+	 * @return Returns the table of the regions. Empty if no mesh was created
+	 */
+	const meshRegionTable &getRegions()
+	{
+		return p_regions;
+	}
+	
 	~meshMaker()
 	{
 		//free(p_nodeList);
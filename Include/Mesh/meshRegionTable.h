@@ -0,0 +1,80 @@
+#ifndef MESH_REGION_TABLE_H_
+#define MESH_REGION_TABLE_H_
+
+#include <map>
+#include <string>
+
+#include <boost/serialization/map.hpp>
+#include <boost/serialization/string.hpp>
+
+class GModel;
+
+
+/**
+ * @class meshRegionTable
+ * @author Phillip
+ * @date 18/10/26
+ * @file meshRegionTable.h
+ * @brief 	This class links the geometric entities of the GMSH model to the properties that the user set in the geometry.
+ * 			The table is filled by the mesh maker when the GMSH geometry is created and is stored with the mesh so that
+ * 			a mesh that is read from a file can still be linked to the materials and the boundary conditions.
+ */
+class meshRegionTable
+{
+private:
+	friend class boost::serialization::access;
+
+	template<class Archive>
+	void serialize(Archive &ar, const unsigned int version)
+	{
+		ar & p_faceMaterials;
+		ar & p_edgeBoundaries;
+	}
+
+	//! The name of the material of each face. The key is the tag of the GFace
+	std::map<int, std::string> p_faceMaterials;
+
+	//! The name of the boundary condition of each edge. The key is the tag of the GEdge. Edges without a boundary condition are not stored
+	std::map<int, std::string> p_edgeBoundaries;
+
+public:
+
+	void setFaceMaterial(int faceTag, std::string material)
+	{
+		p_faceMaterials[faceTag] = material;
+	}
+
+	void setEdgeBoundary(int edgeTag, std::string boundary)
+	{
+		p_edgeBoundaries[edgeTag] = boundary;
+	}
+
+	const std::map<int, std::string> &getFaceMaterials() const
+	{
+		return p_faceMaterials;
+	}
+
+	const std::map<int, std::string> &getEdgeBoundaries() const
+	{
+		return p_edgeBoundaries;
+	}
+
+	void clear()
+	{
+		p_faceMaterials.clear();
+		p_edgeBoundaries.clear();
+	}
+
+	/**
+	 * @brief 	Adds every face of a model to the physical group of its material and every edge with a boundary condition
+	 * 			to the physical group of the boundary condition. The groups are named after the material and the boundary
+	 * 			condition. All of the faces of one material share the number of the group so that the writers and the
+	 * 			solvers can select a material by its number. Must be called again after a mesh is read from a file since
+	 * 			the mesh files are written with all of the elements and without the physical groups
+	 * @param model The model whose entities are added to the physical groups
+	 */
+	void applyPhysicalGroups(GModel *model) const;
+};
+
+
+#endif
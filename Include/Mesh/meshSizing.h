@@ -0,0 +1,205 @@
+#ifndef MESH_SIZING_H_
+#define MESH_SIZING_H_
+
+#include <vector>
+#include <map>
+#include <unordered_map>
+
+#include <UI/geometryShapes.h>
+
+#include <Mesh/ClosedPath.h>
+
+
+/**
+ * @class meshSizing
+ * @author Phillip
+ * @date 18/10/26
+ * @file meshSizing.h
+ * @brief 	This class computes the element sizes of the edges and the nodes of the geometry from the local feature size
+ * 			of the closed contours. The size of an edge is limited by its length and by the radius of an arc. Along the
+ * 			edge, the size is further limited by the distance to the edges that it is not connected to, so that a narrow
+ * 			gap between two contours is crossed by several elements. The gap is stored with the edges that form it so
+ * 			that the size can follow the distance along the edge. The size of a node is limited by the length of its
+ * 			edges and by the distance to the edges that it is not connected to. All of the sizes are absolute and scale
+ * 			with the geometry, so that a model meshes with the same number of elements at any scale. The gaps are found
+ * 			with a uniform grid of the edges, where the arcs are split into straight pieces.
+ */
+class meshSizing
+{
+private:
+	//! A straight piece of an edge. Arcs are split into several pieces
+	struct edgePiece
+	{
+		//! The position of the edge in the edge list
+		unsigned int edge;
+
+		double x0, y0, x1, y1;
+	};
+
+	//! The edges of the closed contours and their holes. Every edge is stored once
+	std::vector<edgeLineShape*> p_edges;
+
+	//! The element size of each edge of p_edges
+	std::vector<double> p_edgeSizes;
+
+	//! The width of the narrowest gap of each edge of p_edges. The width is 0 if the gap does not limit the size of the edge
+	std::vector<double> p_gapWidths;
+
+	//! The edges on the other side of the gap of each edge of p_edges
+	std::vector<std::vector<edgeLineShape*>> p_gapEdges;
+
+	//! The element size of each node. The key is the tag of the GMSH vertex of the node
+	std::map<int, double> p_nodeSizes;
+
+	//! The position of each edge in the edge list
+	std::unordered_map<edgeLineShape*, unsigned int> p_edgeIndex;
+
+	//! The straight pieces of the edges
+	std::vector<edgePiece> p_pieces;
+
+	//! The grid of the pieces, the pieces of cell i are p_gridList[p_gridStart[i] ... p_gridStart[i + 1]]
+	std::vector<unsigned int> p_gridStart, p_gridList;
+
+	double p_gridXMin = 0, p_gridYMin = 0, p_cellSize = 1;
+
+	int p_gridNx = 1, p_gridNy = 1;
+
+	//! The largest element size as a fraction of the size of the model
+	double p_maxSizeFraction = 0.1;
+
+	//! The minimum number of elements along an edge
+	double p_elementsAlongEdge = 2.0;
+
+	//! The minimum number of elements across a gap between two edges
+	double p_elementsAcrossGap = 3.0;
+
+	//! The number of elements on a full circle of the radius of an arc
+	double p_elementsPerCircle = 24.0;
+
+	//! The largest increase of the element size per unit of distance away from a smaller element size
+	double p_gradation = 0.4;
+
+	/**
+	 * @brief Adds an edge to the edge list and splits the edge into straight pieces. Nothing is done if the edge was already added
+	 * @param edge The edge to add
+	 */
+	void addEdge(edgeLineShape *edge);
+
+	/**
+	 * @brief Sorts the pieces of the edges into a uniform grid with about one piece per cell
+	 */
+	void createGrid();
+
+	/**
+	 * @brief 	Finds the pieces of the edges that do not share a node with a box and that are closer to the box than
+	 * 			a search distance. Only the cells that overlap the box expanded by the search distance are searched
+	 * @param xmin The smallest x coordinate of the box
+	 * @param ymin The smallest y coordinate of the box
+	 * @param xmax The largest x coordinate of the box
+	 * @param ymax The largest y coordinate of the box
+	 * @param searchDistance The search distance
+	 * @param firstNode The first node that the pieces may not share
+	 * @param secondNode The second node that the pieces may not share. May be the same as the first node
+	 * @param distance Function that returns the distance to a piece
+	 * @param nearEdges If not null, the positions of the edges of the pieces that were found are added to this list.
+	 * An edge can be added more than once
+	 * @return Returns the distance to the nearest piece or a negative number if no piece was found
+	 */
+	template<class Distance>
+	double findPieces(double xmin, double ymin, double xmax, double ymax, double searchDistance, node *firstNode, node *secondNode,
+						Distance distance, std::vector<unsigned int> *nearEdges = nullptr) const;
+
+public:
+
+	/**
+	 * @brief 	Computes the element sizes of all of the edges and nodes of the closed paths and of their holes.
+	 * 			The previous sizes are removed
+	 * @param paths The closed paths of the geometry
+	 * @param modelSize The size of the model. This is the length of the diagonal of the bounding box
+	 */
+	void compute(std::vector<closedPath> &paths, double modelSize);
+
+	/**
+	 * @brief Retrieves the element size of an edge. The size does not include the limit of the gaps
+	 * @param edge The edge of a closed path
+	 * @return Returns the element size of the edge. Returns 0 if the sizes of the edge were not computed
+	 */
+	double getEdgeSize(edgeLineShape *edge) const
+	{
+		auto found = p_edgeIndex.find(edge);
+
+		if(found != p_edgeIndex.end())
+			return p_edgeSizes[found->second];
+		else
+			return 0;
+	}
+
+	/**
+	 * @brief Retrieves the width of the narrowest gap between an edge and the edges that it is not connected to
+	 * @param edge The edge of a closed path
+	 * @return Returns the width of the gap. Returns 0 if the gap is too wide to limit the size of the edge
+	 */
+	double getGapWidth(edgeLineShape *edge) const
+	{
+		auto found = p_edgeIndex.find(edge);
+
+		if(found != p_edgeIndex.end())
+			return p_gapWidths[found->second];
+		else
+			return 0;
+	}
+
+	/**
+	 * @brief 	Retrieves the edges that form the gap of an edge. These are the edges that are closer to the edge than
+	 * 			the number of elements across a gap times the size of the edge
+	 * @param edge The edge of a closed path
+	 * @return Returns the edges on the other side of the gap. The list is empty if the edge has no gap
+	 */
+	const std::vector<edgeLineShape*> &getGapEdges(edgeLineShape *edge) const
+	{
+		static const std::vector<edgeLineShape*> noEdges;
+		auto found = p_edgeIndex.find(edge);
+
+		if(found != p_edgeIndex.end())
+			return p_gapEdges[found->second];
+		else
+			return noEdges;
+	}
+
+	/**
+	 * @brief Retrieves the element size of a node
+	 * @param vertexTag The tag of the GMSH vertex of the node
+	 * @return Returns the element size of the node. Returns 0 if the node is not on a closed path
+	 */
+	double getNodeSize(int vertexTag) const
+	{
+		auto found = p_nodeSizes.find(vertexTag);
+
+		if(found != p_nodeSizes.end())
+			return found->second;
+		else
+			return 0;
+	}
+
+	/**
+	 * @brief Retrieves the minimum number of elements across a gap. The element size in a gap is the width of the gap divided by this number
+	 * @return Returns the number of elements
+	 */
+	double getElementsAcrossGap() const
+	{
+		return p_elementsAcrossGap;
+	}
+
+	/**
+	 * @brief 	Retrieves the gradation of the element size. Moving away from a small element, the element size grows by at
+	 * 			most the gradation times the distance
+	 * @return Returns the gradation
+	 */
+	double getGradation() const
+	{
+		return p_gradation;
+	}
+};
+
+
+#endif
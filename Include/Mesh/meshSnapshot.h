@@ -0,0 +1,355 @@
+#ifndef MESH_SNAPSHOT_H_
+#define MESH_SNAPSHOT_H_
+
+#include <vector>
+#include <map>
+#include <string>
+#include <utility>
+#include <algorithm>
+#include <cstdlib>
+#include <cmath>
+
+#include <Mesh/GMSH/GModel.h>
+#include <Mesh/GMSH/GEntity.h>
+#include <Mesh/GMSH/MElement.h>
+#include <Mesh/GMSH/MVertex.h>
+#include <Mesh/GMSH/Context.h>
+
+
+/**
+ * @class meshSnapshot
+ * @author Phillip
+ * @date 18/10/26
+ * @file meshSnapshot.h
+ * @brief 	This class holds a copy of the mesh of a GMSH model in flat, indexed arrays. The copy is created once
+ * 			after meshing. Afterwards, the copy does not depend on the GModel anymore which means that it can be
+ * 			read by multiple threads while the model is modified or deleted by the UI. The nodes are stored in the
+ * 			order of the entities of the model (vertices, edges and then faces) with their coordinates in separate
+ * 			arrays. Only the nodes that belong to at least one element are stored. Every node carries two
+ * 			indices: the index that GMSH assigns when all of the elements are saved and the index when only the
+ * 			elements of the physical groups are saved. The elements are stored per entity in the same order as
+ * 			GEntity::getMeshElement. The connectivity of an element is stored as the positions of its nodes in
+ * 			the node arrays. Every element carries the physical group of its entity, which is the material of a face
+ * 			and the boundary condition of an edge (see meshRegionTable). The edges that are shared between faces are
+ * 			duplicated in the GMSH geometry, so their nodes are stored once per face. The coincident nodes are linked
+ * 			to the first node at the same position and the line elements on the outer boundary or on an edge with a
+ * 			boundary condition are listed as the boundary edges.
+ */
+class meshSnapshot
+{
+public:
+
+	//! The data of one geometric entity of the model
+	struct snapshotEntity
+	{
+		//! The dimension of the entity (0 for vertices, 1 for edges and 2 for faces)
+		int dimension;
+
+		//! The tag of the entity
+		int tag;
+
+		//! The physical groups that the entity belongs to
+		std::vector<int> physicals;
+
+		//! The position of the first node of the entity
+		unsigned int firstNode;
+
+		//! The number of nodes that are classified on the entity
+		unsigned int numberNodes;
+
+		//! The position of the first element of the entity
+		unsigned int firstElement;
+
+		//! The number of elements of the entity
+		unsigned int numberElements;
+	};
+
+	//! The data that is identical for all of the elements of the same type
+	struct snapshotElementType
+	{
+		//! The type of the element in the MSH format (MSH_TRI_3, MSH_QUA_4, ...)
+		int mshType;
+
+		//! The class of the element (TYPE_PNT, TYPE_LIN, TYPE_TRI, ...)
+		int elementClass;
+
+		//! The type of the element in the VTK format. 0 if the element can not be saved in VTK
+		int vtkType;
+
+		//! The number of nodes of the element
+		int numberNodes;
+
+		//! The local numbers of the nodes in the order that VTK expects
+		std::vector<int> vtkOrder;
+
+		//! The positions of the elements of the type in the order of the entities
+		std::vector<unsigned int> elements;
+	};
+
+	//! A line element on the outer boundary of the mesh or on an edge with a boundary condition
+	struct snapshotBoundaryEdge
+	{
+		//! The position of the line element
+		unsigned int element;
+
+		//! The tag of the edge that the line element belongs to
+		int edgeTag;
+
+		//! The number of the physical group of the boundary condition of the edge. -1 if the edge has no boundary condition
+		int condition;
+
+		//! Boolean used to indicate if the line element is on the outer boundary of the mesh
+		bool isOuter;
+	};
+
+private:
+
+	//! The name of the model
+	std::string p_name;
+
+	//! The dimension of the model
+	int p_dimension = 0;
+
+	//! The order of the mesh elements
+	int p_meshOrder = 1;
+
+	//! Boolean used to indicate if any entity of the model belongs to a physical group
+	bool p_hasPhysicalGroups = false;
+
+	//! The x coordinate of each node
+	std::vector<double> p_nodeX;
+
+	//! The y coordinate of each node
+	std::vector<double> p_nodeY;
+
+	//! The z coordinate of each node
+	std::vector<double> p_nodeZ;
+
+	//! The position of the first node at the same coordinates for each node. Nodes that do not coincide with another
+	//! node are linked to themselves
+	std::vector<unsigned int> p_sharedNode;
+
+	//! The index of each node if only the elements of the physical groups are saved. The index is 1 based. Nodes that
+	//! are not saved have an index of -1
+	std::vector<int> p_nodePhysicalIndex;
+
+	//! The number of nodes that are saved if only the elements of the physical groups are saved
+	unsigned int p_numberPhysicalNodes = 0;
+
+	//! The entities of the model in the order of GModel::getEntities
+	std::vector<snapshotEntity> p_entities;
+
+	//! The position of each element type in p_elementTypes. The key is the MSH type
+	std::map<int, int> p_elementTypeIndex;
+
+	//! The element types that exist in the mesh
+	std::vector<snapshotElementType> p_elementTypes;
+
+	//! The position of the type of each element in p_elementTypes
+	std::vector<int> p_elementType;
+
+	//! The number of each element as assigned by GMSH
+	std::vector<int> p_elementNumber;
+
+	//! The partition of each element
+	std::vector<int> p_elementPartition;
+
+	//! The number of the physical group of the entity of each element. -1 if the entity is not in a physical group
+	std::vector<int> p_elementRegion;
+
+	//! The position of the first node of each element in p_elementNodes. This vector has a size of the number of elements + 1
+	std::vector<unsigned int> p_elementNodeOffset;
+
+	//! The positions of the nodes of every element
+	std::vector<unsigned int> p_elementNodes;
+
+	//! The names of the physical groups. The key is the dimension and the number of the group
+	std::map<std::pair<int, int>, std::string> p_physicalNames;
+
+	//! The line elements on the outer boundary of the mesh or on an edge with a boundary condition
+	std::vector<snapshotBoundaryEdge> p_boundaryEdges;
+
+	/**
+	 * @brief Retrieves the position of an element type. If the type is new, the data of the type is added
+	 * @param element An element of the type
+	 * @return Returns the position of the type in p_elementTypes
+	 */
+	int addElementType(MElement *element);
+
+	/**
+	 * @brief 	Links every node to the first node at the same coordinates. Two nodes coincide if their coordinates
+	 * 			differ by less than 1e-9 times the diagonal of the bounding box of the nodes
+	 */
+	void findSharedNodes();
+
+	/**
+	 * @brief 	Creates the list of the boundary edges. A line element is on the outer boundary if no other line element
+	 * 			connects the same end nodes. Must be called after findSharedNodes
+	 */
+	void findBoundaryEdges();
+
+public:
+
+	/**
+	 * @brief 	Copies the mesh of a model. This function changes the indices of the mesh vertices. At the end, the
+	 * 			vertices are indexed as with GModel::indexMeshVertices(true). Must be called from the thread that owns
+	 * 			the model
+	 * @param model The model that contains the mesh
+	 */
+	void create(GModel *model);
+
+	const std::string &getName() const
+	{
+		return p_name;
+	}
+
+	int getDimension() const
+	{
+		return p_dimension;
+	}
+
+	int getMeshOrder() const
+	{
+		return p_meshOrder;
+	}
+
+	bool hasPhysicalGroups() const
+	{
+		return p_hasPhysicalGroups;
+	}
+
+	unsigned int getNumberNodes() const
+	{
+		return p_nodeX.size();
+	}
+
+	/**
+	 * @brief Retrieves the number of nodes that are saved
+	 * @param saveAll Set to true if all of the elements are saved. Otherwise, only the elements of the physical groups are saved
+	 * @return Returns the number of nodes
+	 */
+	unsigned int getNumberSavedNodes(bool saveAll) const
+	{
+		return saveAll ? p_nodeX.size() : p_numberPhysicalNodes;
+	}
+
+	/**
+	 * @brief Retrieves the 1 based index that GMSH assigns to a node when a mesh is saved
+	 * @param node The position of the node
+	 * @param saveAll Set to true if all of the elements are saved. Otherwise, only the elements of the physical groups are saved
+	 * @return Returns the index of the node. Returns -1 if the node is not saved
+	 */
+	int getNodeIndex(unsigned int node, bool saveAll) const
+	{
+		return saveAll ? (int)node + 1 : p_nodePhysicalIndex[node];
+	}
+
+	const double *getNodeX() const
+	{
+		return p_nodeX.data();
+	}
+
+	const double *getNodeY() const
+	{
+		return p_nodeY.data();
+	}
+
+	const double *getNodeZ() const
+	{
+		return p_nodeZ.data();
+	}
+
+	/**
+	 * @brief Retrieves the node that a node is merged with
+	 * @param node The position of the node
+	 * @return Returns the position of the first node at the same coordinates
+	 */
+	unsigned int getSharedNode(unsigned int node) const
+	{
+		return p_sharedNode[node];
+	}
+
+	const std::vector<snapshotEntity> &getEntities() const
+	{
+		return p_entities;
+	}
+
+	/**
+	 * @brief Finds an entity of the model
+	 * @param dimension The dimension of the entity
+	 * @param tag The tag of the entity
+	 * @return Returns the position of the entity. Returns -1 if the model has no such entity
+	 */
+	int findEntity(int dimension, int tag) const;
+
+	const std::vector<snapshotElementType> &getElementTypes() const
+	{
+		return p_elementTypes;
+	}
+
+	unsigned int getNumberElements() const
+	{
+		return p_elementType.size();
+	}
+
+	const snapshotElementType &getElementType(unsigned int element) const
+	{
+		return p_elementTypes[p_elementType[element]];
+	}
+
+	int getElementNumber(unsigned int element) const
+	{
+		return p_elementNumber[element];
+	}
+
+	int getElementPartition(unsigned int element) const
+	{
+		return p_elementPartition[element];
+	}
+
+	/**
+	 * @brief Retrieves the region of an element
+	 * @param element The position of the element
+	 * @return 	Returns the number of the physical group of the entity of the element. For a face, this is the group of
+	 * 			its material. For an edge, this is the group of its boundary condition. Returns -1 if the entity is not in a group
+	 */
+	int getElementRegion(unsigned int element) const
+	{
+		return p_elementRegion[element];
+	}
+
+	/**
+	 * @brief Retrieves the nodes of an element
+	 * @param element The position of the element
+	 * @return Returns a pointer to the positions of the nodes of the element in the order of MElement::getVertex
+	 */
+	const unsigned int *getElementNodes(unsigned int element) const
+	{
+		return &p_elementNodes[p_elementNodeOffset[element]];
+	}
+
+	const std::vector<snapshotBoundaryEdge> &getBoundaryEdges() const
+	{
+		return p_boundaryEdges;
+	}
+
+	/**
+	 * @brief 	Retrieves the physical groups of a dimension. The entities of each group are listed in the order of
+	 * 			the entities of the model
+	 * @param dimension The dimension of the groups
+	 * @return Returns a map of the positions of the entities of each group. The key is the number of the group
+	 */
+	std::map<int, std::vector<unsigned int>> getPhysicalGroups(int dimension) const;
+
+	/**
+	 * @brief 	Retrieves the name of a physical group as it is written into the mesh files. If the group has no name,
+	 * 			a name is created from the dimension and the number of the group. Spaces are replaced by underscores
+	 * @param dimension The dimension of the group
+	 * @param number The number of the group
+	 * @return Returns the name of the group
+	 */
+	std::string getPhysicalName(int dimension, int number) const;
+};
+
+
+#endif
@@ -0,0 +1,216 @@
+#ifndef VTU_WRITER_H_
+#define VTU_WRITER_H_
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <cstdio>
+#include <cstdint>
+
+#include <Mesh/meshSnapshot.h>
+#include <Mesh/gmshIO/BufferedWriter.h>
+
+
+/**
+ * @class vtuWriter
+ * @author Phillip
+ * @date 18/10/26
+ * @file vtuWriter.h
+ * @brief 	This class writes a mesh snapshot as an XML VTK unstructured grid (.vtu). All of the arrays are stored
+ * 			as raw binary data in the appended section of the file which is several times smaller and much faster
+ * 			to load than the legacy ASCII format. Optionally, the arrays are compressed in blocks with zlib in the
+ * 			same way as VTK does. The arrays are generated and written one block at a time so that no copy of a
+ * 			complete array is created. Since the sizes of the compressed arrays are only known once they are
+ * 			written, the offsets in the XML header are reserved with a fixed width and filled in at the end.
+ * 			Every cell carries the tag of the geometric entity (the region) and the physical group (the material)
+ * 			that it belongs to. Additional point and cell fields, such as a solution, can be added before the
+ * 			file is written.
+ */
+class vtuWriter
+{
+private:
+
+	//! A field that is written in addition to the mesh
+	struct vtuField
+	{
+		//! The name of the field in the file
+		std::string name;
+
+		//! The number of values per point or cell
+		int numberComponents;
+
+		//! The values of the field. The values of one point or cell are stored together
+		const double *values;
+	};
+
+	//! A part of the file that is filled in once the arrays are written
+	struct vtuPatch
+	{
+		//! The position in the file
+		uint64_t position;
+
+		//! The bytes that are written at the position
+		std::string data;
+	};
+
+	//! The mesh that is written
+	std::shared_ptr<const meshSnapshot> p_snapshot;
+
+	//! Boolean used to indicate if the arrays are compressed
+	bool p_compress = false;
+
+	//! The number of uncompressed bytes in each compressed block. This is the default of VTK
+	unsigned int p_blockSize = 32768;
+
+	//! The fields that are defined on the points
+	std::vector<vtuField> p_pointFields;
+
+	//! The fields that are defined on the cells
+	std::vector<vtuField> p_cellFields;
+
+	//! The output stream of the file that is written
+	BufferedWriter *p_output = nullptr;
+
+	//! The position of the appended section in the file
+	uint64_t p_appendedStart = 0;
+
+	//! The number of bytes that are written into the appended section
+	uint64_t p_appendedSize = 0;
+
+	//! The block of the current array that is not written yet. Only used for compressed arrays
+	std::vector<char> p_block;
+
+	//! The compressed data of a block
+	std::vector<unsigned char> p_compressedBlock;
+
+	//! The compression header of the current array: the number of blocks, the block size, the size of the last
+	//! block and the compressed size of each block
+	std::vector<uint64_t> p_compressionHeader;
+
+	//! The position of the compression header of the current array in the appended section
+	uint64_t p_compressionHeaderOffset = 0;
+
+	//! The parts of the file that are filled in at the end
+	std::vector<vtuPatch> p_patches;
+
+	//! Boolean used to indicate if a block could not be compressed
+	bool p_compressionFailed = false;
+
+	/**
+	 * @brief Starts writing an array into the appended section. Writes the header of the array
+	 * @param numberBytes The number of uncompressed bytes of the array
+	 */
+	void beginArray(uint64_t numberBytes);
+
+	/**
+	 * @brief Appends data to the current array
+	 * @param data Pointer to the data
+	 * @param size The number of bytes
+	 */
+	void appendData(const void *data, std::size_t size);
+
+	/**
+	 * @brief Writes the remaining data of the current array
+	 */
+	void endArray();
+
+	/**
+	 * @brief Compresses the current block and writes it to the file
+	 */
+	void writeBlock();
+
+	/**
+	 * @brief Checks if the cells of an entity are written
+	 * @param entity The entity
+	 * @param saveAll Set to true if all of the entities are written
+	 * @return Returns true if the cells are written
+	 */
+	bool isEntitySaved(const meshSnapshot::snapshotEntity &entity, bool saveAll) const
+	{
+		return (saveAll || entity.physicals.size() > 0);
+	}
+
+	/**
+	 * @brief Calls a function for every element that is written as a cell in the order of the cells
+	 * @param saveAll Set to true if all of the entities are written
+	 * @param cellFunction The function. The arguments are the entity and the position of the element in the snapshot
+	 */
+	template<typename T>
+	void forEachCell(bool saveAll, T cellFunction) const
+	{
+		const std::vector<meshSnapshot::snapshotEntity> &entities = p_snapshot->getEntities();
+
+		for(auto entityIterator = entities.begin(); entityIterator != entities.end(); entityIterator++)
+		{
+			if(!isEntitySaved(*entityIterator, saveAll))
+				continue;
+
+			for(unsigned int i = entityIterator->firstElement; i < entityIterator->firstElement + entityIterator->numberElements; i++)
+			{
+				if(p_snapshot->getElementType(i).vtkType)
+					cellFunction(*entityIterator, i);
+			}
+		}
+	}
+
+public:
+
+	/**
+	 * @brief The constructor for the class
+	 * @param snapshot The mesh that is written
+	 */
+	vtuWriter(std::shared_ptr<const meshSnapshot> snapshot)
+	{
+		p_snapshot = snapshot;
+	}
+
+	/**
+	 * @brief Sets if the arrays are compressed with zlib. If Omni-FEM is built without zlib, the arrays are always
+	 * 			written uncompressed
+	 * @param state Set to true in order to compress the arrays
+	 */
+	void setCompressionState(bool state)
+	{
+		p_compress = state;
+	}
+
+	bool getCompressionState()
+	{
+		return p_compress;
+	}
+
+	/**
+	 * @brief 	Adds a field that is defined on the points of the mesh. The values are not copied and must remain
+	 * 			valid until the file is written
+	 * @param name The name of the field
+	 * @param numberComponents The number of values per point
+	 * @param values The values of the field for each node of the snapshot in the order of the nodes of the snapshot
+	 */
+	void addPointField(std::string name, int numberComponents, const double *values)
+	{
+		p_pointFields.push_back(vtuField{name, numberComponents, values});
+	}
+
+	/**
+	 * @brief 	Adds a field that is defined on the cells of the mesh. The values are not copied and must remain
+	 * 			valid until the file is written
+	 * @param name The name of the field
+	 * @param numberComponents The number of values per cell
+	 * @param values The values of the field for each element of the snapshot in the order of the elements of the snapshot
+	 */
+	void addCellField(std::string name, int numberComponents, const double *values)
+	{
+		p_cellFields.push_back(vtuField{name, numberComponents, values});
+	}
+
+	/**
+	 * @brief Writes the file. If the model has physical groups, only the elements of the physical groups are written
+	 * @param filePath The path of the file
+	 * @param errorMessage Set to the reason if the file could not be written
+	 * @return Returns true if the file was written
+	 */
+	bool write(std::string filePath, std::string &errorMessage);
+};
+
+
+#endif
@@ -0,0 +1,123 @@
+#ifndef BH_CURVE_H_
+#define BH_CURVE_H_
+
+#include <vector>
+#include <algorithm>
+#include <cmath>
+
+#include <common/JilesAthertonParameters.h>
+
+
+//! The permeability of free space in H/m
+const double MU_0 = 4.0 * M_PI * 1.0e-7;
+
+
+/**
+ * @class bhCurve
+ * @author Phillip
+ * @date 18/10/26
+ * @file BHCurve.h
+ * @brief 	This class describes the nonlinear B-H curve of a magnetic material. The curve is given
+ * 			as a list of (H, B) points and is interpolated with a monotone cubic (Fritsch-Carlson) spline so that
+ * 			the interpolated curve never has a negative slope. Since the solver evaluates the reluctivity
+ * 			at every integration point in every nonlinear iteration, the spline is sampled once into a
+ * 			lookup table that is uniform in B^2. Evaluating the reluctivity is then an index computation and
+ * 			one linear interpolation. The derivative that is returned is the exact derivative of the
+ * 			interpolated table which keeps the Newton Jacobian consistent with the residual.
+ */
+class bhCurve
+{
+private:
+
+	//! The magnetic flux density of the data points in T
+	std::vector<double> p_B;
+
+	//! The magnetic field intensity of the data points in A/m
+	std::vector<double> p_H;
+
+	//! The slope dH/dB of the spline at each data point
+	std::vector<double> p_slope;
+
+	//! The reluctivity sampled at uniform steps of B^2
+	std::vector<double> p_reluctivityTable;
+
+	//! The derivative of the reluctivity with respect to B^2 for each interval of the table
+	std::vector<double> p_derivativeTable;
+
+	//! The step size of the lookup table in T^2
+	double p_tableStep = 0;
+
+	//! The inverse of the step size of the lookup table
+	double p_inverseTableStep = 0;
+
+	/**
+	 * @brief Computes the slopes of the monotone cubic spline at the data points
+	 */
+	void computeSlopes();
+
+	/**
+	 * @brief Evaluates the field intensity along the spline
+	 * @param B The flux density to evaluate at
+	 * @return Returns the field intensity in A/m
+	 */
+	double evaluateSpline(double B) const;
+
+public:
+
+	/**
+	 * @brief Sets the data points of the curve. The first point should be at the origin.
+	 * @param H The list of field intensities in A/m
+	 * @param B The list of flux densities in T. Must be the same size as H
+	 */
+	void setData(std::vector<double> H, std::vector<double> B);
+
+	/**
+	 * @brief 	Creates the data points of the curve from the anhysteretic magnetization of the Jiles-Atherton model.
+	 * 			The hysteresis parameters (k and c) have no effect on the anhysteretic curve.
+	 * @param parameters The Jiles-Atherton parameters of the material. Only the X parameters are used
+	 * @param numberPoints The number of data points to generate
+	 * @return Returns true if a curve could be created. Returns false if the saturation magnetization
+	 * 			or the domain wall density are not positive
+	 */
+	bool createFromJilesAtherton(jilesAthertonParameters parameters, unsigned int numberPoints = 100);
+
+	/**
+	 * @brief Samples the spline into the lookup table. Needs to be called after the data points are set
+	 * @param tableSize The number of intervals of the table
+	 */
+	void buildLookupTable(unsigned int tableSize = 2048);
+
+	/**
+	 * @brief Checks if the curve has data points and a lookup table
+	 * @return Returns true if the curve can be evaluated
+	 */
+	bool isValid() const
+	{
+		return p_reluctivityTable.size() > 1;
+	}
+
+	/**
+	 * @brief Evaluates the reluctivity and its derivative for a batch of points.
+	 * 			This is the function that should be called from the assembly loops.
+	 * @param Bsquared Array of the square of the flux density in T^2
+	 * @param reluctivity Array that will store the reluctivity in m/H
+	 * @param derivative Array that will store the derivative of the reluctivity with respect to B^2. Can be null
+	 * @param count The number of points in the arrays
+	 */
+	void evaluateReluctivity(const double *Bsquared, double *reluctivity, double *derivative, unsigned int count) const;
+
+	/**
+	 * @brief Evaluates the reluctivity at one point
+	 * @param Bsquared The square of the flux density in T^2
+	 * @return Returns the reluctivity in m/H
+	 */
+	double getReluctivity(double Bsquared) const
+	{
+		double value;
+		evaluateReluctivity(&Bsquared, &value, nullptr, 1);
+		return value;
+	}
+};
+
+
+#endif
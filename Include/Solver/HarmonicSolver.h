@@ -0,0 +1,437 @@
+#ifndef HARMONIC_SOLVER_H_
+#define HARMONIC_SOLVER_H_
+
+#include <vector>
+#include <map>
+#include <memory>
+#include <complex>
+#include <cmath>
+
+#include <common/OmniFEMMessage.h>
+#include <common/MagneticMaterial.h>
+
+#include <Solver/BHCurve.h>
+#include <Solver/SparseMatrix.h>
+#include <Solver/IterativeSolver.h>
+#include <Solver/SolverMesh.h>
+#include <Solver/MatrixFreeOperator.h>
+
+
+//! Enum that is used to specify which linear solver is used for the complex system
+enum class complexSolverMode
+{
+	COCG,/*!< The conjugate orthogonal conjugate gradient method. This is the fastest option as the system is complex symmetric */
+	BICGSTAB,/*!< The stabilized bi-conjugate gradient method on the complex system */
+	BLOCK_REAL/*!< The complex system is stored as an equivalent real system of twice the size and solved with BiCGStab */
+};
+
+
+/**
+ * @class harmonicSolver
+ * @author Phillip
+ * @date 18/10/26
+ * @file HarmonicSolver.h
+ * @brief 	This class solves the planar time-harmonic (AC) magnetic problem for the complex amplitude of the
+ * 			out of plane component of the magnetic vector potential. The system is
+ * 			curl(nu * curl(A)) + j * omega * sigma * A = J which is complex symmetric. It is solved with the
+ * 			COCG method. If the COCG method breaks down, the solver falls back to BiCGStab and finally to an
+ * 			equivalent real system of twice the size with interleaved real and imaginary parts.
+ * 			Laminated materials and stranded windings are not meshed in detail. Instead, the material is
+ * 			homogenised: laminations that are in the plane of the problem are given a complex permeability
+ * 			that accounts for the eddy currents in the lamination thickness, laminations that are parallel to an
+ * 			axis are given an anisotropic permeability and stranded windings are given a complex reluctivity that
+ * 			accounts for the proximity effect losses in the strands. Nonlinear materials are solved with their
+ * 			linear permeability.
+ * 			In the matrix free mode, the system matrix is never assembled. The operator is applied element by element
+ * 			from geometric factors that are cached per element and the system is preconditioned with its diagonal.
+ * 			This is intended for second order meshes where the assembled matrix and its preconditioner would not fit into memory.
+ */
+class harmonicSolver
+{
+private:
+
+	/**
+	 * @brief Structure that holds the homogenised material data of a face of the mesh
+	 */
+	struct harmonicRegion
+	{
+		//! The reluctivity that multiplies the y-derivative of the potential (Hx = nuX * Bx)
+		std::complex<double> reluctivityX = 1.0 / MU_0;
+
+		//! The reluctivity that multiplies the x-derivative of the potential (Hy = nuY * By)
+		std::complex<double> reluctivityY = 1.0 / MU_0;
+
+		//! The conductivity in S/m that eddy currents in the out of plane direction see
+		double conductivity = 0;
+
+		//! The conductivity in S/m of the strands of a homogenised winding. Only used for the losses
+		double wireConductivity = 0;
+
+		//! The fill factor of a homogenised winding
+		double fillFactor = 1.0;
+
+		//! The source current density in A/m2
+		double currentDensity = 0;
+
+		//! The product of the angular frequency and the conductivity that eddy currents see
+		double eddyCoefficient = 0;
+
+		//! The first element of the region
+		unsigned int firstElement = 0;
+
+		//! One past the last element of the region
+		unsigned int lastElement = 0;
+	};
+
+	/**
+	 * @brief Structure that holds the geometric part of every element matrix
+	 */
+	struct elementIntegrals
+	{
+		//! The integral of the product of the x-derivatives of the shape functions for each entry of each element matrix
+		std::vector<double> stiffnessX;
+
+		//! The integral of the product of the y-derivatives of the shape functions for each entry of each element matrix
+		std::vector<double> stiffnessY;
+
+		//! The integral of the product of the shape functions for each entry of each element matrix
+		std::vector<double> mass;
+
+		//! The integral of each shape function of each element. Uses the node offsets of the mesh
+		std::vector<double> load;
+
+		//! The position of each entry of each element matrix in the system matrix. Set to -1 if the row or column is fixed
+		std::vector<int> position;
+
+		//! The position of the first entry of each element matrix. This vector has a size of the number of elements + 1
+		std::vector<int> matrixOffset;
+	};
+
+	//! The snapshot of the mesh
+	std::shared_ptr<const meshSnapshot> p_snapshot;
+
+	//! The materials assigned to each face. The key is the tag of the GFace
+	std::map<int, magneticMaterial> p_faceMaterials;
+
+	//! The fixed values of the vector potential along edges. The key is the tag of the GEdge
+	std::map<int, double> p_dirichletEdges;
+
+	//! The length of one model unit in meters
+	double p_lengthScale = 1.0;
+
+	//! The frequency of the problem in Hz
+	double p_frequency = 0;
+
+	//! The linear solver that is tried first
+	complexSolverMode p_solverMode = complexSolverMode::COCG;
+
+	//! The relative residual that the linear solver needs to reach
+	double p_tolerance = 1.0e-8;
+
+	//! The number of linear iterations that the last solve required
+	int p_iterationsPerformed = 0;
+
+	//! Boolean used to indicate if the preconditioner of the previous solve is reused as long as it remains effective
+	bool p_reusePreconditioner = false;
+
+	//! The number of iterations that the linear solver required with a freshly computed preconditioner
+	int p_baselineIterations = 0;
+
+	//! Boolean used to indicate if the matrix free mode is requested
+	bool p_isMatrixFree = false;
+
+	//! Boolean used to indicate if the system is solved through the matrix free operator. This is false if the mode
+	//! is requested but the mesh contains element types that the operator does not support
+	bool p_useOperator = false;
+
+	//! Boolean used to indicate if the solver displays any messages
+	bool p_isVerbose = true;
+
+	//! Boolean used to indicate if the mesh data structures have been created
+	bool p_isSetup = false;
+
+	//! The list of regions that the solver operates on
+	std::vector<harmonicRegion> p_regions;
+
+	//! The region data that is currently assembled into the system matrix and the right hand side
+	std::vector<harmonicRegion> p_assembledRegions;
+
+	//! The degree of freedom map and the geometric factors of the mesh. The mesh is never modified after it
+	//! is created which allows the solvers that copy the setup to share it
+	std::shared_ptr<solverMesh> p_mesh;
+
+	//! The element integrals. These do not change after the setup and are shared with the solvers that copy the setup
+	std::shared_ptr<elementIntegrals> p_integrals;
+
+	//! The complex system matrix
+	sparseMatrix<std::complex<double>> p_matrix;
+
+	//! The operator that replaces the system matrix in the matrix free mode
+	matrixFreeOperator<std::complex<double>> p_operator;
+
+	//! The preconditioner of the matrix free mode
+	jacobiPreconditioner<std::complex<double>> p_jacobiPreconditioner;
+
+	//! The preconditioner of the complex system
+	iluPreconditioner<std::complex<double>> p_preconditioner;
+
+	//! The equivalent real system. Only created if the complex solvers fail
+	sparseMatrix<double> p_blockMatrix;
+
+	//! The preconditioner of the equivalent real system
+	iluPreconditioner<double> p_blockPreconditioner;
+
+	//! The right hand side of the complex system
+	std::vector<std::complex<double>> p_rightHandSide;
+
+	//! The complex amplitude of the magnetic vector potential in Wb/m
+	std::vector<std::complex<double>> p_solution;
+
+	/**
+	 * @brief Computes the homogenised material data of every region for the current frequency
+	 */
+	void computeRegionProperties();
+
+	/**
+	 * @brief Integrates the geometric part of every element matrix and finds the position of each entry in the
+	 * 			system matrix. Afterwards, the assembly only multiplies the integrals with the material coefficients.
+	 * 			Needs to be called after the sparsity pattern is created
+	 */
+	void computeElementMatrices();
+
+	/**
+	 * @brief 	Assembles the complex system matrix and the right hand side. Only the regions whose coefficients
+	 * 			changed since the last assembly are updated. The difference between the new and the assembled
+	 * 			coefficients is added to the system
+	 */
+	void assemble();
+
+	/**
+	 * @brief Sets the coefficients of every region in the matrix free operator and computes the right hand side
+	 */
+	void updateOperator();
+
+	/**
+	 * @brief Runs the linear solvers in the order that is set by the solver mode on the matrix free operator
+	 * @param residual On exit, the relative residual that was reached
+	 * @return Returns the number of iterations performed. Returns -1 if the solvers did not converge
+	 */
+	int solveMatrixFree(double &residual);
+
+	/**
+	 * @brief Evaluates the solution at the integration points of an element
+	 * @param element The index of the element
+	 * @param weight Array that will store the integration weight multiplied by the determinant of the Jacobian
+	 * @param potential Array that will store the vector potential
+	 * @param dAdx Array that will store the x-derivative of the vector potential
+	 * @param dAdy Array that will store the y-derivative of the vector potential
+	 * @return Returns the number of integration points
+	 */
+	int evaluateElement(unsigned int element, double *weight, std::complex<double> *potential, std::complex<double> *dAdx, std::complex<double> *dAdy);
+
+	/**
+	 * @brief Runs the linear solvers in the order that is set by the solver mode
+	 * @param residual On exit, the relative residual that was reached
+	 * @return Returns the number of iterations performed. Returns -1 if the solvers did not converge
+	 */
+	int solveComplex(double &residual);
+
+	/**
+	 * @brief Copies the complex system matrix into the equivalent real system. The pattern of the
+	 * 			real system is created on the first call
+	 */
+	void createBlockMatrix();
+
+	/**
+	 * @brief Solves the system through the equivalent real system
+	 * @param residual On exit, the relative residual that was reached
+	 * @return Returns the number of iterations performed. Returns -1 if the solver did not converge
+	 */
+	int solveBlockReal(double &residual);
+
+public:
+
+	/**
+	 * @brief The constructor for the class
+	 * @param snapshot The snapshot of the mesh
+	 */
+	harmonicSolver(std::shared_ptr<const meshSnapshot> snapshot) : p_mesh(std::make_shared<solverMesh>(snapshot))
+	{
+		p_snapshot = snapshot;
+	}
+
+	/**
+	 * @brief 	Copies the problem definition, the mesh data and the assembled system of another solver. The mesh
+	 * 			data is shared and the degree of freedom map is not recreated. The preconditioner is not copied.
+	 * 			This is used by the parameter sweep to create independent solvers without repeating the setup
+	 * @param prototype The solver to copy the setup from
+	 */
+	void copySetup(const harmonicSolver &prototype);
+
+	/**
+	 * @brief Assigns a material to a face of the mesh. Faces without a material are not solved
+	 * @param faceTag The tag of the GFace
+	 * @param material The material of the face
+	 */
+	void setFaceMaterial(int faceTag, const magneticMaterial &material)
+	{
+		if(p_faceMaterials.find(faceTag) == p_faceMaterials.end())
+			p_isSetup = false;
+
+		p_faceMaterials[faceTag] = material;
+	}
+
+	/**
+	 * @brief Fixes the vector potential along an edge of the mesh
+	 * @param edgeTag The tag of the GEdge
+	 * @param value The value of the vector potential in Wb/m
+	 */
+	void setDirichletEdge(int edgeTag, double value)
+	{
+		p_dirichletEdges[edgeTag] = value;
+		p_isSetup = false;
+	}
+
+	/**
+	 * @brief Sets the length of one model unit
+	 * @param scale The length of one model unit in meters
+	 */
+	void setLengthScale(double scale)
+	{
+		p_lengthScale = scale;
+	}
+
+	/**
+	 * @brief Sets the frequency of the problem. Changing the frequency does not
+	 * 			require the degree of freedom map or the sparsity pattern to be recreated
+	 * @param frequency The frequency in Hz
+	 */
+	void setFrequency(double frequency)
+	{
+		p_frequency = frequency;
+	}
+
+	/**
+	 * @brief Sets the linear solver that is tried first
+	 * @param mode The linear solver
+	 */
+	void setSolverMode(complexSolverMode mode)
+	{
+		p_solverMode = mode;
+	}
+
+	/**
+	 * @brief Sets the relative residual that the linear solver needs to reach
+	 * @param tolerance The tolerance
+	 */
+	void setTolerance(double tolerance)
+	{
+		p_tolerance = tolerance;
+	}
+
+	/**
+	 * @brief 	Sets if the preconditioner of the previous solve is reused. The preconditioner is only recomputed once the
+	 * 			linear solver needs more then twice the iterations than it needed with a fresh preconditioner.
+	 * 			This is useful when the matrix changes slowly between solves, for example during a frequency sweep
+	 * @param state Set to true to reuse the preconditioner
+	 */
+	void setReusePreconditioner(bool state)
+	{
+		p_reusePreconditioner = state;
+	}
+
+	/**
+	 * @brief 	Sets if the system is solved without assembling the system matrix. The mode needs much less memory on second
+	 * 			order meshes but is only preconditioned with the diagonal of the system. The equivalent real system is
+	 * 			not available in this mode. Changing the mode recreates the setup on the next solve
+	 * @param state Set to true in order to use the matrix free mode
+	 */
+	void setMatrixFree(bool state)
+	{
+		if(state != p_isMatrixFree)
+			p_isSetup = false;
+
+		p_isMatrixFree = state;
+	}
+
+	/**
+	 * @brief Sets if the solver displays messages. Needs to be turned off when the solver is run
+	 * 			outside of the main thread. The caller is then responsible for reporting failed solves
+	 * @param state Set to false in order to suppress the messages
+	 */
+	void setVerbose(bool state)
+	{
+		p_isVerbose = state;
+	}
+
+	/**
+	 * @brief Sets up the solver without solving. Creates the degree of freedom map and the sparsity pattern if needed
+	 * @return Returns true if the mesh contains degrees of freedom
+	 */
+	bool setup();
+
+	/**
+	 * @brief Retrieves the degree of freedom map of the solver
+	 * @return Returns the mesh data of the solver
+	 */
+	const solverMesh &getMesh()
+	{
+		return *p_mesh;
+	}
+
+	/**
+	 * @brief Retrieves the number of linear iterations that were required by the last solve
+	 * @return Returns the number of iterations
+	 */
+	int getNumberIterations()
+	{
+		return p_iterationsPerformed;
+	}
+
+	/**
+	 * @brief 	Solves the problem. The current solution is used as the initial guess which
+	 * 			reduces the number of iterations when the frequency is changed in small steps
+	 * @return Returns true if the linear solver converged. Otherwise, returns false
+	 */
+	bool solve();
+
+	/**
+	 * @brief Retrieves the solution of the last solve
+	 * @return Returns the complex amplitude of the vector potential in Wb/m for every degree of freedom
+	 */
+	const std::vector<std::complex<double>> &getSolution()
+	{
+		return p_solution;
+	}
+
+	/**
+	 * @brief Sets the initial guess of the next solve. The vector needs to have one entry per degree of freedom
+	 * @param guess The complex amplitude of the vector potential in Wb/m
+	 */
+	void setInitialGuess(const std::vector<std::complex<double>> &guess)
+	{
+		p_solution = guess;
+	}
+
+	/**
+	 * @brief Retrieves the degree of freedom that a node of the mesh snapshot belongs to
+	 * @param node The position of the node in the snapshot
+	 * @return Returns the index of the degree of freedom in the solution. Returns -1 if the
+	 * 			node is not part of the solved regions
+	 */
+	int getNodeIndex(unsigned int node)
+	{
+		return p_mesh->getNodeIndex(node);
+	}
+
+	/**
+	 * @brief 	Computes the time averaged power that is dissipated in a face. This includes the ohmic losses of
+	 * 			the eddy and source currents and the losses of the homogenised laminations and windings
+	 * @param faceTag The tag of the GFace
+	 * @return Returns the losses in W per meter of depth
+	 */
+	double getLosses(int faceTag);
+};
+
+
+#endif
@@ -0,0 +1,468 @@
+#ifndef ITERATIVE_SOLVER_H_
+#define ITERATIVE_SOLVER_H_
+
+#include <vector>
+#include <complex>
+#include <cmath>
+
+#include <Solver/SparseMatrix.h>
+
+
+/**
+ * @brief Computes the unconjugated inner product of two vectors (x^T * y). For real vectors,
+ * 			this is the usual dot product.
+ * @param x The first vector
+ * @param y The second vector
+ * @return Returns the sum of x[i] * y[i]
+ */
+template<class scalar>
+scalar innerProduct(const std::vector<scalar> &x, const std::vector<scalar> &y)
+{
+	scalar sum = scalar();
+
+	for(unsigned int i = 0; i < x.size(); i++)
+		sum += x[i] * y[i];
+
+	return sum;
+}
+
+
+/**
+ * @brief Computes the conjugate of a real number. Unlike std::conj, the result stays a real number
+ * @param x The number
+ * @return Returns x
+ */
+inline double conjugate(double x)
+{
+	return x;
+}
+
+
+/**
+ * @brief Computes the conjugate of a complex number
+ * @param x The number
+ * @return Returns the complex conjugate of x
+ */
+inline std::complex<double> conjugate(const std::complex<double> &x)
+{
+	return std::conj(x);
+}
+
+
+/**
+ * @brief Computes the conjugated inner product of two vectors (x^H * y). For real vectors,
+ * 			this is the usual dot product.
+ * @param x The first vector. This vector is conjugated
+ * @param y The second vector
+ * @return Returns the sum of conj(x[i]) * y[i]
+ */
+template<class scalar>
+scalar conjugatedProduct(const std::vector<scalar> &x, const std::vector<scalar> &y)
+{
+	scalar sum = scalar();
+
+	for(unsigned int i = 0; i < x.size(); i++)
+		sum += conjugate(x[i]) * y[i];
+
+	return sum;
+}
+
+
+/**
+ * @brief Computes the euclidean norm of a vector. For complex vectors, the modulus of each entry is used
+ * @param x The vector to compute the norm of
+ * @return Returns the euclidean norm of the vector
+ */
+template<class scalar>
+double vectorNorm(const std::vector<scalar> &x)
+{
+	double sum = 0;
+
+	for(unsigned int i = 0; i < x.size(); i++)
+		sum += std::norm(x[i]);
+
+	return std::sqrt(sum);
+}
+
+
+/**
+ * @class iluPreconditioner
+ * @author Phillip
+ * @date 18/10/26
+ * @file IterativeSolver.h
+ * @brief 	Incomplete LU factorization with zero fill-in of a sparse matrix. The factors are stored
+ * 			on the sparsity pattern of the matrix that was factored. Once computed, the preconditioner
+ * 			can be applied to any number of right hand sides and can be reused for matrices that
+ * 			share the same pattern (for example, the Jacobian of a later Newton iteration).
+ */
+template<class scalar>
+class iluPreconditioner
+{
+private:
+
+	//! The combined L and U factors. The unit diagonal of L is not stored
+	std::vector<scalar> p_factors;
+
+	//! The row pointer of the factored matrix
+	const std::vector<int> *p_rowPointer = nullptr;
+
+	//! The column indices of the factored matrix
+	const std::vector<int> *p_columnIndex = nullptr;
+
+	//! The position of the diagonal for each row of the factored matrix
+	const std::vector<int> *p_diagonalPosition = nullptr;
+
+public:
+
+	/**
+	 * @brief Computes the factorization of the matrix
+	 * @param matrix The matrix to factor. The matrix must outlive the preconditioner as the
+	 * 				sparsity pattern is not copied
+	 */
+	void compute(const sparseMatrix<scalar> &matrix)
+	{
+		p_rowPointer = &matrix.getRowPointer();
+		p_columnIndex = &matrix.getColumnIndex();
+		p_diagonalPosition = &matrix.getDiagonalPosition();
+		p_factors = matrix.getValues();
+
+		const std::vector<int> &rowPointer = *p_rowPointer;
+		const std::vector<int> &columnIndex = *p_columnIndex;
+		const std::vector<int> &diagonal = *p_diagonalPosition;
+
+		std::vector<int> position(matrix.getSize(), -1);
+
+		for(unsigned int i = 0; i < matrix.getSize(); i++)
+		{
+			for(int j = rowPointer[i]; j < rowPointer[i + 1]; j++)
+				position[columnIndex[j]] = j;
+
+			for(int j = rowPointer[i]; j < diagonal[i]; j++)
+			{
+				int k = columnIndex[j];
+
+				p_factors[j] /= p_factors[diagonal[k]];
+
+				for(int m = diagonal[k] + 1; m < rowPointer[k + 1]; m++)
+				{
+					if(position[columnIndex[m]] >= 0)
+						p_factors[position[columnIndex[m]]] -= p_factors[j] * p_factors[m];
+				}
+			}
+
+			if(p_factors[diagonal[i]] == scalar())
+				p_factors[diagonal[i]] = scalar(1);
+
+			for(int j = rowPointer[i]; j < rowPointer[i + 1]; j++)
+				position[columnIndex[j]] = -1;
+		}
+	}
+
+	/**
+	 * @brief Checks if the preconditioner has been computed
+	 * @return Returns true if compute was called. Otherwise, returns false
+	 */
+	bool isComputed() const
+	{
+		return p_rowPointer != nullptr;
+	}
+
+	/**
+	 * @brief Applies the preconditioner by solving L * U * z = r
+	 * @param r The vector to apply the preconditioner to
+	 * @param z The vector that will store the result
+	 */
+	void apply(const std::vector<scalar> &r, std::vector<scalar> &z) const
+	{
+		const std::vector<int> &rowPointer = *p_rowPointer;
+		const std::vector<int> &columnIndex = *p_columnIndex;
+		const std::vector<int> &diagonal = *p_diagonalPosition;
+		const int size = (int)r.size();
+
+		z.resize(size);
+
+		for(int i = 0; i < size; i++)
+		{
+			scalar sum = r[i];
+
+			for(int j = rowPointer[i]; j < diagonal[i]; j++)
+				sum -= p_factors[j] * z[columnIndex[j]];
+
+			z[i] = sum;
+		}
+
+		for(int i = size - 1; i >= 0; i--)
+		{
+			scalar sum = z[i];
+
+			for(int j = diagonal[i] + 1; j < rowPointer[i + 1]; j++)
+				sum -= p_factors[j] * z[columnIndex[j]];
+
+			z[i] = sum / p_factors[diagonal[i]];
+		}
+	}
+};
+
+
+/**
+ * @class jacobiPreconditioner
+ * @author Phillip
+ * @date 18/10/26
+ * @file IterativeSolver.h
+ * @brief 	Diagonal (Jacobi) preconditioner. Only the diagonal of the system is needed which makes this the
+ * 			preconditioner of choice when the system matrix is never assembled.
+ */
+template<class scalar>
+class jacobiPreconditioner
+{
+private:
+
+	//! The inverse of each diagonal entry
+	std::vector<scalar> p_inverseDiagonal;
+
+public:
+
+	/**
+	 * @brief Computes the preconditioner from the diagonal of the system
+	 * @param diagonal The diagonal entries of the system. Zero entries are treated as one
+	 */
+	void compute(const std::vector<scalar> &diagonal)
+	{
+		p_inverseDiagonal.resize(diagonal.size());
+
+		for(unsigned int i = 0; i < diagonal.size(); i++)
+			p_inverseDiagonal[i] = (diagonal[i] == scalar()) ? scalar(1) : scalar(1) / diagonal[i];
+	}
+
+	/**
+	 * @brief Checks if the preconditioner has been computed
+	 * @return Returns true if compute was called. Otherwise, returns false
+	 */
+	bool isComputed() const
+	{
+		return p_inverseDiagonal.size() > 0;
+	}
+
+	/**
+	 * @brief Applies the preconditioner by scaling each entry with the inverse of the diagonal
+	 * @param r The vector to apply the preconditioner to
+	 * @param z The vector that will store the result
+	 */
+	void apply(const std::vector<scalar> &r, std::vector<scalar> &z) const
+	{
+		z.resize(r.size());
+
+		for(unsigned int i = 0; i < r.size(); i++)
+			z[i] = p_inverseDiagonal[i] * r[i];
+	}
+};
+
+
+/**
+ * @brief 	Solves the system A * x = b with the preconditioned conjugate gradient method. The inner products
+ * 			are unconjugated which means that for complex symmetric matrices, this function performs
+ * 			the conjugate orthogonal conjugate gradient (COCG) method. The system is only accessed through
+ * 			multiply(x, y) which allows a matrix free operator to be used in place of an assembled matrix.
+ * @param matrix The system matrix or operator. The system must be symmetric
+ * @param b The right hand side
+ * @param x On entry, the initial guess. On exit, the solution
+ * @param preconditioner The preconditioner to use. If null, no preconditioning is performed
+ * @param tolerance The relative residual that the solver needs to reach
+ * @param maxIterations The maximum number of iterations
+ * @param residual On exit, the relative residual that was reached
+ * @return Returns the number of iterations performed. Returns -1 if the solver did not converge
+ */
+template<class scalar, class matrixType, class preconditionerType>
+int conjugateGradient(const matrixType &matrix, const std::vector<scalar> &b, std::vector<scalar> &x,
+						const preconditionerType *preconditioner, double tolerance, int maxIterations, double &residual)
+{
+	const unsigned int size = b.size();
+	std::vector<scalar> r(size), z(size), p(size), q(size);
+
+	x.resize(size, scalar());
+
+	double bNorm = vectorNorm(b);
+
+	if(bNorm == 0)
+	{
+		std::fill(x.begin(), x.end(), scalar());
+		residual = 0;
+		return 0;
+	}
+
+	matrix.multiply(x, q);
+
+	for(unsigned int i = 0; i < size; i++)
+		r[i] = b[i] - q[i];
+
+	residual = vectorNorm(r) / bNorm;
+
+	if(residual < tolerance)
+		return 0;
+
+	if(preconditioner)
+		preconditioner->apply(r, z);
+	else
+		z = r;
+
+	p = z;
+
+	scalar rho = innerProduct(r, z);
+
+	for(int iteration = 1; iteration <= maxIterations; iteration++)
+	{
+		matrix.multiply(p, q);
+
+		scalar pq = innerProduct(p, q);
+
+		if(pq == scalar())
+			return -1;
+
+		scalar alpha = rho / pq;
+
+		for(unsigned int i = 0; i < size; i++)
+		{
+			x[i] += alpha * p[i];
+			r[i] -= alpha * q[i];
+		}
+
+		residual = vectorNorm(r) / bNorm;
+
+		if(residual < tolerance)
+			return iteration;
+
+		if(preconditioner)
+			preconditioner->apply(r, z);
+		else
+			z = r;
+
+		scalar rhoNew = innerProduct(r, z);
+		scalar beta = rhoNew / rho;
+		rho = rhoNew;
+
+		for(unsigned int i = 0; i < size; i++)
+			p[i] = z[i] + beta * p[i];
+	}
+
+	return -1;
+}
+
+
+/**
+ * @brief 	Solves the system A * x = b with the preconditioned stabilized bi-conjugate gradient (BiCGStab) method.
+ * 			Unlike the conjugate gradient method, the matrix does not need to be symmetric. Each iteration
+ * 			requires two matrix vector products. As with the conjugate gradient method, the system can be a matrix free operator.
+ * @param matrix The system matrix or operator
+ * @param b The right hand side
+ * @param x On entry, the initial guess. On exit, the solution
+ * @param preconditioner The preconditioner to use. If null, no preconditioning is performed
+ * @param tolerance The relative residual that the solver needs to reach
+ * @param maxIterations The maximum number of iterations
+ * @param residual On exit, the relative residual that was reached
+ * @return Returns the number of iterations performed. Returns -1 if the solver did not converge or broke down
+ */
+template<class scalar, class matrixType, class preconditionerType>
+int biConjugateGradientStabilized(const matrixType &matrix, const std::vector<scalar> &b, std::vector<scalar> &x,
+									const preconditionerType *preconditioner, double tolerance, int maxIterations, double &residual)
+{
+	const unsigned int size = b.size();
+	std::vector<scalar> r(size), shadow(size), p(size), v(size), s(size), t(size), z(size);
+
+	x.resize(size, scalar());
+
+	double bNorm = vectorNorm(b);
+
+	if(bNorm == 0)
+	{
+		std::fill(x.begin(), x.end(), scalar());
+		residual = 0;
+		return 0;
+	}
+
+	matrix.multiply(x, v);
+
+	for(unsigned int i = 0; i < size; i++)
+		r[i] = b[i] - v[i];
+
+	residual = vectorNorm(r) / bNorm;
+
+	if(residual < tolerance)
+		return 0;
+
+	shadow = r;
+	std::fill(p.begin(), p.end(), scalar());
+	std::fill(v.begin(), v.end(), scalar());
+
+	scalar rho = scalar(1);
+	scalar alpha = scalar(1);
+	scalar omega = scalar(1);
+
+	for(int iteration = 1; iteration <= maxIterations; iteration++)
+	{
+		scalar rhoNew = conjugatedProduct(shadow, r);
+
+		if(rhoNew == scalar() || omega == scalar())
+			return -1;
+
+		scalar beta = (rhoNew / rho) * (alpha / omega);
+		rho = rhoNew;
+
+		for(unsigned int i = 0; i < size; i++)
+			p[i] = r[i] + beta * (p[i] - omega * v[i]);
+
+		if(preconditioner)
+			preconditioner->apply(p, z);
+		else
+			z = p;
+
+		matrix.multiply(z, v);
+
+		scalar shadowV = conjugatedProduct(shadow, v);
+
+		if(shadowV == scalar())
+			return -1;
+
+		alpha = rho / shadowV;
+
+		for(unsigned int i = 0; i < size; i++)
+		{
+			x[i] += alpha * z[i];
+			s[i] = r[i] - alpha * v[i];
+		}
+
+		residual = vectorNorm(s) / bNorm;
+
+		if(residual < tolerance)
+			return iteration;
+
+		if(preconditioner)
+			preconditioner->apply(s, z);
+		else
+			z = s;
+
+		matrix.multiply(z, t);
+
+		double tNorm = vectorNorm(t);
+
+		if(tNorm == 0)
+			return -1;
+
+		omega = conjugatedProduct(t, s) / (tNorm * tNorm);
+
+		for(unsigned int i = 0; i < size; i++)
+		{
+			x[i] += omega * z[i];
+			r[i] = s[i] - omega * t[i];
+		}
+
+		residual = vectorNorm(r) / bNorm;
+
+		if(residual < tolerance)
+			return iteration;
+	}
+
+	return -1;
+}
+
+
+#endif
@@ -0,0 +1,262 @@
+#ifndef MAGNETOSTATIC_SOLVER_H_
+#define MAGNETOSTATIC_SOLVER_H_
+
+#include <vector>
+#include <map>
+#include <utility>
+#include <cmath>
+#include <memory>
+
+#include <common/OmniFEMMessage.h>
+#include <common/MagneticMaterial.h>
+
+#include <Solver/BHCurve.h>
+#include <Solver/SparseMatrix.h>
+#include <Solver/IterativeSolver.h>
+#include <Solver/SolverMesh.h>
+
+
+//! Enum that is used to specify how the Jacobian of the Newton iterations is preconditioned
+enum class newtonMode
+{
+	FULL_NEWTON,/*!< The preconditioner is recomputed from the Jacobian at every iteration */
+	MODIFIED_NEWTON/*!< The preconditioner of the first iteration is reused until the linear solver slows down */
+};
+
+
+/**
+ * @class magnetostaticSolver
+ * @author Phillip
+ * @date 18/10/26
+ * @file MagnetostaticSolver.h
+ * @brief 	This class solves the planar magnetostatic problem for the out of plane component of the
+ * 			magnetic vector potential on a mesh created by GMSH. Materials with a nonlinear B-H curve
+ * 			are solved with a Newton-Raphson iteration. The sparsity pattern, the degree of freedom map and
+ * 			the geometric factors of the elements (integration weights and shape function gradients)
+ * 			are computed once by the solverMesh on the first solve. Every iteration then computes the flux density at all integration points,
+ * 			evaluates the reluctivity for all of the integration points of a region in one batch from the lookup
+ * 			table of the B-H curve and re-assembles the values of the Jacobian. Each step is damped with an
+ * 			adaptive relaxation factor that is halved when the residual increases and grown back otherwise.
+ */
+class magnetostaticSolver
+{
+private:
+
+	/**
+	 * @brief Structure that holds the material data of a face of the mesh
+	 */
+	struct solverRegion
+	{
+		//! The reluctivity that multiplies the y-derivative of the potential (Hx = nuX * Bx)
+		double reluctivityX = 1.0 / MU_0;
+
+		//! The reluctivity that multiplies the x-derivative of the potential (Hy = nuY * By)
+		double reluctivityY = 1.0 / MU_0;
+
+		//! The source current density in A/m2
+		double currentDensity = 0;
+
+		//! Boolean used to indicate if the reluctivity depends on the flux density
+		bool isNonlinear = false;
+
+		//! The B-H curve of the region. Only used if the region is nonlinear
+		bhCurve curve;
+
+		//! The first element of the region
+		unsigned int firstElement = 0;
+
+		//! One past the last element of the region
+		unsigned int lastElement = 0;
+	};
+
+	//! The snapshot of the mesh
+	std::shared_ptr<const meshSnapshot> p_snapshot;
+
+	//! The materials assigned to each face. The key is the tag of the GFace
+	std::map<int, magneticMaterial> p_faceMaterials;
+
+	//! The fixed values of the vector potential along edges. The key is the tag of the GEdge
+	std::map<int, double> p_dirichletEdges;
+
+	//! The length of one model unit in meters
+	double p_lengthScale = 1.0;
+
+	//! The way the preconditioner is treated during the Newton iterations
+	newtonMode p_newtonMode = newtonMode::MODIFIED_NEWTON;
+
+	//! The relative residual that the nonlinear iterations need to reach
+	double p_tolerance = 1.0e-6;
+
+	//! The maximum number of nonlinear iterations
+	unsigned int p_maxIterations = 50;
+
+	//! The number of nonlinear iterations that the last solve required
+	unsigned int p_iterationsPerformed = 0;
+
+	//! Boolean used to indicate if the mesh data structures have been created
+	bool p_isSetup = false;
+
+	//! The list of regions that the solver operates on
+	std::vector<solverRegion> p_regions;
+
+	//! The degree of freedom map and the geometric factors of the mesh
+	solverMesh p_mesh;
+
+	//! The square of the flux density at each integration point in T^2
+	std::vector<double> p_Bsquared;
+
+	//! The reluctivity that multiplies the y-derivative of the potential at each integration point
+	std::vector<double> p_reluctivityX;
+
+	//! The reluctivity that multiplies the x-derivative of the potential at each integration point
+	std::vector<double> p_reluctivityY;
+
+	//! The derivative of the reluctivity with respect to B^2 at each integration point
+	std::vector<double> p_reluctivityDerivative;
+
+	//! The right hand side contributed by the source current densities
+	std::vector<double> p_source;
+
+	//! The residual of the last assembly
+	std::vector<double> p_residual;
+
+	//! The magnetic vector potential in Wb/m
+	std::vector<double> p_solution;
+
+	//! The Jacobian of the residual. For linear problems, this is the stiffness matrix
+	sparseMatrix<double> p_jacobian;
+
+	//! The preconditioner of the linear solver
+	iluPreconditioner<double> p_preconditioner;
+
+	/**
+	 * @brief Creates the regions from the faces that have a material assigned
+	 */
+	void createRegions();
+
+	/**
+	 * @brief Computes the right hand side that is contributed by the source current densities
+	 */
+	void computeSource();
+
+	/**
+	 * @brief Computes the square of the flux density at all of the integration points and updates the reluctivities
+	 * @param potential The vector potential to compute the flux density from
+	 */
+	void updateReluctivity(const std::vector<double> &potential);
+
+	/**
+	 * @brief Assembles the residual (and optionally the Jacobian) for a given vector potential
+	 * @param potential The vector potential to assemble at
+	 * @param assembleJacobian Set to true in order to assemble the Jacobian as well
+	 * @return Returns the norm of the residual
+	 */
+	double assemble(const std::vector<double> &potential, bool assembleJacobian);
+
+public:
+
+	/**
+	 * @brief The constructor for the class
+	 * @param snapshot The snapshot of the mesh
+	 */
+	magnetostaticSolver(std::shared_ptr<const meshSnapshot> snapshot) : p_mesh(snapshot)
+	{
+		p_snapshot = snapshot;
+	}
+
+	/**
+	 * @brief Assigns a material to a face of the mesh. Faces without a material are not solved
+	 * @param faceTag The tag of the GFace
+	 * @param material The material of the face
+	 */
+	void setFaceMaterial(int faceTag, magneticMaterial material)
+	{
+		p_faceMaterials[faceTag] = material;
+		p_isSetup = false;
+	}
+
+	/**
+	 * @brief Fixes the vector potential along an edge of the mesh
+	 * @param edgeTag The tag of the GEdge
+	 * @param value The value of the vector potential in Wb/m
+	 */
+	void setDirichletEdge(int edgeTag, double value)
+	{
+		p_dirichletEdges[edgeTag] = value;
+		p_isSetup = false;
+	}
+
+	/**
+	 * @brief Sets the length of one model unit
+	 * @param scale The length of one model unit in meters
+	 */
+	void setLengthScale(double scale)
+	{
+		p_lengthScale = scale;
+	}
+
+	/**
+	 * @brief Sets how the preconditioner is treated during the Newton iterations
+	 * @param mode The Newton mode
+	 */
+	void setNewtonMode(newtonMode mode)
+	{
+		p_newtonMode = mode;
+	}
+
+	/**
+	 * @brief Sets the relative residual that the nonlinear iterations need to reach
+	 * @param tolerance The tolerance
+	 */
+	void setTolerance(double tolerance)
+	{
+		p_tolerance = tolerance;
+	}
+
+	/**
+	 * @brief Sets the maximum number of nonlinear iterations
+	 * @param iterations The maximum number of iterations
+	 */
+	void setMaxIterations(unsigned int iterations)
+	{
+		p_maxIterations = iterations;
+	}
+
+	/**
+	 * @brief Retrieves the number of nonlinear iterations that were required by the last solve
+	 * @return Returns the number of iterations
+	 */
+	unsigned int getNumberIterations()
+	{
+		return p_iterationsPerformed;
+	}
+
+	/**
+	 * @brief Solves the problem
+	 * @return Returns true if the iterations converged. Otherwise, returns false
+	 */
+	bool solve();
+
+	/**
+	 * @brief Retrieves the solution of the last solve
+	 * @return Returns the vector potential in Wb/m for every degree of freedom
+	 */
+	const std::vector<double> &getSolution()
+	{
+		return p_solution;
+	}
+
+	/**
+	 * @brief Retrieves the degree of freedom that a node of the mesh snapshot belongs to
+	 * @param node The position of the node in the snapshot
+	 * @return Returns the index of the degree of freedom in the solution. Returns -1 if the
+	 * 			node is not part of the solved regions
+	 */
+	int getNodeIndex(unsigned int node)
+	{
+		return p_mesh.getNodeIndex(node);
+	}
+};
+
+
+#endif
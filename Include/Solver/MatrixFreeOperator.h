@@ -0,0 +1,508 @@
+#ifndef MATRIX_FREE_OPERATOR_H_
+#define MATRIX_FREE_OPERATOR_H_
+
+#include <vector>
+#include <map>
+#include <memory>
+#include <algorithm>
+
+#include <Solver/SolverMesh.h>
+#include <Solver/ReferenceElement.h>
+
+
+/**
+ * @class matrixFreeOperator
+ * @author Phillip
+ * @date 18/10/26
+ * @file MatrixFreeOperator.h
+ * @brief 	This class applies the operator of the scalar potential problem div(cX * d/dx, cY * d/dy) + cMass without
+ * 			ever assembling the system matrix. The elements are grouped in batches of ELEMENT_BATCH_SIZE elements of the
+ * 			same type and material region. For every batch, only the geometric factors of each integration point are
+ * 			cached (the integration weight and the inverse of the Jacobian). The shape functions come from the tables of the
+ * 			reference element. Each product with the operator evaluates the element contributions on the fly with the
+ * 			loops over the elements of a batch as the inner unit stride loops. The element results are stored per element
+ * 			node and summed per degree of freedom afterwards so that the elements can be processed in parallel without
+ * 			any write conflicts. For second order elements, this needs several times less memory then the assembled
+ * 			matrix with its preconditioner. The rows and columns of the fixed degrees of freedom are treated in the same
+ * 			way as the assembled system: the fixed rows are the identity and the fixed columns are moved to the right hand side.
+ */
+template<class scalar>
+class matrixFreeOperator
+{
+private:
+
+	/**
+	 * @brief Structure that holds a batch of elements of the same type and region
+	 */
+	struct elementBatch
+	{
+		//! The tables of the reference element
+		const referenceElement *table = nullptr;
+
+		//! The index of the region that the elements belong to
+		unsigned int region = 0;
+
+		//! The number of elements in the batch
+		int count = 0;
+
+		//! The indices of the elements. Unused slots repeat the first element
+		unsigned int elements[ELEMENT_BATCH_SIZE];
+
+		//! The position of the first geometric factor of the batch
+		unsigned int factorOffset = 0;
+	};
+
+	/**
+	 * @brief Structure that holds the data that does not change after the operator is created
+	 */
+	struct operatorGeometry
+	{
+		//! The list of element batches
+		std::vector<elementBatch> batches;
+
+		//! The geometric factors of every batch. See solverMesh::computeBatchFactors for the layout
+		std::vector<double> factors;
+
+		//! The batch and the slot of every element. The value is batch * ELEMENT_BATCH_SIZE + slot
+		std::vector<unsigned int> elementLocation;
+
+		//! The position of the first element node of each degree of freedom in nodeEntries
+		std::vector<int> nodeEntryOffset;
+
+		//! The positions in the element node list that refer to each degree of freedom
+		std::vector<int> nodeEntries;
+	};
+
+	//! The mesh that the operator works on
+	std::shared_ptr<const solverMesh> p_mesh;
+
+	//! The batches and the geometric factors. These are shared between the copies of the operator
+	std::shared_ptr<const operatorGeometry> p_geometry;
+
+	//! The coefficient of the product of the x-derivatives of each region
+	std::vector<scalar> p_coefficientX;
+
+	//! The coefficient of the product of the y-derivatives of each region
+	std::vector<scalar> p_coefficientY;
+
+	//! The coefficient of the product of the shape functions of each region
+	std::vector<scalar> p_coefficientMass;
+
+	//! The source of each region. The source is integrated against each shape function for the right hand side
+	std::vector<scalar> p_source;
+
+	//! The result of each element for each element node. Uses the node offsets of the mesh
+	mutable std::vector<scalar> p_elementOutput;
+
+	/**
+	 * @brief 	Evaluates the element contributions of all of the batches into p_elementOutput. The result of each
+	 * 			element is the product of the element matrix with the element values of x, minus the integral of the
+	 * 			source if requested
+	 * @param x The values of every degree of freedom
+	 * @param excludeFixed Set to true in order to treat the values of the fixed degrees of freedom as zero
+	 * @param subtractSource Set to true in order to subtract the integral of the source
+	 */
+	void evaluateElements(const std::vector<scalar> &x, bool excludeFixed, bool subtractSource) const
+	{
+		const std::vector<int> &nodeOffset = p_mesh->getElementNodeOffset();
+		const std::vector<int> &elementNodes = p_mesh->getElementNodes();
+		const std::vector<char> &isFixed = p_mesh->getIsFixed();
+		const std::vector<elementBatch> &batches = p_geometry->batches;
+
+#if defined(_OPENMP)
+		#pragma omp parallel for schedule(static)
+#endif
+		for(int i = 0; i < (int)batches.size(); i++)
+		{
+			const elementBatch &batch = batches[i];
+			const referenceElement *table = batch.table;
+			const int numberShapeFunctions = table->getNumberShapeFunctions();
+			const scalar coefficientX = p_coefficientX[batch.region];
+			const scalar coefficientY = p_coefficientY[batch.region];
+			const scalar coefficientMass = p_coefficientMass[batch.region];
+			const scalar source = subtractSource ? p_source[batch.region] : scalar();
+			scalar values[MAX_BATCH_NODES * ELEMENT_BATCH_SIZE];
+			scalar results[MAX_BATCH_NODES * ELEMENT_BATCH_SIZE];
+			scalar derivativeU[ELEMENT_BATCH_SIZE], derivativeV[ELEMENT_BATCH_SIZE], potential[ELEMENT_BATCH_SIZE];
+
+			for(int b = 0; b < ELEMENT_BATCH_SIZE; b++)
+			{
+				const int firstNode = nodeOffset[batch.elements[b]];
+
+				for(int k = 0; k < numberShapeFunctions; k++)
+				{
+					const int node = elementNodes[firstNode + k];
+
+					values[k * ELEMENT_BATCH_SIZE + b] = (excludeFixed && isFixed[node]) ? scalar() : x[node];
+					results[k * ELEMENT_BATCH_SIZE + b] = scalar();
+				}
+			}
+
+			for(int q = 0; q < table->getNumberPoints(); q++)
+			{
+				const double *gradientU = table->getGradientU(q);
+				const double *gradientV = table->getGradientV(q);
+				const double *shapeValue = table->getShapeValue(q);
+				const double *weight = &p_geometry->factors[batch.factorOffset + q * GEOMETRIC_FACTOR_COUNT * ELEMENT_BATCH_SIZE];
+				const double *inverse00 = weight + ELEMENT_BATCH_SIZE;
+				const double *inverse01 = weight + 2 * ELEMENT_BATCH_SIZE;
+				const double *inverse10 = weight + 3 * ELEMENT_BATCH_SIZE;
+				const double *inverse11 = weight + 4 * ELEMENT_BATCH_SIZE;
+
+				for(int b = 0; b < ELEMENT_BATCH_SIZE; b++)
+				{
+					derivativeU[b] = scalar();
+					derivativeV[b] = scalar();
+					potential[b] = scalar();
+				}
+
+				// Derivatives on the reference element
+				for(int k = 0; k < numberShapeFunctions; k++)
+				{
+					const scalar *nodeValues = &values[k * ELEMENT_BATCH_SIZE];
+
+					for(int b = 0; b < ELEMENT_BATCH_SIZE; b++)
+					{
+						derivativeU[b] += gradientU[k] * nodeValues[b];
+						derivativeV[b] += gradientV[k] * nodeValues[b];
+						potential[b] += shapeValue[k] * nodeValues[b];
+					}
+				}
+
+				// The flux is mapped to the element and back with the inverse of the Jacobian
+				for(int b = 0; b < ELEMENT_BATCH_SIZE; b++)
+				{
+					const scalar fluxX = weight[b] * coefficientX * (inverse00[b] * derivativeU[b] + inverse01[b] * derivativeV[b]);
+					const scalar fluxY = weight[b] * coefficientY * (inverse10[b] * derivativeU[b] + inverse11[b] * derivativeV[b]);
+
+					derivativeU[b] = inverse00[b] * fluxX + inverse10[b] * fluxY;
+					derivativeV[b] = inverse01[b] * fluxX + inverse11[b] * fluxY;
+					potential[b] = weight[b] * (coefficientMass * potential[b] - source);
+				}
+
+				for(int k = 0; k < numberShapeFunctions; k++)
+				{
+					scalar *nodeResults = &results[k * ELEMENT_BATCH_SIZE];
+
+					for(int b = 0; b < ELEMENT_BATCH_SIZE; b++)
+						nodeResults[b] += gradientU[k] * derivativeU[b] + gradientV[k] * derivativeV[b] + shapeValue[k] * potential[b];
+				}
+			}
+
+			for(int b = 0; b < batch.count; b++)
+			{
+				const int firstNode = nodeOffset[batch.elements[b]];
+
+				for(int k = 0; k < numberShapeFunctions; k++)
+					p_elementOutput[firstNode + k] = results[k * ELEMENT_BATCH_SIZE + b];
+			}
+		}
+	}
+
+	/**
+	 * @brief Sums the element results of p_elementOutput for every degree of freedom
+	 * @param y The vector that will store the sums
+	 */
+	void sumElementOutput(std::vector<scalar> &y) const
+	{
+		const std::vector<int> &entryOffset = p_geometry->nodeEntryOffset;
+		const std::vector<int> &entries = p_geometry->nodeEntries;
+		const int size = (int)getSize();
+
+		y.resize(size);
+
+#if defined(_OPENMP)
+		#pragma omp parallel for schedule(static)
+#endif
+		for(int i = 0; i < size; i++)
+		{
+			scalar sum = scalar();
+
+			for(int j = entryOffset[i]; j < entryOffset[i + 1]; j++)
+				sum += p_elementOutput[entries[j]];
+
+			y[i] = sum;
+		}
+	}
+
+public:
+
+	/**
+	 * @brief 	Creates the element batches and computes the geometric factors. The degree of freedom map of the mesh
+	 * 			needs to be created beforehand. The geometric factors of the mesh itself are not needed
+	 * @param mesh The mesh. The boundary conditions of the mesh can be applied before or after the operator is created
+	 * @param exactMass Set to true if the product of two shape functions needs to be integrated exactly
+	 * @return Returns false if the mesh contains elements that are not supported by the reference element tables
+	 */
+	bool create(std::shared_ptr<const solverMesh> mesh, bool exactMass)
+	{
+		std::shared_ptr<operatorGeometry> geometry = std::make_shared<operatorGeometry>();
+		const std::vector<int> &nodeOffset = mesh->getElementNodeOffset();
+		const std::vector<int> &elementNodes = mesh->getElementNodes();
+
+		geometry->elementLocation.resize(mesh->getNumberElements());
+
+		// The elements of each region are sorted by type and cut into batches
+		for(unsigned int i = 0; i < mesh->getNumberFaces(); i++)
+		{
+			std::map<const referenceElement*, std::vector<unsigned int>> typeGroups;
+
+			for(unsigned int j = mesh->getFaceFirstElement(i); j < mesh->getFaceLastElement(i); j++)
+			{
+				const int elementType = mesh->getElementType(j);
+				const referenceElement *table = referenceElement::get(elementType, solverMesh::getIntegrationOrder(elementType, exactMass));
+
+				if(!table || table->getNumberShapeFunctions() > MAX_BATCH_NODES)
+					return false;
+
+				typeGroups[table].push_back(j);
+			}
+
+			for(auto groupIterator = typeGroups.begin(); groupIterator != typeGroups.end(); groupIterator++)
+			{
+				const std::vector<unsigned int> &group = groupIterator->second;
+
+				for(unsigned int j = 0; j < group.size(); j += ELEMENT_BATCH_SIZE)
+				{
+					elementBatch newBatch;
+
+					newBatch.table = groupIterator->first;
+					newBatch.region = i;
+					newBatch.count = std::min<int>(ELEMENT_BATCH_SIZE, group.size() - j);
+					newBatch.factorOffset = geometry->factors.size();
+
+					for(int b = 0; b < ELEMENT_BATCH_SIZE; b++)
+						newBatch.elements[b] = group[j + ((b < newBatch.count) ? b : 0)];
+
+					for(int b = 0; b < newBatch.count; b++)
+						geometry->elementLocation[newBatch.elements[b]] = geometry->batches.size() * ELEMENT_BATCH_SIZE + b;
+
+					geometry->factors.resize(geometry->factors.size() + newBatch.table->getNumberPoints() * GEOMETRIC_FACTOR_COUNT * ELEMENT_BATCH_SIZE);
+					geometry->batches.push_back(newBatch);
+				}
+			}
+		}
+
+#if defined(_OPENMP)
+		#pragma omp parallel for schedule(static)
+#endif
+		for(int i = 0; i < (int)geometry->batches.size(); i++)
+		{
+			const elementBatch &batch = geometry->batches[i];
+			mesh->computeBatchFactors(batch.table, batch.elements, batch.count, &geometry->factors[batch.factorOffset]);
+		}
+
+		// The transpose of the element node list. This lists the element results that are summed for each degree of freedom
+		geometry->nodeEntryOffset.assign(mesh->getNumberNodes() + 1, 0);
+		geometry->nodeEntries.resize(elementNodes.size());
+
+		for(unsigned int i = 0; i < elementNodes.size(); i++)
+			geometry->nodeEntryOffset[elementNodes[i] + 1]++;
+
+		for(unsigned int i = 0; i < mesh->getNumberNodes(); i++)
+			geometry->nodeEntryOffset[i + 1] += geometry->nodeEntryOffset[i];
+
+		std::vector<int> nextEntry(geometry->nodeEntryOffset.begin(), geometry->nodeEntryOffset.end() - 1);
+
+		for(unsigned int i = 0; i < elementNodes.size(); i++)
+			geometry->nodeEntries[nextEntry[elementNodes[i]]++] = i;
+
+		p_mesh = mesh;
+		p_geometry = geometry;
+		p_coefficientX.assign(mesh->getNumberFaces(), scalar());
+		p_coefficientY.assign(mesh->getNumberFaces(), scalar());
+		p_coefficientMass.assign(mesh->getNumberFaces(), scalar());
+		p_source.assign(mesh->getNumberFaces(), scalar());
+		p_elementOutput.assign(nodeOffset.back(), scalar());
+
+		return true;
+	}
+
+	/**
+	 * @brief Checks if the operator has been created
+	 * @return Returns true if create was successful
+	 */
+	bool isCreated() const
+	{
+		return p_geometry != nullptr;
+	}
+
+	/**
+	 * @brief Retrieves the number of degrees of freedom
+	 * @return Returns the number of rows of the operator
+	 */
+	unsigned int getSize() const
+	{
+		return p_mesh ? p_mesh->getNumberNodes() : 0;
+	}
+
+	/**
+	 * @brief Sets the coefficients of a region
+	 * @param region The index of the face in the mesh
+	 * @param coefficientX The coefficient of the product of the x-derivatives
+	 * @param coefficientY The coefficient of the product of the y-derivatives
+	 * @param coefficientMass The coefficient of the product of the shape functions
+	 * @param source The source that is integrated against the shape functions
+	 */
+	void setRegionCoefficients(unsigned int region, scalar coefficientX, scalar coefficientY, scalar coefficientMass, scalar source)
+	{
+		p_coefficientX[region] = coefficientX;
+		p_coefficientY[region] = coefficientY;
+		p_coefficientMass[region] = coefficientMass;
+		p_source[region] = source;
+	}
+
+	/**
+	 * @brief Computes the product y = A * x
+	 * @param x The vector to multiply
+	 * @param y The vector that will store the result
+	 */
+	void multiply(const std::vector<scalar> &x, std::vector<scalar> &y) const
+	{
+		const std::vector<char> &isFixed = p_mesh->getIsFixed();
+
+		evaluateElements(x, true, false);
+		sumElementOutput(y);
+
+		for(unsigned int i = 0; i < y.size(); i++)
+		{
+			if(isFixed[i])
+				y[i] = x[i];
+		}
+	}
+
+	/**
+	 * @brief 	Computes the right hand side. This is the integral of the source minus the columns of the fixed degrees
+	 * 			of freedom multiplied with their values. The rows of the fixed degrees of freedom are set to the fixed value
+	 * @param rightHandSide The vector that will store the right hand side
+	 */
+	void computeRightHandSide(std::vector<scalar> &rightHandSide) const
+	{
+		const std::vector<char> &isFixed = p_mesh->getIsFixed();
+		const std::vector<double> &fixedValue = p_mesh->getFixedValue();
+		std::vector<scalar> fixedPart(fixedValue.begin(), fixedValue.end());
+
+		evaluateElements(fixedPart, false, true);
+		sumElementOutput(rightHandSide);
+
+		for(unsigned int i = 0; i < rightHandSide.size(); i++)
+			rightHandSide[i] = isFixed[i] ? fixedPart[i] : -rightHandSide[i];
+	}
+
+	/**
+	 * @brief Computes the diagonal of the operator. This is used by the Jacobi preconditioner
+	 * @param diagonal The vector that will store the diagonal
+	 */
+	void computeDiagonal(std::vector<scalar> &diagonal) const
+	{
+		const std::vector<int> &nodeOffset = p_mesh->getElementNodeOffset();
+		const std::vector<char> &isFixed = p_mesh->getIsFixed();
+		const std::vector<elementBatch> &batches = p_geometry->batches;
+
+#if defined(_OPENMP)
+		#pragma omp parallel for schedule(static)
+#endif
+		for(int i = 0; i < (int)batches.size(); i++)
+		{
+			const elementBatch &batch = batches[i];
+			const referenceElement *table = batch.table;
+			const int numberShapeFunctions = table->getNumberShapeFunctions();
+
+			for(int b = 0; b < batch.count; b++)
+			{
+				scalar *result = &p_elementOutput[nodeOffset[batch.elements[b]]];
+
+				for(int k = 0; k < numberShapeFunctions; k++)
+					result[k] = scalar();
+
+				for(int q = 0; q < table->getNumberPoints(); q++)
+				{
+					const double *weight = &p_geometry->factors[batch.factorOffset + q * GEOMETRIC_FACTOR_COUNT * ELEMENT_BATCH_SIZE];
+					const double *gradientU = table->getGradientU(q);
+					const double *gradientV = table->getGradientV(q);
+					const double *shapeValue = table->getShapeValue(q);
+
+					for(int k = 0; k < numberShapeFunctions; k++)
+					{
+						const double gradientX = weight[ELEMENT_BATCH_SIZE + b] * gradientU[k] + weight[2 * ELEMENT_BATCH_SIZE + b] * gradientV[k];
+						const double gradientY = weight[3 * ELEMENT_BATCH_SIZE + b] * gradientU[k] + weight[4 * ELEMENT_BATCH_SIZE + b] * gradientV[k];
+
+						result[k] += weight[b] * (p_coefficientX[batch.region] * (gradientX * gradientX) + p_coefficientY[batch.region] * (gradientY * gradientY) +
+													p_coefficientMass[batch.region] * (shapeValue[k] * shapeValue[k]));
+					}
+				}
+			}
+		}
+
+		sumElementOutput(diagonal);
+
+		for(unsigned int i = 0; i < diagonal.size(); i++)
+		{
+			if(isFixed[i])
+				diagonal[i] = scalar(1);
+		}
+	}
+
+	/**
+	 * @brief Evaluates a solution at the integration points of an element
+	 * @param element The index of the element in the mesh
+	 * @param x The values of every degree of freedom
+	 * @param weight Array that will store the integration weight multiplied by the determinant of the Jacobian
+	 * @param value Array that will store the value of the solution
+	 * @param gradientX Array that will store the x-derivative of the solution
+	 * @param gradientY Array that will store the y-derivative of the solution
+	 * @return Returns the number of integration points
+	 */
+	int evaluatePoints(unsigned int element, const std::vector<scalar> &x, double *weight, scalar *value, scalar *gradientX, scalar *gradientY) const
+	{
+		const unsigned int location = p_geometry->elementLocation[element];
+		const elementBatch &batch = p_geometry->batches[location / ELEMENT_BATCH_SIZE];
+		const int slot = location % ELEMENT_BATCH_SIZE;
+		const int firstNode = p_mesh->getElementNodeOffset()[element];
+		const std::vector<int> &elementNodes = p_mesh->getElementNodes();
+
+		for(int q = 0; q < batch.table->getNumberPoints(); q++)
+		{
+			const double *factors = &p_geometry->factors[batch.factorOffset + q * GEOMETRIC_FACTOR_COUNT * ELEMENT_BATCH_SIZE];
+			const double *gradientU = batch.table->getGradientU(q);
+			const double *gradientV = batch.table->getGradientV(q);
+			const double *shapeValue = batch.table->getShapeValue(q);
+			scalar derivativeU = scalar();
+			scalar derivativeV = scalar();
+
+			value[q] = scalar();
+
+			for(int k = 0; k < batch.table->getNumberShapeFunctions(); k++)
+			{
+				const scalar nodeValue = x[elementNodes[firstNode + k]];
+
+				derivativeU += gradientU[k] * nodeValue;
+				derivativeV += gradientV[k] * nodeValue;
+				value[q] += shapeValue[k] * nodeValue;
+			}
+
+			weight[q] = factors[slot];
+			gradientX[q] = factors[ELEMENT_BATCH_SIZE + slot] * derivativeU + factors[2 * ELEMENT_BATCH_SIZE + slot] * derivativeV;
+			gradientY[q] = factors[3 * ELEMENT_BATCH_SIZE + slot] * derivativeU + factors[4 * ELEMENT_BATCH_SIZE + slot] * derivativeV;
+		}
+
+		return batch.table->getNumberPoints();
+	}
+
+	/**
+	 * @brief Computes the memory that is used by the operator
+	 * @return Returns the number of bytes
+	 */
+	size_t getMemoryUsage() const
+	{
+		if(!p_geometry)
+			return 0;
+
+		return p_geometry->batches.size() * sizeof(elementBatch) + p_geometry->factors.size() * sizeof(double) +
+				p_geometry->elementLocation.size() * sizeof(unsigned int) + (p_geometry->nodeEntryOffset.size() + p_geometry->nodeEntries.size()) * sizeof(int) +
+				p_elementOutput.size() * sizeof(scalar);
+	}
+};
+
+
+#endif
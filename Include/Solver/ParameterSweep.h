@@ -0,0 +1,192 @@
+#ifndef PARAMETER_SWEEP_H_
+#define PARAMETER_SWEEP_H_
+
+#include <vector>
+#include <map>
+#include <string>
+#include <fstream>
+#include <cstdio>
+
+#include <common/OmniFEMMessage.h>
+#include <common/MagneticMaterial.h>
+
+#include <Solver/HarmonicSolver.h>
+
+
+//! Enum that is used to specify which parameter of the problem is swept
+enum class sweepParameter
+{
+	FREQUENCY,/*!< The frequency of the problem in Hz */
+	CURRENT_DENSITY,/*!< The source current density of the sweep face in MA/m2 */
+	CONDUCTIVITY,/*!< The conductivity of the sweep face in MS/m */
+	RELATIVE_PERMEABILITY/*!< The relative permeability of the sweep face in both directions */
+};
+
+
+/**
+ * @class parameterSweep
+ * @author Phillip
+ * @date 18/10/26
+ * @file ParameterSweep.h
+ * @brief 	This class solves the same AC problem for a list of values of one parameter (the frequency, or the
+ * 			current density, conductivity or permeability of one face). The degree of freedom map, the sparsity pattern
+ * 			and the element integrals are created once by a prototype solver. Each worker thread copies the setup
+ * 			of the prototype and owns its own matrix values, preconditioner and solution. The memory use is therefore
+ * 			bounded by the number of threads and not by the number of sweep points. The sweep points are handed
+ * 			out to the workers in blocks of consecutive values. Within a block, each solve starts from the solution
+ * 			of the previous point and reuses the preconditioner as long as it remains effective. The result of each
+ * 			point is written to the output file as soon as the point is finished.
+ */
+class parameterSweep
+{
+private:
+
+	//! The snapshot of the mesh
+	std::shared_ptr<const meshSnapshot> p_snapshot;
+
+	//! The materials assigned to each face. The key is the tag of the GFace
+	std::map<int, magneticMaterial> p_faceMaterials;
+
+	//! The fixed values of the vector potential along edges. The key is the tag of the GEdge
+	std::map<int, double> p_dirichletEdges;
+
+	//! The length of one model unit in meters
+	double p_lengthScale = 1.0;
+
+	//! The frequency in Hz that is used if the frequency is not the sweep parameter
+	double p_frequency = 0;
+
+	//! The parameter that is swept
+	sweepParameter p_parameter = sweepParameter::FREQUENCY;
+
+	//! The tag of the face whose material parameter is swept. Not used for frequency sweeps
+	int p_sweepFace = -1;
+
+	//! The values of the swept parameter
+	std::vector<double> p_values;
+
+	//! The number of worker threads. If 0, the number of threads of OpenMP is used
+	int p_numberThreads = 0;
+
+	//! The number of consecutive sweep points that are solved by one worker before it takes the next block
+	unsigned int p_blockSize = 4;
+
+	//! Boolean used to indicate if the solution of every point is written to a separate file
+	bool p_writeSolutions = false;
+
+	/**
+	 * @brief Sets the value of the swept parameter in a solver
+	 * @param solver The solver to modify
+	 * @param value The value of the parameter
+	 */
+	void applyParameter(harmonicSolver &solver, double value);
+
+	/**
+	 * @brief Writes the vector potential of every degree of freedom of a sweep point into a file
+	 * @param solver The solver that solved the point
+	 * @param filePath The path of the file
+	 */
+	void writeSolution(harmonicSolver &solver, std::string filePath);
+
+public:
+
+	/**
+	 * @brief The constructor for the class
+	 * @param snapshot The snapshot of the mesh
+	 */
+	parameterSweep(std::shared_ptr<const meshSnapshot> snapshot)
+	{
+		p_snapshot = snapshot;
+	}
+
+	/**
+	 * @brief Assigns a material to a face of the mesh. Faces without a material are not solved
+	 * @param faceTag The tag of the GFace
+	 * @param material The material of the face
+	 */
+	void setFaceMaterial(int faceTag, magneticMaterial material)
+	{
+		p_faceMaterials[faceTag] = material;
+	}
+
+	/**
+	 * @brief Fixes the vector potential along an edge of the mesh
+	 * @param edgeTag The tag of the GEdge
+	 * @param value The value of the vector potential in Wb/m
+	 */
+	void setDirichletEdge(int edgeTag, double value)
+	{
+		p_dirichletEdges[edgeTag] = value;
+	}
+
+	/**
+	 * @brief Sets the length of one model unit
+	 * @param scale The length of one model unit in meters
+	 */
+	void setLengthScale(double scale)
+	{
+		p_lengthScale = scale;
+	}
+
+	/**
+	 * @brief Sets the frequency that is used if the frequency is not the swept parameter
+	 * @param frequency The frequency in Hz
+	 */
+	void setFrequency(double frequency)
+	{
+		p_frequency = frequency;
+	}
+
+	/**
+	 * @brief Sets the parameter that is swept and the values that it takes
+	 * @param parameter The parameter to sweep
+	 * @param values The list of values. The values should be ordered so that consecutive values are close to each other
+	 * @param faceTag The tag of the face whose material parameter is swept. Not used for frequency sweeps
+	 */
+	void setSweep(sweepParameter parameter, std::vector<double> values, int faceTag = -1)
+	{
+		p_parameter = parameter;
+		p_values = values;
+		p_sweepFace = faceTag;
+	}
+
+	/**
+	 * @brief Sets the number of worker threads. Each worker holds one copy of the system matrix
+	 * @param number The number of threads. If 0, the number of threads of OpenMP is used
+	 */
+	void setNumberThreads(int number)
+	{
+		p_numberThreads = number;
+	}
+
+	/**
+	 * @brief Sets the number of consecutive sweep points that a worker solves in a row
+	 * @param size The number of points
+	 */
+	void setBlockSize(unsigned int size)
+	{
+		p_blockSize = (size > 0) ? size : 1;
+	}
+
+	/**
+	 * @brief Sets if the solution of every point is written to a separate file
+	 * @param state Set to true in order to write the solutions
+	 */
+	void setWriteSolutions(bool state)
+	{
+		p_writeSolutions = state;
+	}
+
+	/**
+	 * @brief 	Runs the sweep. Every finished point appends one line to the output file that contains the index of the point,
+	 * 			the parameter value, if the solver converged, the number of iterations and the losses of every face in W/m.
+	 * 			The lines appear in the order that the points finish. If the solutions are written, the solution of
+	 * 			point i is written to the file outputPath_i.txt
+	 * @param outputPath The path of the output file
+	 * @return Returns true if all of the points converged. Otherwise, returns false
+	 */
+	bool run(std::string outputPath);
+};
+
+
+#endif
@@ -0,0 +1,127 @@
+#ifndef REFERENCE_ELEMENT_H_
+#define REFERENCE_ELEMENT_H_
+
+#include <vector>
+#include <map>
+#include <utility>
+
+#include <Mesh/GMSH/GmshDefines.h>
+#include <Mesh/GMSH/ElementType.h>
+#include <Mesh/GMSH/BasisFactory.h>
+#include <Mesh/GMSH/nodalBasis.h>
+#include <Mesh/GMSH/GaussIntegration.h>
+
+
+/**
+ * @class referenceElement
+ * @author Phillip
+ * @date 18/10/26
+ * @file ReferenceElement.h
+ * @brief 	This class holds the data of an element type on the reference element for one integration order: the
+ * 			quadrature points and weights and the values and the gradients of the shape functions at every quadrature point.
+ * 			The data is identical for every element of the same type. Instead of evaluating the shape functions through the
+ * 			virtual functions of MElement at every point of every element, the tables are created once per element type
+ * 			and integration order and shared by all elements. The tables are stored point major (the shape functions of
+ * 			one point are contiguous) so that the loops over the shape functions have unit stride.
+ * 			The supported element types are the triangles and the quadrangles of any order. The tables are created from the
+ * 			same nodal basis and the same quadrature rules that GMSH uses which guarantees the same node ordering as the mesh
+ * 			elements.
+ */
+class referenceElement
+{
+private:
+
+	//! The GMSH type of the element (MSH_TRI_3, MSH_QUA_4, ...)
+	int p_elementType = 0;
+
+	//! The number of shape functions of the element type
+	int p_numberShapeFunctions = 0;
+
+	//! The number of quadrature points
+	int p_numberPoints = 0;
+
+	//! The weight of each quadrature point on the reference element
+	std::vector<double> p_weight;
+
+	//! The value of every shape function at every quadrature point. The index is point * numberShapeFunctions + shapeFunction
+	std::vector<double> p_shapeValue;
+
+	//! The derivative with respect to u of every shape function at every quadrature point
+	std::vector<double> p_gradientU;
+
+	//! The derivative with respect to v of every shape function at every quadrature point
+	std::vector<double> p_gradientV;
+
+	/**
+	 * @brief Evaluates the tables for an element type and an integration order
+	 * @param elementType The GMSH type of the element
+	 * @param integrationOrder The polynomial order that the quadrature needs to integrate exactly
+	 */
+	referenceElement(int elementType, int integrationOrder);
+
+public:
+
+	/**
+	 * @brief Checks if tables can be created for an element type
+	 * @param elementType The GMSH type of the element
+	 * @return Returns true if the element type is supported
+	 */
+	static bool isSupported(int elementType)
+	{
+		const int parentType = ElementType::ParentTypeFromTag(elementType);
+
+		return (parentType == TYPE_TRI || parentType == TYPE_QUA);
+	}
+
+	/**
+	 * @brief 	Retrieves the tables of an element type. The tables are created on the first request and are kept
+	 * 			for the life time of the program. This function can be called from multiple threads
+	 * @param elementType The GMSH type of the element. Must be a supported type
+	 * @param integrationOrder The polynomial order that the quadrature needs to integrate exactly
+	 * @return Returns a pointer to the tables. Returns nullptr if the element type is not supported
+	 */
+	static const referenceElement *get(int elementType, int integrationOrder);
+
+	int getElementType() const
+	{
+		return p_elementType;
+	}
+
+	int getNumberShapeFunctions() const
+	{
+		return p_numberShapeFunctions;
+	}
+
+	int getNumberPoints() const
+	{
+		return p_numberPoints;
+	}
+
+	const double *getWeight() const
+	{
+		return p_weight.data();
+	}
+
+	/**
+	 * @brief Retrieves the values of the shape functions at a quadrature point
+	 * @param point The index of the quadrature point
+	 * @return Returns a pointer to the values of all of the shape functions
+	 */
+	const double *getShapeValue(int point) const
+	{
+		return &p_shapeValue[point * p_numberShapeFunctions];
+	}
+
+	const double *getGradientU(int point) const
+	{
+		return &p_gradientU[point * p_numberShapeFunctions];
+	}
+
+	const double *getGradientV(int point) const
+	{
+		return &p_gradientV[point * p_numberShapeFunctions];
+	}
+};
+
+
+#endif
@@ -0,0 +1,315 @@
+#ifndef SOLVER_MESH_H_
+#define SOLVER_MESH_H_
+
+#include <vector>
+#include <map>
+#include <utility>
+#include <cmath>
+#include <algorithm>
+
+#include <memory>
+
+#include <common/OmniFEMMessage.h>
+
+#include <Mesh/meshSnapshot.h>
+
+#include <Solver/ReferenceElement.h>
+
+
+//! The number of elements that the geometric factors are computed for at the same time
+const int ELEMENT_BATCH_SIZE = 8;
+
+//! The largest number of nodes of an element that is processed in batches
+const int MAX_BATCH_NODES = 9;
+
+//! The number of geometric factors that are stored for each integration point of a batch: the integration
+//! weight multiplied by the determinant of the Jacobian and the four entries of the inverse of the Jacobian
+const int GEOMETRIC_FACTOR_COUNT = 5;
+
+
+/**
+ * @class solverMesh
+ * @author Phillip
+ * @date 18/10/26
+ * @file SolverMesh.h
+ * @brief 	This class holds the data of the mesh that does not change between solves: the degree of freedom map,
+ * 			the connectivity of the elements and the geometric factors (integration weights, shape function values
+ * 			and shape function gradients) at every integration point. All of the data is stored in flat arrays.
+ * 			The elements of a face are stored contiguously so that a solver can loop over the elements of a material
+ * 			region without any look ups. The data is created from a snapshot of the mesh, so the solvers do not depend
+ * 			on the GMSH model. The geometric factors are in model units. The solvers are responsible for
+ * 			scaling the terms that depend on the length of the model unit.
+ */
+class solverMesh
+{
+private:
+
+	//! The snapshot of the mesh
+	std::shared_ptr<const meshSnapshot> p_snapshot;
+
+	//! The tags of the faces that are part of the mesh
+	std::vector<int> p_faceTags;
+
+	//! The position of the first element of each face. This vector has a size of the number of faces + 1
+	std::vector<unsigned int> p_faceElementOffset;
+
+	//! The position of each element in the snapshot in the order that the elements are stored
+	std::vector<unsigned int> p_elements;
+
+	//! The MSH type of each element
+	std::vector<int> p_elementType;
+
+	//! The x coordinate of each degree of freedom
+	std::vector<double> p_nodeX;
+
+	//! The y coordinate of each degree of freedom
+	std::vector<double> p_nodeY;
+
+	//! The degree of freedom of each node of the snapshot. Coincident nodes share a degree of freedom. Nodes
+	//! that are not part of the mesh have -1
+	std::vector<int> p_nodeIndex;
+
+	//! The position of the first node of each element in p_elementNodes
+	std::vector<int> p_elementNodeOffset;
+
+	//! The degree of freedom of each node of each element
+	std::vector<int> p_elementNodes;
+
+	//! The position of the first integration point of each element
+	std::vector<int> p_elementPointOffset;
+
+	//! The position of the shape functions of the first integration point of each element
+	std::vector<int> p_elementShapeOffset;
+
+	//! The integration weight multiplied by the determinant of the Jacobian for each integration point
+	std::vector<double> p_pointWeight;
+
+	//! The value of the shape functions at each integration point
+	std::vector<double> p_shapeValue;
+
+	//! The x-derivative of the shape functions at each integration point
+	std::vector<double> p_gradientX;
+
+	//! The y-derivative of the shape functions at each integration point
+	std::vector<double> p_gradientY;
+
+	//! Boolean used to indicate if the degree of freedom has a fixed value
+	std::vector<char> p_isFixed;
+
+	//! The fixed value of the degree of freedom
+	std::vector<double> p_fixedValue;
+
+	/**
+	 * @brief Numbers the degrees of freedom and stores the connectivity of the elements
+	 */
+	void createDOFMap();
+
+	/**
+	 * @brief 	Expands the geometric factors of a batch of elements of the same type into the integration weights
+	 * 			and the shape function gradients of every integration point
+	 * @param table The tables of the reference element
+	 * @param elementIndices The indices of the elements of the batch
+	 * @param count The number of elements in the batch. Must not be larger then ELEMENT_BATCH_SIZE
+	 */
+	void computeElementBatch(const referenceElement *table, const unsigned int *elementIndices, int count);
+
+	/**
+	 * @brief 	Computes the integration weights, the shape function values and the shape function gradients of all of the elements.
+	 * 			Elements with up to MAX_BATCH_NODES nodes are processed in batches. Larger elements are evaluated one at a time
+	 * 			from the tables of the reference element. Elements that are not triangles or quadrangles have no integration points
+	 * @param exactMass Set to true if the integration points need to integrate the product of two shape functions exactly
+	 */
+	void computeGeometricFactors(bool exactMass);
+
+public:
+
+	/**
+	 * @brief The constructor for the class
+	 * @param snapshot The snapshot of the mesh
+	 */
+	solverMesh(std::shared_ptr<const meshSnapshot> snapshot = nullptr)
+	{
+		p_snapshot = snapshot;
+	}
+
+	/**
+	 * @brief Sets the snapshot that the mesh is created from
+	 * @param snapshot The snapshot of the mesh
+	 */
+	void setSnapshot(std::shared_ptr<const meshSnapshot> snapshot)
+	{
+		p_snapshot = snapshot;
+	}
+
+	/**
+	 * @brief Creates the degree of freedom map and the geometric factors for a set of faces
+	 * @param faceTags The tags of the faces that will be part of the mesh. Faces without elements are skipped
+	 * @param exactMass Set to true if the integration points need to integrate the product of two shape functions
+	 * 					exactly. This is required by solvers that contain a mass term. Otherwise, the integration
+	 * 					points are only exact for the product of the gradients
+	 * @param computeFactors Set to false if the solver computes its own geometric factors. The arrays of
+	 * 							the integration points are then left empty
+	 */
+	void create(const std::vector<int> &faceTags, bool exactMass, bool computeFactors = true);
+
+	/**
+	 * @brief Computes the integration order that the geometric factors of an element are created with
+	 * @param elementType The MSH type of the element
+	 * @param exactMass Set to true if the product of two shape functions needs to be integrated exactly
+	 * @return Returns the polynomial order that the integration points integrate exactly
+	 */
+	static int getIntegrationOrder(int elementType, bool exactMass)
+	{
+		const int order = ElementType::OrderFromTag(elementType);
+
+		// The flux density of a triangle is one order lower then the potential. Quadrangles need
+		// the extra order for the bilinear terms
+		return (ElementType::ParentTypeFromTag(elementType) == TYPE_TRI && !exactMass) ? 2 * (order - 1) : 2 * order;
+	}
+
+	/**
+	 * @brief 	Computes the Jacobians of a batch of elements of the same type from the tables of the reference element.
+	 * 			The Jacobians of all of the elements of the batch are computed together at each quadrature point. The
+	 * 			factors are stored point major. For each point, the integration weight multiplied by the determinant of
+	 * 			the Jacobian and the entries (0, 0), (0, 1), (1, 0) and (1, 1) of the inverse of the Jacobian are stored
+	 * 			for all ELEMENT_BATCH_SIZE elements of the batch. Unused slots of a partial batch repeat the first element.
+	 * 			The x-derivative of a shape function is inverse(0, 0) * dN/du + inverse(0, 1) * dN/dv
+	 * @param table The tables of the reference element
+	 * @param elementIndices The indices of the elements of the batch
+	 * @param count The number of elements in the batch. Must not be larger then ELEMENT_BATCH_SIZE
+	 * @param factors Array of size numberPoints * GEOMETRIC_FACTOR_COUNT * ELEMENT_BATCH_SIZE that the factors are written to
+	 */
+	void computeBatchFactors(const referenceElement *table, const unsigned int *elementIndices, int count, double *factors) const;
+
+	/**
+	 * @brief Marks the degrees of freedom that have a fixed value. If no edges are specified, the
+	 * 			value is set to zero along the outer boundary of the mesh (see meshSnapshot::getBoundaryEdges)
+	 * @param dirichletEdges The fixed values along edges. The key is the tag of the GEdge
+	 */
+	void applyBoundaryConditions(const std::map<int, double> &dirichletEdges);
+
+	/**
+	 * @brief Creates the list of columns of every row of the system matrix. The rows and columns
+	 * 			of the fixed degrees of freedom are excluded
+	 * @param rowColumns The list of columns for every row. Can be passed to sparseMatrix::createPattern
+	 */
+	void getMatrixPattern(std::vector<std::vector<int>> &rowColumns) const;
+
+	/**
+	 * @brief Retrieves the degree of freedom that a node of the snapshot belongs to
+	 * @param node The position of the node in the snapshot
+	 * @return Returns the index of the degree of freedom. Returns -1 if the node is not part of the mesh
+	 */
+	int getNodeIndex(unsigned int node) const
+	{
+		return (node < p_nodeIndex.size()) ? p_nodeIndex[node] : -1;
+	}
+
+	unsigned int getNumberNodes() const
+	{
+		return p_nodeX.size();
+	}
+
+	unsigned int getNumberElements() const
+	{
+		return p_elements.size();
+	}
+
+	unsigned int getNumberPoints() const
+	{
+		return p_pointWeight.size();
+	}
+
+	unsigned int getNumberFaces() const
+	{
+		return p_faceTags.size();
+	}
+
+	int getFaceTag(unsigned int faceIndex) const
+	{
+		return p_faceTags[faceIndex];
+	}
+
+	unsigned int getFaceFirstElement(unsigned int faceIndex) const
+	{
+		return p_faceElementOffset[faceIndex];
+	}
+
+	unsigned int getFaceLastElement(unsigned int faceIndex) const
+	{
+		return p_faceElementOffset[faceIndex + 1];
+	}
+
+	/**
+	 * @brief Retrieves the type of an element
+	 * @param index The index of the element
+	 * @return Returns the MSH type of the element (MSH_TRI_3, MSH_QUA_4, ...)
+	 */
+	int getElementType(unsigned int index) const
+	{
+		return p_elementType[index];
+	}
+
+	const std::vector<double> &getNodeX() const
+	{
+		return p_nodeX;
+	}
+
+	const std::vector<double> &getNodeY() const
+	{
+		return p_nodeY;
+	}
+
+	const std::vector<int> &getElementNodeOffset() const
+	{
+		return p_elementNodeOffset;
+	}
+
+	const std::vector<int> &getElementNodes() const
+	{
+		return p_elementNodes;
+	}
+
+	const std::vector<int> &getElementPointOffset() const
+	{
+		return p_elementPointOffset;
+	}
+
+	const std::vector<int> &getElementShapeOffset() const
+	{
+		return p_elementShapeOffset;
+	}
+
+	const std::vector<double> &getPointWeight() const
+	{
+		return p_pointWeight;
+	}
+
+	const std::vector<double> &getShapeValue() const
+	{
+		return p_shapeValue;
+	}
+
+	const std::vector<double> &getGradientX() const
+	{
+		return p_gradientX;
+	}
+
+	const std::vector<double> &getGradientY() const
+	{
+		return p_gradientY;
+	}
+
+	const std::vector<char> &getIsFixed() const
+	{
+		return p_isFixed;
+	}
+
+	const std::vector<double> &getFixedValue() const
+	{
+		return p_fixedValue;
+	}
+};
+
+
+#endif
@@ -0,0 +1,221 @@
+#ifndef SPARSE_MATRIX_H_
+#define SPARSE_MATRIX_H_
+
+#include <vector>
+#include <algorithm>
+#include <complex>
+#include <cmath>
+
+
+/**
+ * @class sparseMatrix
+ * @author Phillip
+ * @date 18/10/26
+ * @file SparseMatrix.h
+ * @brief 	This class is the sparse matrix used by the solvers. The matrix is stored in the compressed
+ * 			sparse row (CSR) format. The sparsity pattern is created once from the connectivity of the
+ * 			mesh and is kept for the life time of the object. Afterwards, only the values are modified.
+ * 			This allows the nonlinear solvers to re-assemble the matrix at every iteration without
+ * 			any memory allocations. The column indices within a row are always sorted.
+ */
+template<class scalar>
+class sparseMatrix
+{
+private:
+
+	//! The number of rows (and columns) of the matrix
+	unsigned int p_size = 0;
+
+	//! The position of the first entry of each row. This vector has a size of p_size + 1
+	std::vector<int> p_rowPointer;
+
+	//! The column index of each entry in the matrix
+	std::vector<int> p_columnIndex;
+
+	//! The position of the diagonal entry for each row
+	std::vector<int> p_diagonalPosition;
+
+	//! The value of each entry in the matrix
+	std::vector<scalar> p_values;
+
+public:
+
+	/**
+	 * @brief Creates the sparsity pattern of the matrix. Any values that were stored in the matrix are discarded.
+	 * @param rowColumns For each row, the list of the columns that will contain a non-zero entry. The list
+	 * 					does not need to be sorted and may contain duplicates. The diagonal entry is always added.
+	 */
+	void createPattern(std::vector<std::vector<int>> &rowColumns)
+	{
+		p_size = rowColumns.size();
+		p_rowPointer.assign(p_size + 1, 0);
+		p_diagonalPosition.assign(p_size, -1);
+		p_columnIndex.clear();
+
+		for(unsigned int i = 0; i < p_size; i++)
+		{
+			std::vector<int> &columns = rowColumns[i];
+
+			columns.push_back(i);
+			std::sort(columns.begin(), columns.end());
+			columns.erase(std::unique(columns.begin(), columns.end()), columns.end());
+
+			p_rowPointer[i + 1] = p_rowPointer[i] + columns.size();
+		}
+
+		p_columnIndex.reserve(p_rowPointer[p_size]);
+
+		for(unsigned int i = 0; i < p_size; i++)
+		{
+			for(auto columnIterator = rowColumns[i].begin(); columnIterator != rowColumns[i].end(); columnIterator++)
+			{
+				if(*columnIterator == (int)i)
+					p_diagonalPosition[i] = p_columnIndex.size();
+
+				p_columnIndex.push_back(*columnIterator);
+			}
+		}
+
+		p_values.assign(p_columnIndex.size(), scalar());
+	}
+
+	/**
+	 * @brief Retrieves the position of an entry within the values array
+	 * @param row The row of the entry
+	 * @param column The column of the entry
+	 * @return Returns the position of the entry within the values array. Returns -1 if the entry
+	 * 			is not part of the sparsity pattern
+	 */
+	int getPosition(int row, int column) const
+	{
+		auto rowBegin = p_columnIndex.begin() + p_rowPointer[row];
+		auto rowEnd = p_columnIndex.begin() + p_rowPointer[row + 1];
+		auto found = std::lower_bound(rowBegin, rowEnd, column);
+
+		if(found != rowEnd && *found == column)
+			return (int)(found - p_columnIndex.begin());
+		else
+			return -1;
+	}
+
+	/**
+	 * @brief Adds a value to an entry of the matrix. Entries that are not part of the sparsity pattern are ignored
+	 * @param row The row of the entry
+	 * @param column The column of the entry
+	 * @param value The value that will be added to the entry
+	 */
+	void addToMatrix(int row, int column, const scalar &value)
+	{
+		int position = getPosition(row, column);
+
+		if(position >= 0)
+			p_values[position] += value;
+	}
+
+	/**
+	 * @brief Adds a value to the diagonal entry of a row
+	 * @param row The row of the entry
+	 * @param value The value that will be added to the entry
+	 */
+	void addToDiagonal(int row, const scalar &value)
+	{
+		p_values[p_diagonalPosition[row]] += value;
+	}
+
+	/**
+	 * @brief Sets all of the values of the matrix to zero. The sparsity pattern is kept
+	 */
+	void zeroMatrix()
+	{
+		std::fill(p_values.begin(), p_values.end(), scalar());
+	}
+
+	/**
+	 * @brief Computes the product y = A * x
+	 * @param x The vector that the matrix will be multiplied by
+	 * @param y The vector that will store the result. This vector is resized if needed
+	 */
+	void multiply(const std::vector<scalar> &x, std::vector<scalar> &y) const
+	{
+		y.resize(p_size);
+
+#if defined(_OPENMP)
+		#pragma omp parallel for schedule(static)
+#endif
+		for(int i = 0; i < (int)p_size; i++)
+		{
+			scalar sum = scalar();
+
+			for(int j = p_rowPointer[i]; j < p_rowPointer[i + 1]; j++)
+				sum += p_values[j] * x[p_columnIndex[j]];
+
+			y[i] = sum;
+		}
+	}
+
+	/**
+	 * @brief Retrieves the number of rows of the matrix
+	 * @return Returns the number of rows of the matrix
+	 */
+	unsigned int getSize() const
+	{
+		return p_size;
+	}
+
+	/**
+	 * @brief Retrieves the number of non-zero entries stored in the matrix
+	 * @return Returns the number of entries in the sparsity pattern
+	 */
+	unsigned int getNumberNonZero() const
+	{
+		return p_columnIndex.size();
+	}
+
+	/**
+	 * @brief Retrieves the row pointer array of the CSR format
+	 * @return Returns a reference to the row pointer array
+	 */
+	const std::vector<int> &getRowPointer() const
+	{
+		return p_rowPointer;
+	}
+
+	/**
+	 * @brief Retrieves the column index array of the CSR format
+	 * @return Returns a reference to the column index array
+	 */
+	const std::vector<int> &getColumnIndex() const
+	{
+		return p_columnIndex;
+	}
+
+	/**
+	 * @brief Retrieves the position of the diagonal entry for every row
+	 * @return Returns a reference to the diagonal position array
+	 */
+	const std::vector<int> &getDiagonalPosition() const
+	{
+		return p_diagonalPosition;
+	}
+
+	/**
+	 * @brief Retrieves the values array of the CSR format
+	 * @return Returns a reference to the values array
+	 */
+	std::vector<scalar> &getValues()
+	{
+		return p_values;
+	}
+
+	/**
+	 * @brief Retrieves the values array of the CSR format
+	 * @return Returns a constant reference to the values array
+	 */
+	const std::vector<scalar> &getValues() const
+	{
+		return p_values;
+	}
+};
+
+
+#endif
@@ -29,67 +29,17 @@ private:
 	template<class Archive>
 	void save(Archive &ar, const unsigned int version) const
 	{
-		/*
-		 * I really wish there was a better way of doing this
-		 */ 
-		std::vector<node> saveNodes;
-		std::vector<edgeLineShape> saveLines;
-		std::vector<arcShape> saveArcs;
-		std::vector<blockLabel> saveLabels;
-		
-		for(plf::colony<node>::iterator nodeIterator = _nodeList.begin(); nodeIterator != _nodeList.end(); nodeIterator++)
-			saveNodes.push_back(*nodeIterator);
-		
-		for(plf::colony<edgeLineShape>::iterator lineIterator = _lineList.begin(); lineIterator != _lineList.end(); lineIterator++)
-			saveLines.push_back(*lineIterator);
-			
-		for(plf::colony<arcShape>::iterator arcIterator = _arcList.begin(); arcIterator != _arcList.end(); arcIterator++)
-			saveArcs.push_back(*arcIterator);
-			
-		for(plf::colony<blockLabel>::iterator labelIterator = _blockLabelList.begin(); labelIterator != _blockLabelList.end(); labelIterator++)
-			saveLabels.push_back(*labelIterator);
-
-		ar & saveNodes;
-		ar & saveLines;
-		ar & saveArcs;
-		ar & saveLabels;
-		
+		saveNodes(ar);
+		saveSegments(ar);
+		saveLabels(ar);
 	}
 	
 	template<class Archive>
 	void load(Archive &ar, const unsigned int version)
 	{
-		std::vector<node> loadNodes;
-		std::vector<edgeLineShape> loadLines;
-		std::vector<arcShape> loadArcs;
-		std::vector<blockLabel> loadLabels;
-		
-		ar & loadNodes;
-		ar & loadLines;
-		ar & loadArcs;
-		ar & loadLabels;
-		
-		for(std::vector<node>::iterator nodeIterator = loadNodes.begin(); nodeIterator != loadNodes.end(); nodeIterator++)
-		{
-			_nodeList.insert(*nodeIterator);
-			if(nodeIterator->getNodeID() > _nodeNumber)
-				_nodeNumber = nodeIterator->getNodeID();
-		}
-		
-		for(std::vector<edgeLineShape>::iterator lineIterator = loadLines.begin(); lineIterator != loadLines.end(); lineIterator++)
-			_lineList.insert(*lineIterator);
-			
-		for(std::vector<arcShape>::iterator arcIterator = loadArcs.begin(); arcIterator != loadArcs.end(); arcIterator++)
-		{
-			_arcList.insert(*arcIterator);
-			if(arcIterator->getArcID() > p_arcNumber)
-				p_arcNumber = arcIterator->getArcID();
-		}
-			
-		for(std::vector<blockLabel>::iterator labelIterator = loadLabels.begin(); labelIterator != loadLabels.end(); labelIterator++)
-			_blockLabelList.insert(*labelIterator);
-			
-		
+		loadNodes(ar);
+		loadSegments(ar);
+		loadLabels(ar);
 	}
 	BOOST_SERIALIZATION_SPLIT_MEMBER()
     /*
@@ -652,6 +602,119 @@ public:
     */ 
     bool createFillet(double radius);
 	
+	/**
+	 * @brief 	Saves the nodes into an archive. The nodes, segments and labels are saved separately so that
+	 * 			the binary project file can store each of them in its own chunk
+	 * @param ar The archive
+	 */
+	template<class Archive>
+	void saveNodes(Archive &ar) const
+	{
+		/*
+		 * I really wish there was a better way of doing this
+		 */ 
+		std::vector<node> nodes;
+		
+		for(plf::colony<node>::iterator nodeIterator = _nodeList.begin(); nodeIterator != _nodeList.end(); nodeIterator++)
+			nodes.push_back(*nodeIterator);
+			
+		ar & nodes;
+	}
+	
+	/**
+	 * @brief Saves the lines and the arcs into an archive
+	 * @param ar The archive
+	 */
+	template<class Archive>
+	void saveSegments(Archive &ar) const
+	{
+		std::vector<edgeLineShape> lines;
+		std::vector<arcShape> arcs;
+		
+		for(plf::colony<edgeLineShape>::iterator lineIterator = _lineList.begin(); lineIterator != _lineList.end(); lineIterator++)
+			lines.push_back(*lineIterator);
+			
+		for(plf::colony<arcShape>::iterator arcIterator = _arcList.begin(); arcIterator != _arcList.end(); arcIterator++)
+			arcs.push_back(*arcIterator);
+			
+		ar & lines;
+		ar & arcs;
+	}
+	
+	/**
+	 * @brief Saves the block labels into an archive
+	 * @param ar The archive
+	 */
+	template<class Archive>
+	void saveLabels(Archive &ar) const
+	{
+		std::vector<blockLabel> labels;
+		
+		for(plf::colony<blockLabel>::iterator labelIterator = _blockLabelList.begin(); labelIterator != _blockLabelList.end(); labelIterator++)
+			labels.push_back(*labelIterator);
+			
+		ar & labels;
+	}
+	
+	/**
+	 * @brief Loads the nodes from an archive
+	 * @param ar The archive
+	 */
+	template<class Archive>
+	void loadNodes(Archive &ar)
+	{
+		std::vector<node> nodes;
+		
+		ar & nodes;
+		
+		for(std::vector<node>::iterator nodeIterator = nodes.begin(); nodeIterator != nodes.end(); nodeIterator++)
+		{
+			_nodeList.insert(*nodeIterator);
+			if(nodeIterator->getNodeID() > _nodeNumber)
+				_nodeNumber = nodeIterator->getNodeID();
+		}
+	}
+	
+	/**
+	 * @brief 	Loads the lines and the arcs from an archive. The addresses of the nodes are set
+	 * 			once rebuildDataStructure is called
+	 * @param ar The archive
+	 */
+	template<class Archive>
+	void loadSegments(Archive &ar)
+	{
+		std::vector<edgeLineShape> lines;
+		std::vector<arcShape> arcs;
+		
+		ar & lines;
+		ar & arcs;
+		
+		for(std::vector<edgeLineShape>::iterator lineIterator = lines.begin(); lineIterator != lines.end(); lineIterator++)
+			_lineList.insert(*lineIterator);
+			
+		for(std::vector<arcShape>::iterator arcIterator = arcs.begin(); arcIterator != arcs.end(); arcIterator++)
+		{
+			_arcList.insert(*arcIterator);
+			if(arcIterator->getArcID() > p_arcNumber)
+				p_arcNumber = arcIterator->getArcID();
+		}
+	}
+	
+	/**
+	 * @brief Loads the block labels from an archive
+	 * @param ar The archive
+	 */
+	template<class Archive>
+	void loadLabels(Archive &ar)
+	{
+		std::vector<blockLabel> labels;
+		
+		ar & labels;
+		
+		for(std::vector<blockLabel>::iterator labelIterator = labels.begin(); labelIterator != labels.end(); labelIterator++)
+			_blockLabelList.insert(*labelIterator);
+	}
+	
 	/**
 	 * @brief 	Function that is called after the data structure is loaded AND copied. If this function is called
 	 * 			after the data structure is loaded, then the addresses of all of nodes will change once the 
@@ -23,8 +23,9 @@
  * @brief This class handles all of the additional settings that the user can select or edit that should be
  * 			more hidden from the the main view. These settings apply directly to the mesh settings. This
  * 			class handles the selection of the different file formats to save the mesh in, the directory
- * 			location of the mesh saved files, the number of mesh passes, the llyod smoothing steps, and
- * 			the global mesh size factor setting.
+ * 			location of the mesh saved files, the number of mesh passes, the llyod smoothing steps, the
+ * 			global mesh size factor setting, the number of partitions of the partitioned mesh files, and the refinement
+ * 			of the mesh at the corners of the geometry.
  */
 class meshAdvanced : public wxDialog
 {
@@ -41,6 +42,12 @@ private:
 	//! Text box that is used to set the Global Mesh Factor Scaling number
 	wxTextCtrl *p_factorTextCtrl = new wxTextCtrl();
 	
+	//! Text box that is used to set the number of partitions of the partitioned mesh files
+	wxTextCtrl *p_partitionsTextCtrl = new wxTextCtrl();
+	
+	//! Text box that is used to set the refinement factor of the mesh at the corners of the geometry
+	wxTextCtrl *p_cornerTextCtrl = new wxTextCtrl();
+	
 	//! Text box used to indicate the local of the directory to save the mesh file to
 	wxTextCtrl *p_meshFileDirectory = new wxTextCtrl();
 	
@@ -101,6 +108,12 @@ private:
 	//! Check box used to indicate that the user wants to save the mesh as VRML file
 	wxCheckBox *p_saveAsVRML = new wxCheckBox();
 	
+	//! Check box used to indicate that the user wants to save the mesh as VTU file
+	wxCheckBox *p_saveAsVTU = new wxCheckBox();
+	
+	//! Check box used to indicate that the user wants the data of the VTU file to be compressed
+	wxCheckBox *p_compressVTU = new wxCheckBox();
+	
 	/**
 	 * @brief Event procedure that is fired when the user needs to reset to default settings
 	 * @param event Required arguement for event procedure functionality
@@ -9,6 +9,7 @@
 
 #include <thread>
 #include <chrono>
+#include <memory>
 
 #include <glew.h>
 #include <freeglut.h>
@@ -21,6 +22,9 @@
 #include <common/ProblemDefinition.h>
 #include <common/plfcolony.h>
 #include <common/GridPreferences.h>
+#include <common/ProjectFile.h>
+
+#include <Mesh/meshRegionTable.h>
 
 #include <common/GeometryProperties/NodeSettings.h>
 
@@ -312,6 +316,15 @@ private:
 		in the Mesh folder. This variable will only store the mesh so that it can be drawn
 	*/ 
 	GModel *p_modelMesh = new GModel();
+	
+	//! The project file that contains the mesh of the model. The mesh is only read from the file once it is displayed
+	std::shared_ptr<projectFile> p_savedMeshFile;
+	
+	//! The materials of the faces and the boundary conditions of the edges of the mesh. Empty if the model was not meshed
+	meshRegionTable p_meshRegions;
+	
+	//! Counter that is incremented whenever the user edits the geometry. The autosave uses it to detect if the model changed
+	unsigned long p_editGeneration = 0;
     
     //! A function that converts the x pixel coordinate into a cartesian/polar coordinate
     /*!
@@ -606,6 +619,20 @@ private:
         After execution, _doZoomWindow is false.
     */ 
     void doZoomWindow();
+	
+	/**
+	 * @brief 	Function that is called whenever the geometry is edited. The edit generation is incremented so that
+	 * 			the autosave writes the model again. If the model is meshed, the mesh no longer matches the geometry
+	 * 			and is deleted
+	 */
+	void geometryChanged()
+	{
+		p_editGeneration++;
+		
+		// Check to make sure that the mesh exists before deleting it
+		if(p_modelMesh->getNumMeshVertices() > 0 || p_savedMeshFile)
+			deleteMesh();
+	}
     
 public:
     //! This is the constructor for the class
@@ -1118,9 +1145,86 @@ public:
 			delete p_modelMesh;
 			p_modelMesh = new GModel();
 		}
+		p_savedMeshFile.reset();
+		p_meshRegions.clear();
 		p_drawMesh = false;
 	}
 	
+	/**
+	 * @brief Sets the regions of the mesh. This is called by the mesh command once the geometry is meshed
+	 * @param regions The materials of the faces and the boundary conditions of the edges of the mesh
+	 */
+	void setMeshRegions(const meshRegionTable &regions)
+	{
+		p_meshRegions = regions;
+	}
+	
+	/**
+	 * @brief Retrieves the regions of the mesh. These are stored with the mesh when the project is saved
+	 * @return Returns the materials of the faces and the boundary conditions of the edges of the mesh
+	 */
+	const meshRegionTable &getMeshRegions()
+	{
+		return p_meshRegions;
+	}
+	
+	/**
+	 * @brief 	Sets the project file that contains the mesh of the model. The mesh is not read until
+	 * 			loadSavedMesh is called
+	 * @param file The project file that was opened
+	 */
+	void setSavedMesh(std::shared_ptr<projectFile> file)
+	{
+		p_savedMeshFile = file;
+	}
+	
+	/**
+	 * @brief Retrieves the project file that contains the mesh of the model which is not read yet
+	 * @return Returns the project file or nullptr if there is no mesh to read
+	 */
+	std::shared_ptr<projectFile> getSavedMesh()
+	{
+		return p_savedMeshFile;
+	}
+	
+	/**
+	 * @brief 	Reads the mesh of the model from the project file that was set with setSavedMesh. The regions of the mesh
+	 * 			are read as well and the physical groups of the mesh are created again from them
+	 * @param errorMessage Set to the reason if the mesh could not be read
+	 * @return Returns true if the mesh was read or if there is no mesh to read
+	 */
+	bool loadSavedMesh(std::string &errorMessage)
+	{
+		std::shared_ptr<projectFile> file = p_savedMeshFile;
+		
+		p_savedMeshFile.reset();
+		p_meshRegions.clear();
+		
+		if(!file)
+			return true;
+		
+		// Projects that were saved before the regions were stored only contain the mesh
+		if(file->hasChunk(projectChunk::MESH_REGIONS) &&
+			!file->readArchiveChunk(projectChunk::MESH_REGIONS, [&](boost::archive::binary_iarchive &ar){ ar >> p_meshRegions; }, errorMessage))
+			return false;
+			
+		if(!file->readMesh(p_modelMesh, errorMessage))
+			return false;
+		
+		p_meshRegions.applyPhysicalGroups(p_modelMesh);
+		
+		return true;
+	}
+	
+	/**
+	 * @brief Retrieves the edit generation of the model
+	 * @return Returns a number that is incremented every time the geometry is edited
+	 */
+	unsigned long getEditGeneration()
+	{
+		return p_editGeneration;
+	}
+	
 	void toggleMesh()
 	{
 		p_drawMesh = !p_drawMesh;
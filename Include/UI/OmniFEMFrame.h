@@ -11,6 +11,7 @@
 #include <wx/sizer.h>
 #include <wx/treectrl.h>
 #include <wx/filefn.h> 
+#include <wx/timer.h>
 
 #include <UI/GeometryEditor2D.h>
 #include <UI/common.h>
@@ -43,6 +44,10 @@
 #include "common/OmniFEMMessage.h"
 #include <common/ProblemDefinition.h>
 
+#include <Mesh/meshExporter.h>
+
+#include <UI/ProjectAutosave.h>
+
 
 // For documenting code, see: https://www.stack.nl/~dimitri/doxygen/manual/docblocks.html
 
@@ -91,6 +96,8 @@ public:
 	
 	~OmniFEMMainFrame()
 	{
+		// The autosave posts its result to the message windows
+		p_autosave.waitForAutosave();
 		delete OmniFEMMsg::instance();
 	}
 private:
@@ -222,6 +229,15 @@ private:
         deleted on the frame when the user moves between UI states
     */ 
     systemState _UIState = systemState::ON_START_UP_STATE;
+	
+	//! The number of milliseconds between two autosaves
+	const int p_autosaveInterval = 120000;
+	
+	//! The timer that periodically starts the autosave
+	wxTimer p_autosaveTimer;
+	
+	//! Writes the autosave of the project on a background thread
+	projectAutosave p_autosave;
 
 
 	/***********************************
@@ -297,6 +313,13 @@ private:
         \param event A required parameter for the event procedure to work properly
     */ 
     void OnExit(wxCommandEvent &event);
+	
+	/**
+	 * @brief 	Event procedure that is fired periodically by the autosave timer. If the model was edited since the
+	 * 			last save, a snapshot of the project is written to the autosave file in the background
+	 * @param event A required parameter for the event procedure to work properly
+	 */
+	void onAutosaveTimer(wxTimerEvent &event);
     
     /* This section is for the Edit menu */
     
@@ -1013,6 +1036,15 @@ private:
 	 * @param filePath The path where the file is located
 	 */
 	void load(string filePath);
+	
+	/**
+	 * @brief Retrieves the path of the autosave file of the current project
+	 * @return Returns the path of the autosave file
+	 */
+	std::string getAutosavePath()
+	{
+		return projectAutosave::getAutosavePath(_saveFilePath, _problemDefinition.getName().ToStdString());
+	}
     
     //! Function that is needed in order to tell the wx library that this class has event procedures
     wxDECLARE_EVENT_TABLE();
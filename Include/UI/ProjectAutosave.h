@@ -0,0 +1,95 @@
+#ifndef PROJECTAUTOSAVE_H_
+#define PROJECTAUTOSAVE_H_
+
+#include <string>
+#include <memory>
+#include <thread>
+#include <atomic>
+
+#include <UI/ProjectSnapshot.h>
+
+
+/**
+ * @class projectAutosave
+ * @author Phillip
+ * @date 18/10/26
+ * @file ProjectAutosave.h
+ * @brief 	This class periodically writes a copy of the project so that the work of the user can be recovered after
+ * 			a crash. The UI thread only takes a snapshot of the project. The snapshot is serialized and written by
+ * 			a background thread. The file is written under a temporary name and renamed once it is complete so
+ * 			that a crash during the autosave never destroys the previous autosave. Nothing is written if the edit
+ * 			generation of the model did not change since the last autosave or save. Only one autosave is written
+ * 			at a time. If the previous autosave is still being written, the autosave is skipped.
+ */
+class projectAutosave
+{
+private:
+
+	//! Boolean used to indicate if the background thread is writing an autosave
+	std::atomic<bool> p_isWriting{false};
+
+	//! The background thread that writes the autosave
+	std::thread p_autosaveThread;
+
+	//! The edit generation of the model when it was last saved or autosaved
+	unsigned long p_savedGeneration = 0;
+
+	/**
+	 * @brief The function that is executed by the background thread. Serializes the snapshot and writes the file
+	 * @param snapshot The project that is written
+	 * @param filePath The path of the autosave file
+	 */
+	void runAutosave(std::shared_ptr<projectSnapshot> snapshot, std::string filePath);
+
+public:
+
+	~projectAutosave()
+	{
+		waitForAutosave();
+	}
+
+	/**
+	 * @brief 	Retrieves the path of the autosave file of a project. The autosave is written next to the project file.
+	 * 			If the project was never saved, the autosave is written in the temporary folder
+	 * @param filePath The path of the project file. Empty if the project was never saved
+	 * @param name The name of the project
+	 * @return Returns the path of the autosave file
+	 */
+	static std::string getAutosavePath(std::string filePath, std::string name);
+
+	/**
+	 * @brief 	Sets the edit generation of the model that is saved. This function is called after the
+	 * 			project is saved, loaded or created
+	 * @param generation The edit generation of the model
+	 */
+	void setSavedGeneration(unsigned long generation)
+	{
+		p_savedGeneration = generation;
+	}
+
+	/**
+	 * @brief 	Takes a snapshot of the project and starts a background thread that writes the snapshot. Returns
+	 * 			immediately
+	 * @param problem The problem definition of the project
+	 * @param model The model of the project
+	 * @param filePath The path of the autosave file
+	 * @return Returns true if an autosave was started. False if the model did not change or if the previous
+	 * 			autosave is still being written
+	 */
+	bool start(problemDefinition &problem, modelDefinition *model, std::string filePath);
+
+	/**
+	 * @brief Blocks until the background thread has finished writing
+	 */
+	void waitForAutosave();
+
+	/**
+	 * @brief 	Deletes the autosave file of a project. This is called once the project is saved since the autosave
+	 * 			is then older than the project file
+	 * @param filePath The path of the autosave file
+	 */
+	void removeAutosave(std::string filePath);
+};
+
+
+#endif
@@ -0,0 +1,71 @@
+#ifndef PROJECTSNAPSHOT_H_
+#define PROJECTSNAPSHOT_H_
+
+#include <vector>
+
+#include <common/ProblemDefinition.h>
+#include <common/GridPreferences.h>
+#include <common/ProjectFile.h>
+
+#include <UI/GeometryEditor2D.h>
+#include <UI/ModelDefinition/ModelDefinition.h>
+
+
+/**
+ * @class projectSnapshot
+ * @author Phillip
+ * @date 18/10/26
+ * @file ProjectSnapshot.h
+ * @brief 	This class holds a copy of everything that is saved in a project file: the problem definition, the grid
+ * 			preferences, the geometry and the view. Copying the data is much faster than serializing it. Once the
+ * 			copy is made, the user can keep editing the model while the snapshot is serialized and written on a
+ * 			background thread. The lines and arcs of the copy still point to the nodes of the model but only the
+ * 			node IDs are serialized so the pointers are never used.
+ */
+class projectSnapshot
+{
+private:
+
+	//! The problem definition of the project
+	problemDefinition p_problem;
+
+	//! The grid preferences of the model
+	gridPreferences p_preferences;
+
+	//! The nodes, lines, arcs and labels of the model
+	geometryEditor2D p_editor;
+
+	//! The zoom factor (x and y) and the camera displacement (x and y) of the model
+	std::vector<double> p_view;
+
+public:
+
+	/**
+	 * @brief The constructor for the class. Copies the data of the project
+	 * @param problem The problem definition of the project
+	 * @param model The model of the project
+	 */
+	projectSnapshot(problemDefinition &problem, modelDefinition *model)
+	{
+		p_problem = problem;
+		model->getParameters(p_preferences, p_editor, p_view);
+	}
+
+	/**
+	 * @brief 	Serializes the snapshot into the chunks of a project file. Every part of the project is stored in
+	 * 			its own chunk so that the geometry can be read without reading the mesh
+	 * @param file The project file that the chunks are added to
+	 */
+	void addChunks(projectFile &file)
+	{
+		file.addArchiveChunk(projectChunk::PROBLEM_SETTINGS, [&](boost::archive::binary_oarchive &ar){ p_problem.serializeSettings(ar); });
+		file.addArchiveChunk(projectChunk::MATERIAL_LIBRARY, [&](boost::archive::binary_oarchive &ar){ p_problem.serializeMaterials(ar); });
+		file.addArchiveChunk(projectChunk::VIEW_SETTINGS, [&](boost::archive::binary_oarchive &ar){ ar << p_preferences; ar << p_view; });
+		file.addArchiveChunk(projectChunk::NODES, [&](boost::archive::binary_oarchive &ar){ p_editor.saveNodes(ar); });
+		file.addArchiveChunk(projectChunk::SEGMENTS, [&](boost::archive::binary_oarchive &ar){ p_editor.saveSegments(ar); });
+		file.addArchiveChunk(projectChunk::LABELS, [&](boost::archive::binary_oarchive &ar){ p_editor.saveLabels(ar); });
+	}
+};
+
+
+#endif
@@ -111,6 +111,12 @@ private:
 	
 	//! Boolean to indicate if the mesh should be saved as VRML (true)
 	bool p_saveAsVRML = false;
+	
+	//! Boolean to indicate if the mesh should be saved as a binary XML VTK file (true)
+	bool p_saveAsVTU = false;
+	
+	//! Boolean to indicate if the data of the VTU file is compressed with zlib (true)
+	bool p_compressVTU = true;
 
 	bool p_isStructured = false;
 	
@@ -148,6 +154,12 @@ private:
 	//! Property used to specify the number of smoothing steps for Blossom algorithm 
 	unsigned int p_llyodSmoothingSteps = 5;
 	
+	//! Property used to specify the number of partitions of the partitioned mesh files
+	unsigned int p_numberPartitions = 2;
+	
+	//! Property used to specify the element size at the corners of the geometry relative to the element size of the edges. 1 turns the refinement off
+	double p_cornerRefinementFactor = 1.0;
+	
 //---- Section is for structured meshes	
 
 public:
@@ -437,6 +449,49 @@ public:
 		return p_llyodSmoothingSteps;
 	}
 	
+	/**
+	 * @brief Function that is used to set the number of partitions the mesh is split into when the mesh
+	 * 			is saved as a partitioned mesh. One file is saved for each partition.
+	 * @param value The number of partitions
+	 */
+	void setNumberPartitions(unsigned int value)
+	{
+		p_numberPartitions = value;
+	}
+	
+	/**
+	 * @brief Function that is used to retrieve the number of partitions of the partitioned mesh files
+	 * @return Returns the number of partitions
+	 */
+	unsigned int getNumberPartitions()
+	{
+		return p_numberPartitions;
+	}
+	
+	/**
+	 * @brief Function that is used to set the refinement of the mesh at the corners of the geometry. A corner is a node
+	 * 			where the edges meet at an angle or where more than two edges meet, such as the corners of a magnet or
+	 * 			of an air gap. The element size at the corners is the element size of the edges multiplied by the factor and
+	 * 			grows back to the element size of the edges within a few elements.
+	 * @param value The factor between 0 and 1. Values outside of this range turn the refinement off
+	 */
+	void setCornerRefinementFactor(double value)
+	{
+		if(value <= 0 || value > 1)
+			p_cornerRefinementFactor = 1.0;
+		else
+			p_cornerRefinementFactor = value;
+	}
+	
+	/**
+	 * @brief Function that is used to retrieve the refinement factor of the mesh at the corners of the geometry
+	 * @return Returns the factor. A factor of 1 means that the corners are not refined
+	 */
+	double getCornerRefinementFactor()
+	{
+		return p_cornerRefinementFactor;
+	}
+	
 	/**
 	 * @brief Function that is used to set the save as VTK State
 	 * @param state Set to true to save the mesh as a VTK file. Otherwise, set to false.
@@ -777,6 +832,42 @@ public:
 	{
 		return p_saveAsVRML;
 	}
+	
+	/**
+	 * @brief Function that is used to set the save as VTU State
+	 * @param state Set to true to save the mesh as a binary XML VTK file. Otherwise, set to false.
+	 */
+	void setSaveVTUState(bool state)
+	{
+		p_saveAsVTU = state;
+	}
+	
+	/**
+	 * @brief Function that is used to retrieve the save as VTU State
+	 * @return Returns true if the mesh should be saved as a binary XML VTK file. Otherwise, returns false.
+	 */
+	bool getSaveVTUState()
+	{
+		return p_saveAsVTU;
+	}
+	
+	/**
+	 * @brief Function that is used to set the compression state of the VTU file
+	 * @param state Set to true to compress the data of the VTU file with zlib. Otherwise, set to false.
+	 */
+	void setCompressVTUState(bool state)
+	{
+		p_compressVTU = state;
+	}
+	
+	/**
+	 * @brief Function that is used to retrieve the compression state of the VTU file
+	 * @return Returns true if the data of the VTU file is compressed. Otherwise, returns false.
+	 */
+	bool getCompressVTUState()
+	{
+		return p_compressVTU;
+	}
 };
 
 #endif
\ No newline at end of file
@@ -123,6 +123,23 @@ private:
 	
 	template<class Archive>
 	void serialize(Archive &ar, const unsigned int version)
+	{
+		serializeSettings(ar);
+		serializeMaterials(ar);
+	}
+    
+    /**********
+    * Methods *
+	***********/
+public:
+	
+	/**
+	 * @brief 	Serializes the settings of the problem: the physics problem, the exterior region, the nodal properties,
+	 * 			the name and the preferences. The binary project file stores these in their own chunk
+	 * @param ar The archive
+	 */
+	template<class Archive>
+	void serializeSettings(Archive &ar)
 	{
 		ar & _phycisProblem;
 		ar & p_exteriorRegion;
@@ -131,26 +148,33 @@ private:
 		ar & name;
 		_problemName = wxString(name);
 		if(_phycisProblem == physicProblems::PROB_ELECTROSTATIC)
-		{
 			ar & _localElectricalPreference;
+		else if(_phycisProblem == physicProblems::PROB_MAGNETICS)
+			ar & _localMagneticPreference;
+	}
+	
+	/**
+	 * @brief 	Serializes the boundary conditions, the conductors or circuits and the materials of the problem.
+	 * 			The settings need to be serialized first since the lists depend on the physics problem
+	 * @param ar The archive
+	 */
+	template<class Archive>
+	void serializeMaterials(Archive &ar)
+	{
+		if(_phycisProblem == physicProblems::PROB_ELECTROSTATIC)
+		{
 			ar & _localElectricalBoundaryConditionList;
 			ar & _localConductorList;
 			ar & _localElectrialMaterialList;
 		}
 		else if(_phycisProblem == physicProblems::PROB_MAGNETICS)
 		{
-			ar & _localMagneticPreference;
 			ar & _localMagneticBoundaryConditionList;
 			ar & _localCircuitList;
 			ar & _localMagneticMaterialList;
 		}
 	}
     
-    /**********
-    * Methods *
-	***********/
-public:
-    
     //! Sets the physics problem
     /*!
         \param prob A value that represents the physics simulation that 
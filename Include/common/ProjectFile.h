@@ -0,0 +1,230 @@
+#ifndef PROJECTFILE_H_
+#define PROJECTFILE_H_
+
+#include <string>
+#include <vector>
+#include <sstream>
+#include <cstdint>
+
+#include <boost/archive/binary_oarchive.hpp>
+#include <boost/archive/binary_iarchive.hpp>
+#include <boost/archive/archive_exception.hpp>
+#include <boost/serialization/vector.hpp>
+
+class GModel;
+
+
+//! Enum that is used to identify the chunks of a project file
+enum class projectChunk : uint32_t
+{
+	PROBLEM_SETTINGS = 1,
+	MATERIAL_LIBRARY = 2,
+	VIEW_SETTINGS = 3,
+	NODES = 4,
+	SEGMENTS = 5,
+	LABELS = 6,
+	MESH = 7,
+	RESULTS = 8,
+	MESH_KEY = 9,
+	MESH_REGIONS = 10
+};
+
+
+/**
+ * @class projectFile
+ * @author Phillip
+ * @date 18/10/26
+ * @file ProjectFile.h
+ * @brief 	This class reads and writes the binary .omniFEM project file. The file starts with a header and a
+ * 			directory of chunks followed by the data of the chunks. Each chunk contains one part of the project
+ * 			(the problem settings, the material library, the nodes, the segments, the labels, the mesh, ...)
+ * 			and carries a CRC-32 checksum of its data which is verified when the chunk is read. When a file is
+ * 			opened, only the header and the directory are read. The chunks are read on demand so that the
+ * 			geometry can be loaded first and the mesh and the results are only read once they are viewed.
+ * 			The data of the chunks is created with the binary archives of boost. The layout of the file is:
+ * 			the magic string "OmniFEM" followed by a null character, the version, the number of chunks and the
+ * 			checksum of the directory as 32 bit integers and then one entry per chunk with the ID and the
+ * 			checksum as 32 bit integers and the position and the size of the data as 64 bit integers.
+ */
+class projectFile
+{
+private:
+
+	//! An entry of the directory of the file
+	struct chunkEntry
+	{
+		//! The ID of the chunk
+		uint32_t id;
+
+		//! The CRC-32 checksum of the data
+		uint32_t checksum;
+
+		//! The position of the data in the file
+		uint64_t position;
+
+		//! The number of bytes of the data
+		uint64_t size;
+	};
+
+	//! The version of the file format that is written
+	static const uint32_t p_version = 1;
+
+	//! The path of the file that was opened
+	std::string p_filePath;
+
+	//! The directory of the file that was opened
+	std::vector<chunkEntry> p_directory;
+
+	//! The chunks that are written. The data of each chunk is stored in the same order as the IDs
+	std::vector<projectChunk> p_chunkIDs;
+
+	//! The data of the chunks that are written
+	std::vector<std::string> p_chunkData;
+
+	/**
+	 * @brief Finds the entry of a chunk in the directory of the file that was opened
+	 * @param id The ID of the chunk
+	 * @return Returns a pointer to the entry or nullptr if the file does not contain the chunk
+	 */
+	const chunkEntry *findChunk(projectChunk id) const;
+
+public:
+
+	/**
+	 * @brief Computes the CRC-32 checksum of data. The result is the same as the one of the crc32 function of zlib
+	 * @param data Pointer to the data
+	 * @param size The number of bytes
+	 * @return Returns the checksum
+	 */
+	static uint32_t computeChecksum(const void *data, std::size_t size);
+
+	/**
+	 * @brief 	Checks if a file is a binary project file. Project files that were saved before the binary
+	 * 			format was introduced are text archives and need to be loaded as such
+	 * @param filePath The path of the file
+	 * @return Returns true if the file starts with the magic string of the binary format
+	 */
+	static bool isProjectFile(std::string filePath);
+
+	/**
+	 * @brief Adds a chunk that is written to the file. If a chunk with the same ID was added before, it is replaced
+	 * @param id The ID of the chunk
+	 * @param data The data of the chunk
+	 */
+	void addChunk(projectChunk id, std::string data);
+
+	/**
+	 * @brief 	Adds a chunk whose data is created with a binary archive of boost
+	 * @param id The ID of the chunk
+	 * @param saveFunction The function that saves the data into the archive. The argument is the archive
+	 */
+	template<typename T>
+	void addArchiveChunk(projectChunk id, T saveFunction)
+	{
+		std::ostringstream stream(std::ios::out | std::ios::binary);
+
+		{
+			boost::archive::binary_oarchive archive(stream);
+			saveFunction(archive);
+		}
+
+		addChunk(id, stream.str());
+	}
+
+	/**
+	 * @brief 	Adds the mesh of a model as a chunk. The mesh is stored as a binary MSH file. A temporary
+	 * 			file is created next to the project file for this
+	 * @param mesh The model that contains the mesh
+	 * @param filePath The path of the project file
+	 * @param errorMessage Set to the reason if the mesh could not be added
+	 * @return Returns true if the mesh was added
+	 */
+	bool addMesh(GModel *mesh, std::string filePath, std::string &errorMessage);
+
+	/**
+	 * @brief 	Writes the chunks that were added to a file. The file is first written under a temporary name
+	 * 			and then renamed so that an existing file is never left half written
+	 * @param filePath The path of the file
+	 * @param errorMessage Set to the reason if the file could not be written
+	 * @return Returns true if the file was written
+	 */
+	bool write(std::string filePath, std::string &errorMessage);
+
+	/**
+	 * @brief Opens a file and reads the header and the directory. The data of the chunks is not read
+	 * @param filePath The path of the file
+	 * @param errorMessage Set to the reason if the file could not be opened
+	 * @return Returns true if the file is a valid project file
+	 */
+	bool open(std::string filePath, std::string &errorMessage);
+
+	/**
+	 * @brief Checks if the file that was opened contains a chunk
+	 * @param id The ID of the chunk
+	 * @return Returns true if the chunk exists
+	 */
+	bool hasChunk(projectChunk id) const
+	{
+		return (findChunk(id) != nullptr);
+	}
+
+	/**
+	 * @brief Reads the data of a chunk from the file that was opened and verifies its checksum
+	 * @param id The ID of the chunk
+	 * @param data Set to the data of the chunk
+	 * @param errorMessage Set to the reason if the chunk could not be read
+	 * @return Returns true if the chunk was read and the checksum is correct
+	 */
+	bool readChunk(projectChunk id, std::string &data, std::string &errorMessage) const;
+
+	/**
+	 * @brief Reads a chunk whose data was created with a binary archive of boost
+	 * @param id The ID of the chunk
+	 * @param loadFunction The function that loads the data from the archive. The argument is the archive
+	 * @param errorMessage Set to the reason if the chunk could not be read
+	 * @return Returns true if the chunk was read
+	 */
+	template<typename T>
+	bool readArchiveChunk(projectChunk id, T loadFunction, std::string &errorMessage) const
+	{
+		std::string data;
+
+		if(!readChunk(id, data, errorMessage))
+			return false;
+
+		std::istringstream stream(data, std::ios::in | std::ios::binary);
+
+		try
+		{
+			boost::archive::binary_iarchive archive(stream);
+			loadFunction(archive);
+		}
+		catch(boost::archive::archive_exception &exception)
+		{
+			errorMessage = "Unable to read chunk " + std::to_string((uint32_t)id) + " of " + p_filePath + ": " + exception.what();
+			return false;
+		}
+
+		return true;
+	}
+
+	/**
+	 * @brief Reads the mesh chunk of the file that was opened into a model
+	 * @param mesh The model that the mesh is read into
+	 * @param errorMessage Set to the reason if the mesh could not be read
+	 * @return Returns true if the mesh was read
+	 */
+	bool readMesh(GModel *mesh, std::string &errorMessage) const;
+
+	/**
+	 * @brief Retrieves the path of the file that was opened
+	 * @return Returns the path of the file
+	 */
+	std::string getFilePath() const
+	{
+		return p_filePath;
+	}
+};
+
+
+#endif
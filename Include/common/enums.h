@@ -36,7 +36,8 @@ enum FileMenuID
     ID_FILE_NEW,/*!< Value used to indicate that the event is a file new event */
     ID_SAVE,/*!< Value used to indicate that the event is a save event */
     ID_SAVE_AS,/*!< Value used to indicate that the event is a save as event */
-    ID_OPEN/*!< Value used to indicate that the event is a open event */
+    ID_OPEN,/*!< Value used to indicate that the event is a open event */
+    ID_AUTOSAVE_TIMER/*!< Value used to indicate that the event came from the autosave timer */
 };
 
 
@@ -17,13 +17,12 @@
 
 void outputScalarField(std::list<BDS_Face*> t, const char *iii, int param, GFace *gf)
 {
+  // only a debug view, called on errors and from the debug paths of the mesher
+  if(!Msg::GetDebugFiles()) return;
 
   if (gf){
-    FILE* view_c = std::fopen("param_c.pos","w");
-    if(!view_c){
-      Msg::Error("Could not open file 'param_c.pos");
-      return;
-    }
+    FILE* view_c = Msg::OpenDebugFile("param_c-%d.pos", gf->tag());
+    if(!view_c) return;
     fprintf(view_c,"View \"paramC\"{\n");
     std::set<MEdge,Less_Edge> all;
     std::list<BDS_Face*>::iterator tit = t.begin();
@@ -16,7 +16,7 @@
 #include "common/OS.h"
 #include "Mesh/GMSH/Field.h"
 #include "Mesh/GMSH/MElement.h"
-#include "Mesh/GMSH/MElementOctree.h"
+#include "Mesh/GMSH/MElementGrid.h"
 #include "Mesh/GMSH/MLine.h"
 #include "Mesh/GMSH/MTriangle.h"
 #include "Mesh/GMSH/MQuadrangle.h"
@@ -54,8 +54,9 @@ void backgroundMesh::unset()
 }
 
 backgroundMesh::backgroundMesh(GFace *_gf, bool cfd)
+  : _grid(0)
 #if defined(HAVE_ANN)
-  : _octree(0), uv_kdtree(0), nodes(0), angle_nodes(0), angle_kdtree(0)
+  , uv_kdtree(0), nodes(0), angle_nodes(0), angle_kdtree(0)
 #endif
 {
 
@@ -112,7 +113,7 @@ backgroundMesh::backgroundMesh(GFace *_gf, bool cfd)
 #endif
 
   // build a search structure
-  _octree = new MElementOctree(_triangles);
+  _grid = new MElementGrid(_triangles);
 
   // compute the mesh sizes at nodes
   if (CTX::instance()->mesh.lcFromPoints){
@@ -138,7 +139,7 @@ backgroundMesh::~backgroundMesh()
 {
   for (unsigned int i = 0; i < _vertices.size(); i++) delete _vertices[i];
   for (unsigned int i = 0; i < _triangles.size(); i++) delete _triangles[i];
-  if (_octree)delete _octree;
+  if (_grid)delete _grid;
 #if defined(HAVE_ANN)
   if(uv_kdtree) delete uv_kdtree;
   if(angle_kdtree) delete angle_kdtree;
@@ -380,7 +381,7 @@ double backgroundMesh::getSmoothness(MElement *e)
 
 double backgroundMesh::getSmoothness(double u, double v, double w)
 {
-  MElement *e = _octree->find(u, v, w, 2, true);
+  MElement *e = _grid->find(u, v);
   if (!e) return -1.0;
   MVertex *v0 = e->getVertex(0);
   MVertex *v1 = e->getVertex(1);
@@ -422,13 +423,13 @@ void backgroundMesh::propagateCrossField(GFace *_gf)
     if (++ITER > 0)break;
   }
   //  printf("converged in %d iterations\n", ITER);
-#if 0 // debug print
-  char name[256];
-  sprintf(name, "cross-%d-%d.pos", _gf->tag(), ITER);
-  print(name, 0, 1);
-  sprintf(name, "smooth-%d-%d.pos", _gf->tag(), ITER);
-  print(name, _gf, 2);
-#endif
+  if(Msg::GetDebugFiles()){
+    char name[256];
+    sprintf(name, "cross-%d-%d.pos", _gf->tag(), ITER);
+    print(name, 0, 1);
+    sprintf(name, "smooth-%d-%d.pos", _gf->tag(), ITER);
+    print(name, _gf, 2);
+  }
 }
 
 void backgroundMesh::propagateCrossFieldHJ(GFace *_gf)
@@ -499,6 +500,9 @@ void backgroundMesh::propagateCrossField(GFace *_gf, simpleFunction<double> *ONE
 
 void backgroundMesh::updateSizes(GFace *_gf)
 {
+  // the sizes of the vertices of the face are computed at once
+  std::vector<std::map<MVertex*,double>::iterator> inFace;
+  std::vector<double> fu, fv, fx, fy, fz;
   std::map<MVertex*,double>::iterator itv = _sizes.begin();
   for ( ; itv != _sizes.end(); ++itv){
     SPoint2 p;
@@ -514,13 +518,26 @@ void backgroundMesh::updateSizes(GFace *_gf)
     }
     else{
       reparamMeshVertexOnFace(v, _gf, p);
-      lc = BGM_MeshSize(_gf, p.x(), p.y(), v->x(), v->y(), v->z());
+      inFace.push_back(itv);
+      fu.push_back(p.x()); fv.push_back(p.y());
+      fx.push_back(v->x()); fy.push_back(v->y()); fz.push_back(v->z());
+      continue;
     }
     // printf("2D -- %g %g 3D -- %g %g\n",p.x(),p.y(),v->x(),v->y());
     itv->second = std::min(lc,itv->second);
     itv->second = std::max(itv->second,  CTX::instance()->mesh.lcMin);
     itv->second = std::min(itv->second,  CTX::instance()->mesh.lcMax);
   }
+  if (!inFace.empty()){
+    std::vector<double> lc(inFace.size());
+    BGM_MeshSize(_gf, inFace.size(), &fu[0], &fv[0], &fx[0], &fy[0], &fz[0], &lc[0]);
+    for (unsigned int i = 0; i < inFace.size(); i++){
+      itv = inFace[i];
+      itv->second = std::min(lc[i],itv->second);
+      itv->second = std::max(itv->second,  CTX::instance()->mesh.lcMin);
+      itv->second = std::min(itv->second,  CTX::instance()->mesh.lcMax);
+    }
+  }
   // do not allow large variations in the size field
   // (Int. J. Numer. Meth. Engng. 43, 1143-1165 (1998) MESH GRADATION
   // CONTROL, BOROUCHAKI, HECHT, FREY)
@@ -548,14 +565,14 @@ void backgroundMesh::updateSizes(GFace *_gf)
 
 bool backgroundMesh::inDomain (double u, double v, double w) const
 {
-  return _octree->find(u, v, w, 2, true) != 0;
+  return _grid->find(u, v) != 0;
 }
 
 double backgroundMesh::operator() (double u, double v, double w) const
 {
   double uv[3] = {u, v, w};
   double uv2[3];
-  MElement *e = _octree->find(u, v, w, 2, true);
+  MElement *e = _grid->find(u, v);
   if (!e) {
 #if defined(HAVE_ANN)
     //printf("BGM octree not found --> find in kdtree \n");
@@ -566,10 +583,10 @@ double backgroundMesh::operator() (double u, double v, double w) const
     SPoint3  p2(nodes[index[1]][0], nodes[index[1]][1], nodes[index[1]][2]);
     SPoint3 pnew; double d;
     signedDistancePointLine(p1, p2, SPoint3(u, v, 0.), d, pnew);
-    e = _octree->find(pnew.x(), pnew.y(), 0.0, 2, true);
+    e = _grid->find(pnew.x(), pnew.y());
 #endif
     if(!e){
-      Msg::Error("BGM octree: cannot find UVW=%g %g %g", u, v, w);
+      Msg::Error("BGM grid: cannot find UVW=%g %g %g", u, v, w);
       return -1000.0;//0.4;
     }
   }
@@ -586,7 +603,7 @@ double backgroundMesh::getAngle(double u, double v, double w) const
   // we can use closest point for computing
   // cross field angles : this allow NOT to
   // generate a spurious mesh and solve a PDE
-  if (!_octree){
+  if (!_grid){
 #if defined(HAVE_ANN)
     double angle = 0.;
     if(angle_kdtree->nPoints() >= _NBANN){
@@ -617,7 +634,7 @@ double backgroundMesh::getAngle(double u, double v, double w) const
 
   double uv[3] = {u, v, w};
   double uv2[3];
-  MElement *e = _octree->find(u, v, w, 2, true);
+  MElement *e = _grid->find(u, v);
   if (!e) {
 #if defined(HAVE_ANN)
     //printf("BGM octree not found --> find in kdtree \n");
@@ -628,10 +645,10 @@ double backgroundMesh::getAngle(double u, double v, double w) const
     SPoint3  p2(nodes[index[1]][0], nodes[index[1]][1], nodes[index[1]][2]);
     SPoint3 pnew; double d;
     signedDistancePointLine(p1, p2, SPoint3(u, v, 0.), d, pnew);
-    e = _octree->find(pnew.x(), pnew.y(), 0., 2, true);
+    e = _grid->find(pnew.x(), pnew.y());
 #endif
     if(!e){
-      Msg::Error("BGM octree angle: cannot find UVW=%g %g %g", u, v, w);
+      Msg::Error("BGM grid angle: cannot find UVW=%g %g %g", u, v, w);
       return -1000.0;
     }
   }
@@ -702,18 +719,18 @@ void backgroundMesh::print(const std::string &filename, GFace *gf,
   fclose(f);*/
 }
 
-MElementOctree* backgroundMesh::get_octree(){
+MElementGrid* backgroundMesh::get_grid(){
 
-  return _octree;
+  return _grid;
 }
 
 MElement *backgroundMesh::getMeshElementByCoord(double u, double v, double w, bool strict)
 {
-  if(!_octree){
-	Msg::Debug("Rebuilding BackgroundMesh element octree");
-    _octree = new MElementOctree(_triangles);
+  if(!_grid){
+	Msg::Debug("Rebuilding BackgroundMesh element grid");
+    _grid = new MElementGrid(_triangles);
   }
-  return _octree->find(u,v,w, 2, strict);
+  return _grid->find(u, v, strict);
 }
 
 backgroundMesh* backgroundMesh::_current = 0;
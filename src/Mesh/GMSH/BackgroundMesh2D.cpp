@@ -15,6 +15,7 @@
 #include "Mesh/GMSH/GFaceCompound.h"
 #include "Mesh/GMSH/MElement.h"
 #include "Mesh/GMSH/MElementOctree.h"
+#include "Mesh/GMSH/MElementGrid.h"
 #include "Mesh/GMSH/MTriangle.h"
 #include "Mesh/GMSH/MVertex.h"
 #include "Mesh/GMSH/Numeric.h"
@@ -100,6 +101,15 @@ MElementOctree* backgroundMesh2D::getOctree()
   return octree;
 }
 
+const MElement* backgroundMesh2D::findElement(double u, double v, double w, bool strict)
+{
+  if(!grid){
+    Msg::Debug("Rebuilding BackgroundMesh element grid");
+    grid = new MElementGrid(elements);
+  }
+  return grid->find(u, v, strict);
+}
+
 const MElement* backgroundMesh2D::getElement(unsigned int i)const
 {
   return elements[i];
@@ -135,6 +145,8 @@ void backgroundMesh2D::unset()
   for (unsigned int i = 0; i < getNumMeshElements(); i++) delete elements[i];
   if (octree)delete octree;
   octree=NULL;
+  if (grid)delete grid;
+  grid=NULL;
 }
 
 void backgroundMesh2D::create_mesh_copy()
@@ -181,7 +193,7 @@ GPoint backgroundMesh2D::get_GPoint_from_MVertex(const MVertex *v)const
 }
 
 
-backgroundMesh2D::backgroundMesh2D(GFace *_gf, bool erase_2D3D):BGMBase(2,_gf),sizeFactor(1.)
+backgroundMesh2D::backgroundMesh2D(GFace *_gf, bool erase_2D3D):BGMBase(2,_gf),grid(NULL),sizeFactor(1.)
 {
   reset(erase_2D3D);
 
@@ -340,6 +352,10 @@ inline double myAngle (const SVector3 &a, const SVector3 &b, const SVector3 &d){
 
 void backgroundMesh2D::updateSizes()
 {
+  // the sizes of the vertices of the face are computed at once
+  GFace *face = 0;
+  std::vector<DoubleStorageType::iterator> inFace;
+  std::vector<double> fu, fv, fx, fy, fz;
   DoubleStorageType::iterator itv = sizeField.begin();
   for ( ; itv != sizeField.end(); ++itv){
     SPoint2 p;
@@ -354,19 +370,32 @@ void backgroundMesh2D::updateSizes()
       lc = sizeFactor * BGM_MeshSize(v->onWhat(), u, 0, v->x(), v->y(), v->z());
     }
     else{
-      GFace *face = dynamic_cast<GFace*>(gf);
+      face = dynamic_cast<GFace*>(gf);
       if(!face){
         Msg::Error("Entity is not a face in background mesh");
         return;
       }
       reparamMeshVertexOnFace(v, face, p);
-      lc = sizeFactor * BGM_MeshSize(face, p.x(), p.y(), v->x(), v->y(), v->z());
+      inFace.push_back(itv);
+      fu.push_back(p.x()); fv.push_back(p.y());
+      fx.push_back(v->x()); fy.push_back(v->y()); fz.push_back(v->z());
+      continue;
     }
     // printf("2D -- %g %g 3D -- %g %g\n",p.x(),p.y(),v->x(),v->y());
     itv->second = min(lc,itv->second);
     itv->second = max(itv->second,  sizeFactor * CTX::instance()->mesh.lcMin);
     itv->second = min(itv->second,  sizeFactor * CTX::instance()->mesh.lcMax);
   }
+  if (!inFace.empty()){
+    std::vector<double> lc(inFace.size());
+    BGM_MeshSize(face, inFace.size(), &fu[0], &fv[0], &fx[0], &fy[0], &fz[0], &lc[0]);
+    for (unsigned int i = 0; i < inFace.size(); i++){
+      itv = inFace[i];
+      itv->second = min(sizeFactor * lc[i],itv->second);
+      itv->second = max(itv->second,  sizeFactor * CTX::instance()->mesh.lcMin);
+      itv->second = min(itv->second,  sizeFactor * CTX::instance()->mesh.lcMax);
+    }
+  }
   // do not allow large variations in the size field
   // (Int. J. Numer. Meth. Engng. 43, 1143-1165 (1998) MESH GRADATION
   // CONTROL, BOROUCHAKI, HECHT, FREY)
@@ -302,6 +302,40 @@ double BGM_MeshSize(GEntity *ge, double U, double V,
 //	return lc * CTX::instance()->mesh.lcFactor;
 }
 
+// same as above at n points, the background field is evaluated at all the
+// points at once
+void BGM_MeshSize(GEntity *ge, int n, const double *U, const double *V,
+                  const double *X, const double *Y, const double *Z, double *lc)
+{
+  if(n <= 0) return;
+  const double l1 = CTX::instance()->lc;
+  const double l5 = ge->getMeshSize();
+  const bool fromPoints = CTX::instance()->mesh.lcFromPoints && ge->dim() < 2;
+  const bool fromCurvature = CTX::instance()->mesh.lcFromCurvature && ge->dim() < 3;
+
+  // lc from fields
+  std::vector<double> l4(n, MAX_LC);
+  FieldManager *fields = ge->model()->getFields();
+  if(fields->getBackgroundField() > 0){
+    Field *f = fields->get(fields->getBackgroundField());
+    if(f) (*f)(n, X, Y, Z, &l4[0], ge);
+  }
+
+  for(int i = 0; i < n; i++){
+    const double l2 = fromPoints ? LC_MVertex_PNTS(ge, U[i], V[i]) : MAX_LC;
+    const double l3 = fromCurvature ? LC_MVertex_CURV(ge, U[i], V[i]) : MAX_LC;
+    double l = std::min(std::min(std::min(std::min(l1, l2), l3), l4[i]), l5);
+    l = std::max(l, CTX::instance()->mesh.lcMin);
+    l = std::min(l, CTX::instance()->mesh.lcMax);
+    if(l <= 0.){
+      Msg::Error("Wrong mesh element size lc = %g (lcmin = %g, lcmax = %g)",
+                 l, CTX::instance()->mesh.lcMin, CTX::instance()->mesh.lcMax);
+      l = l1;
+    }
+    lc[i] = l * CTX::instance()->mesh.lcFactor * ge->meshAttributes.meshSize;
+  }
+}
+
 // anisotropic version of the background field
 SMetric3 BGM_MeshMetric(GEntity *ge,
                         double U, double V,
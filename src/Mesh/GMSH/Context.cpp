@@ -107,6 +107,7 @@ CTX::CTX()
   mesh.lcIntegrationPrecision = mesh.randFactor = 0;
   mesh.algo2d = mesh.algo3d = mesh.algoRecombine = mesh.recombineAll = 0;
   mesh.recombine3DAll = mesh.algoSubdivide = mesh.meshOnlyVisible = 0;
+  mesh.meshOnlyEmpty = 0;
   mesh.minCircPoints = mesh.order = 0;
   mesh.secondOrderLinear = mesh.secondOrderIncomplete = 0;
   mesh.preserveNumberingMsh2 = 1;
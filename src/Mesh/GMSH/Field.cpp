@@ -68,6 +68,13 @@ FieldOption *Field::getOption(const std::string optionName)
   return it->second;
 }
 
+void Field::operator() (int n, const double *x, const double *y,
+                        const double *z, double *val, GEntity *ge)
+{
+  for(int i = 0; i < n; i++)
+    val[i] = (*this)(x[i], y[i], z[i], ge);
+}
+
 void FieldManager::reset()
 {
   for(std::map<int, Field *>::iterator it = begin(); it != end(); it++) {
@@ -685,7 +692,24 @@ class ThresholdField : public Field
   {
     Field *field = GModel::current()->getFields()->get(iField);
     if(!field || iField == id) return MAX_LC;
-    double r = ((*field) (x, y, z) - dmin) / (dmax - dmin);
+    return size((*field) (x, y, z));
+  }
+  void operator() (int n, const double *x, const double *y, const double *z,
+                   double *val, GEntity *ge=0)
+  {
+    Field *field = GModel::current()->getFields()->get(iField);
+    if(!field || iField == id){
+      std::fill(val, val + n, MAX_LC);
+      return;
+    }
+    (*field) (n, x, y, z, val);
+    for(int i = 0; i < n; i++)
+      val[i] = size(val[i]);
+  }
+ private:
+  double size(double d) const
+  {
+    double r = (d - dmin) / (dmax - dmin);
     r = std::max(std::min(r, 1.), 0.);
     double lc;
     if(stopAtDistMax && r >= 1.){
@@ -998,6 +1022,33 @@ class MathEvalExpression
     else
       return MAX_LC;
   }
+  // the fields of the expression are evaluated at all the points first, then
+  // the expression is evaluated point by point with the same buffers
+  void evaluate(int n, const double *x, const double *y, const double *z,
+                double *val)
+  {
+    if(!_f){
+      std::fill(val, val + n, MAX_LC);
+      return;
+    }
+    std::vector<std::vector<double> > fieldValues(_fields.size());
+    int i = 0;
+    for(std::set<int>::iterator it = _fields.begin(); it != _fields.end(); it++){
+      Field *field = GModel::current()->getFields()->get(*it);
+      fieldValues[i].resize(n, MAX_LC);
+      if(field) (*field)(n, x, y, z, &fieldValues[i][0]);
+      i++;
+    }
+    std::vector<double> values(3 + _fields.size()), res(1);
+    for(int k = 0; k < n; k++){
+      values[0] = x[k];
+      values[1] = y[k];
+      values[2] = z[k];
+      for(unsigned int j = 0; j < fieldValues.size(); j++)
+        values[3 + j] = fieldValues[j][k];
+      val[k] = _f->eval(values, res) ? res[0] : MAX_LC;
+    }
+  }
 };
 
 class MathEvalExpressionAniso
@@ -1103,6 +1154,18 @@ class MathEvalField : public Field
     }
     return expr.evaluate(x, y, z);
   }
+  void operator() (int n, const double *x, const double *y, const double *z,
+                   double *val, GEntity *ge=0)
+  {
+    if(n <= 0) return;
+    if(update_needed) {
+      if(!expr.set_function(f))
+        Msg::Error("Field %i: Invalid matheval expression \"%s\"",
+                   this->id, f.c_str());
+      update_needed = false;
+    }
+    expr.evaluate(n, x, y, z, val);
+  }
   const char *getName()
   {
     return "MathEval";
@@ -1738,6 +1801,31 @@ class MinField : public Field
     }
     return v;
   }
+  void operator() (int n, const double *x, const double *y, const double *z,
+                   double *val, GEntity *ge=0)
+  {
+    if(n <= 0) return;
+    std::fill(val, val + n, MAX_LC);
+    std::vector<double> fv(n);
+    for(std::list<int>::iterator it = idlist.begin(); it != idlist.end(); it++) {
+      Field *f = (GModel::current()->getFields()->get(*it));
+      if(!f || *it == id) continue;
+      if (f->isotropic())
+        (*f) (n, x, y, z, &fv[0], ge);
+      else{
+        for(int i = 0; i < n; i++){
+          SMetric3 ff;
+          (*f) (x[i], y[i], z[i], ff, ge);
+          fullMatrix<double> V(3,3);
+          fullVector<double> S(3);
+          ff.eig(V, S, 1);
+          fv[i] = sqrt(1./S(2));
+        }
+      }
+      for(int i = 0; i < n; i++)
+        val[i] = std::min(val[i], fv[i]);
+    }
+  }
   const char *getName()
   {
     return "Min";
@@ -1777,22 +1865,58 @@ class MaxField : public Field
     }
     return v;
   }
+  void operator() (int n, const double *x, const double *y, const double *z,
+                   double *val, GEntity *ge=0)
+  {
+    if(n <= 0) return;
+    std::fill(val, val + n, -MAX_LC);
+    std::vector<double> fv(n);
+    for(std::list<int>::iterator it = idlist.begin(); it != idlist.end(); it++) {
+      Field *f = (GModel::current()->getFields()->get(*it));
+      if(!f || *it == id) continue;
+      if (f->isotropic())
+        (*f) (n, x, y, z, &fv[0], ge);
+      else{
+        for(int i = 0; i < n; i++){
+          SMetric3 ff;
+          (*f) (x[i], y[i], z[i], ff, ge);
+          fullMatrix<double> V(3,3);
+          fullVector<double> S(3);
+          ff.eig(V, S, 1);
+          fv[i] = sqrt(1./S(0));
+        }
+      }
+      for(int i = 0; i < n; i++)
+        val[i] = std::max(val[i], fv[i]);
+    }
+  }
   const char *getName()
   {
     return "Max";
   }
 };
 
-/*
-class RestrictField : public FieldannDeallocPts
+class RestrictField : public Field
 {
   int iField;
   std::list<int> vertices, edges, faces, regions;
+  bool _inside(GEntity *ge)
+  {
+    return
+      (ge->dim() == 0 && std::find
+       (vertices.begin(), vertices.end(), ge->tag()) != vertices.end()) ||
+      (ge->dim() == 1 && std::find
+       (edges.begin(), edges.end(), ge->tag()) != edges.end()) ||
+      (ge->dim() == 2 && std::find
+       (faces.begin(), faces.end(), ge->tag()) != faces.end()) ||
+      (ge->dim() == 3 && std::find
+       (regions.begin(), regions.end(), ge->tag()) != regions.end());
+  }
  public:
   RestrictField()
   {
     iField = 1;
-//    options["IField"] = new FieldOptionInt(iField, "Field index");
+    options["IField"] = new FieldOptionInt(iField, "Field index");
     options["VerticesList"] = new FieldOptionList(vertices, "Point indices");
     options["EdgesList"] = new FieldOptionList(edges, "Curve indices");
     options["FacesList"] = new FieldOptionList(faces, "Surface indices");
@@ -1803,29 +1927,33 @@ class RestrictField : public FieldannDeallocPts
     return "Restrict the application of a field to a given list of geometrical "
       "points, curves, surfaces or volumes.";
   }
-  
   double operator() (double x, double y, double z, GEntity *ge=0)
   {
     Field *f = (GModel::current()->getFields()->get(iField));
     if(!f || iField == id) return MAX_LC;
     if(!ge) return (*f) (x, y, z);
-    if((ge->dim() == 0 && std::find
-        (vertices.begin(), vertices.end(), ge->tag()) != vertices.end()) ||
-       (ge->dim() == 1 && std::find
-        (edges.begin(), edges.end(), ge->tag()) != edges.end()) ||
-       (ge->dim() == 2 && std::find
-        (faces.begin(), faces.end(), ge->tag()) != faces.end()) ||
-       (ge->dim() == 3 && std::find
-        (regions.begin(), regions.end(), ge->tag()) != regions.end()))
+    if(_inside(ge))
       return (*f) (x, y, z);
     return MAX_LC;
   }
+  // the points of a batch all belong to the same entity
+  void operator() (int n, const double *x, const double *y, const double *z,
+                   double *val, GEntity *ge=0)
+  {
+    if(n <= 0) return;
+    Field *f = (GModel::current()->getFields()->get(iField));
+    if(!f || iField == id || (ge && !_inside(ge)))
+      std::fill(val, val + n, MAX_LC);
+    else
+      (*f) (n, x, y, z, val);
+  }
   const char *getName()
   {
     return "Restrict";
   }
 };
 
+/*
 #if defined(HAVE_ANN)
 struct AttractorInfo{
   AttractorInfo (int a=0, int b=0, double c=0, double d=0)
@@ -2305,7 +2433,7 @@ public:
   }
   const char *getName()
   {
-    return "DistanceField";
+    return "Distance";
   }
   std::string getDescription()
   {
@@ -2322,6 +2450,9 @@ public:
       _zField = _zFieldId >= 0 ? (GModel::current()->getFields()->get(_zFieldId)) : NULL;
 
       std::vector<SPoint3> &points = P.pts;
+      points.clear();
+      if(index) delete index;
+      index = NULL;
       for(std::list<int>::iterator it = faces_id.begin();
           it != faces_id.end(); ++it) {
 	GFace *f = GModel::current()->getFaceByTag(*it);
@@ -2373,13 +2504,51 @@ public:
       
       //      printf("Constructing kd-tree with %lu points\n",points.size());
       
-      index = new my_kd_tree_t(3 , pc2kd, KDTreeSingleIndexAdaptorParams(10) );
-      index->buildIndex();
+      if(points.size()){
+        index = new my_kd_tree_t(3 , pc2kd, KDTreeSingleIndexAdaptorParams(10) );
+        index->buildIndex();
+      }
       update_needed=false;
     }
   }
   
   virtual double operator() (double X, double Y, double Z, GEntity *ge=0)
+  {
+    if(update_needed){
+#if defined(_OPENMP)
+#pragma omp critical
+#endif
+      {
+        update();
+      }
+    }
+    if(!index) return MAX_LC;
+    return distance(X, Y, Z);
+  }
+  // the queries only read the kd-tree, they are shared between the threads
+  virtual void operator() (int n, const double *x, const double *y,
+                           const double *z, double *val, GEntity *ge=0)
+  {
+    if(update_needed){
+#if defined(_OPENMP)
+#pragma omp critical
+#endif
+      {
+        update();
+      }
+    }
+    if(!index){
+      std::fill(val, val + n, MAX_LC);
+      return;
+    }
+#if defined(_OPENMP)
+#pragma omp parallel for schedule(static) if(n > 1000)
+#endif
+    for(int i = 0; i < n; i++)
+      val[i] = distance(x[i], y[i], z[i]);
+  }
+ private:
+  double distance(double X, double Y, double Z) const
   {
     double query_pt[3] = {X,Y,Z};
     const size_t num_results = 1;
@@ -2393,6 +2562,186 @@ public:
 };
 //------------------------ N A N O F L A N N -------------------------------------------------------------------------
 
+// Memoisation of a field of a planar model on a uniform grid. The grid covers
+// the bounding box of the model and is split into blocks of nodes; the field
+// is evaluated at all the nodes of a block (with the batch evaluation) the
+// first time a point of the block is queried, the queries are then bilinear
+// interpolations. Points outside of the grid are passed to the field.
+class CacheField : public Field
+{
+  int iField;
+  double size;
+  static const int BLOCK = 16;
+  double _xmin, _ymin, _h;
+  int _nx, _ny, _nbx, _nby;
+  std::vector<std::vector<double> > _blocks;
+  void _fill(Field *field, const std::vector<int> &blocks)
+  {
+    const int nb = BLOCK * BLOCK;
+    std::vector<double> x(blocks.size() * nb), y(x.size()), z(x.size(), 0.);
+    for(unsigned int k = 0; k < blocks.size(); k++){
+      const int bx = blocks[k] % _nbx, by = blocks[k] / _nbx;
+      for(int j = 0; j < BLOCK; j++)
+        for(int i = 0; i < BLOCK; i++){
+          x[k * nb + j * BLOCK + i] = _xmin + (bx * BLOCK + i) * _h;
+          y[k * nb + j * BLOCK + i] = _ymin + (by * BLOCK + j) * _h;
+        }
+    }
+    std::vector<double> val(x.size());
+    (*field)(x.size(), &x[0], &y[0], &z[0], &val[0]);
+    for(unsigned int k = 0; k < blocks.size(); k++)
+      _blocks[blocks[k]].assign(val.begin() + k * nb, val.begin() + (k + 1) * nb);
+  }
+  // blocks of the 4 nodes of the cell of a point, -1 if outside of the grid
+  int _cell(double x, double y, int &i, int &j, double &u, double &v) const
+  {
+    const double fx = (x - _xmin) / _h, fy = (y - _ymin) / _h;
+    if(!(fx >= 0. && fx <= _nx - 1 && fy >= 0. && fy <= _ny - 1)) return -1;
+    i = std::min((int)fx, _nx - 2);
+    j = std::min((int)fy, _ny - 2);
+    u = fx - i;
+    v = fy - j;
+    return 0;
+  }
+  double _node(int i, int j) const
+  {
+    return _blocks[(j / BLOCK) * _nbx + i / BLOCK][(j % BLOCK) * BLOCK + i % BLOCK];
+  }
+  double _interpolate(int i, int j, double u, double v) const
+  {
+    return (1. - u) * (1. - v) * _node(i, j) + u * (1. - v) * _node(i + 1, j) +
+      (1. - u) * v * _node(i, j + 1) + u * v * _node(i + 1, j + 1);
+  }
+  void _missing(int i, int j, std::vector<int> &blocks) const
+  {
+    for(int dj = 0; dj < 2; dj++)
+      for(int di = 0; di < 2; di++){
+        const int b = ((j + dj) / BLOCK) * _nbx + (i + di) / BLOCK;
+        if(_blocks[b].empty() &&
+           std::find(blocks.begin(), blocks.end(), b) == blocks.end())
+          blocks.push_back(b);
+      }
+  }
+ public:
+  CacheField() : _xmin(0.), _ymin(0.), _h(1.), _nx(0), _ny(0), _nbx(0), _nby(0)
+  {
+    iField = 1;
+    size = 0.;
+    update_needed = true;
+    options["IField"] = new FieldOptionInt
+      (iField, "Index of the field to evaluate", &update_needed);
+    options["Size"] = new FieldOptionDouble
+      (size, "Spacing of the grid (0 for 1/512 of the size of the model)",
+       &update_needed);
+  }
+  const char *getName()
+  {
+    return "Cache";
+  }
+  std::string getDescription()
+  {
+    return "Interpolate Field[IField] on a uniform grid in the plane z = 0. "
+      "The field is evaluated once at the nodes of the grid, the first time "
+      "they are needed, and the grid is kept until an option is changed.";
+  }
+  void update()
+  {
+    if(!update_needed) return;
+    SBoundingBox3d bb = GModel::current()->bounds();
+    _blocks.clear();
+    _nx = _ny = _nbx = _nby = 0;
+    update_needed = false;
+    if(bb.empty()) return;
+    const double lx = bb.max().x() - bb.min().x();
+    const double ly = bb.max().y() - bb.min().y();
+    _h = size > 0. ? size : std::max(lx, ly) / 512.;
+    // at most about 4 millions nodes
+    const double maxNodes = 4.e6;
+    if(_h <= 0. || (lx / _h + 2.) * (ly / _h + 2.) > maxNodes){
+      _h = std::max(sqrt(lx * ly / maxNodes), std::max(lx, ly) / 2048.);
+      Msg::Info("Field %i: grid spacing increased to %g", id, _h);
+    }
+    if(_h <= 0.) return;
+    _xmin = bb.min().x() - _h;
+    _ymin = bb.min().y() - _h;
+    _nx = (int)(lx / _h) + 3;
+    _ny = (int)(ly / _h) + 3;
+    _nbx = (_nx + BLOCK - 1) / BLOCK;
+    _nby = (_ny + BLOCK - 1) / BLOCK;
+    _blocks.resize(_nbx * _nby);
+  }
+  double operator() (double x, double y, double z, GEntity *ge=0)
+  {
+    Field *field = GModel::current()->getFields()->get(iField);
+    if(!field || iField == id) return MAX_LC;
+    int i, j;
+    double u, v, val;
+#if defined(_OPENMP)
+#pragma omp critical(CacheField)
+#endif
+    {
+      update();
+      if(_nx < 2 || _cell(x, y, i, j, u, v) < 0)
+        i = -1;
+      else{
+        std::vector<int> blocks;
+        _missing(i, j, blocks);
+        if(blocks.size()) _fill(field, blocks);
+        val = _interpolate(i, j, u, v);
+      }
+    }
+    return i < 0 ? (*field)(x, y, z) : val;
+  }
+  void operator() (int n, const double *x, const double *y, const double *z,
+                   double *val, GEntity *ge=0)
+  {
+    Field *field = GModel::current()->getFields()->get(iField);
+    if(!field || iField == id){
+      std::fill(val, val + n, MAX_LC);
+      return;
+    }
+    if(n <= 0) return;
+    std::vector<int> cell(2 * n);
+    std::vector<double> uv(2 * n);
+    std::vector<int> outside;
+#if defined(_OPENMP)
+#pragma omp critical(CacheField)
+#endif
+    {
+      update();
+      std::vector<int> blocks;
+      for(int k = 0; k < n; k++){
+        if(_nx < 2 || _cell(x[k], y[k], cell[2 * k], cell[2 * k + 1],
+                            uv[2 * k], uv[2 * k + 1]) < 0){
+          cell[2 * k] = -1;
+          outside.push_back(k);
+        }
+        else
+          _missing(cell[2 * k], cell[2 * k + 1], blocks);
+      }
+      if(blocks.size()) _fill(field, blocks);
+    }
+    // the blocks of the points are filled and are not modified anymore
+#if defined(_OPENMP)
+#pragma omp parallel for schedule(static) if(n > 1000)
+#endif
+    for(int k = 0; k < n; k++)
+      if(cell[2 * k] >= 0)
+        val[k] = _interpolate(cell[2 * k], cell[2 * k + 1], uv[2 * k], uv[2 * k + 1]);
+    if(outside.size()){
+      const int m = outside.size();
+      std::vector<double> xo(m), yo(m), zo(m), vo(m);
+      for(int k = 0; k < m; k++){
+        xo[k] = x[outside[k]];
+        yo[k] = y[outside[k]];
+        zo[k] = z[outside[k]];
+      }
+      (*field)(m, &xo[0], &yo[0], &zo[0], &vo[0]);
+      for(int k = 0; k < m; k++) val[outside[k]] = vo[k];
+    }
+  }
+};
+
 
 class OctreeField : public Field {
   // octree field
@@ -2914,8 +3263,9 @@ FieldManager::FieldManager()
 #if defined(HAVE_ANN)
   map_type_name["Octree"] = new FieldFactoryT<OctreeField>();
 #endif
- // map_type_name["Distance"] = new FieldFactoryT<DistanceField>();
-//  map_type_name["Restrict"] = new FieldFactoryT<RestrictField>();
+  map_type_name["Distance"] = new FieldFactoryT<DistanceField>();
+  map_type_name["Cache"] = new FieldFactoryT<CacheField>();
+  map_type_name["Restrict"] = new FieldFactoryT<RestrictField>();
   map_type_name["Min"] = new FieldFactoryT<MinField>();
   map_type_name["MinAniso"] = new FieldFactoryT<MinAnisoField>();
   map_type_name["IntersectAniso"] = new FieldFactoryT<IntersectAnisoField>();
@@ -2930,6 +3280,9 @@ FieldManager::FieldManager()
 #if defined(HAVE_ANN)
   map_type_name["Attractor"] = new FieldFactoryT<AttractorField>();
   map_type_name["AttractorAnisoCurve"] = new FieldFactoryT<AttractorAnisoCurveField>();
+#else
+  // same options as the attractor, the distances are computed with nanoflann
+  map_type_name["Attractor"] = new FieldFactoryT<DistanceField>();
 #endif
   map_type_name["MaxEigenHessian"] = new FieldFactoryT<MaxEigenHessianField>();
   _background_field = -1;
@@ -1460,7 +1460,7 @@ void GFace::lloyd(int nbiter, int infn)
 {
 #if defined(HAVE_MESH) && defined(HAVE_BFGS)
   smoothing s = smoothing(nbiter,infn);
-  s.optimize_face(this);
+  s.optimize_face_lpcvt(this);
   //lloydAlgorithm algo(nbiter, infn);
   //algo(this);
 #endif
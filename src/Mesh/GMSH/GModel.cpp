@@ -1105,12 +1105,12 @@ int GModel::optimizeMesh(const std::string &how)
 
 int GModel::partitionMesh(int numPart)
 {
-#if defined(HAVE_MESH) && (defined(HAVE_METIS) || defined(HAVE_CHACO))
+#if defined(HAVE_MESH)
+  // without METIS or Chaco, the mesh is partitioned by coordinate bisection
   opt_mesh_partition_num(0, GMSH_SET, numPart);
-  PartitionMesh(this, CTX::instance()->partitionOptions);
-  return 1;
+  return PartitionMesh(this, CTX::instance()->partitionOptions) ? 0 : 1;
 #else
-	OmniFEMMsg::instance()->MsgError("Mesh module not compiled or no METIS or no CHACO");
+	OmniFEMMsg::instance()->MsgError("Mesh module not compiled");
   return 0;
 #endif
 }
@@ -4150,7 +4150,7 @@ void GModel::classifyFaces(std::set<GFace*> &_faces)
 
 void GModel::createPartitionBoundaries(int createGhostCells, int createAllDims)
 {
-#if (defined(HAVE_CHACO) || defined(HAVE_METIS)) && defined(HAVE_MESH)
+#if defined(HAVE_MESH)
   CreatePartitionBoundaries(this, createGhostCells, createAllDims);
 #endif
 }
@@ -60,7 +60,7 @@ static int SphereInEle(void *a, double*c)
 
 static void printNodes(std::set<MVertex *> myNodes)
 {
-  FILE * xyz = std::fopen("myNodes.pos","w");
+  FILE * xyz = Msg::OpenDebugFile("myNodes.pos");
   if(xyz){
     fprintf(xyz,"View \"\"{\n");
     for(std::set<MVertex *>::iterator itv = myNodes.begin(); itv !=myNodes.end(); ++itv){
@@ -74,7 +74,7 @@ static void printNodes(std::set<MVertex *> myNodes)
 
 static void exportParametrizedMesh(fullMatrix<double> &UV, int nbNodes)
 {
-  FILE *f = std::fopen("UV.pos", "w");
+  FILE *f = Msg::OpenDebugFile("UV.pos");
   if(f){
     fprintf(f,"View  \" uv \" {\n");
     Msg::Info("*** RBF exporting 'UV.pos' ");
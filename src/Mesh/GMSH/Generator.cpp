@@ -14,6 +14,7 @@
 #include "Mesh/GMSH/MLine.h"
 #include "Mesh/GMSH/MTriangle.h"
 #include "Mesh/GMSH/MQuadrangle.h"
+#include "Mesh/GMSH/qualityMeasures.h"
 //#include "MTetrahedron.h"
 //#include "MHexahedron.h"
 //include "MPrism.h"
@@ -122,6 +123,33 @@ public:
 };*/
 
 class instance;
+template<class T>
+static void GetGammaMeasure(std::vector<T*> &ele, std::vector<double> &g)
+{
+  g.resize(ele.size());
+  for(unsigned int i = 0; i < ele.size(); i++)
+    g[i] = ele[i]->gammaShapeMeasure();
+}
+
+// triangles and quadrangles are measured in one batch
+static void GetGammaMeasure(std::vector<MTriangle*> &ele, std::vector<double> &g)
+{
+  qmElementArrays arrays;
+  arrays.gather(ele);
+  g.resize(ele.size());
+  qmTriangle::gamma(g.size(), arrays.nodes.data(), arrays.x.data(),
+                    arrays.y.data(), arrays.z.data(), g.data());
+}
+
+static void GetGammaMeasure(std::vector<MQuadrangle*> &ele, std::vector<double> &g)
+{
+  qmElementArrays arrays;
+  arrays.gather(ele);
+  g.resize(ele.size());
+  qmQuadrangle::eta(g.size(), arrays.nodes.data(), arrays.x.data(),
+                    arrays.y.data(), arrays.z.data(), g.data());
+}
+
 template<class T>
 static void GetQualityMeasure(std::vector<T*> &ele,
                               double &gamma, double &gammaMin, double &gammaMax,
@@ -129,8 +157,10 @@ static void GetQualityMeasure(std::vector<T*> &ele,
                               double &minSIGE, double &minSIGEMin, double &minSIGEMax,
                               double quality[3][100])
 {
+  std::vector<double> gammas;
+  GetGammaMeasure(ele, gammas);
   for(unsigned int i = 0; i < ele.size(); i++){
-    double g = ele[i]->gammaShapeMeasure();
+    double g = gammas[i];
     gamma += g;
     gammaMin = std::min(gammaMin, g);
     gammaMax = std::max(gammaMax, g);
@@ -441,8 +471,11 @@ static void Mesh2D(GModel *m)
   OmniFEMMsg::instance()->MsgStatus("Meshing 2D...");
   double t1 = Cpu();
 
+  // the faces that keep their mesh are not smoothed or recombined again
   for(GModel::fiter it = m->firstFace(); it != m->lastFace(); ++it)
-    (*it)->meshStatistics.status = GFace::PENDING;
+    (*it)->meshStatistics.status =
+      (CTX::instance()->mesh.meshOnlyEmpty && (*it)->getNumMeshElements()) ?
+      GFace::DONE : GFace::PENDING;
 
   // boundary layers are special: their generation (including vertices and curve
   // meshes) is global as it depends on a smooth normal field generated from the
@@ -470,7 +503,6 @@ static void Mesh2D(GModel *m)
           backgroundMesh::current()->unset();
 //	   meshGFace mesher(true);
           temp[K]->mesh(true);
-#if defined(HAVE_BFGS)
           if(CTX::instance()->mesh.optimizeLloyd){
             if (temp[K]->geomType()==GEntity::CompoundSurface ||
                 temp[K]->geomType()==GEntity::Plane ||
@@ -489,7 +521,6 @@ static void Mesh2D(GModel *m)
               }
             }
           }
-#endif
 //#if defined(_OPENMP)
 //#pragma omp critical
 //#endif
@@ -513,7 +544,6 @@ static void Mesh2D(GModel *m)
           backgroundMesh::current()->unset();
 	            meshGFace mesher(true);
           (*it)->mesh(true);
-#if defined(HAVE_BFGS)
           if(CTX::instance()->mesh.optimizeLloyd){
             if ((*it)->geomType()==GEntity::CompoundSurface ||
                 (*it)->geomType()==GEntity::Plane ||
@@ -532,7 +562,6 @@ static void Mesh2D(GModel *m)
               }
             }
           }
-#endif
           nPending++;
         }
 		if(!nIter)
@@ -3,6 +3,9 @@
 // See the LICENSE.txt file for license information. Please report all
 // bugs and problems to the public mailing list <gmsh@onelab.info>.
 
+#include <vector>
+#include <algorithm>
+#include <random>
 #include "Mesh/GMSH/SBoundingBox3d.h"
 #include "Mesh/GMSH/MVertex.h"
 #include "Mesh/GMSH/HilbertCurve.h"
@@ -274,3 +277,15 @@ void SortHilbert (std::vector<MVertex*>& v)
   //HilbertSort h;
   h.Apply(v);
 }
+
+void SortBRIO (std::vector<MVertex*>& v)
+{
+  // the rounds of the multiscale sort take the first vertices of the
+  // array. Vertices that come from the boundary are ordered along the
+  // curves, so they are shuffled first for the rounds to be spread over the
+  // whole domain. The seed is fixed so that the mesh does not change from
+  // one run to the next
+  std::mt19937 generator(12345);
+  std::shuffle(v.begin(), v.end(), generator);
+  SortHilbert(v);
+}
@@ -33,6 +33,7 @@
 #include "Mesh/GMSH/Numeric.h"
 #include "Mesh/GMSH/CondNumBasis.h"
 #include "Mesh/GMSH/Context.h"
+#include "Mesh/gmshIO/BufferedWriter.h"
 #include "Mesh/GMSH/qualityMeasuresJacobian.h"
 
 #define SQU(a)      ((a)*(a))
@@ -1051,7 +1052,7 @@ void MElement::writeMSH(FILE *fp, bool binary, int entity,
   }
 }
 
-void MElement::writeMSH2(FILE *fp, double version, bool binary, int num,
+void MElement::writeMSH2(BufferedWriter &out, double version, bool binary, int num,
                          int elementary, int physical, int parentNum,
                          int dom1Num, int dom2Num, std::vector<short> *ghosts)
 {
@@ -1069,19 +1070,19 @@ void MElement::writeMSH2(FILE *fp, double version, bool binary, int num,
     if(poly){
       for (int i = 0; i < getNumChildren() ; i++){
          MElement *t = getChild(i);
-         t->writeMSH2(fp, version, binary, num++, elementary, physical, 0, 0, 0, ghosts);
+         t->writeMSH2(out, version, binary, num++, elementary, physical, 0, 0, 0, ghosts);
       }
       return;
     }
     if(type == MSH_TRI_B){
       MTriangle *t = new MTriangle(getVertex(0), getVertex(1), getVertex(2));
-      t->writeMSH2(fp, version, binary, num++, elementary, physical, 0, 0, 0, ghosts);
+      t->writeMSH2(out, version, binary, num++, elementary, physical, 0, 0, 0, ghosts);
       delete t;
       return;
     }
     if(type == MSH_LIN_B || type == MSH_LIN_C){
       MLine *l = new MLine(getVertex(0), getVertex(1));
-      l->writeMSH2(fp, version, binary, num++, elementary, physical, 0, 0, 0, ghosts);
+      l->writeMSH2(out, version, binary, num++, elementary, physical, 0, 0, 0, ghosts);
       delete l;
       return;
     }
@@ -1090,28 +1091,57 @@ void MElement::writeMSH2(FILE *fp, double version, bool binary, int num,
   if(CTX::instance()->mesh.preserveNumberingMsh2) num = _num;
 
   if(!binary){
-    fprintf(fp, "%d %d", num ? num : _num, type);
-    if(version < 2.0)
-      fprintf(fp, " %d %d %d", abs(physical), elementary, n);
-    else if (version < 2.2)
-      fprintf(fp, " %d %d %d", abs(physical), elementary, _partition);
-    else if(!_partition && !par && !dom)
-      fprintf(fp, " %d %d %d", 2 + par + dom, abs(physical), elementary);
-    else if(!ghosts)
-      fprintf(fp, " %d %d %d 1 %d", 4 + par + dom, abs(physical), elementary, _partition);
+    int tags[5], numTags;
+    if(version < 2.0){
+      tags[0] = abs(physical); tags[1] = elementary; tags[2] = n;
+      numTags = 3;
+    }
+    else if (version < 2.2){
+      tags[0] = abs(physical); tags[1] = elementary; tags[2] = _partition;
+      numTags = 3;
+    }
+    else if(!_partition && !par && !dom){
+      tags[0] = 2 + par + dom; tags[1] = abs(physical); tags[2] = elementary;
+      numTags = 3;
+    }
+    else if(!ghosts){
+      tags[0] = 4 + par + dom; tags[1] = abs(physical); tags[2] = elementary;
+      tags[3] = 1; tags[4] = _partition;
+      numTags = 5;
+    }
     else{
       int numGhosts = ghosts->size();
-      fprintf(fp, " %d %d %d %d %d", 4 + numGhosts + par + dom, abs(physical),
-              elementary, 1 + numGhosts, _partition);
-      for(unsigned int i = 0; i < ghosts->size(); i++)
-        fprintf(fp, " %d", -(*ghosts)[i]);
+      tags[0] = 4 + numGhosts + par + dom; tags[1] = abs(physical);
+      tags[2] = elementary; tags[3] = 1 + numGhosts; tags[4] = _partition;
+      numTags = 5;
+    }
+    out.putInt(num ? num : _num);
+    out.putChar(' ');
+    out.putInt(type);
+    for(int i = 0; i < numTags; i++){
+      out.putChar(' ');
+      out.putInt(tags[i]);
+    }
+    if(version >= 2.2 && ghosts && (_partition || par || dom)){
+      for(unsigned int i = 0; i < ghosts->size(); i++){
+        out.putChar(' ');
+        out.putInt(-(*ghosts)[i]);
+      }
+    }
+    if(version >= 2.0 && par){
+      out.putChar(' ');
+      out.putInt(parentNum);
+    }
+    if(version >= 2.0 && dom){
+      out.putChar(' ');
+      out.putInt(dom1Num);
+      out.putChar(' ');
+      out.putInt(dom2Num);
+    }
+    if(version >= 2.0 && poly){
+      out.putChar(' ');
+      out.putInt(n);
     }
-    if(version >= 2.0 && par)
-      fprintf(fp, " %d", parentNum);
-    if(version >= 2.0 && dom)
-      fprintf(fp, " %d %d", dom1Num, dom2Num);
-    if(version >= 2.0 && poly)
-      fprintf(fp, " %d", n);
   }
   else{
     int numTags, numGhosts = 0;
@@ -1135,7 +1165,7 @@ void MElement::writeMSH2(FILE *fp, double version, bool binary, int num,
     if(poly){
  Msg::Error("Unable to write polygons/polyhedra in binary files.");
 	}
-    fwrite(blob, sizeof(int), 4 + numTags, fp);
+    out.putBinary(blob, (4 + numTags) * sizeof(int));
   }
 
   if(physical < 0) reverse();
@@ -1144,12 +1174,14 @@ void MElement::writeMSH2(FILE *fp, double version, bool binary, int num,
   getVerticesIdForMSH(verts);
 
   if(!binary){
-    for(int i = 0; i < n; i++)
-      fprintf(fp, " %d", verts[i]);
-    fprintf(fp, "\n");
+    for(int i = 0; i < n; i++){
+      out.putChar(' ');
+      out.putInt(verts[i]);
+    }
+    out.putChar('\n');
   }
   else{
-    fwrite(&verts[0], sizeof(int), n, fp);
+    out.putBinary(&verts[0], n * sizeof(int));
   }
 
   if(physical < 0) reverse();
@@ -1215,72 +1247,6 @@ void MElement::writePOS(FILE *fp, bool printElementary, bool printElementNumber,
   fprintf(fp, "};\n");
 }
 
-void MElement::writeSTL(FILE *fp, bool binary, double scalingFactor)
-{
-  if(getType() != TYPE_TRI && getType() != TYPE_QUA) return;
-  int qid[3] = {0, 2, 3};
-  SVector3 n = getFace(0).normal();
-  if(!binary){
-    fprintf(fp, "facet normal %g %g %g\n", n[0], n[1], n[2]);
-    fprintf(fp, "  outer loop\n");
-    for(int j = 0; j < 3; j++)
-      fprintf(fp, "    vertex %g %g %g\n",
-              getVertex(j)->x() * scalingFactor,
-              getVertex(j)->y() * scalingFactor,
-              getVertex(j)->z() * scalingFactor);
-    fprintf(fp, "  endloop\n");
-    fprintf(fp, "endfacet\n");
-    if(getNumVertices() == 4){
-      fprintf(fp, "facet normal %g %g %g\n", n[0], n[1], n[2]);
-      fprintf(fp, "  outer loop\n");
-      for(int j = 0; j < 3; j++)
-        fprintf(fp, "    vertex %g %g %g\n",
-                getVertex(qid[j])->x() * scalingFactor,
-                getVertex(qid[j])->y() * scalingFactor,
-                getVertex(qid[j])->z() * scalingFactor);
-      fprintf(fp, "  endloop\n");
-      fprintf(fp, "endfacet\n");
-    }
-  }
-  else{
-    char data[50];
-    float *coords = (float*)data;
-    coords[0] = (float)n[0];
-    coords[1] = (float)n[1];
-    coords[2] = (float)n[2];
-    for(int j = 0; j < 3; j++){
-      coords[3 + 3 * j] = (float)(getVertex(j)->x() * scalingFactor);
-      coords[3 + 3 * j + 1] = (float)(getVertex(j)->y() * scalingFactor);
-      coords[3 + 3 * j + 2] = (float)(getVertex(j)->z() * scalingFactor);
-    }
-    data[48] = data[49] = 0;
-    fwrite(data, sizeof(char), 50, fp);
-    if(getNumVertices() == 4){
-      for(int j = 0; j < 3; j++){
-        coords[3 + 3 * j] = (float)(getVertex(qid[j])->x() * scalingFactor);
-        coords[3 + 3 * j + 1] = (float)(getVertex(qid[j])->y() * scalingFactor);
-        coords[3 + 3 * j + 2] = (float)(getVertex(qid[j])->z() * scalingFactor);
-      }
-      fwrite(data, sizeof(char), 50, fp);
-    }
-  }
-}
-
-void MElement::writePLY2(FILE *fp)
-{
-  fprintf(fp, "3 ");
-  for(int i = 0; i < getNumVertices(); i++)
-    fprintf(fp, " %d", getVertex(i)->getIndex() - 1);
-  fprintf(fp, "\n");
-}
-
-void MElement::writeVRML(FILE *fp)
-{
-  for(int i = 0; i < getNumVertices(); i++)
-    fprintf(fp, "%d,", getVertex(i)->getIndex() - 1);
-  fprintf(fp, "-1,\n");
-}
-
 void MElement::writeTOCHNOG(FILE *fp, int num)
 {
   const char *str = getStringForTOCHNOG();
@@ -1294,28 +1260,6 @@ void MElement::writeTOCHNOG(FILE *fp, int num)
   fprintf(fp, "\n");
 }
 
-void MElement::writeVTK(FILE *fp, bool binary, bool bigEndian)
-{
-  if(!getTypeForVTK()) return;
-
-  int n = getNumVertices();
-  if(binary){
-    int verts[60];
-    verts[0] = n;
-    for(int i = 0; i < n; i++)
-      verts[i + 1] = getVertexVTK(i)->getIndex() - 1;
-    // VTK always expects big endian binary data
-    if(!bigEndian) SwapBytes((char*)verts, sizeof(int), n + 1);
-    fwrite(verts, sizeof(int), n + 1, fp);
-  }
-  else{
-    fprintf(fp, "%d", n);
-    for(int i = 0; i < n; i++)
-      fprintf(fp, " %d", getVertexVTK(i)->getIndex() - 1);
-    fprintf(fp, "\n");
-  }
-}
-
 void MElement::writeUNV(FILE *fp, int num, int elementary, int physical)
 {
   int type = getTypeForUNV();
@@ -1343,24 +1287,6 @@ void MElement::writeUNV(FILE *fp, int num, int elementary, int physical)
   if(physical < 0) reverse();
 }
 
-void MElement::writeMESH(FILE *fp, int elementTagType, int elementary,
-                         int physical)
-{
-  if(physical < 0) reverse();
-
-  for(int i = 0; i < getNumVertices(); i++)
-    if (getTypeForMSH() == MSH_TET_10 && i == 8)
-      fprintf(fp, " %d", getVertex(9)->getIndex());
-    else if (getTypeForMSH() == MSH_TET_10 && i == 9)
-      fprintf(fp, " %d", getVertex(8)->getIndex());
-    else
-      fprintf(fp, " %d", getVertex(i)->getIndex());
-  fprintf(fp, " %d\n", (elementTagType == 3) ? _partition :
-          (elementTagType == 2) ? abs(physical) : elementary);
-
-  if(physical < 0) reverse();
-}
-
 void MElement::writeIR3(FILE *fp, int elementTagType, int num, int elementary,
                         int physical)
 {
@@ -1456,15 +1382,6 @@ void MElement::writeINP(FILE *fp, int num)
   fprintf(fp, "\n");
 }
 
-void MElement::writeSU2(FILE *fp, int num)
-{
-  fprintf(fp, "%d ", getTypeForVTK());
-  for(int i = 0; i < getNumVertices(); i++)
-    fprintf(fp, "%d ", getVertexVTK(i)->getIndex() - 1);
-  if(num >= 0) fprintf(fp, "%d\n", num);
-  else fprintf(fp, "\n");
-}
-
 int MElement::getInfoMSH(const int typeMSH, const char **const name)
 {
   switch(typeMSH){
@@ -0,0 +1,146 @@
+// Gmsh - Copyright (C) 1997-2017 C. Geuzaine, J.-F. Remacle
+//
+// See the LICENSE.txt file for license information. Please report all
+// bugs and problems to the public mailing list <gmsh@onelab.info>.
+
+#include <cmath>
+#include <algorithm>
+#include "Mesh/GMSH/MElement.h"
+#include "Mesh/GMSH/MVertex.h"
+#include "Mesh/GMSH/MElementGrid.h"
+#include "Mesh/GMSH/Context.h"
+#include "Mesh/GMSH/GmshMessage.h"
+
+#if defined(_OPENMP)
+#include <omp.h>
+#endif
+
+MElementGrid::MElementGrid(const std::vector<MElement*> &v)
+  : _elems(v), _xmin(0.), _ymin(0.), _dx(1.), _dy(1.), _nx(1), _ny(1)
+{
+  // quadrangles are split along their diagonal 0-2, which is exact for the
+  // planar (convex) quadrangles of a parametric mesh
+  static const int split[2][3] = {{0, 1, 2}, {0, 2, 3}};
+  double xmin = 1.e22, ymin = 1.e22, xmax = -1.e22, ymax = -1.e22;
+  std::vector<double> box;
+  for(unsigned int i = 0; i < _elems.size(); i++){
+    MElement *e = _elems[i];
+    const int n = e->getNumPrimaryVertices();
+    for(int j = 0; j < n; j++){
+      MVertex *p = e->getVertex(j);
+      xmin = std::min(xmin, p->x()); xmax = std::max(xmax, p->x());
+      ymin = std::min(ymin, p->y()); ymax = std::max(ymax, p->y());
+    }
+    if(n != 3 && n != 4) continue;
+    for(int k = 0; k < n - 2; k++){
+      MVertex *p0 = e->getVertex(split[k][0]);
+      MVertex *p1 = e->getVertex(split[k][1]);
+      MVertex *p2 = e->getVertex(split[k][2]);
+      const double a = p1->x() - p0->x(), b = p2->x() - p0->x();
+      const double c = p1->y() - p0->y(), d = p2->y() - p0->y();
+      const double det = a * d - b * c;
+      if(det == 0.) continue;
+      _element.push_back(i);
+      _x0.push_back(p0->x());
+      _y0.push_back(p0->y());
+      _j00.push_back(d / det);
+      _j01.push_back(-b / det);
+      _j10.push_back(-c / det);
+      _j11.push_back(a / det);
+      box.push_back(std::min(p0->x(), std::min(p1->x(), p2->x())));
+      box.push_back(std::max(p0->x(), std::max(p1->x(), p2->x())));
+      box.push_back(std::min(p0->y(), std::min(p1->y(), p2->y())));
+      box.push_back(std::max(p0->y(), std::max(p1->y(), p2->y())));
+    }
+  }
+  const int nt = _element.size();
+  if(!nt) {
+    _start.assign(2, 0);
+    return;
+  }
+
+  // make the bounding boxes larger up to (absolute) geometrical tolerance
+  const double eps = CTX::instance()->geom.tolerance;
+  xmin -= eps; ymin -= eps; xmax += eps; ymax += eps;
+  const double lx = xmax - xmin, ly = ymax - ymin;
+  // about one triangle per bucket
+  _nx = (int)std::max(1., std::min((double)nt, std::sqrt(nt * lx / ly)));
+  _ny = std::max(1, nt / _nx);
+  _xmin = xmin;
+  _ymin = ymin;
+  _dx = lx / _nx;
+  _dy = ly / _ny;
+
+  std::vector<int> range(4 * nt);
+  _start.assign(_nx * _ny + 1, 0);
+  for(int t = 0; t < nt; t++){
+    const double *bb = &box[4 * t];
+    int *r = &range[4 * t];
+    r[0] = std::max(0, (int)((bb[0] - eps - _xmin) / _dx));
+    r[1] = std::min(_nx - 1, (int)((bb[1] + eps - _xmin) / _dx));
+    r[2] = std::max(0, (int)((bb[2] - eps - _ymin) / _dy));
+    r[3] = std::min(_ny - 1, (int)((bb[3] + eps - _ymin) / _dy));
+    for(int iy = r[2]; iy <= r[3]; iy++)
+      for(int ix = r[0]; ix <= r[1]; ix++)
+        _start[iy * _nx + ix + 1]++;
+  }
+  for(int b = 0; b < _nx * _ny; b++) _start[b + 1] += _start[b];
+  _list.resize(_start[_nx * _ny]);
+  std::vector<int> fill(_start.begin(), _start.end() - 1);
+  for(int t = 0; t < nt; t++){
+    const int *r = &range[4 * t];
+    for(int iy = r[2]; iy <= r[3]; iy++)
+      for(int ix = r[0]; ix <= r[1]; ix++)
+        _list[fill[iy * _nx + ix]++] = t;
+  }
+  Msg::Debug("Element grid of %d x %d buckets for %d elements", _nx, _ny,
+             (int)_elems.size());
+}
+
+// same test as MTriangle::isInside
+bool MElementGrid::_inside(int t, double x, double y, double tol) const
+{
+  const double dx = x - _x0[t], dy = y - _y0[t];
+  const double u = _j00[t] * dx + _j01[t] * dy;
+  const double v = _j10[t] * dx + _j11[t] * dy;
+  return !(u < -tol || v < -tol || u > (1. + tol) - v);
+}
+
+MElement *MElementGrid::_find(double x, double y, bool strict) const
+{
+  double tol = MElement::getTolerance();
+  const double fx = (x - _xmin) / _dx, fy = (y - _ymin) / _dy;
+  if(fx >= 0. && fx <= _nx && fy >= 0. && fy <= _ny){
+    const int b = std::min((int)fy, _ny - 1) * _nx + std::min((int)fx, _nx - 1);
+    for(int k = _start[b]; k < _start[b + 1]; k++)
+      if(_inside(_list[k], x, y, tol)) return _elems[_element[_list[k]]];
+  }
+  if(strict) return 0;
+  while(tol < 0.1){
+    tol *= 10.0;
+    for(unsigned int t = 0; t < _element.size(); t++)
+      if(_inside(t, x, y, tol)) return _elems[_element[t]];
+  }
+  return 0;
+}
+
+MElement *MElementGrid::find(double x, double y, bool strict) const
+{
+  MElement *e = _find(x, y, strict);
+  if(!e && !strict) Msg::Warning("Point %g %g not found", x, y);
+  return e;
+}
+
+void MElementGrid::find(int n, const double *x, const double *y, MElement **e,
+                        bool strict) const
+{
+#if defined(_OPENMP)
+#pragma omp parallel for schedule(static) if(n > 1000)
+#endif
+  for(int i = 0; i < n; i++)
+    e[i] = _find(x[i], y[i], strict);
+  // the messages are only written by the calling thread
+  if(!strict)
+    for(int i = 0; i < n; i++)
+      if(!e[i]) Msg::Warning("Point %g %g not found", x[i], y[i]);
+}
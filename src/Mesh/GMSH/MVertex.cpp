@@ -15,6 +15,7 @@
 #include "Mesh/GMSH/discreteDiskFace.h"
 #include "Mesh/GMSH/GmshMessage.h"
 #include "Mesh/GMSH/StringUtils.h"
+#include "Mesh/gmshIO/BufferedWriter.h"
 
 double angle3Vertices(const MVertex *p1, const MVertex *p2, const MVertex *p3)
 {
@@ -138,7 +139,8 @@ void MVertex::writeMSH(FILE *fp, bool binary, bool saveParametric, double scalin
   }
 }
 
-void MVertex::writeMSH2(FILE *fp, bool binary, bool saveParametric, double scalingFactor)
+void MVertex::writeMSH2(BufferedWriter &out, bool binary, bool saveParametric,
+                        double scalingFactor)
 {
   if(_index < 0) return; // negative index vertices are never saved
 
@@ -153,20 +155,29 @@ void MVertex::writeMSH2(FILE *fp, bool binary, bool saveParametric, double scali
   }
 
   if(!binary){
+    out.putInt(_index);
+    out.putChar(' ');
+    out.putDouble(x() * scalingFactor);
+    out.putChar(' ');
+    out.putDouble(y() * scalingFactor);
+    out.putChar(' ');
+    out.putDouble(z() * scalingFactor);
     if(!saveParametric)
-      fprintf(fp, "%d %.16g %.16g %.16g\n", _index, x() * scalingFactor,
-              y() * scalingFactor, z() * scalingFactor);
-    else
-      fprintf(fp, "%d %.16g %.16g %.16g %d %d", _index, x() * scalingFactor,
-              y() * scalingFactor, z() * scalingFactor, myDim, myTag);
+      out.putChar('\n');
+    else{
+      out.putChar(' ');
+      out.putInt(myDim);
+      out.putChar(' ');
+      out.putInt(myTag);
+    }
   }
   else{
-    fwrite(&_index, sizeof(int), 1, fp);
+    out.putBinary(&_index, sizeof(int));
     double data[3] = {x() * scalingFactor, y() * scalingFactor, z() * scalingFactor};
-    fwrite(data, sizeof(double), 3, fp);
+    out.putBinary(data, 3 * sizeof(double));
     if(saveParametric){
-      fwrite(&myDim, sizeof(int), 1, fp);
-      fwrite(&myTag, sizeof(int), 1, fp);
+      out.putBinary(&myDim, sizeof(int));
+      out.putBinary(&myTag, sizeof(int));
     }
   }
 
@@ -174,43 +185,36 @@ void MVertex::writeMSH2(FILE *fp, bool binary, bool saveParametric, double scali
     if(myDim == 1){
       double _u;
       getParameter(0, _u);
-      if(!binary)
-        fprintf(fp, " %.16g\n", _u);
+      if(!binary){
+        out.putChar(' ');
+        out.putDouble(_u);
+        out.putChar('\n');
+      }
       else
-        fwrite(&_u, sizeof(double), 1, fp);
+        out.putBinary(&_u, sizeof(double));
     }
     else if (myDim == 2){
       double _u, _v;
       getParameter(0, _u);
       getParameter(1, _v);
-      if(!binary)
-        fprintf(fp, " %.16g %.16g\n", _u, _v);
+      if(!binary){
+        out.putChar(' ');
+        out.putDouble(_u);
+        out.putChar(' ');
+        out.putDouble(_v);
+        out.putChar('\n');
+      }
       else{
-        fwrite(&_u, sizeof(double), 1, fp);
-        fwrite(&_v, sizeof(double), 1, fp);
+        out.putBinary(&_u, sizeof(double));
+        out.putBinary(&_v, sizeof(double));
       }
     }
     else
       if(!binary)
-        fprintf(fp, "\n");
+        out.putChar('\n');
   }
 }
 
-void MVertex::writePLY2(FILE *fp)
-{
-  if(_index < 0) return; // negative index vertices are never saved
-
-  fprintf(fp, "%.16g %.16g %.16g\n", x(), y(), z());
-}
-
-void MVertex::writeVRML(FILE *fp, double scalingFactor)
-{
-  if(_index < 0) return; // negative index vertices are never saved
-
-  fprintf(fp, "%.16g %.16g %.16g,\n",
-          x() * scalingFactor, y() * scalingFactor, z() * scalingFactor);
-}
-
 void MVertex::writeUNV(FILE *fp, double scalingFactor)
 {
   if(_index < 0) return; // negative index vertices are never saved
@@ -227,22 +231,6 @@ void MVertex::writeUNV(FILE *fp, double scalingFactor)
   fprintf(fp, "%s", tmp);
 }
 
-void MVertex::writeVTK(FILE *fp, bool binary, double scalingFactor, bool bigEndian)
-{
-  if(_index < 0) return; // negative index vertices are never saved
-
-  if(binary){
-    double data[3] = {x() * scalingFactor, y() * scalingFactor, z() * scalingFactor};
-    // VTK always expects big endian binary data
-    if(!bigEndian) SwapBytes((char*)data, sizeof(double), 3);
-    fwrite(data, sizeof(double), 3, fp);
-  }
-  else{
-    fprintf(fp, "%.16g %.16g %.16g\n",
-            x() * scalingFactor, y() * scalingFactor, z() * scalingFactor);
-  }
-}
-
 void MVertex::writeTOCHNOG(FILE *fp, int dim, double scalingFactor)
 {
   if(_index < 0) return; // negative index vertices are never saved
@@ -262,15 +250,6 @@ void MVertex::writeTOCHNOG(FILE *fp, int dim, double scalingFactor)
   }
 }
 
-void MVertex::writeMESH(FILE *fp, double scalingFactor)
-{
-  if(_index < 0) return; // negative index vertices are never saved
-
-  fprintf(fp, " %20.14G      %20.14G      %20.14G      %d\n",
-          x() * scalingFactor, y() * scalingFactor, z() * scalingFactor,
-          _ge ? _ge->tag() : 0);
-}
-
 static void double_to_char8(double val, char *str)
 {
   if(val >= 1.e6)
@@ -339,18 +318,6 @@ void MVertex::writeDIFF(FILE *fp, bool binary, double scalingFactor)
           _index, x() * scalingFactor, y() * scalingFactor, z() * scalingFactor);
 }
 
-void MVertex::writeSU2(FILE *fp, int dim, double scalingFactor)
-{
-  if(_index < 0) return; // negative index vertices are never saved
-
-  if(dim == 2)
-    fprintf(fp, "%.16g %.16g %d\n", x() * scalingFactor, y() * scalingFactor,
-             _index - 1);
-  else
-    fprintf(fp, "%.16g %.16g %.16g %d\n", x() * scalingFactor, y() * scalingFactor,
-            z() * scalingFactor, _index - 1);
-}
-
 bool MVertexLessThanNum::operator()(const MVertex *v1, const MVertex *v2) const
 {
   if(v1->getNum() < v2->getNum()) return true;
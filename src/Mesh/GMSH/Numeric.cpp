@@ -1405,9 +1405,10 @@ int intersection_segments(const SPoint3 &p1, const SPoint3 &p2,
     SPoint3 x1 (p1.x()*(1.-x[0]) + p2.x()*x[0],
 		p1.y()*(1.-x[0]) + p2.y()*x[0],
 		p1.z()*(1.-x[0]) + p2.z()*x[0]);
-    SPoint3 x2 (q1.x()*(1.-x[0]) + q2.x()*x[0],
-		q1.y()*(1.-x[0]) + q2.y()*x[0],
-		q1.z()*(1.-x[0]) + q2.z()*x[0]);
+    // the intersection on the second segment is at x[1]
+    SPoint3 x2 (q1.x()*(1.-x[1]) + q2.x()*x[1],
+		q1.y()*(1.-x[1]) + q2.y()*x[1],
+		q1.z()*(1.-x[1]) + q2.z()*x[1]);
 
     SVector3 d (x2,x1);
     double nd = norm(d);
@@ -592,9 +592,7 @@ bool buildAdditionalPoints2D(GFace *gf)
   }
 
   // DEBUG STUFF
-  char name[256];
-  sprintf(name, "points_face_%d.pos", gf->tag());
-  FILE *f = Fopen (name,"w");
+  FILE *f = Msg::OpenDebugFile("points_face_%d.pos", gf->tag());
   if(f){
     fprintf(f,"View \"\" {\n");
     for (std::set<MVertex*>::iterator it = _vertices.begin(); it != _vertices.end() ; ++it){
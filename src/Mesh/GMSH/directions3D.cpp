@@ -993,7 +993,7 @@ void Frame_field::continuousCrossField(GRegion *gr, GFace *gf)
   std::map<MVertex*, STensor3>::iterator iter = crossField.find(beginV);
   STensor3 bCross = iter->second;
 
-  FILE *fi = Fopen ("cross_recur.pos","w");
+  FILE *fi = Msg::OpenDebugFile("cross_recur.pos");
   if(fi){
     fprintf(fi,"View \"\"{\n");
     fprintf(fi,"SP(%g,%g,%g) {%g};\n",beginV->x(),beginV->y(),beginV->z(), 0.0);
@@ -1293,9 +1293,8 @@ double triangulation::geodesicDistance ()
   }
 
 
-  char name[256];
-  sprintf(name,"geodesicDistance%d.pos",iter);
-  FILE *f = fopen(name,"w");
+  FILE *f = Msg::OpenDebugFile("geodesicDistance%d.pos",iter);
+  if(!f) return CLOSEST;
   fprintf(f,"View \"%d\"{\n",iter);
   for (unsigned int i=0;i<tri.size();i++){
     double d0 = Fixed[tri[i]->getVertex(0)];
@@ -248,7 +248,8 @@ void discreteFace::createGeometry()
 
 
   /*
-  FILE* debug = Fopen("tralala-init.pos","w");
+  FILE* debug = Msg::OpenDebugFile("tralala-init.pos");
+  if(debug){
   fprintf(debug,"View \"discreteEdges\"{\n");
   for(unsigned int j=0; j<toParam.size(); j++){
 
@@ -270,6 +271,7 @@ void discreteFace::createGeometry()
   }
   fprintf(debug,"};");
   fclose(debug);
+  }
   */
 
   for(unsigned int i=0; i<toParam.size(); i++){
@@ -932,7 +934,8 @@ void discreteFace::complex_crossField()
 
 
   lsys->systemSolve();
-  FILE* myfile = Fopen("crossField.pos","w");
+  FILE* myfile = Msg::OpenDebugFile("crossField.pos");
+  if(!myfile) return;
   fprintf(myfile,"View \"cross\"{\n");
   for(unsigned int i=0; i<triangles.size(); i++){
     fprintf(myfile,"VT(");
@@ -1076,7 +1079,8 @@ void discreteFace::crossField()
 
 
   lsys->systemSolve();
-  FILE* myfile = Fopen("crossField.pos","w");
+  FILE* myfile = Msg::OpenDebugFile("crossField.pos");
+  if(!myfile) return;
   fprintf(myfile,"View \"cross\"{\n");
   for(unsigned int i=0; i<triangles.size(); i++){
     fprintf(myfile,"VT(");
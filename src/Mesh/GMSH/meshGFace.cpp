@@ -35,7 +35,7 @@
 #include "Mesh/GMSH/qualityMeasures.h"
 #include "Mesh/GMSH/Field.h"
 #include "common/OS.h"
-#include "Mesh/GMSH/MElementOctree.h"
+#include "Mesh/GMSH/MElementGrid.h"
 #include "Mesh/GMSH/HighOrder.h"
 #include "Mesh/GMSH/meshGEdge.h"
 #include "Mesh/GMSH/meshPartitionOptions.h"
@@ -61,8 +61,13 @@ static void computeElementShapes(GFace *gf, double &worst, double &avg,
   best = 0.0;
   nT = 0;
   greaterThan = 0;
+  qmElementArrays triangles;
+  triangles.gather(gf->triangles);
+  std::vector<double> gamma(gf->triangles.size());
+  qmTriangle::gamma(gamma.size(), triangles.nodes.data(), triangles.x.data(),
+                    triangles.y.data(), triangles.z.data(), gamma.data());
   for(unsigned int i = 0; i < gf->triangles.size(); i++){
-    double q = qmTriangle::gamma(gf->triangles[i]);
+    double q = gamma[i];
     if(q > .9) greaterThan++;
     avg += q;
     worst = std::min(worst, q);
@@ -672,7 +677,7 @@ static void modifyInitialMeshForTakingIntoAccountBoundaryLayers(GFace *gf,
   std::list<GEdge*> embedded_edges = gf->embeddedEdges();
   edges.insert(edges.begin(), embedded_edges.begin(),embedded_edges.end());
   std::list<GEdge*>::iterator ite = edges.begin();
-  FILE *ff2 = std::fopen ("tato.pos","w");
+  FILE *ff2 = Msg::OpenDebugFile("tato-%d.pos", gf->tag());
   if(ff2) fprintf(ff2,"View \" \"{\n");
 
   std::vector<MLine*> _lines;
@@ -817,7 +822,7 @@ static void modifyInitialMeshForTakingIntoAccountBoundaryLayers(GFace *gf,
   std::list<GEdge*> hop;
   std::set<MEdge,Less_Edge>::iterator it =  bedges.begin();
 
-  FILE *ff = std::fopen ("toto.pos","w");
+  FILE *ff = Msg::OpenDebugFile("toto-%d.pos", gf->tag());
   if(ff) fprintf(ff,"View \" \"{\n");
   for (; it != bedges.end(); ++it){
     ne.lines.push_back(new MLine (it->getVertex(0),it->getVertex(1)));
@@ -837,15 +842,15 @@ static void modifyInitialMeshForTakingIntoAccountBoundaryLayers(GFace *gf,
   meshGenerator(gf, 0, 0, true , false, &hop);
 }
 
-static bool inside_domain(MElementOctree* octree,double x,double y)
+static bool inside_domain(MElementGrid* grid,double x,double y)
 {
   MElement* element;
-  element = (MElement*)octree->find(x, y, 0.0, 2, true);
+  element = (MElement*)grid->find(x, y);
   if(element != NULL) return 1;
   else return 0;
 }
 
-static bool translate(GFace* gf,MElementOctree* octree,MVertex* vertex,
+static bool translate(GFace* gf,MElementGrid* grid,MVertex* vertex,
                       SPoint2 corr,SVector3& v1,SVector3& v2)
 {
   bool ok;
@@ -877,15 +882,15 @@ static bool translate(GFace* gf,MElementOctree* octree,MVertex* vertex,
   x2 = x + delta_y;
   y2 = y - delta_x;
 
-  if(!inside_domain(octree,x1,y1)){
+  if(!inside_domain(grid,x1,y1)){
     x1 = x - delta_x;
     y1 = y - delta_y;
-    if(!inside_domain(octree,x1,y1)) ok = false;
+    if(!inside_domain(grid,x1,y1)) ok = false;
   }
-  if(!inside_domain(octree,x2,y2)){
+  if(!inside_domain(grid,x2,y2)){
     x2 = x - delta_y;
     y2 = y + delta_x;
-    if(!inside_domain(octree,x2,y2)) ok = false;
+    if(!inside_domain(grid,x2,y2)) ok = false;
   }
 
   ok = true; //?
@@ -946,7 +951,7 @@ static void directions_storage(GFace* gf)
   SPoint2 point;
   SVector3 v1;
   SVector3 v2;
-  MElementOctree* octree;
+  MElementGrid* grid;
   std::set<MVertex*> vertices;
   std::set<MVertex*>::iterator it;
 
@@ -961,7 +966,7 @@ static void directions_storage(GFace* gf)
   }
 
   backgroundMesh::set(gf);
-  octree = backgroundMesh::current()->get_octree();
+  grid = backgroundMesh::current()->get_grid();
 
   gf->storage1.clear();
   gf->storage2.clear();
@@ -973,7 +978,7 @@ static void directions_storage(GFace* gf)
 
     if(!gf->getCompound()){
       if(gf->geomType()==GEntity::CompoundSurface){
-        ok = translate(gf,octree,*it,SPoint2(0.0,0.0),v1,v2);
+        ok = translate(gf,grid,*it,SPoint2(0.0,0.0),v1,v2);
       }
       else{
         ok = improved_translate(gf,*it,v1,v2);
@@ -34,6 +34,48 @@ static int  N_SEARCH;
 static double DT_INSERT_VERTEX;
 int MTri3::radiusNorm = 2;
 
+// Pool of the MTri3s of one thread. Blocks are allocated in chunks and the
+// freed blocks are kept in a free list, chunks are only released when the
+// thread ends
+class MTri3Pool
+{
+ private:
+  std::vector<void*> _free;
+  std::vector<char*> _chunks;
+  static const size_t CHUNK = 4096;
+ public:
+  ~MTri3Pool()
+  {
+    for (unsigned int i = 0; i < _chunks.size(); i++)
+      ::operator delete(_chunks[i]);
+  }
+  void *allocate()
+  {
+    if (_free.empty()){
+      char *chunk = static_cast<char*>(::operator new(CHUNK * sizeof(MTri3)));
+      _chunks.push_back(chunk);
+      for (size_t i = CHUNK; i > 0; i--)
+        _free.push_back(chunk + (i - 1) * sizeof(MTri3));
+    }
+    void *p = _free.back();
+    _free.pop_back();
+    return p;
+  }
+  void release(void *p) { _free.push_back(p); }
+};
+
+static thread_local MTri3Pool mtri3Pool;
+
+void *MTri3::operator new (size_t size)
+{
+  return mtri3Pool.allocate();
+}
+
+void MTri3::operator delete (void *p)
+{
+  if (p) mtri3Pool.release(p);
+}
+
 template <class ITERATOR>
 void _printTris(char *name, ITERATOR it,  ITERATOR end, bidimMeshData * data)
 {
@@ -695,10 +737,11 @@ inline double getSurfUV(MTriangle *t, bidimMeshData & data)
   return s * 0.5;
 }
 
+template <class CONTAINER>
 bool insertVertexB (std::list<edgeXface> &shell,
 		    std::list<MTri3*> &cavity,
 		    bool force, GFace *gf, MVertex *v, double *param , MTri3 *t,
-		    std::set<MTri3*, compareTri3Ptr> &allTets,
+		    CONTAINER &allTets,
 		    std::set<MTri3*, compareTri3Ptr> *activeTets,
 		    bidimMeshData & data,
 		    double *metric,
@@ -727,7 +770,7 @@ bool insertVertexB (std::list<edgeXface> &shell,
 
   bool onePointIsTooClose = false;
   while (it != shell.end()){
-    MTriangle *t = new MTriangle(it->v[0], it->v[1], v);
+    MTriangle *t = data.newTriangle(it->v[0], it->v[1], v);
     int index0 = data.getIndex (t->getVertex(0));
     int index1 = data.getIndex (t->getVertex(1));
     int index2 = data.getIndex (t->getVertex(2));
@@ -802,7 +845,7 @@ bool insertVertexB (std::list<edgeXface> &shell,
     //    _printTris("new_cavity.pos", new_cavity.begin(), new_cavity.end(), Us, Vs, false);
     //    _printTris("newTris.pos", &newTris[0], newTris+shell.size(), Us, Vs, false);
     //    _printTris("allTris.pos", allTets.begin(),allTets.end(), Us, Vs, false);
-    for (unsigned int i = 0; i < shell.size(); i++) {delete newTris[i]->tri(), delete newTris[i];}
+    for (unsigned int i = 0; i < shell.size(); i++) {data.recycleTriangle(newTris[i]->tri()), delete newTris[i];}
     delete [] newTris;
     //    throw;
     //    double t2 = Cpu();
@@ -891,8 +934,9 @@ static MTri3* search4Triangle (MTri3 *t, MVertex *v, int maxx, int &ITER) {
   return 0;
 }
 
+template <class CONTAINER>
 static MTri3* search4Triangle (MTri3 *t, double pt[2], bidimMeshData & data,
-			       std::set<MTri3*,compareTri3Ptr> &AllTris, double uv[2], bool force = false) {
+			       CONTAINER &AllTris, double uv[2], bool force = false) {
 
   //  bool inside = t->inCircumCircle(pt);
   bool inside =  invMapUV(t->tri(), pt, data, uv, 1.e-8);
@@ -932,7 +976,7 @@ static MTri3* search4Triangle (MTri3 *t, double pt[2], bidimMeshData & data,
   if (!force)return 0; // FIXME: removing this leads to horrible performance
 
   N_GLOBAL_SEARCH ++ ;
-  for(std::set<MTri3*,compareTri3Ptr>::iterator itx = AllTris.begin();
+  for(typename CONTAINER::iterator itx = AllTris.begin();
       itx != AllTris.end();++itx){
     if (!(*itx)->isDeleted()){
       inside = invMapUV((*itx)->tri(), pt, data, uv, 1.e-8);
@@ -948,12 +992,33 @@ static MTri3* search4Triangle (MTri3 *t, double pt[2], bidimMeshData & data,
 
 ///*********************
 
+// change the radius of a triangle that could not be refined so that it moves
+// down in the refinement queue
+static void requeueTriangle(std::set<MTri3*,compareTri3Ptr> &AllTris,
+                            std::set<MTri3*,compareTri3Ptr>::iterator it,
+                            MTri3 *worst, double radius)
+{
+  AllTris.erase(it);
+  worst->forceRadius(radius);
+  AllTris.insert(worst);
+}
+
+// in the heap the triangle is still on top
+static void requeueTriangle(MTri3Heap &AllTris, MTri3Heap::iterator it,
+                            MTri3 *worst, double radius)
+{
+  AllTris.pop();
+  worst->forceRadius(radius);
+  AllTris.insert(worst);
+}
+
+template <class CONTAINER>
 static bool insertAPoint(GFace *gf,
-			 std::set<MTri3*,compareTri3Ptr>::iterator it,
+			 typename CONTAINER::iterator it,
                          double center[2],
 			 double metric[3],
 			 bidimMeshData & data,
-                         std::set<MTri3*,compareTri3Ptr> &AllTris,
+                         CONTAINER &AllTris,
                          std::set<MTri3*,compareTri3Ptr> *ActiveTris = 0,
                          MTri3 *worst = 0,
 			 MTri3 **oneNewTriangle = 0)
@@ -1025,9 +1090,7 @@ static bool insertAPoint(GFace *gf,
 		 center[0], center[1], p.succeeded() );
             printf("Point %g %g cannot be inserted because %d",
       	     center[0], center[1], p.succeeded() );
-      AllTris.erase(it);
-      worst->forceRadius(-1);
-      AllTris.insert(worst);
+      requeueTriangle(AllTris, it, worst, -1);
       delete v;
       for (std::list<MTri3*>::iterator itc = cavity.begin(); itc != cavity.end(); ++itc)(*itc)->setDeleted(false);
       return false;
@@ -1043,9 +1106,7 @@ static bool insertAPoint(GFace *gf,
   else {
     //    MTriangle *base = worst->tri();
     for (std::list<MTri3*>::iterator itc = cavity.begin(); itc != cavity.end(); ++itc)(*itc)->setDeleted(false);
-    AllTris.erase(it);
-    worst->forceRadius(0);
-    AllTris.insert(worst);
+    requeueTriangle(AllTris, it, worst, 0);
     return false;
   }
 }
@@ -1054,21 +1115,26 @@ void bowyerWatson(GFace *gf, int MAXPNT,
 		  std::map<MVertex* , MVertex*>* equivalence,
 		  std::map<MVertex*, SPoint2> * parametricCoordinates)
 {
-  std::set<MTri3*,compareTri3Ptr> AllTris;
+  std::set<MTri3*,compareTri3Ptr> AllTrisSet;
   bidimMeshData DATA(equivalence,parametricCoordinates);
 
-  buildMeshGenerationDataStructures(gf, AllTris, DATA);
+  buildMeshGenerationDataStructures(gf, AllTrisSet, DATA);
 
   //  if (equivalence)_printTris ("before.pos", AllTris.begin(), AllTris.end(), DATA);
-  int nbSwaps = edgeSwapPass(gf, AllTris, SWCR_DEL, DATA);
+  int nbSwaps = edgeSwapPass(gf, AllTrisSet, SWCR_DEL, DATA);
   // _printTris ("after2.pos", AllTris, Us,Vs);
   Msg::Debug("Delaunization of the initial mesh done (%d swaps)", nbSwaps);
 
-  if(AllTris.empty()){
+  if(AllTrisSet.empty()){
     Msg::Error("No triangles in initial mesh");
     return;
   }
 
+  // the refinement only needs the worst triangle, a heap is much cheaper
+  // than keeping the whole set sorted
+  MTri3Heap AllTris(AllTrisSet.begin(), AllTrisSet.end());
+  AllTrisSet.clear();
+
   int ITER = 0;
   int NBDELETED = 0;
   //  double DT1 = 0 , DT2=0, DT3=0;
@@ -1078,12 +1144,13 @@ void bowyerWatson(GFace *gf, int MAXPNT,
     //      sprintf(name,"del2d%d-ITER%4d.pos",gf->tag(),ITER);
     //      _printTris (name, AllTris, Us,Vs,false);
     //    }
-    MTri3 *worst = *AllTris.begin();
+    if (AllTris.empty()) break;
+    MTri3 *worst = AllTris.top();
     if (worst->isDeleted()){
       //      double t1 = Cpu();
-      delete worst->tri();
+      DATA.recycleTriangle(worst->tri());
       delete worst;
-      AllTris.erase(AllTris.begin());
+      AllTris.pop();
       NBDELETED ++;
       //      DT1 += (Cpu() - t1);
     }
@@ -1115,7 +1182,16 @@ void bowyerWatson(GFace *gf, int MAXPNT,
       insertAPoint(gf, AllTris.begin(), center, metric, DATA, AllTris);
     }
   }
-  nbSwaps = edgeSwapPass(gf, AllTris, SWCR_QUAL, DATA);
+
+  for (MTri3Heap::iterator it = AllTris.begin(); it != AllTris.end(); ++it){
+    if ((*it)->isDeleted()){
+      DATA.recycleTriangle((*it)->tri());
+      delete *it;
+    }
+    else AllTrisSet.insert(*it);
+  }
+
+  nbSwaps = edgeSwapPass(gf, AllTrisSet, SWCR_QUAL, DATA);
   //  printf("%12.5E %12.5E %12.5E %12.5E %12.5E\n",DT1,DT2,DT3,__DT1,__DT2);
   //  printf("%12.5E \n",__DT2);
 #if defined(HAVE_ANN)
@@ -1129,7 +1205,7 @@ void bowyerWatson(GFace *gf, int MAXPNT,
     }
   }
 #endif
-  transferDataStructure(gf, AllTris, DATA);
+  transferDataStructure(gf, AllTrisSet, DATA);
 }
 
 /*
@@ -1568,7 +1644,7 @@ void buildBackGroundMesh (GFace *gf,
     backgroundMesh::set(gf);
     //    printf("2 end build bak mesh\n");
     char name[256];
-    if (CTX::instance()->mesh.saveAll){
+    if (Msg::GetDebugFiles()){
       sprintf(name,"bgm-%d.pos",gf->tag());
       backgroundMesh::current()->print(name,gf);
       sprintf(name,"cross-%d.pos",gf->tag());
@@ -1947,7 +2023,60 @@ void bowyerWatsonParallelogramsConstrained(GFace *gf,
   }
 
 
-  MTri3 * getTriToBreak (MVertex *v, std::vector<MTri3*> &t, int &NB_GLOBAL_SEARCH, int &ITER){
+  // Jump and walk: a coarse grid over the domain keeps, for each cell, the
+  // last vertex inserted in the cell and one of the triangles created around
+  // it. The walk starts from the triangle of the cell of the new vertex when
+  // that vertex is closer than the last inserted one, which happens at the
+  // start of each round of the BRIO order.
+  class triangleSeedGrid
+  {
+   private:
+    double _xmin, _ymin, _dx, _dy;
+    int _n;
+    std::vector<std::pair<MVertex*, MTri3*> > _cells;
+    inline int cell (double x, double y) const
+    {
+      int i = std::min(std::max((int)((x - _xmin) / _dx), 0), _n - 1);
+      int j = std::min(std::max((int)((y - _ymin) / _dy), 0), _n - 1);
+      return i + _n * j;
+    }
+   public:
+    triangleSeedGrid (MVertex *box[4], size_t numPoints)
+    {
+      _n = std::max(1, (int)sqrt((double)numPoints / 16.));
+      _xmin = box[0]->x();
+      _ymin = box[0]->y();
+      _dx = (box[2]->x() - _xmin) / _n;
+      _dy = (box[2]->y() - _ymin) / _n;
+      if (_dx <= 0.) _dx = 1.;
+      if (_dy <= 0.) _dy = 1.;
+      _cells.resize(_n * _n, std::make_pair((MVertex*)0, (MTri3*)0));
+    }
+    inline void add (MVertex *v, MTri3 *t)
+    {
+      _cells[cell(v->x(), v->y())] = std::make_pair(v, t);
+    }
+    inline MTri3 *seed (MVertex *v, MVertex *last) const
+    {
+      const std::pair<MVertex*, MTri3*> &c = _cells[cell(v->x(), v->y())];
+      if (!c.first || c.first == last || c.second->isDeleted()) return 0;
+      // the triangles of a cavity are reused for the new triangles, the
+      // triangle may have moved away from the vertex since
+      MTriangle *tr = c.second->tri();
+      if (tr->getVertex(0) != c.first && tr->getVertex(1) != c.first &&
+          tr->getVertex(2) != c.first) return 0;
+      if (!last || distance2(c.first, v) < distance2(last, v)) return c.second;
+      return 0;
+    }
+    static inline double distance2 (MVertex *a, MVertex *b)
+    {
+      const double dx = a->x() - b->x(), dy = a->y() - b->y();
+      return dx * dx + dy * dy;
+    }
+  };
+
+  MTri3 * getTriToBreak (MVertex *v, std::vector<MTri3*> &t, const triangleSeedGrid &grid,
+                         MVertex *last, int &NB_GLOBAL_SEARCH, int &ITER){
     // last inserted is used as starting point
     // we know it is not deleted
     unsigned int k = t.size() - 1;
@@ -1955,6 +2084,8 @@ void bowyerWatsonParallelogramsConstrained(GFace *gf,
       k--;
     }
     MTri3 *start = t[k];
+    MTri3 *jump = grid.seed(v, last);
+    if (jump) start = jump;
     start = search4Triangle (start,v,(int)t.size(),ITER);
     if (start)return start;
     //  printf("Global Search has to be done\n");
@@ -1992,6 +2123,7 @@ void bowyerWatsonParallelogramsConstrained(GFace *gf,
     std::vector<MTri3*> cavity;
     MVertex *box[4];
     initialSquare (v,box,t);
+    triangleSeedGrid grid(box, v.size());
 
     int NB_GLOBAL_SEARCH = 0;
     double AVG_ITER = 0;
@@ -2000,18 +2132,17 @@ void bowyerWatsonParallelogramsConstrained(GFace *gf,
     double t1 = Cpu();
 	
 	OmniFEMMsg::instance()->MsgInfo("Delaunay 2D SORTING");
-    if(hilbertSort) SortHilbert(v);
+    if(hilbertSort) SortBRIO(v);
 
-    double ta=0,tb=0,tc=0,td=0,T;
+    // no timing inside the loop, Cpu() is a system call that costs more
+    // than the insertion of a point
 
 	OmniFEMMsg::instance()->MsgInfo("Delaunay 2D INSERTING");
     for (size_t i=0;i<v.size();i++){
       MVertex *pv = v[i];
 
       int NITER = 0;
-      T = Cpu();
-      MTri3 * found = getTriToBreak (pv,t,NB_GLOBAL_SEARCH,NITER);
-      ta += Cpu()-T;
+      MTri3 * found = getTriToBreak (pv,t,grid,i ? v[i-1] : 0,NB_GLOBAL_SEARCH,NITER);
       AVG_ITER += (double)NITER;
       if(!found) {
 		  OmniFEMMsg::instance()->MsgError("Cannot insert a point in 2D Delaunay");
@@ -2020,17 +2151,14 @@ void bowyerWatsonParallelogramsConstrained(GFace *gf,
       shell.clear();
       cavity.clear();
 
-      T = Cpu();
       recurFindCavity(shell, cavity, pv, found);
       AVG_CAVSIZE += (double)cavity.size();
-      tb += Cpu()-T;
       //double V = 0.0;
       //for (unsigned int k=0;k<cavity.size();k++)V+=fabs(cavity[k]->tri()->getVolume());
 
       std::vector<MTri3*> extended_cavity;
       //double Vb = 0.0;
 
-      T = Cpu();
       for (unsigned int count = 0; count < shell.size(); count++){
         const edgeXface &fxt = shell[count];
         MTriangle *tr;
@@ -2055,8 +2183,8 @@ void bowyerWatsonParallelogramsConstrained(GFace *gf,
         if (otherSide)
           extended_cavity.push_back(otherSide);
       }
-      tc += Cpu()-T;
       //if (fabs(Vb-V) > 1.e-8 * (Vb+V))printf("%12.5E %12.5E\n",Vb,V);
+      grid.add(pv, extended_cavity[0]);
 
       for (unsigned int k=0;k<std::min(cavity.size(),shell.size());k++){
         cavity[k]->setDeleted(false);
@@ -2064,9 +2192,7 @@ void bowyerWatsonParallelogramsConstrained(GFace *gf,
           cavity[k]->setNeigh(l,0);
         }
       }
-      T = Cpu();
       connectTris(extended_cavity.begin(),extended_cavity.end(),conn);
-      td += Cpu()-T;
     }
 
     double t2 = Cpu();
@@ -18,8 +18,405 @@
 #include "Mesh/GMSH/Context.h"
 #include "Mesh/GMSH/meshGFace.h"
 #include "Mesh/GMSH/BackgroundMesh.h"
+#include "Mesh/GMSH/GModel.h"
+#include "Mesh/GMSH/GEdge.h"
+#include "Mesh/GMSH/MLine.h"
+#include "Mesh/GMSH/BackgroundMeshTools.h"
+#include "Mesh/GMSH/robustPredicates.h"
+#include "Mesh/GMSH/GmshMessage.h"
+#include "common/OS.h"
+#include <map>
+#include <list>
+#include <vector>
+#include <random>
+#include <stdint.h>
+#include <unordered_map>
 //#include "Mesh/GMSH/GmshConfig.h"
 
+/****************class cvt_smoother****************/
+
+// Lloyd iterations on the triangulation of a face. The Voronoi cell of a
+// vertex is the dual of the triangles around it, so the centroids of the
+// cells are computed from the triangle stars in parallel. After the vertices
+// moved, the Delaunay property is restored by local edge flips around the
+// moved vertices instead of computing the whole Voronoi diagram again. The
+// iterations stop when the energy of the tessellation stops decreasing.
+
+class cvt_smoother{
+ private :
+  GFace *gf;
+  std::vector<MVertex*> vertices;
+  // (u,v) of each vertex, 2 per vertex
+  std::vector<double> uv;
+  // density 1/h^4 at each vertex
+  std::vector<double> rho;
+  std::vector<char> movable;
+  // 3 vertices per triangle, counter clockwise in (u,v)
+  std::vector<int> tris;
+  // triangle across edge (k,k+1) of each triangle, -1 on the boundary
+  std::vector<int> neighbors;
+  // triangles around each vertex
+  std::vector<int> star_start;
+  std::vector<int> star;
+  bool reversed;
+  void build_stars();
+  double cell_moments(int,double&,double&,double&);
+  bool valid_position(int,double,double);
+  bool flip(int,int);
+  int restore_delaunay(const std::vector<char>&);
+ public :
+  cvt_smoother(GFace*);
+  bool init();
+  int run(int,double&);
+  void write();
+};
+
+cvt_smoother::cvt_smoother(GFace *f) : gf(f), reversed(false) {}
+
+static inline uint64_t cvt_edge_key(int a, int b)
+{
+  if(a > b) std::swap(a, b);
+  return ((uint64_t)a << 32) | (uint32_t)b;
+}
+
+bool cvt_smoother::init()
+{
+  if(gf->triangles.empty() || !gf->quadrangles.empty() || !gf->polygons.empty())
+    return false;
+
+  std::map<MVertex*, int> index;
+  tris.resize(3 * gf->triangles.size());
+  for(unsigned int i = 0; i < gf->triangles.size(); i++){
+    MTriangle *t = gf->triangles[i];
+    if(t->getNumVertices() != 3) return false;
+    for(int j = 0; j < 3; j++){
+      MVertex *v = t->getVertex(j);
+      std::map<MVertex*, int>::iterator it = index.find(v);
+      if(it == index.end()){
+        SPoint2 p;
+        if(!reparamMeshVertexOnFace(v, gf, p)){
+          Msg::Error("Impossible to apply Lloyd to model face %d", gf->tag());
+          Msg::Error("A mesh vertex cannot be reparametrized");
+          return false;
+        }
+        it = index.insert(std::make_pair(v, (int)vertices.size())).first;
+        vertices.push_back(v);
+        uv.push_back(p.x());
+        uv.push_back(p.y());
+        movable.push_back(v->onWhat() == gf);
+      }
+      tris[3 * i + j] = it->second;
+    }
+  }
+
+  // the sizes of all the vertices are computed at once
+  const int n = vertices.size();
+  std::vector<double> u(n), v(n), x(n), y(n), z(n), h(n);
+  for(int i = 0; i < n; i++){
+    u[i] = uv[2 * i];
+    v[i] = uv[2 * i + 1];
+    x[i] = vertices[i]->x();
+    y[i] = vertices[i]->y();
+    z[i] = vertices[i]->z();
+  }
+  BGM_MeshSize(gf, n, &u[0], &v[0], &x[0], &y[0], &z[0], &h[0]);
+  rho.resize(n);
+  for(int i = 0; i < n; i++)
+    rho[i] = 1.0 / (h[i] * h[i] * h[i] * h[i]);
+
+  // the triangles of a face all have the same orientation in the parameter
+  // plane; they are stored counter clockwise and turned back in write()
+  int positive = 0, negative = 0;
+  for(unsigned int i = 0; i < tris.size(); i += 3){
+    const double o = robustPredicates::orient2d(&uv[2 * tris[i]], &uv[2 * tris[i + 1]],
+                                                &uv[2 * tris[i + 2]]);
+    if(o > 0) positive++;
+    else if(o < 0) negative++;
+  }
+  if(positive && negative) return false;
+  reversed = negative > 0;
+  if(reversed)
+    for(unsigned int i = 0; i < tris.size(); i += 3) std::swap(tris[i + 1], tris[i + 2]);
+
+  // the mesh edges of the model edges must stay where they are
+  std::set<uint64_t> constrained;
+  std::list<GEdge*> edges = gf->edges();
+  std::list<GEdge*> embedded = gf->embeddedEdges();
+  edges.insert(edges.end(), embedded.begin(), embedded.end());
+  for(std::list<GEdge*>::iterator it = edges.begin(); it != edges.end(); ++it){
+    for(unsigned int i = 0; i < (*it)->lines.size(); i++){
+      std::map<MVertex*, int>::iterator a = index.find((*it)->lines[i]->getVertex(0));
+      std::map<MVertex*, int>::iterator b = index.find((*it)->lines[i]->getVertex(1));
+      if(a != index.end() && b != index.end())
+        constrained.insert(cvt_edge_key(a->second, b->second));
+    }
+  }
+
+  neighbors.assign(tris.size(), -1);
+  std::unordered_map<uint64_t, int> open;
+  open.reserve(tris.size());
+  for(unsigned int i = 0; i < tris.size(); i++){
+    const int t = i / 3, k = i % 3;
+    const uint64_t key = cvt_edge_key(tris[i], tris[3 * t + (k + 1) % 3]);
+    if(constrained.count(key)) continue;
+    std::unordered_map<uint64_t, int>::iterator it = open.find(key);
+    if(it == open.end()) open[key] = i;
+    else{
+      neighbors[i] = it->second / 3;
+      neighbors[it->second] = t;
+      open.erase(it);
+    }
+  }
+
+  build_stars();
+  return true;
+}
+
+void cvt_smoother::build_stars()
+{
+  star_start.assign(vertices.size() + 1, 0);
+  for(unsigned int i = 0; i < tris.size(); i++) star_start[tris[i] + 1]++;
+  for(unsigned int i = 0; i < vertices.size(); i++) star_start[i + 1] += star_start[i];
+  star.resize(tris.size());
+  std::vector<int> fill(star_start.begin(), star_start.end() - 1);
+  for(unsigned int i = 0; i < tris.size(); i++) star[fill[tris[i]]++] = i / 3;
+}
+
+// Integrates the density over the Voronoi cell of a vertex. The cell is cut
+// into the signed triangles (vertex, edge midpoint, circumcenter) of each
+// triangle of the star. Circumcenters outside the face are moved back onto
+// the boundary edge so that the cells are clipped by the boundary. Returns
+// the second moment about the vertex
+double cvt_smoother::cell_moments(int i, double &mass, double &mu, double &mv)
+{
+  const double *p = &uv[2 * i];
+  double energy = 0.0;
+  mass = mu = mv = 0.0;
+  for(int s = star_start[i]; s < star_start[i + 1]; s++){
+    const int t = star[s];
+    int k = 0;
+    while(tris[3 * t + k] != i) k++;
+    const int j = tris[3 * t + (k + 1) % 3], l = tris[3 * t + (k + 2) % 3];
+    const double *pj = &uv[2 * j], *pl = &uv[2 * l];
+    const double density = (rho[i] + rho[j] + rho[l]) / 3.0;
+
+    // circumcenter relative to the vertex
+    const double bx = pj[0] - p[0], by = pj[1] - p[1];
+    const double cx = pl[0] - p[0], cy = pl[1] - p[1];
+    const double d = 2.0 * (bx * cy - by * cx);
+    if(d <= 0.0) continue;
+    const double b2 = bx * bx + by * by, c2 = cx * cx + cy * cy;
+    double ox = (cy * b2 - by * c2) / d;
+    double oy = (bx * c2 - cx * b2) / d;
+
+    for(int e = 0; e < 3; e++){
+      if(neighbors[3 * t + e] >= 0) continue;
+      const double *a = &uv[2 * tris[3 * t + e]];
+      const double *b = &uv[2 * tris[3 * t + (e + 1) % 3]];
+      const double side = (b[0] - a[0]) * (oy + p[1] - a[1]) - (b[1] - a[1]) * (ox + p[0] - a[0]);
+      if(side < 0.0){
+        ox = 0.5 * (a[0] + b[0]) - p[0];
+        oy = 0.5 * (a[1] + b[1]) - p[1];
+      }
+    }
+
+    const double m[2][2] = {{0.5 * bx, 0.5 * by}, {0.5 * cx, 0.5 * cy}};
+    for(int h = 0; h < 2; h++){
+      // (vertex, midpoint, circumcenter) and (vertex, circumcenter, midpoint)
+      const double *q = m[h];
+      const double area = h == 0 ? 0.5 * (q[0] * oy - q[1] * ox) : 0.5 * (ox * q[1] - oy * q[0]);
+      const double w = density * area;
+      mass += w;
+      mu += w * (q[0] + ox) / 3.0;
+      mv += w * (q[1] + oy) / 3.0;
+      energy += w * (q[0] * q[0] + q[1] * q[1] + ox * ox + oy * oy + q[0] * ox + q[1] * oy) / 6.0;
+    }
+  }
+  return energy;
+}
+
+bool cvt_smoother::valid_position(int i, double u, double v)
+{
+  double p[2] = {u, v};
+  for(int s = star_start[i]; s < star_start[i + 1]; s++){
+    const int t = star[s];
+    double *c[3];
+    for(int k = 0; k < 3; k++) c[k] = tris[3 * t + k] == i ? p : &uv[2 * tris[3 * t + k]];
+    if(robustPredicates::orient2d(c[0], c[1], c[2]) <= 0.0) return false;
+  }
+  return true;
+}
+
+// Flips edge k of triangle t if the opposite vertex of the neighbor lies in
+// the circumcircle of t. The stars are not updated
+bool cvt_smoother::flip(int t, int k)
+{
+  const int n = neighbors[3 * t + k];
+  if(n < 0) return false;
+  const int a = tris[3 * t + k], b = tris[3 * t + (k + 1) % 3], c = tris[3 * t + (k + 2) % 3];
+  int j = 0;
+  while(tris[3 * n + j] != b) j++;
+  const int d = tris[3 * n + (j + 2) % 3];
+  if(robustPredicates::incircle(&uv[2 * a], &uv[2 * b], &uv[2 * c], &uv[2 * d]) <= 0.0 ||
+     robustPredicates::orient2d(&uv[2 * a], &uv[2 * d], &uv[2 * c]) <= 0.0 ||
+     robustPredicates::orient2d(&uv[2 * b], &uv[2 * c], &uv[2 * d]) <= 0.0)
+    return false;
+
+  const int nbc = neighbors[3 * t + (k + 1) % 3], nca = neighbors[3 * t + (k + 2) % 3];
+  const int nad = neighbors[3 * n + (j + 1) % 3], ndb = neighbors[3 * n + (j + 2) % 3];
+  tris[3 * t] = a; tris[3 * t + 1] = d; tris[3 * t + 2] = c;
+  neighbors[3 * t] = nad; neighbors[3 * t + 1] = n; neighbors[3 * t + 2] = nca;
+  tris[3 * n] = b; tris[3 * n + 1] = c; tris[3 * n + 2] = d;
+  neighbors[3 * n] = nbc; neighbors[3 * n + 1] = t; neighbors[3 * n + 2] = ndb;
+  for(int e = 0; nad >= 0 && e < 3; e++)
+    if(neighbors[3 * nad + e] == n) neighbors[3 * nad + e] = t;
+  for(int e = 0; nbc >= 0 && e < 3; e++)
+    if(neighbors[3 * nbc + e] == t) neighbors[3 * nbc + e] = n;
+  return true;
+}
+
+int cvt_smoother::restore_delaunay(const std::vector<char> &moved)
+{
+  std::vector<int> stack;
+  for(unsigned int i = 0; i < vertices.size(); i++)
+    if(moved[i])
+      for(int s = star_start[i]; s < star_start[i + 1]; s++) stack.push_back(star[s]);
+
+  int flips = 0;
+  while(!stack.empty()){
+    const int t = stack.back();
+    stack.pop_back();
+    for(int k = 0; k < 3; k++){
+      const int n = neighbors[3 * t + k];
+      if(flip(t, k)){
+        flips++;
+        stack.push_back(t);
+        stack.push_back(n);
+        break;
+      }
+    }
+  }
+  if(flips) build_stars();
+  return flips;
+}
+
+// Runs at most maxIter iterations and returns the number of iterations done.
+// decrease is set to the relative decrease of the energy
+int cvt_smoother::run(int maxIter, double &decrease)
+{
+  const int n = vertices.size();
+  const double tolerance = 1.e-4;
+  std::vector<double> target(2 * n);
+  std::vector<char> moved(n);
+  double first = 0.0, previous = 0.0;
+  int iter = 0;
+
+  decrease = 0.0;
+  for(; iter < maxIter; iter++){
+    double energy = 0.0;
+#if defined(_OPENMP)
+#pragma omp parallel for schedule(static) reduction(+:energy)
+#endif
+    for(int i = 0; i < n; i++){
+      double mass, mu, mv;
+      energy += cell_moments(i, mass, mu, mv);
+      target[2 * i] = uv[2 * i];
+      target[2 * i + 1] = uv[2 * i + 1];
+      if(movable[i] && mass > 0.0){
+        target[2 * i] += mu / mass;
+        target[2 * i + 1] += mv / mass;
+      }
+    }
+
+    if(iter == 0) first = energy;
+    else{
+      decrease = (first - energy) / first;
+      if(previous - energy < tolerance * previous) break;
+    }
+    previous = energy;
+
+    // the centroids are applied one vertex after the other so that no
+    // triangle is inverted by two neighbors moving at the same time
+    int numMoved = 0;
+    for(int i = 0; i < n; i++){
+      moved[i] = 0;
+      if(!movable[i]) continue;
+      double u = target[2 * i], v = target[2 * i + 1];
+      if(!valid_position(i, u, v)){
+        u = 0.5 * (u + uv[2 * i]);
+        v = 0.5 * (v + uv[2 * i + 1]);
+        if(!valid_position(i, u, v)) continue;
+      }
+      uv[2 * i] = u;
+      uv[2 * i + 1] = v;
+      moved[i] = 1;
+      numMoved++;
+    }
+    if(!numMoved) break;
+    restore_delaunay(moved);
+  }
+  return iter;
+}
+
+void cvt_smoother::write()
+{
+  for(unsigned int i = 0; i < vertices.size(); i++){
+    if(!movable[i]) continue;
+    MVertex *v = vertices[i];
+    GPoint gp = gf->point(uv[2 * i], uv[2 * i + 1]);
+    v->x() = gp.x();
+    v->y() = gp.y();
+    v->z() = gp.z();
+    v->setParameter(0, uv[2 * i]);
+    v->setParameter(1, uv[2 * i + 1]);
+  }
+  // the flips keep the number of triangles, only the vertices change
+  for(unsigned int i = 0; i < gf->triangles.size(); i++){
+    MTriangle *t = gf->triangles[i];
+    t->setVertex(0, vertices[tris[3 * i]]);
+    t->setVertex(1, vertices[tris[3 * i + (reversed ? 2 : 1)]]);
+    t->setVertex(2, vertices[tris[3 * i + (reversed ? 1 : 2)]]);
+  }
+}
+
+/****************class smoothing****************/
+
+smoothing::smoothing(int param1,int param2){
+  ITER_MAX = param1;
+  NORM = param2;
+}
+
+void smoothing::optimize_face(GFace* gf){
+  if(gf->getNumMeshElements()==0 || gf->getCompound()) return;
+
+  double t1 = Cpu();
+  cvt_smoother smoother(gf);
+  if(!smoother.init()){
+    Msg::Debug("Lloyd skipped on face %d", gf->tag());
+    return;
+  }
+  double decrease;
+  int iter = smoother.run(ITER_MAX, decrease);
+  smoother.write();
+  Msg::Debug("Lloyd on face %d: %d iterations, energy decreased by %g%% (%g s)",
+             gf->tag(), iter, 100.0 * decrease, Cpu() - t1);
+}
+
+void smoothing::optimize_model(){
+  GFace*gf;
+  GModel*model = GModel::current();
+  GModel::fiter it;
+
+  for(it=model->firstFace();it!=model->lastFace();it++)
+  {
+    gf = *it;
+	if(gf->getNumMeshElements()>0 && !gf->getCompound() /*&& gf->geomType()==GEntity::CompoundSurface*/){
+	  optimize_face(gf);
+	  //recombineIntoQuads(gf,1,1);
+	}
+  }
+}
+
 #if defined(HAVE_BFGS)
 
 #include "Mesh/BFGS/ap.h"
@@ -28,7 +425,7 @@
 #include "Mesh/BFGS/linalg.h"
 #include "Mesh/BFGS/optimization.h"
 #include "Mesh/GMSH/polynomialBasis.h"
-#include "Mesh/GMSH/MElementOctree.h"
+#include "Mesh/GMSH/MElementGrid.h"
 #include "Mesh/GMSH/GModel.h"
 #include "Mesh/GMSH/meshGFaceOptimize.h"
 #include <algorithm>
@@ -159,7 +556,7 @@ class wrapper{
   int max;
   double start;
   DocRecord* triangulator;
-  MElementOctree* octree;
+  MElementGrid* grid;
  public :
   wrapper();
   ~wrapper();
@@ -177,8 +574,8 @@ class wrapper{
   void set_start(double);
   DocRecord* get_triangulator();
   void set_triangulator(DocRecord*);
-  MElementOctree* get_octree();
-  void set_octree(MElementOctree*);
+  MElementGrid* get_grid();
+  void set_grid(MElementGrid*);
 };
 
 class lpcvt{
@@ -245,10 +642,10 @@ class lpcvt{
 
 /****************functions****************/
 
-bool domain_search(MElementOctree* octree,double x,double y){
+bool domain_search(MElementGrid* grid,double x,double y){
   MElement* element;
 
-  element = (MElement*)octree->find(x,y,0.0,2,true);
+  element = (MElement*)grid->find(x,y);
   if(element!=NULL) return 1;
   else return 0;
 }
@@ -275,7 +672,7 @@ void callback(const alglib::real_1d_array& x,double& func,alglib::real_1d_array&
   GFace* gf;
   DocRecord* pointer;
   wrapper* w;
-  MElementOctree* octree;
+  MElementGrid* grid;
   lpcvt obj;
   std::vector<SVector3> gradients;
 
@@ -287,7 +684,7 @@ void callback(const alglib::real_1d_array& x,double& func,alglib::real_1d_array&
   max = w->get_max();
   start = w->get_start();
   pointer = w->get_triangulator();
-  octree = w->get_octree();
+  grid = w->get_grid();
   num = pointer->numPoints;
   gradients.resize(num);
   error1 = 0;
@@ -299,7 +696,7 @@ void callback(const alglib::real_1d_array& x,double& func,alglib::real_1d_array&
 	if(obj.interior(*pointer,gf,i)){
 	  u = x[index];
 	  v = x[index + dimension/2];
-	  inside = domain_search(octree,u,v);
+	  inside = domain_search(grid,u,v);
 	  if(!inside) error1 = 1;
 	  pointer->points[i].where.h = u;
 	  pointer->points[i].where.v = v;
@@ -377,8 +774,8 @@ void verification(alglib::real_1d_array& x,void* ptr){
 
   w = static_cast<wrapper*>(ptr);
   dimension = w->get_dimension();
-  srand(time(NULL));
-  index = rand()%(dimension/2);
+  static thread_local std::mt19937 generator(time(NULL));
+  index = std::uniform_int_distribution<int>(0, dimension/2 - 1)(generator);
   e = 0.0000001;
 
   alglib::real_1d_array grad;
@@ -406,14 +803,9 @@ void verification(alglib::real_1d_array& x,void* ptr){
   printf("%f %f\n",grad[index],grad[index + dimension/2]);
 }
 
-/****************class smoothing****************/
+/****************LpCVT with BFGS****************/
 
-smoothing::smoothing(int param1,int param2){
-  ITER_MAX = param1;
-  NORM = param2;
-}
-
-void smoothing::optimize_face(GFace* gf){
+void smoothing::optimize_face_lpcvt(GFace* gf){
   if(gf->getNumMeshElements()==0 || gf->getCompound()) return;
 
   std::set<MVertex*> all;
@@ -441,6 +833,10 @@ void smoothing::optimize_face(GFace* gf){
   //printf("Lloyd on face %d %d elements %d nodes LC %g\n", gf->tag(),
   //       gf->getNumMeshElements(), (int)all.size(), LC2D);
 
+  // faces may be smoothed from several threads, rand() is shared by all of them
+  static thread_local std::mt19937 generator(12345);
+  std::uniform_real_distribution<double> jitter(0.0, 1.0);
+
   int i = 0;
   for (std::set<MVertex*>::iterator it = all.begin(); it != all.end(); ++it){
     SPoint2 p;
@@ -450,10 +846,8 @@ void smoothing::optimize_face(GFace* gf){
       Msg::Error("A mesh vertex cannot be reparametrized");
       return;
     }
-    double XX = CTX::instance()->mesh.randFactor * LC2D * (double)rand() /
-      (double)RAND_MAX;
-    double YY = CTX::instance()->mesh.randFactor * LC2D * (double)rand() /
-      (double)RAND_MAX;
+    double XX = CTX::instance()->mesh.randFactor * LC2D * jitter(generator);
+    double YY = CTX::instance()->mesh.randFactor * LC2D * jitter(generator);
     triangulator.x(i) = p.x() + XX;
     triangulator.y(i) = p.y() + YY;
     triangulator.data(i++) = (*it);
@@ -462,7 +856,11 @@ void smoothing::optimize_face(GFace* gf){
   // compute the Voronoi diagram
   triangulator.Voronoi();
   //printf("hullSize = %d\n",triangulator.hullSize());
-  triangulator.makePosView("LloydInit.pos");
+  if(Msg::GetDebugFiles()){
+    char name[256];
+    sprintf(name, "LloydInit-%d.pos", gf->tag());
+    triangulator.makePosView(name);
+  }
   //triangulator.printMedialAxis("medialAxis.pos");
 
   int exponent;
@@ -483,7 +881,7 @@ void smoothing::optimize_face(GFace* gf){
   alglib::real_1d_array x;
   alglib::real_1d_array scales;
   wrapper w;
-  MElementOctree* octree;
+  MElementGrid* grid;
 
   exponent = NORM;
   epsg = 0;
@@ -516,14 +914,14 @@ void smoothing::optimize_face(GFace* gf){
   x.setcontent(2*num_interior,initial_conditions);
   scales.setcontent(2*num_interior,variables_scales);
 
-  octree = backgroundMesh::current()->get_octree();
+  grid = backgroundMesh::current()->get_grid();
 
   w.set_p(exponent);
   w.set_dimension(2*num_interior);
   w.set_face(gf);
   w.set_max(2*ITER_MAX);
   w.set_triangulator(&triangulator);
-  w.set_octree(octree);
+  w.set_grid(grid);
 
   /*if(num_interior>1){
     verification(x,&w);
@@ -592,21 +990,6 @@ void smoothing::optimize_face(GFace* gf){
   backgroundMesh::unset();
 }
 
-void smoothing::optimize_model(){
-  GFace*gf;
-  GModel*model = GModel::current();
-  GModel::fiter it;
-
-  for(it=model->firstFace();it!=model->lastFace();it++)
-  {
-    gf = *it;
-	if(gf->getNumMeshElements()>0 && !gf->getCompound() /*&& gf->geomType()==GEntity::CompoundSurface*/){
-	  optimize_face(gf);
-	  //recombineIntoQuads(gf,1,1);
-	}
-  }
-}
-
 /****************class lpcvt****************/
 
 lpcvt::lpcvt(){}
@@ -2198,12 +2581,12 @@ void wrapper::set_triangulator(DocRecord* new_triangulator){
   triangulator = new_triangulator;
 }
 
-MElementOctree* wrapper::get_octree(){
-  return octree;
+MElementGrid* wrapper::get_grid(){
+  return grid;
 }
 
-void wrapper::set_octree(MElementOctree* new_octree){
-  octree = new_octree;
+void wrapper::set_grid(MElementGrid* new_grid){
+  grid = new_grid;
 }
 
 #endif
@@ -358,6 +358,174 @@ void buildEdgeToElements(std::vector<MElement*> &tris, e2t_cont &adj)
   buildEdgeToElement(tris, adj);
 }
 
+void faceAdjacency::build(GFace *gf)
+{
+  _vertices.clear();
+  _index.clear();
+  _colorStart.clear();
+  _colored.clear();
+
+  for(unsigned int i = 0; i < gf->triangles.size(); i++)
+    for(int j = 0; j < gf->triangles[i]->getNumVertices(); j++)
+      _vertices.push_back(gf->triangles[i]->getVertex(j));
+  for(unsigned int i = 0; i < gf->quadrangles.size(); i++)
+    for(int j = 0; j < gf->quadrangles[i]->getNumVertices(); j++)
+      _vertices.push_back(gf->quadrangles[i]->getVertex(j));
+  std::sort(_vertices.begin(), _vertices.end(), MVertexLessThanNum());
+  _vertices.erase(std::unique(_vertices.begin(), _vertices.end()), _vertices.end());
+  _index.reserve(_vertices.size());
+  for(unsigned int i = 0; i < _vertices.size(); i++) _index[_vertices[i]] = i;
+
+  const int n = _vertices.size();
+  _size.assign(n, 0);
+  for(unsigned int i = 0; i < gf->triangles.size(); i++)
+    for(int j = 0; j < gf->triangles[i]->getNumVertices(); j++)
+      _size[_index[gf->triangles[i]->getVertex(j)]]++;
+  for(unsigned int i = 0; i < gf->quadrangles.size(); i++)
+    for(int j = 0; j < gf->quadrangles[i]->getNumVertices(); j++)
+      _size[_index[gf->quadrangles[i]->getVertex(j)]]++;
+
+  // two spare slots per row
+  _start.resize(n);
+  _capacity.resize(n);
+  int total = 0;
+  for(int i = 0; i < n; i++){
+    _start[i] = total;
+    _capacity[i] = _size[i] + 2;
+    total += _capacity[i];
+    _size[i] = 0;
+  }
+  _elements.assign(total, (MElement*)0);
+  for(unsigned int i = 0; i < gf->triangles.size(); i++)
+    for(int j = 0; j < gf->triangles[i]->getNumVertices(); j++)
+      _add(_index[gf->triangles[i]->getVertex(j)], gf->triangles[i]);
+  for(unsigned int i = 0; i < gf->quadrangles.size(); i++)
+    for(int j = 0; j < gf->quadrangles[i]->getNumVertices(); j++)
+      _add(_index[gf->quadrangles[i]->getVertex(j)], gf->quadrangles[i]);
+}
+
+int faceAdjacency::getIndex(MVertex *v) const
+{
+  std::unordered_map<MVertex*, int>::const_iterator it = _index.find(v);
+  return it == _index.end() ? -1 : it->second;
+}
+
+void faceAdjacency::getElements(int i, std::vector<MElement*> &lt) const
+{
+  lt.assign(_elements.begin() + _start[i], _elements.begin() + _start[i] + _size[i]);
+}
+
+void faceAdjacency::_add(int i, MElement *e)
+{
+  if(_size[i] == _capacity[i]){
+    // the row is full, it is moved to the end with twice the room
+    const int start = _elements.size();
+    _capacity[i] = 2 * _capacity[i] + 2;
+    _elements.resize(start + _capacity[i], (MElement*)0);
+    std::copy(_elements.begin() + _start[i], _elements.begin() + _start[i] + _size[i],
+              _elements.begin() + start);
+    _start[i] = start;
+  }
+  _elements[_start[i] + _size[i]++] = e;
+}
+
+void faceAdjacency::_remove(int i, MElement *e)
+{
+  MElement **row = &_elements[_start[i]];
+  MElement **last = std::remove(row, row + _size[i], e);
+  _size[i] = last - row;
+}
+
+void faceAdjacency::addElement(MElement *e)
+{
+  for(int j = 0; j < e->getNumVertices(); j++){
+    MVertex *v = e->getVertex(j);
+    int i = getIndex(v);
+    if(i < 0){
+      i = _vertices.size();
+      _vertices.push_back(v);
+      _index[v] = i;
+      _start.push_back(_elements.size());
+      _size.push_back(0);
+      _capacity.push_back(4);
+      _elements.resize(_elements.size() + 4, (MElement*)0);
+    }
+    _add(i, e);
+  }
+  _colorStart.clear();
+}
+
+void faceAdjacency::removeElement(MElement *e)
+{
+  for(int j = 0; j < e->getNumVertices(); j++){
+    const int i = getIndex(e->getVertex(j));
+    if(i >= 0) _remove(i, e);
+  }
+  _colorStart.clear();
+}
+
+void faceAdjacency::mergeVertex(MVertex *v1, MVertex *v2)
+{
+  const int i1 = getIndex(v1), i2 = getIndex(v2);
+  if(i1 < 0 || i2 < 0) return;
+  for(int j = 0; j < _size[i1]; j++){
+    MElement *e = _elements[_start[i1] + j];
+    MElement **row = &_elements[_start[i2]];
+    if(std::find(row, row + _size[i2], e) == row + _size[i2]) _add(i2, e);
+  }
+  _size[i1] = 0;
+  _colorStart.clear();
+}
+
+void faceAdjacency::removeVertex(MVertex *v)
+{
+  std::unordered_map<MVertex*, int>::iterator it = _index.find(v);
+  if(it == _index.end()) return;
+  _size[it->second] = 0;
+  _vertices[it->second] = 0;
+  _index.erase(it);
+  _colorStart.clear();
+}
+
+// greedy coloring, a vertex takes the first color that none of the vertices
+// of its elements has
+void faceAdjacency::_computeColors()
+{
+  const int n = _vertices.size();
+  std::vector<int> color(n, -1);
+  std::vector<int> used;
+  int nc = 0;
+  for(int i = 0; i < n; i++){
+    for(int j = 0; j < _size[i]; j++){
+      MElement *e = _elements[_start[i] + j];
+      for(int k = 0; k < e->getNumVertices(); k++){
+        const int l = getIndex(e->getVertex(k));
+        if(l >= 0 && color[l] >= 0) used[color[l]] = i;
+      }
+    }
+    int c = 0;
+    while(c < nc && used[c] == i) c++;
+    if(c == nc){
+      nc++;
+      used.push_back(-1);
+    }
+    color[i] = c;
+  }
+
+  _colorStart.assign(nc + 1, 0);
+  for(int i = 0; i < n; i++) _colorStart[color[i] + 1]++;
+  for(int c = 0; c < nc; c++) _colorStart[c + 1] += _colorStart[c];
+  _colored.resize(n);
+  std::vector<int> fill(_colorStart.begin(), _colorStart.end() - 1);
+  for(int i = 0; i < n; i++) _colored[fill[color[i]]++] = i;
+}
+
+int faceAdjacency::numColors()
+{
+  if(_colorStart.empty()) _computeColors();
+  return _colorStart.size() - 1;
+}
+
 void buildListOfEdgeAngle(e2t_cont adj, std::vector<edge_angle> &edges_detected,
                           std::vector<edge_angle> &edges_lonly)
 {
@@ -469,22 +637,20 @@ void removeThreeTrianglesNodes(GFace *gf)
   while(_removeThreeTrianglesNodes(gf));
 }
 
-static int _removeTwoQuadsNodes(GFace *gf)
+static int _removeTwoQuadsNodes(GFace *gf, faceAdjacency &adj)
 {
-  v2t_cont adj;
-  buildVertexToElement(gf->triangles,adj);
-  buildVertexToElement(gf->quadrangles,adj);
-  v2t_cont :: iterator it = adj.begin();
   std::set<MElement*>  touched;
+  std::set<MElement*>  created;
   std::set<MVertex*>  vtouched;
-  while (it != adj.end()) {
-    MVertex *v = it->first;
-    if(it->second.size()==2 && v->onWhat()->dim() == 2) {
-      MElement *q1 = it->second[0];
-      MElement *q2 = it->second[1];
+  for (int iv = 0; iv < adj.numVertices(); iv++) {
+    MVertex *v = adj.getVertex(iv);
+    if(adj.numElements(iv)==2 && v->onWhat()->dim() == 2) {
+      MElement *q1 = adj.getElement(iv,0);
+      MElement *q2 = adj.getElement(iv,1);
       if (q1->getNumVertices() == 4 &&
           q2->getNumVertices() == 4 &&
-          touched.find(q1) == touched.end() && touched.find(q2) == touched.end()){
+          touched.find(q1) == touched.end() && touched.find(q2) == touched.end() &&
+          created.find(q1) == created.end() && created.find(q2) == created.end()){
         int comm = 0;
         for (int i=0;i<4;i++){
           if (q1->getVertex(i) == v){
@@ -518,12 +684,17 @@ static int _removeTwoQuadsNodes(GFace *gf)
         else{
           touched.insert(q1);
           touched.insert(q2);
+          // the vertices of q1 and q2 now see q, which must not be merged again
+          created.insert(q);
           gf->quadrangles.push_back(q);
           vtouched.insert(v);
+          adj.removeElement(q1);
+          adj.removeElement(q2);
+          adj.addElement(q);
+          adj.removeVertex(v);
         }
       }
     }
-    it++;
   }
   std::vector<MQuadrangle*> quadrangles2;
   quadrangles2.reserve(gf->quadrangles.size() - touched.size());
@@ -552,11 +723,11 @@ static int _removeTwoQuadsNodes(GFace *gf)
   return vtouched.size();
 }
 
-int removeTwoQuadsNodes(GFace *gf)
+int removeTwoQuadsNodes(GFace *gf, faceAdjacency &adj)
 {
   int nbRemove = 0;
   while(1){
-    int x = _removeTwoQuadsNodes(gf);
+    int x = _removeTwoQuadsNodes(gf, adj);
     if (!x)break;
     nbRemove += x;
   }
@@ -564,6 +735,12 @@ int removeTwoQuadsNodes(GFace *gf)
   return nbRemove;
 }
 
+int removeTwoQuadsNodes(GFace *gf)
+{
+  faceAdjacency adj(gf);
+  return removeTwoQuadsNodes(gf, adj);
+}
+
 
 static bool _tryToCollapseThatVertex2 (GFace *gf,
 				       std::vector<MElement*> &e1,
@@ -738,10 +915,8 @@ static bool _isItAGoodIdeaToMoveThatVertex(GFace *gf,
   return true;
 }
 
-static int _removeDiamonds(GFace *gf)
+static int _removeDiamonds(GFace *gf, faceAdjacency &adj)
 {
-  v2t_cont adj;
-  buildVertexToElement(gf->quadrangles,adj);
   std::set<MElement*> diamonds;
   std::set<MVertex*> touched;
   std::set<MVertex*> deleted;
@@ -760,10 +935,12 @@ static int _removeDiamonds(GFace *gf)
     MVertex *v2 = q->getVertex(1);
     MVertex *v3 = q->getVertex(2);
     MVertex *v4 = q->getVertex(3);
-    v2t_cont::iterator it1 = adj.find(v1);
-    v2t_cont::iterator it2 = adj.find(v2);
-    v2t_cont::iterator it3 = adj.find(v3);
-    v2t_cont::iterator it4 = adj.find(v4);
+    // the vertices of the triangles are touched, so the rows only hold quadrangles
+    std::vector<MElement*> e1, e2, e3, e4;
+    adj.getElements(adj.getIndex(v1), e1);
+    adj.getElements(adj.getIndex(v2), e2);
+    adj.getElements(adj.getIndex(v3), e3);
+    adj.getElements(adj.getIndex(v4), e4);
     if (touched.find(v1) == touched.end() &&
         touched.find(v2) == touched.end() &&
         touched.find(v3) == touched.end() &&
@@ -772,8 +949,8 @@ static int _removeDiamonds(GFace *gf)
           v2->onWhat()->dim() == 2 &&
           v3->onWhat()->dim() == 2 &&
           v4->onWhat()->dim() == 2 &&
-          it1->second.size() == 3 && it3->second.size() == 3 &&
-          _tryToCollapseThatVertex (gf, it1->second, it3->second,
+          e1.size() == 3 && e3.size() == 3 &&
+          _tryToCollapseThatVertex (gf, e1, e3,
                                       q, v1, v3)){
         touched.insert(v1);
         touched.insert(v2);
@@ -781,13 +958,16 @@ static int _removeDiamonds(GFace *gf)
         touched.insert(v4);
         deleted.insert(v3);
         diamonds.insert(q);
+        adj.removeElement(q);
+        adj.mergeVertex(v3, v1);
+        adj.removeVertex(v3);
       }
       else if (v1->onWhat()->dim() == 2 &&
                v2->onWhat()->dim() == 2 &&
                v3->onWhat()->dim() == 2 &&
                v4->onWhat()->dim() == 2 &&
-               it2->second.size() ==3 &&  it4->second.size() == 3 &&
-               _tryToCollapseThatVertex (gf, it2->second, it4->second,
+               e2.size() ==3 &&  e4.size() == 3 &&
+               _tryToCollapseThatVertex (gf, e2, e4,
                                          q, v2, v4)){
         touched.insert(v1);
         touched.insert(v2);
@@ -795,6 +975,9 @@ static int _removeDiamonds(GFace *gf)
         touched.insert(v4);
         deleted.insert(v4);
         diamonds.insert(q);
+        adj.removeElement(q);
+        adj.mergeVertex(v4, v2);
+        adj.removeVertex(v4);
       }
       else {
         quadrangles2.push_back(q);
@@ -821,11 +1004,11 @@ static int _removeDiamonds(GFace *gf)
   return diamonds.size();
 }
 
-int removeDiamonds(GFace *gf)
+int removeDiamonds(GFace *gf, faceAdjacency &adj)
 {
   int nbRemove = 0;
   while(1){
-    int x = _removeDiamonds(gf);
+    int x = _removeDiamonds(gf, adj);
     if (!x)break;
     nbRemove += x;
   }
@@ -833,6 +1016,12 @@ int removeDiamonds(GFace *gf)
   return nbRemove;
 }
 
+int removeDiamonds(GFace *gf)
+{
+  faceAdjacency adj(gf);
+  return removeDiamonds(gf, adj);
+}
+
 struct p1p2p3 {
   MVertex *p1,*p2;
 };
@@ -921,22 +1110,36 @@ void getAllBoundaryLayerVertices (GFace *gf, std::set<MVertex*> &vs){
 }
 
 void laplaceSmoothing(GFace *gf, int niter, bool infinity_norm)
+{
+  if (!niter)return;
+  faceAdjacency adj(gf);
+  laplaceSmoothing(gf, adj, niter, infinity_norm);
+}
+
+void laplaceSmoothing(GFace *gf, faceAdjacency &adj, int niter, bool infinity_norm)
 {
   if (!niter)return;
   std::set<MVertex*> vs;
   getAllBoundaryLayerVertices (gf, vs);
-  v2t_cont adj;
-  buildVertexToElement(gf->triangles, adj);
-  buildVertexToElement(gf->quadrangles, adj);
   for(int i = 0; i < niter; i++){
-    v2t_cont::iterator it = adj.begin();
-    while (it != adj.end()){
-      if (vs.find(it->first) == vs.end()){
-	_relocateVertex(gf, it->first, it->second);
+    // the vertices of one color share no element, each sweep over a color is
+    // a Jacobi sweep
+    for(int c = 0; c < adj.numColors(); c++){
+      const int n = adj.colorSize(c);
+#if defined(_OPENMP)
+#pragma omp parallel for schedule(dynamic, 64)
+#endif
+      for(int k = 0; k < n; k++){
+        const int j = adj.colorVertex(c, k);
+        if (!adj.numElements(j) || vs.find(adj.getVertex(j)) != vs.end()) continue;
+        std::vector<MElement*> lt;
+        adj.getElements(j, lt);
+        _relocateVertex(gf, adj.getVertex(j), lt);
       }
-      ++it;
     }
   }
+  // the messages of the worker threads are written by the main thread
+  Msg::FlushQueuedMessages();
 }
 
 bool edgeSwapDelProj (MVertex *v1, MVertex *v2, MVertex *v3, MVertex *v4)
@@ -1225,7 +1428,7 @@ static int _recombineIntoQuads(GFace *gf, double minqual, bool cubicGraph = 1)
          emb_edgeverts.find(it->first.getVertex(1)) == emb_edgeverts.end())){
       pairs.push_back(RecombineTriangle(it->first,
                                      it->second.first,
-                                     it->second.second));
+                                     it->second.second, false));
     }
     else if (!it->second.second &&
              it->second.first->getNumVertices() == 3){
@@ -1246,6 +1449,21 @@ static int _recombineIntoQuads(GFace *gf, double minqual, bool cubicGraph = 1)
     }
   }
 
+  // the quadrangles n1 n3 n2 n4 of all the pairs are measured in one batch
+  {
+    qmElementArrays quads;
+    quads.nodes.reserve(4 * pairs.size());
+    for(unsigned int i = 0; i < pairs.size(); i++)
+      quads.addElement(pairs[i].n1, pairs[i].n3, pairs[i].n2, pairs[i].n4);
+    std::vector<double> eta(pairs.size()), angle(pairs.size());
+    qmQuadrangle::eta(pairs.size(), quads.nodes.data(), quads.x.data(),
+                      quads.y.data(), quads.z.data(), eta.data(), angle.data());
+    for(unsigned int i = 0; i < pairs.size(); i++){
+      pairs[i].angle = eta[i];
+      pairs[i].quality = angle[i];
+    }
+  }
+
   std::sort(pairs.begin(),pairs.end());
   std::set<MElement*> touched;
 
@@ -1419,8 +1637,13 @@ static double printStats(GFace *gf,const char *message)
   int nbInv=0;
   double Qav=0;
   double Qmin=1;
+  qmElementArrays quads;
+  quads.gather(gf->quadrangles);
+  std::vector<double> eta(gf->quadrangles.size());
+  qmQuadrangle::eta(eta.size(), quads.nodes.data(), quads.x.data(),
+                    quads.y.data(), quads.z.data(), eta.data());
   for (unsigned int i=0;i<gf->quadrangles.size();i++){
-    double Q = gf->quadrangles[i]->etaShapeMeasure() ;
+    double Q = eta[i];
     if (Q <= 0.0)nbInv ++;
     if (Q <= 0.1)nbBad ++;
     Qav += Q;
@@ -1450,8 +1673,11 @@ void recombineIntoQuads(GFace *gf,
   
  // if (saveAll) gf->model()->writeMSH("raw.msh");
 
+  // shared by the smoothing and the cleanups until quadsToTriangles
+  faceAdjacency adj(gf);
+
   if(haveParam && nodeRepositioning){
-    RelocateVertices (gf,CTX::instance()->mesh.nbSmoothing);
+    RelocateVertices (gf,adj,CTX::instance()->mesh.nbSmoothing);
   }
   // blossom-quad algo
   if(success && CTX::instance()->mesh.algoRecombine != 0){
@@ -1463,9 +1689,9 @@ void recombineIntoQuads(GFace *gf,
         int nbTwoQuadNodes = 1;
         int nbDiamonds = 1;
         while(nbTwoQuadNodes || nbDiamonds){
-          nbTwoQuadNodes = removeTwoQuadsNodes(gf);
-          nbDiamonds = removeDiamonds(gf) ;
-          if(haveParam) RelocateVertices (gf,CTX::instance()->mesh.nbSmoothing);
+          nbTwoQuadNodes = removeTwoQuadsNodes(gf, adj);
+          nbDiamonds = removeDiamonds(gf, adj) ;
+          if(haveParam) RelocateVertices (gf,adj,CTX::instance()->mesh.nbSmoothing);
           //          printStats (gf, "toto");
           if (ITER > 20) break;
           ITER ++;
@@ -339,21 +339,33 @@ static double _relocateVertex(GFace* gf, MVertex *ver,
 void getAllBoundaryLayerVertices (GFace *gf, std::set<MVertex*> &vs);
 
 void RelocateVertices (GFace* gf, int niter, double tol) {
+  faceAdjacency adj(gf);
+  RelocateVertices(gf, adj, niter, tol);
+}
+
+void RelocateVertices (GFace* gf, faceAdjacency &adj, int niter, double tol) {
   std::set<MVertex*> vs;
   getAllBoundaryLayerVertices (gf, vs);
   
-  v2t_cont adj;
-  buildVertexToElement(gf->triangles, adj);
-  buildVertexToElement(gf->quadrangles, adj);
   for (int i=0;i<niter;i++){
-    v2t_cont::iterator it = adj.begin();
-    while (it != adj.end()){
-      if (vs.find(it->first) == vs.end()){
-	_relocateVertex( gf, it->first, it->second, tol);
+    // a vertex only changes the quality of its own elements, the vertices of
+    // one color can be moved in parallel
+    for (int c=0;c<adj.numColors();c++){
+      const int n = adj.colorSize(c);
+#if defined(_OPENMP)
+#pragma omp parallel for schedule(dynamic, 64)
+#endif
+      for (int k=0;k<n;k++){
+        const int j = adj.colorVertex(c, k);
+        if (!adj.numElements(j) || vs.find(adj.getVertex(j)) != vs.end()) continue;
+        std::vector<MElement*> lt;
+        adj.getElements(j, lt);
+        _relocateVertex( gf, adj.getVertex(j), lt, tol);
       }
-      ++it;
-    }  
+    }
   }
+  // the messages of the worker threads are written by the main thread
+  Msg::FlushQueuedMessages();
 }
 
 /*
@@ -1362,11 +1362,194 @@ template void MakeGraphDIM<3, GModel::riter, GModel::fiter>
 
 #else
 
+#include <algorithm>
+#include "Mesh/GMSH/GModel.h"
+#include "Mesh/GMSH/MElement.h"
+#include "Mesh/GMSH/MEdge.h"
+#include "Mesh/GMSH/GmshMessage.h"
+
+/*******************************************************************************
+ *
+ * Without METIS or Chaco, the mesh is partitioned by recursive coordinate
+ * bisection of the barycenters of the elements of highest dimension. Each
+ * cut splits the elements along the largest extent of the current set in
+ * proportion to the number of partitions on each side, so that the
+ * partitions are balanced and compact.
+ *
+ ******************************************************************************/
+
+struct bisectionElement
+{
+  MElement *element;
+  double x[3];
+};
+
+static void bisectElements(std::vector<bisectionElement>::iterator begin,
+                           std::vector<bisectionElement>::iterator end,
+                           int numPartitions, int firstPartition)
+{
+  if(numPartitions <= 1 || end - begin <= 1){
+    for(std::vector<bisectionElement>::iterator it = begin; it != end; ++it)
+      it->element->setPartition(firstPartition);
+    return;
+  }
+
+  double min[3] = {begin->x[0], begin->x[1], begin->x[2]};
+  double max[3] = {begin->x[0], begin->x[1], begin->x[2]};
+  for(std::vector<bisectionElement>::iterator it = begin; it != end; ++it){
+    for(int i = 0; i < 3; i++){
+      min[i] = std::min(min[i], it->x[i]);
+      max[i] = std::max(max[i], it->x[i]);
+    }
+  }
+  int axis = 0;
+  for(int i = 1; i < 3; i++)
+    if(max[i] - min[i] > max[axis] - min[axis]) axis = i;
+
+  const int numLeft = numPartitions / 2;
+  std::vector<bisectionElement>::iterator middle =
+    begin + (long)(end - begin) * numLeft / numPartitions;
+  std::nth_element(begin, middle, end,
+                   [axis](const bisectionElement &a, const bisectionElement &b)
+                   { return a.x[axis] < b.x[axis]; });
+
+  bisectElements(begin, middle, numLeft, firstPartition);
+  bisectElements(middle, end, numPartitions - numLeft, firstPartition + numLeft);
+}
+
+static void getPartitionedEntities(GModel *model, std::vector<GEntity*> &volumes,
+                                   std::vector<GEntity*> &boundaries)
+{
+  std::vector<GEntity*> entities;
+  model->getEntities(entities);
+  unsigned numElem[6];
+  const int meshDim = model->getNumMeshElements(numElem);
+  for(unsigned int i = 0; i < entities.size(); i++){
+    if(entities[i]->dim() == meshDim)
+      volumes.push_back(entities[i]);
+    else if(entities[i]->dim() < meshDim)
+      boundaries.push_back(entities[i]);
+  }
+}
+
 int PartitionMesh(GModel *const model, meshPartitionOptions &options)
 {
-  //Msg::Error("Gmsh must be compiled with METIS or Chaco support to partition meshes");
+  std::vector<GEntity*> volumes, boundaries;
+  getPartitionedEntities(model, volumes, boundaries);
+
+  std::vector<bisectionElement> elements;
+  for(unsigned int i = 0; i < volumes.size(); i++){
+    for(unsigned int j = 0; j < volumes[i]->getNumMeshElements(); j++){
+      bisectionElement e;
+      e.element = volumes[i]->getMeshElement(j);
+      SPoint3 b = e.element->barycenter();
+      e.x[0] = b.x(); e.x[1] = b.y(); e.x[2] = b.z();
+      elements.push_back(e);
+    }
+  }
+  if(elements.empty() || options.num_partitions < 1) return 1;
+
+  Msg::Info("Partitioning mesh by coordinate bisection...");
+  bisectElements(elements.begin(), elements.end(), options.num_partitions, 1);
+
+  // boundary elements take the partition of an element they bound
+  std::map<MEdge, int, Less_Edge> edgePartition;
+  for(unsigned int i = 0; i < boundaries.size(); i++){
+    for(unsigned int j = 0; j < boundaries[i]->getNumMeshElements(); j++){
+      MElement *e = boundaries[i]->getMeshElement(j);
+      if(e->getNumPrimaryVertices() > 1)
+        edgePartition[MEdge(e->getVertex(0), e->getVertex(1))] = 0;
+    }
+  }
+  std::vector<int> vertexPartition(model->getMaxVertexNumber() + 1, 0);
+  for(unsigned int i = 0; i < elements.size(); i++){
+    MElement *e = elements[i].element;
+    for(int j = 0; j < e->getNumPrimaryVertices(); j++){
+      int &partition = vertexPartition[e->getVertex(j)->getNum()];
+      if(!partition) partition = e->getPartition();
+    }
+    if(edgePartition.empty()) continue;
+    for(int j = 0; j < e->getNumEdges(); j++){
+      std::map<MEdge, int, Less_Edge>::iterator it = edgePartition.find(e->getEdge(j));
+      if(it != edgePartition.end() && !it->second) it->second = e->getPartition();
+    }
+  }
+  for(unsigned int i = 0; i < boundaries.size(); i++){
+    for(unsigned int j = 0; j < boundaries[i]->getNumMeshElements(); j++){
+      MElement *e = boundaries[i]->getMeshElement(j);
+      int partition = 0;
+      if(e->getNumPrimaryVertices() > 1)
+        partition = edgePartition[MEdge(e->getVertex(0), e->getVertex(1))];
+      if(!partition)
+        partition = vertexPartition[e->getVertex(0)->getNum()];
+      e->setPartition(partition ? partition : 1);
+    }
+  }
+
+  std::vector<int> sizes(options.num_partitions, 0);
+  for(unsigned int i = 0; i < elements.size(); i++)
+    sizes[elements[i].element->getPartition() - 1]++;
+  model->setMinPartitionSize(*std::min_element(sizes.begin(), sizes.end()));
+  model->setMaxPartitionSize(*std::max_element(sizes.begin(), sizes.end()));
+
+  model->recomputeMeshPartitions();
+
+  if(options.createPartitionBoundaries || options.createGhostCells)
+    CreatePartitionBoundaries(model, options.createGhostCells, options.createAllDims);
+  Msg::Info("Done partitioning mesh");
   return 0;
 }
 
+/*******************************************************************************
+ *
+ * The partition boundary entities are only available with the graph
+ * partitioners. Here, only the vertex based ghost cells are created: an
+ * element of highest dimension is a ghost cell of every other partition
+ * that owns an element sharing one of its vertices.
+ *
+ ******************************************************************************/
+
+int CreatePartitionBoundaries(GModel *model, bool createGhostCells, bool createAllDims)
+{
+  if(!createGhostCells) return 1;
+
+  std::vector<GEntity*> volumes, boundaries;
+  getPartitionedEntities(model, volumes, boundaries);
+
+  // partitions of the elements around each vertex, by vertex number
+  std::vector<std::vector<short> > vertexPartitions(model->getMaxVertexNumber() + 1);
+  for(unsigned int i = 0; i < volumes.size(); i++){
+    for(unsigned int j = 0; j < volumes[i]->getNumMeshElements(); j++){
+      MElement *e = volumes[i]->getMeshElement(j);
+      for(int k = 0; k < e->getNumVertices(); k++){
+        std::vector<short> &parts = vertexPartitions[e->getVertex(k)->getNum()];
+        if(std::find(parts.begin(), parts.end(), e->getPartition()) == parts.end())
+          parts.push_back(e->getPartition());
+      }
+    }
+  }
+
+  std::multimap<MElement*, short> &ghosts(model->getGhostCells());
+  ghosts.clear();
+  for(unsigned int i = 0; i < volumes.size(); i++){
+    for(unsigned int j = 0; j < volumes[i]->getNumMeshElements(); j++){
+      MElement *e = volumes[i]->getMeshElement(j);
+      std::vector<short> elementGhosts;
+      for(int k = 0; k < e->getNumVertices(); k++){
+        std::vector<short> &parts = vertexPartitions[e->getVertex(k)->getNum()];
+        for(unsigned int l = 0; l < parts.size(); l++){
+          if(parts[l] != e->getPartition() &&
+             std::find(elementGhosts.begin(), elementGhosts.end(), parts[l]) ==
+             elementGhosts.end())
+            elementGhosts.push_back(parts[l]);
+        }
+      }
+      std::sort(elementGhosts.begin(), elementGhosts.end());
+      for(unsigned int k = 0; k < elementGhosts.size(); k++)
+        ghosts.insert(std::pair<MElement*, short>(e, elementGhosts[k]));
+    }
+  }
+  return 1;
+}
 
 #endif
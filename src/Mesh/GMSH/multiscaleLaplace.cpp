@@ -628,10 +628,10 @@ static void connected_left_right (std::vector<MElement *> &left,
 static void printCut(std::map<MEdge,MVertex*,Less_Edge> &cutEdges,
                      std::set<MEdge,Less_Edge> &theCut, std::set<MVertex*> cutVertices)
 {
-   printf("Writing points.pos \n");
    std::map<MEdge,MVertex*,Less_Edge>::iterator ite = cutEdges.begin();
-   FILE *f1 = std::fopen("points.pos","w");
+   FILE *f1 = Msg::OpenDebugFile("points.pos");
    if(f1){
+     printf("Writing points.pos \n");
      fprintf(f1,"View\"\"{\n");
      for ( ; ite != cutEdges.end();++ite){
        fprintf(f1,"SP(%g,%g,%g){1.0};\n",ite->second->x(),ite->second->y(),ite->second->z());
@@ -644,10 +644,10 @@ static void printCut(std::map<MEdge,MVertex*,Less_Edge> &cutEdges,
      fclose(f1);
    }
 
-   printf("Writing edges.pos \n");
    std::set<MEdge,Less_Edge>::iterator itc = theCut.begin();
-   FILE *f2 = std::fopen("edges.pos","w");
+   FILE *f2 = Msg::OpenDebugFile("edges.pos");
    if(f2){
+     printf("Writing edges.pos \n");
      fprintf(f2,"View\"\"{\n");
      for ( ; itc != theCut.end();++itc){
        fprintf(f2,"SL(%g,%g,%g,%g,%g,%g){1.0,1.0};\n",itc->getVertex(0)->x(),
@@ -286,7 +286,7 @@ void Filler2D::pointInsertion2D(GFace* gf,  vector<MVertex*> &packed,
 
   const bool goNonLinear = true;
   const bool debug=false;
-  const bool export_stuff=true;
+  const bool export_stuff=Msg::GetDebugFiles();
 
   if (debug) cout << "ENTERING POINTINSERTION2D" << endl;
 
@@ -414,20 +414,19 @@ void Filler2D::pointInsertion2D(GFace* gf,  vector<MVertex*> &packed,
 
   // add the vertices as additional vertices in the
   // surface mesh
-  char ccc[256]; sprintf(ccc,"points%d.pos",gf->tag());
-  FILE *f = std::fopen(ccc,"w");
-  if(f){
-    fprintf(f,"View \"\"{\n");
-    for (unsigned int i=0;i<vertices.size();i++){
-      vertices[i]->print(f,i);
-      if(vertices[i]->_v->onWhat() == gf) {
-        packed.push_back(vertices[i]->_v);
-        metrics.push_back(vertices[i]->_meshMetric);
-        SPoint2 midpoint;
-        reparamMeshVertexOnFace(vertices[i]->_v, gf, midpoint);
-      }
-      delete  vertices[i];
+  FILE *f = Msg::OpenDebugFile("points%d.pos", gf->tag());
+  if(f) fprintf(f,"View \"\"{\n");
+  for (unsigned int i=0;i<vertices.size();i++){
+    if(f) vertices[i]->print(f,i);
+    if(vertices[i]->_v->onWhat() == gf) {
+      packed.push_back(vertices[i]->_v);
+      metrics.push_back(vertices[i]->_meshMetric);
+      SPoint2 midpoint;
+      reparamMeshVertexOnFace(vertices[i]->_v, gf, midpoint);
     }
+    delete  vertices[i];
+  }
+  if(f){
     fprintf(f,"};");
     fclose(f);
   }
@@ -459,7 +458,7 @@ bool Filler3D::treat_region(GRegion *gr)
   }
 
   const bool debug=false;
-  const bool export_stuff=true;
+  const bool export_stuff=Msg::GetDebugFiles();
   double a;
 
   cout << "ENTERING POINTINSERTION3D" << endl;
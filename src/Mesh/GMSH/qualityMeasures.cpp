@@ -168,6 +168,141 @@ double qmTriangle::eta(MTriangle *el)
 }
 
 
+int qmElementArrays::addVertex(const MVertex *v)
+{
+  std::unordered_map<const MVertex*, int>::iterator it = _index.find(v);
+  if(it != _index.end()) return it->second;
+  const int i = x.size();
+  _index[v] = i;
+  x.push_back(v->x());
+  y.push_back(v->y());
+  z.push_back(v->z());
+  return i;
+}
+
+
+void qmElementArrays::addElement(const MVertex *v1, const MVertex *v2,
+                                 const MVertex *v3)
+{
+  nodes.push_back(addVertex(v1));
+  nodes.push_back(addVertex(v2));
+  nodes.push_back(addVertex(v3));
+}
+
+
+void qmElementArrays::addElement(const MVertex *v1, const MVertex *v2,
+                                 const MVertex *v3, const MVertex *v4)
+{
+  nodes.push_back(addVertex(v1));
+  nodes.push_back(addVertex(v2));
+  nodes.push_back(addVertex(v3));
+  nodes.push_back(addVertex(v4));
+}
+
+
+void qmElementArrays::gather(const std::vector<MTriangle*> &ele)
+{
+  clear();
+  _index.reserve(ele.size());
+  nodes.reserve(3 * ele.size());
+  for(unsigned int i = 0; i < ele.size(); i++)
+    addElement(ele[i]->getVertex(0), ele[i]->getVertex(1), ele[i]->getVertex(2));
+}
+
+
+void qmElementArrays::gather(const std::vector<MQuadrangle*> &ele)
+{
+  clear();
+  _index.reserve(ele.size());
+  nodes.reserve(4 * ele.size());
+  for(unsigned int i = 0; i < ele.size(); i++)
+    addElement(ele[i]->getVertex(0), ele[i]->getVertex(1), ele[i]->getVertex(2),
+               ele[i]->getVertex(3));
+}
+
+
+void qmElementArrays::clear()
+{
+  _index.clear();
+  x.clear();
+  y.clear();
+  z.clear();
+  nodes.clear();
+}
+
+
+// Same operations as gamma(xa, ..., zc), written without branches so that the
+// loop is vectorized
+void qmTriangle::gamma(int n, const int *nodes, const double *x, const double *y,
+                       const double *z, double *q)
+{
+#if defined(_OPENMP)
+#pragma omp simd
+#endif
+  for(int i = 0; i < n; i++){
+    const int ia = nodes[3 * i], ib = nodes[3 * i + 1], ic = nodes[3 * i + 2];
+    double a0 = x[ic] - x[ib], a1 = y[ic] - y[ib], a2 = z[ic] - z[ib];
+    double b0 = x[ia] - x[ic], b1 = y[ia] - y[ic], b2 = z[ia] - z[ic];
+    double c0 = x[ib] - x[ia], c1 = y[ib] - y[ia], c2 = z[ib] - z[ia];
+    const double la = sqrt(a0 * a0 + a1 * a1 + a2 * a2);
+    const double lb = sqrt(b0 * b0 + b1 * b1 + b2 * b2);
+    const double lc = sqrt(c0 * c0 + c1 * c1 + c2 * c2);
+    const double ila = la != 0.0 ? 1. / la : 1.;
+    const double ilb = lb != 0.0 ? 1. / lb : 1.;
+    const double ilc = lc != 0.0 ? 1. / lc : 1.;
+    a0 *= ila; a1 *= ila; a2 *= ila;
+    b0 *= ilb; b1 *= ilb; b2 *= ilb;
+    c0 *= ilc; c1 *= ilc; c2 *= ilc;
+    const double pa0 = b1 * c2 - b2 * c1, pa1 = -b0 * c2 + b2 * c0, pa2 = b0 * c1 - b1 * c0;
+    const double pb0 = c1 * a2 - c2 * a1, pb1 = -c0 * a2 + c2 * a0, pb2 = c0 * a1 - c1 * a0;
+    const double pc0 = a1 * b2 - a2 * b1, pc1 = -a0 * b2 + a2 * b0, pc2 = a0 * b1 - a1 * b0;
+    const double sina = sqrt(pa0 * pa0 + pa1 * pa1 + pa2 * pa2);
+    const double sinb = sqrt(pb0 * pb0 + pb1 * pb1 + pb2 * pb2);
+    const double sinc = sqrt(pc0 * pc0 + pc1 * pc1 + pc2 * pc2);
+    const double s = sina + sinb + sinc;
+    q[i] = s != 0.0 ? 2 * (2 * sina * sinb * sinc / (s != 0.0 ? s : 1.)) : 0.0;
+  }
+}
+
+
+// The cosine of the angle at vertex b of the corner abc. Degenerated corners,
+// whose angle is 0 in angle3Vertices, get a cosine of 1
+static inline double cornerCosine(double u0, double u1, double u2,
+                                  double v0, double v1, double v2)
+{
+  const double l = sqrt((u0 * u0 + u1 * u1 + u2 * u2) *
+                        (v0 * v0 + v1 * v1 + v2 * v2));
+  const double c = (u0 * v0 + u1 * v1 + u2 * v2) / (l != 0.0 ? l : 1.);
+  return l != 0.0 ? std::max(-1., std::min(1., c)) : 1.;
+}
+
+
+// The cosines are computed in a vectorized loop; the smallest angle is the
+// one with the largest cosine, so that acos is only evaluated once per
+// triangle
+void qmTriangle::eta(int n, const int *nodes, const double *x, const double *y,
+                     const double *z, double *q)
+{
+#if defined(_OPENMP)
+#pragma omp simd
+#endif
+  for(int i = 0; i < n; i++){
+    const int i0 = nodes[3 * i], i1 = nodes[3 * i + 1], i2 = nodes[3 * i + 2];
+    const double e0 = x[i1] - x[i0], e1 = y[i1] - y[i0], e2 = z[i1] - z[i0];
+    const double f0 = x[i2] - x[i1], f1 = y[i2] - y[i1], f2 = z[i2] - z[i1];
+    const double g0 = x[i0] - x[i2], g1 = y[i0] - y[i2], g2 = z[i0] - z[i2];
+    const double c1 = cornerCosine(-e0, -e1, -e2, f0, f1, f2);
+    const double c2 = cornerCosine(-f0, -f1, -f2, g0, g1, g2);
+    const double c3 = cornerCosine(-g0, -g1, -g2, e0, e1, e2);
+    q[i] = std::max(std::max(c1, c2), c3);
+  }
+  for(int i = 0; i < n; i++){
+    const double amin = 180 * acos(q[i]) / M_PI;
+    q[i] = 1. - fabs(60. - amin) / 60;
+  }
+}
+
+
 double qmTriangle::angles(MTriangle *e)
 {
   double a = 500;
@@ -404,6 +539,50 @@ double qmQuadrangle::eta(MQuadrangle *el) {
 }
 
 
+// The largest deviation from 90 degrees is the one of the angle whose cosine
+// has the largest magnitude, i.e. asin(max |cos|)
+void qmQuadrangle::eta(int n, const int *nodes, const double *x, const double *y,
+                       const double *z, double *q, double *maxAngle)
+{
+  std::vector<double> cmax(n);
+#if defined(_OPENMP)
+#pragma omp simd
+#endif
+  for(int i = 0; i < n; i++){
+    const int i0 = nodes[4 * i], i1 = nodes[4 * i + 1];
+    const int i2 = nodes[4 * i + 2], i3 = nodes[4 * i + 3];
+    const double v010 = x[i1] - x[i0], v011 = y[i1] - y[i0], v012 = z[i1] - z[i0];
+    const double v120 = x[i2] - x[i1], v121 = y[i2] - y[i1], v122 = z[i2] - z[i1];
+    const double v230 = x[i3] - x[i2], v231 = y[i3] - y[i2], v232 = z[i3] - z[i2];
+    const double v300 = x[i0] - x[i3], v301 = y[i0] - y[i3], v302 = z[i0] - z[i3];
+
+    // normals at the corners 1, 2, 3 and 0
+    const double a0 = v011 * v122 - v012 * v121, a1 = v012 * v120 - v010 * v122,
+      a2 = v010 * v121 - v011 * v120;
+    const double b0 = v121 * v232 - v122 * v231, b1 = v122 * v230 - v120 * v232,
+      b2 = v120 * v231 - v121 * v230;
+    const double c0 = v231 * v302 - v232 * v301, c1 = v232 * v300 - v230 * v302,
+      c2 = v230 * v301 - v231 * v300;
+    const double d0 = v301 * v012 - v302 * v011, d1 = v302 * v010 - v300 * v012,
+      d2 = v300 * v011 - v301 * v010;
+    const bool flipped = (a0 * b0 + a1 * b1 + a2 * b2 < 0) ||
+      (a0 * c0 + a1 * c1 + a2 * c2 < 0) || (a0 * d0 + a1 * d1 + a2 * d2 < 0);
+    q[i] = flipped ? -1. : 1.;
+
+    const double k1 = cornerCosine(-v010, -v011, -v012, v120, v121, v122);
+    const double k2 = cornerCosine(-v120, -v121, -v122, v230, v231, v232);
+    const double k3 = cornerCosine(-v230, -v231, -v232, v300, v301, v302);
+    const double k4 = cornerCosine(-v300, -v301, -v302, v010, v011, v012);
+    cmax[i] = std::max(std::max(fabs(k1), fabs(k2)), std::max(fabs(k3), fabs(k4)));
+  }
+  for(int i = 0; i < n; i++){
+    const double angle = 180 * asin(cmax[i]) / M_PI;
+    q[i] *= 1. - angle / 90;
+    if(maxAngle) maxAngle[i] = angle;
+  }
+}
+
+
 double qmQuadrangle::angles(MQuadrangle *e)
 {
   double a = 100;
@@ -606,10 +606,9 @@ void packingOfParallelogramsSmoothness(GFace* gf,  std::vector<MVertex*> &packed
   SPoint2 newp[4][NUMDIR];
   std::set<MVertex*>::iterator it =  bnd_vertices.begin() ;
 
-  char NAME[345]; sprintf(NAME,"crossReal%d.pos",gf->tag());
   FILE *crossf = NULL;
   if (debug){
-    crossf = Fopen (NAME,"w");
+    crossf = Msg::OpenDebugFile("crossReal%d.pos", gf->tag());
   }
   if (crossf) fprintf(crossf,"View \"\"{\n");
   for (; it !=  bnd_vertices.end() ; ++it){
@@ -726,11 +725,11 @@ void packingOfParallelograms(GFace* gf,  std::vector<MVertex*> &packed, std::vec
   //  FILE *f = Fopen ("parallelograms.pos","w");
 
 
-  // test test test
-  stringstream ssa;
-  ssa << "oldbgm_angles_" << gf->tag() << ".pos";
-  backgroundMesh::current()->print(ssa.str(),gf,1);
-  // test test test
+  if (Msg::GetDebugFiles()){
+    stringstream ssa;
+    ssa << "oldbgm_angles_" << gf->tag() << ".pos";
+    backgroundMesh::current()->print(ssa.str(),gf,1);
+  }
 
   // get all the boundary vertices
   std::set<MVertex*> bnd_vertices;
@@ -752,8 +751,7 @@ void packingOfParallelograms(GFace* gf,  std::vector<MVertex*> &packed, std::vec
   SPoint2 newp[4][NUMDIR];
   std::set<MVertex*>::iterator it =  bnd_vertices.begin() ;
 
-  char NAME[345]; sprintf(NAME,"crossReal%d.pos",gf->tag());
-  FILE *crossf = std::fopen (NAME,"w");
+  FILE *crossf = Msg::OpenDebugFile("crossReal%d.pos", gf->tag());
   if (crossf) fprintf(crossf,"View \"\"{\n");
   for (; it !=  bnd_vertices.end() ; ++it){
     SPoint2 midpoint;
@@ -803,8 +801,7 @@ void packingOfParallelograms(GFace* gf,  std::vector<MVertex*> &packed, std::vec
   }
     // add the vertices as additional vertices in the
     // surface mesh
-  char ccc[256]; sprintf(ccc,"points%d.pos",gf->tag());
-  FILE *f = std::fopen(ccc,"w");
+  FILE *f = Msg::OpenDebugFile("points%d.pos", gf->tag());
   if(f) fprintf(f,"View \"\"{\n");
   for (unsigned int i=0;i<vertices.size();i++){
     //    if(vertices[i]->_v->onWhat() != gf)
@@ -859,8 +856,7 @@ void packingOfParallelogramsConstrained(GFace* gf, std::set<MVertex*> constr_ver
   SPoint2 newp[4][NUMDIR];
   std::set<MVertex*>::iterator it =  bnd_vertices.begin() ;
 
-  char NAME[345]; sprintf(NAME,"crossReal%d.pos",gf->tag());
-  FILE *crossf = Fopen (NAME,"w");
+  FILE *crossf = Msg::OpenDebugFile("crossReal%d.pos", gf->tag());
   if (crossf)fprintf(crossf,"View \"\"{\n");
   std::cout<<"      entering first for"<<std::endl;
   for (; it !=  bnd_vertices.end() ; ++it){
@@ -960,13 +956,12 @@ void packingOfParallelogramsConstrained(GFace* gf, std::set<MVertex*> constr_ver
 
     // add the vertices as additional vertices in the
     // surface mesh
-    char ccc[256]; sprintf(ccc,"points%d.pos",gf->tag());
-    FILE *f = Fopen(ccc,"w");
-    fprintf(f,"View \"\"{\n");
+    FILE *f = Msg::OpenDebugFile("points%d.pos", gf->tag());
+    if(f) fprintf(f,"View \"\"{\n");
     std::cout<<"      entering another for"<<std::endl;
     for (unsigned int i=0;i<vertices.size();i++){
       //    if(vertices[i]->_v->onWhat() != gf)
-      vertices[i]->print(f,i);
+      if(f) vertices[i]->print(f,i);
       if(vertices[i]->_v->onWhat() == gf) {
         packed.push_back(vertices[i]->_v);
         metrics.push_back(vertices[i]->_meshMetric);
@@ -985,8 +980,10 @@ void packingOfParallelogramsConstrained(GFace* gf, std::set<MVertex*> constr_ver
       }
       delete  vertices[i];
     }
-    fprintf(f,"};");
-    fclose(f);
+    if(f){
+      fprintf(f,"};");
+      fclose(f);
+    }
     //  printf("packed.size = %d\n",packed.size());
     //  delete rtree;
 #endif
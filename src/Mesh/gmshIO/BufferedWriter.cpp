@@ -0,0 +1,129 @@
+// Gmsh - Copyright (C) 1997-2017 C. Geuzaine, J.-F. Remacle
+//
+// See the LICENSE.txt file for license information. Please report all
+// bugs and problems to the public mailing list <gmsh@onelab.info>.
+
+#include <cmath>
+#include <cstdarg>
+#include <limits>
+#include "Mesh/gmshIO/BufferedWriter.h"
+
+// powers of ten that are exactly representable with a 64 bit mantissa
+static const long double powersOfTen[28] = {
+  1e0L, 1e1L, 1e2L, 1e3L, 1e4L, 1e5L, 1e6L, 1e7L, 1e8L, 1e9L, 1e10L, 1e11L,
+  1e12L, 1e13L, 1e14L, 1e15L, 1e16L, 1e17L, 1e18L, 1e19L, 1e20L, 1e21L,
+  1e22L, 1e23L, 1e24L, 1e25L, 1e26L, 1e27L};
+
+// Converts a finite double like "%.<precision>g". The significant digits are
+// obtained by scaling the value with an exact power of ten in extended
+// precision: the scaled value is off by less than 1e-2, so the rounding to
+// an integer is exact unless the fractional part is close to one half. In
+// that case (and for values with a very large or small exponent, or if the
+// platform has no extended precision) -1 is returned and the caller falls
+// back to snprintf().
+static int fastFormatDouble(double value, int precision, char *out)
+{
+  if(std::numeric_limits<long double>::digits < 64) return -1;
+  if(precision < 1 || precision > 17) return -1;
+  if(!std::isfinite(value)) return -1;
+
+  char *start = out;
+  if(std::signbit(value)){
+    *out++ = '-';
+    value = -value;
+  }
+  if(value == 0.){
+    *out++ = '0';
+    return out - start;
+  }
+
+  const long double lower = powersOfTen[precision - 1];
+  const long double upper = powersOfTen[precision];
+  int exponent = (int)std::floor(std::log10(value));
+  long double scaled = 0;
+  for(int iter = 0; iter < 3; iter++){
+    int shift = precision - 1 - exponent;
+    if(shift > 27 || shift < -27) return -1;
+    if(shift >= 0)
+      scaled = (long double)value * powersOfTen[shift];
+    else
+      scaled = (long double)value / powersOfTen[-shift];
+    if(scaled >= upper) exponent++;
+    else if(scaled < lower) exponent--;
+    else break;
+  }
+  if(scaled < lower || scaled >= upper) return -1;
+
+  long double integral = std::floor(scaled);
+  long double fraction = scaled - integral;
+  if(std::fabs(fraction - 0.5L) < 1e-2L) return -1;
+  unsigned long long digits = (unsigned long long)integral;
+  if(fraction > 0.5L) digits++;
+  if((long double)digits >= upper){
+    digits = (unsigned long long)lower;
+    exponent++;
+  }
+
+  char d[20];
+  for(int i = precision - 1; i >= 0; i--){
+    d[i] = '0' + digits % 10;
+    digits /= 10;
+  }
+  int count = precision;
+  while(count > 1 && d[count - 1] == '0') count--;
+
+  if(exponent < -4 || exponent >= precision){
+    *out++ = d[0];
+    if(count > 1){
+      *out++ = '.';
+      for(int i = 1; i < count; i++) *out++ = d[i];
+    }
+    *out++ = 'e';
+    *out++ = (exponent < 0) ? '-' : '+';
+    int e = std::abs(exponent);
+    if(e >= 100) *out++ = '0' + e / 100;
+    *out++ = '0' + (e / 10) % 10;
+    *out++ = '0' + e % 10;
+  }
+  else if(exponent >= 0){
+    for(int i = 0; i <= exponent; i++) *out++ = d[i];
+    if(count > exponent + 1){
+      *out++ = '.';
+      for(int i = exponent + 1; i < count; i++) *out++ = d[i];
+    }
+  }
+  else{
+    *out++ = '0';
+    *out++ = '.';
+    for(int i = 0; i < -exponent - 1; i++) *out++ = '0';
+    for(int i = 0; i < count; i++) *out++ = d[i];
+  }
+  return out - start;
+}
+
+void BufferedWriter::putDouble(double value, int precision)
+{
+  char *out = _reserve(64);
+  int length = fastFormatDouble(value, precision, out);
+  if(length < 0) length = snprintf(out, 64, "%.*g", precision, value);
+  _size += length;
+}
+
+void BufferedWriter::putFormat(const char *format, ...)
+{
+  va_list args;
+  char *out = _reserve(256);
+  va_start(args, format);
+  int length = vsnprintf(out, 256, format, args);
+  va_end(args);
+  if(length < 0) return;
+  if(length >= 256){
+    std::vector<char> str(length + 1);
+    va_start(args, format);
+    vsnprintf(&str[0], str.size(), format, args);
+    va_end(args);
+    putString(&str[0], length);
+    return;
+  }
+  _size += length;
+}
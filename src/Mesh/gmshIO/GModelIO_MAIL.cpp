@@ -4,6 +4,7 @@
 // bugs and problems to the public mailing list <gmsh@onelab.info>.
 
 #include "Mesh/GMSH/GModel.h"
+#include "Mesh/meshFileWriter.h"
 #include "common/OS.h"
 #include "Mesh/GMSH/MTriangle.h"
 
@@ -11,52 +12,13 @@ int GModel::writeMAIL(const std::string &name, bool saveAll, double scalingFacto
 {
   // CEA triangulation (.mail format) for Eric Darrigrand. Note that
   // we currently don't save the edges of the triangulation (the last
-  // part of the file).
-  FILE *fp = fopen(name.c_str(), "w");
-  if(!fp){
-    Msg::Error("Unable to open file '%s'", name.c_str());
+  // part of the file). The mesh is written from a snapshot by the same
+  // writer as the background mesh exports
+  std::string message;
+  if(!meshFileWriter::writeModel(this, meshExportFormat::MAIL, name, message,
+                                 false, saveAll, scalingFactor)){
+    Msg::Error("%s", message.c_str());
     return 0;
   }
-
-  if(noPhysicalGroups()) saveAll = true;
-
-  int numVertices = indexMeshVertices(saveAll), numTriangles = 0;
-  for(fiter it = firstFace(); it != lastFace(); ++it)
-    if(saveAll || (*it)->physicals.size())
-      numTriangles += (*it)->triangles.size();
-
-  fprintf(fp, " %d %d\n", numVertices, numTriangles);
-
-  std::vector<GEntity*> entities;
-  getEntities(entities);
-  for(unsigned int i = 0; i < entities.size(); i++){
-    for(unsigned int j = 0; j < entities[i]->mesh_vertices.size(); j++){
-      MVertex *v = entities[i]->mesh_vertices[j];
-      fprintf(fp, " %19.10E %19.10E %19.10E\n", v->x() * scalingFactor,
-              v->y() * scalingFactor, v->z() * scalingFactor);
-    }
-  }
-
-  for(fiter it = firstFace(); it != lastFace(); ++it){
-    if(saveAll || (*it)->physicals.size()){
-      for(unsigned int i = 0; i < (*it)->triangles.size(); i++){
-        MTriangle *t = (*it)->triangles[i];
-        fprintf(fp, " %d %d %d\n", t->getVertex(0)->getIndex(),
-                t->getVertex(1)->getIndex(), t->getVertex(2)->getIndex());
-      }
-    }
-  }
-
-  // TODO write edges (with signs)
-  for(fiter it = firstFace(); it != lastFace(); ++it){
-    if(saveAll || (*it)->physicals.size()){
-      for(unsigned int i = 0; i < (*it)->triangles.size(); i++){
-        //MTriangle *t = (*it)->triangles[i];
-        fprintf(fp, " %d %d %d\n", 0, 0, 0);
-      }
-    }
-  }
-
-  fclose(fp);
   return 1;
 }
@@ -477,7 +477,8 @@ int GModel::readMSH(const std::string &name)
   fclose(fp);
 
   return postpro ? 2 : 1;*/
-    return 1;
+  // only the MSH 2 reader is available, it rejects newer files
+  return _readMSH2(name);
 }
 
 static void writeMSHPhysicals(FILE *fp, GEntity *ge)
@@ -746,7 +747,7 @@ int GModel::writePartitionedMSH(const std::string &baseName, double version,
                                 bool binary, bool saveAll, bool saveParametric,
                                 double scalingFactor)
 {
-/*  if(version < 3)
+  if(version < 3)
     return _writePartitionedMSH2(baseName, binary, saveAll, saveParametric,
                                  scalingFactor);
 
@@ -755,9 +756,9 @@ int GModel::writePartitionedMSH(const std::string &baseName, double version,
     int partition = *it;
     std::ostringstream sstream;
     sstream << baseName << "_" << std::setw(6) << std::setfill('0') << partition;
-    //Msg::Info("Writing partition %d in file '%s'", partition, sstream.str().c_str());
+    Msg::Info("Writing partition %d in file '%s'", partition, sstream.str().c_str());
     writeMSH(sstream.str(), version, binary, saveAll, saveParametric,
              scalingFactor, 0, partition);
-  }*/
+  }
   return 1;
 }
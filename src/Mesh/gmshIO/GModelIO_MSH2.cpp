@@ -10,6 +10,8 @@
 #include <sstream>
 #include <cassert>
 #include <iomanip>
+#include <algorithm>
+#include <cctype>
 #include "Mesh/GMSH/GModel.h"
 #include "common/OS.h"
 #include "Mesh/GMSH/GmshDefines.h"
@@ -25,6 +27,12 @@
 #include "Mesh/GMSH/StringUtils.h"
 #include "Mesh/GMSH/GmshMessage.h"
 #include "Mesh/GMSH/Context.h"
+#include "Mesh/gmshIO/BufferedWriter.h"
+#include "Mesh/gmshIO/MappedFile.h"
+
+#if defined(_OPENMP)
+#include <omp.h>
+#endif
 
 
 #define FAST_ELEMENTS 1
@@ -181,15 +189,76 @@ static void getDomains(int dom1Num, int dom2Num, int type,
 
 #endif
 
+// Splits [begin, end) at white space into one chunk per thread and converts
+// the numbers of all chunks in parallel
+template<class T>
+static bool parseNumbers(const char *begin, const char *end, std::vector<T> &values)
+{
+  int numChunks = 1;
+#if defined(_OPENMP)
+  // small sections are not worth starting the threads
+  if(end - begin > (1 << 20)) numChunks = omp_get_max_threads();
+#endif
+  std::vector<const char*> bounds(numChunks + 1, end);
+  bounds[0] = begin;
+  for(int i = 1; i < numChunks; i++){
+    const char *p = std::max(bounds[i - 1], begin + (end - begin) / numChunks * i);
+    while(p < end && !isspace((unsigned char)*p)) p++;
+    bounds[i] = p;
+  }
+
+  std::vector<std::vector<T> > chunks(numChunks);
+  std::vector<char> valid(numChunks, 0);
+#if defined(_OPENMP)
+#pragma omp parallel for num_threads(numChunks) schedule(static, 1)
+#endif
+  for(int i = 0; i < numChunks; i++){
+    TextScanner scanner(bounds[i], bounds[i + 1]);
+    chunks[i].reserve((bounds[i + 1] - bounds[i]) / 8);
+    T value;
+    while(scanner.get(value)) chunks[i].push_back(value);
+    valid[i] = scanner.atEnd();
+  }
+
+  std::size_t numValues = 0;
+  for(int i = 0; i < numChunks; i++){
+    if(!valid[i]) return false;
+    numValues += chunks[i].size();
+  }
+  values.resize(numValues);
+  std::size_t offset = 0;
+  for(int i = 0; i < numChunks; i++){
+    std::copy(chunks[i].begin(), chunks[i].end(), values.begin() + offset);
+    offset += chunks[i].size();
+    std::vector<T>().swap(chunks[i]);
+  }
+  return true;
+}
+
+static inline bool getNextInt(const std::vector<int> &values, std::size_t &pos, int &value)
+{
+  if(pos >= values.size()) return false;
+  value = values[pos++];
+  return true;
+}
+
+// returns the start of the line that closes the current section
+static const char *findEndOfSection(TextScanner &scanner)
+{
+  const char *end = scanner.find("\n$");
+  return (end < scanner.end()) ? end + 1 : end;
+}
+
 int GModel::_readMSH2(const std::string &name)
 {
-  FILE *fp = std::fopen(name.c_str(), "rb");
-  if(!fp){
+  MappedFile file;
+  if(!file.open(name)){
     Msg::Error("Unable to open file '%s'", name.c_str());
     return 0;
   }
 
-  char str[256] = "XXX";
+  TextScanner scanner(file.begin(), file.end());
+  std::string str = "XXX";
   double version = 1.0;
   bool binary = false, swap = false, postpro = false;
   std::map<int, std::vector<MElement*> > elements[10];
@@ -200,27 +269,32 @@ int GModel::_readMSH2(const std::string &name)
 
   while(1) {
 
+    bool endOfFile = false;
     while(str[0] != '$'){
-      if(!fgets(str, sizeof(str), fp) || feof(fp))
+      if(!scanner.getLine(str)){
+        endOfFile = true;
         break;
+      }
     }
 
-    if(feof(fp))
+    if(endOfFile)
       break;
 
     if(!strncmp(&str[1], "MeshFormat", 10)) {
 
-      if(!fgets(str, sizeof(str), fp)){ fclose(fp); return 0; }
+      if(!scanner.getLine(str)) return 0;
       int format, size;
-      if(sscanf(str, "%lf %d %d", &version, &format, &size) != 3){
-        fclose(fp);
+      if(sscanf(str.c_str(), "%lf %d %d", &version, &format, &size) != 3)
+        return 0;
+      if(version >= 3.){
+        Msg::Error("MSH version %g is not supported", version);
         return 0;
       }
       if(format){
         binary = true;
         Msg::Debug("Mesh is in binary format");
         int one;
-        if(fread(&one, sizeof(int), 1, fp) != 1){ fclose(fp); return 0; }
+        if(!scanner.getBinary(&one, sizeof(int))) return 0;
         if(one != 1){
           swap = true;
           Msg::Debug("Swapping bytes from binary file");
@@ -230,17 +304,17 @@ int GModel::_readMSH2(const std::string &name)
     }
     else if(!strncmp(&str[1], "PhysicalNames", 13)) {
 
-      if(!fgets(str, sizeof(str), fp)){ fclose(fp); return 0; }
+      if(!scanner.getLine(str)) return 0;
       int numNames;
-      if(sscanf(str, "%d", &numNames) != 1){ fclose(fp); return 0; }
+      if(sscanf(str.c_str(), "%d", &numNames) != 1) return 0;
       for(int i = 0; i < numNames; i++) {
         int dim = -1, num;
         if(version > 2.0){
-          if(fscanf(fp, "%d", &dim) != 1){ fclose(fp); return 0; }
+          if(!scanner.get(dim)) return 0;
         }
-        if(fscanf(fp, "%d", &num) != 1){ fclose(fp); return 0; }
-        if(!fgets(str, sizeof(str), fp)){ fclose(fp); return 0; }
-        std::string name = ExtractDoubleQuotedString(str, 256);
+        if(!scanner.get(num)) return 0;
+        if(!scanner.getLine(str)) return 0;
+        std::string name = ExtractDoubleQuotedString(str.c_str(), 256);
         if(name.size()) setPhysicalName(name, dim, num);
       }
 
@@ -249,51 +323,67 @@ int GModel::_readMSH2(const std::string &name)
             !strncmp(&str[1], "ParametricNodes", 15)) {
 
       const bool parametric = !strncmp(&str[1], "ParametricNodes", 15);
-      if(!fgets(str, sizeof(str), fp)){ fclose(fp); return 0; }
+      if(!scanner.getLine(str)) return 0;
       int numVertices = -1;
-      if(sscanf(str, "%d", &numVertices) != 1){ fclose(fp); return 0; }
+      if(sscanf(str.c_str(), "%d", &numVertices) != 1) return 0;
       Msg::Info("%d vertices", numVertices);
-      //Msg::ResetProgressMeter();
       vertexVector.clear();
       vertexMap.clear();
-      minVertex = numVertices + 1;
-      int maxVertex = -1;
-      for(int i = 0; i < numVertices; i++) {
-        int num;
-        double xyz[3], uv[2];
-        MVertex *newVertex = 0;
-        if (!parametric){
-          if(!binary){
-            if (fscanf(fp, "%d %lf %lf %lf", &num, &xyz[0], &xyz[1], &xyz[2]) != 4){
-              fclose(fp);
-              return 0;
-            }
-          }
-          else{
-            if(fread(&num, sizeof(int), 1, fp) != 1){ fclose(fp); return 0; }
-            if(swap) SwapBytes((char*)&num, sizeof(int), 1);
-            if(fread(xyz, sizeof(double), 3, fp) != 3){ fclose(fp); return 0; }
-            if(swap) SwapBytes((char*)xyz, sizeof(double), 3);
+      std::vector<std::pair<int, MVertex*> > newVertices;
+      newVertices.reserve(numVertices);
+      if(!parametric && !binary){
+        // the coordinates are converted in parallel, the node numbers are
+        // exactly representable as doubles
+        const char *sectionEnd = findEndOfSection(scanner);
+        std::vector<double> values;
+        if(!parseNumbers(scanner.position(), sectionEnd, values) ||
+           values.size() != 4 * (std::size_t)numVertices)
+          return 0;
+        for(int i = 0; i < numVertices; i++){
+          const double *xyz = &values[4 * i + 1];
+          int num = (int)values[4 * i];
+          newVertices.push_back(std::make_pair
+                                (num, new MVertex(xyz[0], xyz[1], xyz[2], 0, num)));
+        }
+        scanner.setPosition(sectionEnd);
+      }
+      else if(!parametric){
+        // the records are copied in one block
+        const std::size_t recordSize = sizeof(int) + 3 * sizeof(double);
+        std::vector<char> records((std::size_t)numVertices * recordSize);
+        if(numVertices > 0 && !scanner.getBinary(&records[0], records.size()))
+          return 0;
+        for(int i = 0; i < numVertices; i++){
+          int num;
+          double xyz[3];
+          memcpy(&num, &records[i * recordSize], sizeof(int));
+          memcpy(xyz, &records[i * recordSize + sizeof(int)], 3 * sizeof(double));
+          if(swap){
+            SwapBytes((char*)&num, sizeof(int), 1);
+            SwapBytes((char*)xyz, sizeof(double), 3);
           }
-          newVertex = new MVertex(xyz[0], xyz[1], xyz[2], 0, num);
+          newVertices.push_back(std::make_pair
+                                (num, new MVertex(xyz[0], xyz[1], xyz[2], 0, num)));
         }
-        else{
-          int iClasDim, iClasTag;
+      }
+      else{
+        for(int i = 0; i < numVertices; i++) {
+          int num, iClasDim, iClasTag;
+          double xyz[3], uv[2];
+          MVertex *newVertex = 0;
           if(!binary){
-            if (fscanf(fp, "%d %lf %lf %lf %d %d", &num, &xyz[0], &xyz[1], &xyz[2],
-                       &iClasDim, &iClasTag) != 6){
-              fclose(fp);
+            if(!scanner.get(num) || !scanner.get(xyz[0]) || !scanner.get(xyz[1]) ||
+               !scanner.get(xyz[2]) || !scanner.get(iClasDim) || !scanner.get(iClasTag))
               return 0;
-            }
           }
           else{
-            if(fread(&num, sizeof(int), 1, fp) != 1){ fclose(fp); return 0; }
+            if(!scanner.getBinary(&num, sizeof(int))) return 0;
             if(swap) SwapBytes((char*)&num, sizeof(int), 1);
-            if(fread(xyz, sizeof(double), 3, fp) != 3){ fclose(fp); return 0; }
+            if(!scanner.getBinary(xyz, 3 * sizeof(double))) return 0;
             if(swap) SwapBytes((char*)xyz, sizeof(double), 3);
-            if(fread(&iClasDim, sizeof(int), 1, fp) != 1){ fclose(fp); return 0; }
+            if(!scanner.getBinary(&iClasDim, sizeof(int))) return 0;
             if(swap) SwapBytes((char*)&iClasDim, sizeof(int), 1);
-            if(fread(&iClasTag, sizeof(int), 1, fp) != 1){ fclose(fp); return 0; }
+            if(!scanner.getBinary(&iClasTag, sizeof(int))) return 0;
             if(swap) SwapBytes((char*)&iClasTag, sizeof(int), 1);
           }
           if (iClasDim == 0){
@@ -304,10 +394,10 @@ int GModel::_readMSH2(const std::string &name)
           else if (iClasDim == 1){
             GEdge *ge = getEdgeByTag(iClasTag);
             if(!binary){
-              if (fscanf(fp, "%lf", &uv[0]) != 1){ fclose(fp); return 0; }
+              if(!scanner.get(uv[0])) return 0;
             }
             else{
-              if(fread(uv, sizeof(double), 1, fp) != 1){ fclose(fp); return 0; }
+              if(!scanner.getBinary(uv, sizeof(double))) return 0;
               if(swap) SwapBytes((char*)uv, sizeof(double), 1);
             }
             newVertex = new MEdgeVertex(xyz[0], xyz[1], xyz[2], ge, uv[0], -1.0, num);
@@ -315,10 +405,10 @@ int GModel::_readMSH2(const std::string &name)
           else if (iClasDim == 2){
             GFace *gf = getFaceByTag(iClasTag);
             if(!binary){
-              if (fscanf(fp, "%lf %lf", &uv[0], &uv[1]) != 2){ fclose(fp); return 0; }
+              if(!scanner.get(uv[0]) || !scanner.get(uv[1])) return 0;
             }
             else{
-              if(fread(uv, sizeof(double), 2, fp) != 2){ fclose(fp); return 0; }
+              if(!scanner.getBinary(uv, 2 * sizeof(double))) return 0;
               if(swap) SwapBytes((char*)uv, sizeof(double), 2);
             }
             newVertex = new MFaceVertex(xyz[0], xyz[1], xyz[2], gf, uv[0], uv[1], num);
@@ -327,36 +417,48 @@ int GModel::_readMSH2(const std::string &name)
             //GRegion *gr = getRegionByTag(iClasTag);
            // newVertex = new MVertex(xyz[0], xyz[1], xyz[2], gr, num);
           }
+          newVertices.push_back(std::make_pair(num, newVertex));
         }
-        minVertex = std::min(minVertex, num);
-        maxVertex = std::max(maxVertex, num);
-        if(vertexMap.count(num))
-          {Msg::Warning("Skipping duplicate vertex %d", num);}
-        vertexMap[num] = newVertex;
-        if(numVertices > 100000)
-          {/*Msg::ProgressMeter(i + 1, numVertices, true, "Reading nodes");*/}
       }
-      // If the vertex numbering is dense, transfer the map into a
-      // vector to speed up element creation
-      if((int)vertexMap.size() == numVertices &&
-         ((minVertex == 1 && maxVertex == numVertices) ||
-          (minVertex == 0 && maxVertex == numVertices - 1))){
-        Msg::Debug("Vertex numbering is dense");
-        vertexVector.resize(vertexMap.size() + 1);
-        if(minVertex == 1)
-          vertexVector[0] = 0;
+
+      minVertex = numVertices + 1;
+      int maxVertex = -1;
+      for(unsigned int i = 0; i < newVertices.size(); i++){
+        minVertex = std::min(minVertex, newVertices[i].first);
+        maxVertex = std::max(maxVertex, newVertices[i].first);
+      }
+      // If the vertex numbering is dense, store the vertices in a vector to
+      // speed up element creation. Otherwise (or if there are duplicates),
+      // use a map
+      bool dense = ((minVertex == 1 && maxVertex == numVertices) ||
+                    (minVertex == 0 && maxVertex == numVertices - 1));
+      if(dense){
+        vertexVector.assign(numVertices + 1, (MVertex*)0);
+        for(unsigned int i = 0; i < newVertices.size(); i++){
+          MVertex *&slot = vertexVector[newVertices[i].first];
+          if(slot){
+            dense = false;
+            break;
+          }
+          slot = newVertices[i].second;
+        }
+        if(dense)
+          Msg::Debug("Vertex numbering is dense");
         else
-          vertexVector[numVertices] = 0;
-        std::map<int, MVertex*>::const_iterator it = vertexMap.begin();
-        for(; it != vertexMap.end(); ++it)
-          vertexVector[it->first] = it->second;
-        vertexMap.clear();
+          vertexVector.clear();
+      }
+      if(!dense){
+        for(unsigned int i = 0; i < newVertices.size(); i++){
+          if(vertexMap.count(newVertices[i].first))
+            {Msg::Warning("Skipping duplicate vertex %d", newVertices[i].first);}
+          vertexMap[newVertices[i].first] = newVertices[i].second;
+        }
       }
 
     }
     else if(!strncmp(&str[1], "ELM", 3) || !strncmp(&str[1], "Elements", 8)) {
 
-      if(!fgets(str, sizeof(str), fp)){ fclose(fp); return 0; }
+      if(!scanner.getLine(str)) return 0;
       int numElements;
 
       std::map<int, MElement*> elems;
@@ -366,29 +468,36 @@ int GModel::_readMSH2(const std::string &name)
       std::map<int, int> elemphy;
 
       std::set<MElement*> parentsOwned;
-      sscanf(str, "%d", &numElements);
+      sscanf(str.c_str(), "%d", &numElements);
       Msg::Info("%d elements", numElements);
-      //Msg::ResetProgressMeter();
       if(!binary){
+        // all the integers of the section are converted in parallel and then
+        // consumed in the same order as they would be read from the file
+        const char *sectionEnd = findEndOfSection(scanner);
+        std::vector<int> values;
+        if(!parseNumbers(scanner.position(), sectionEnd, values)) return 0;
+        scanner.setPosition(sectionEnd);
+        std::size_t pos = 0;
         for(int i = 0; i < numElements; i++) {
           int num, type, physical = 0, elementary = 0, partition = 0, parent = 0;
           int dom1 = 0, dom2 = 0, numVertices;
           std::vector<short> ghosts;
           if(version <= 1.0){
-            if(fscanf(fp, "%d %d %d %d %d", &num, &type, &physical, &elementary,
-                      &numVertices) != 5){
-              fclose(fp);
+            if(!getNextInt(values, pos, num) || !getNextInt(values, pos, type) ||
+               !getNextInt(values, pos, physical) || !getNextInt(values, pos, elementary) ||
+               !getNextInt(values, pos, numVertices))
               return 0;
-            }
-            if(numVertices != MElement::getInfoMSH(type)){ fclose(fp); return 0; }
+            if(numVertices != MElement::getInfoMSH(type)) return 0;
           }
           else{
             int numTags;
-            if(fscanf(fp, "%d %d %d", &num, &type, &numTags) != 3){ fclose(fp); return 0; }
+            if(!getNextInt(values, pos, num) || !getNextInt(values, pos, type) ||
+               !getNextInt(values, pos, numTags))
+              return 0;
             int numPartitions = 0;
             for(int j = 0; j < numTags; j++){
               int tag;
-              if(fscanf(fp, "%d", &tag) != 1){ fclose(fp); return 0; }
+              if(!getNextInt(values, pos, tag)) return 0;
               if(j == 0) physical = tag;
               else if(j == 1) elementary = tag;
               else if(version < 2.2 && j == 2) partition = tag;
@@ -399,39 +508,26 @@ int GModel::_readMSH2(const std::string &name)
                 parent = tag;
               else if(j == 3 + numPartitions && (numTags == 5 + numPartitions)) {
                 dom1 = tag; j++;
-                if(fscanf(fp, "%d", &dom2) != 1){ fclose(fp); return 0; }
+                if(!getNextInt(values, pos, dom2)) return 0;
               }
             }
             if(!(numVertices = MElement::getInfoMSH(type))) {
-              if(type != MSH_POLYG_ && type != MSH_POLYH_ && type != MSH_POLYG_B){
-                fclose(fp);
+              if(type != MSH_POLYG_ && type != MSH_POLYH_ && type != MSH_POLYG_B)
                 return 0;
-              }
-              if(fscanf(fp, "%d", &numVertices) != 1){ fclose(fp); return 0; }
-            }
-          }
-          int *indices = new int[numVertices];
-          for(int j = 0; j < numVertices; j++){
-            if(fscanf(fp, "%d", &indices[j]) != 1){
-              delete [] indices;
-              fclose(fp);
-              return 0;
+              if(!getNextInt(values, pos, numVertices)) return 0;
             }
           }
+          if(numVertices < 0 || pos + numVertices > values.size()) return 0;
+          int *indices = &values[pos];
+          pos += numVertices;
           std::vector<MVertex*> vertices;
           if(vertexVector.size()){
-            if(!getVertices(numVertices, indices, vertexVector, vertices, minVertex)){
-              delete [] indices;
-              fclose(fp);
+            if(!getVertices(numVertices, indices, vertexVector, vertices, minVertex))
               return 0;
-            }
           }
           else{
-            if(!getVertices(numVertices, indices, vertexMap, vertices)){
-              delete [] indices;
-              fclose(fp);
+            if(!getVertices(numVertices, indices, vertexMap, vertices))
               return 0;
-            }
           }
           MElement *p = NULL;
           bool own = false;
@@ -496,8 +592,6 @@ int GModel::_readMSH2(const std::string &name)
               Msg::Error("Domain element %d not found for element %d", dom2, num);
 #endif
 	  }
-          delete [] indices;
-
           if (CTX::instance()->mesh.ignorePartBound && elementary<0) continue;
           MElement *e = createElementMSH2(this, num, type, physical, elementary,
                                           partition, vertices, elements, physicals,
@@ -517,48 +611,42 @@ int GModel::_readMSH2(const std::string &name)
       }
       else{
         int numElementsPartial = 0;
+        std::vector<int> data;
         while(numElementsPartial < numElements){
           int header[3];
-          if(fread(header, sizeof(int), 3, fp) != 3){ fclose(fp); return 0; }
+          if(!scanner.getBinary(header, 3 * sizeof(int))) return 0;
           if(swap) SwapBytes((char*)header, sizeof(int), 3);
           int type = header[0];
           int numElms = header[1];
           int numTags = header[2];
           int numVertices = MElement::getInfoMSH(type);
           unsigned int n = 1 + numTags + numVertices;
-          int *data = new int[n];
+          // the records of the block are copied in one go
+          data.resize((std::size_t)numElms * n);
+          if(data.size() && !scanner.getBinary(&data[0], data.size() * sizeof(int)))
+            return 0;
+          if(swap && data.size()) SwapBytes((char*)&data[0], sizeof(int), data.size());
           for(int i = 0; i < numElms; i++) {
-            if(fread(data, sizeof(int), n, fp) != n){
-              delete [] data;
-              fclose(fp);
-              return 0;
-            }
-            if(swap) SwapBytes((char*)data, sizeof(int), n);
-            int num = data[0];
-            int physical = (numTags > 0) ? data[1] : 0;
-            int elementary = (numTags > 1) ? data[2] : 0;
-            int numPartitions = (version >= 2.2 && numTags > 3) ? data[3] : 0;
-            int partition = (version < 2.2 && numTags > 2) ? data[3] :
-              (version >= 2.2 && numTags > 3) ? data[4] : 0;
+            int *record = &data[(std::size_t)i * n];
+            int num = record[0];
+            int physical = (numTags > 0) ? record[1] : 0;
+            int elementary = (numTags > 1) ? record[2] : 0;
+            int numPartitions = (version >= 2.2 && numTags > 3) ? record[3] : 0;
+            int partition = (version < 2.2 && numTags > 2) ? record[3] :
+              (version >= 2.2 && numTags > 3) ? record[4] : 0;
             int parent = (version < 2.2 && numTags > 3) ||
               (version >= 2.2 && numPartitions && numTags > 3 + numPartitions) ||
               (version >= 2.2 && !numPartitions && numTags > 2) ?
-              data[numTags] : 0;
-            int *indices = &data[numTags + 1];
+              record[numTags] : 0;
+            int *indices = &record[numTags + 1];
             std::vector<MVertex*> vertices;
             if(vertexVector.size()){
-              if(!getVertices(numVertices, indices, vertexVector, vertices, minVertex)){
-                delete [] data;
-                fclose(fp);
+              if(!getVertices(numVertices, indices, vertexVector, vertices, minVertex))
                 return 0;
-              }
             }
             else{
-              if(!getVertices(numVertices, indices, vertexMap, vertices)){
-                delete [] data;
-                fclose(fp);
+              if(!getVertices(numVertices, indices, vertexMap, vertices))
                 return 0;
-              }
             }
             MElement *p = NULL;
             bool own = false;
@@ -603,12 +691,11 @@ int GModel::_readMSH2(const std::string &name)
 #endif
             if(numPartitions > 1)
               for(int j = 0; j < numPartitions - 1; j++)
-                _ghostCells.insert(std::pair<MElement*, short>(e, -data[5 + j]));
+                _ghostCells.insert(std::pair<MElement*, short>(e, -record[5 + j]));
             if(numElements > 100000)
               {/*Msg::ProgressMeter(numElementsPartial + i + 1, numElements, true,
 			  "Reading elements");*/}
           }
-          delete [] data;
           numElementsPartial += numElms;
         }
       }
@@ -641,7 +728,6 @@ int GModel::_readMSH2(const std::string &name)
           case TYPE_POLYH : elements[9][reg].push_back(e); break;
           default :
             Msg::Error("Wrong type of element");
-            fclose(fp);
             return 0;
           }
         }
@@ -668,8 +754,10 @@ int GModel::_readMSH2(const std::string &name)
     }
 
     do {
-      if(!fgets(str, sizeof(str), fp) || feof(fp))
+      if(!scanner.getLine(str)){
+        str.clear();
         break;
+      }
     } while(str[0] != '$');
   }
 
@@ -694,30 +782,40 @@ int GModel::_readMSH2(const std::string &name)
   _createGeometryOfDiscreteEntities() ;
 
 
-  // copying periodic information from the mesh
+  // copying periodic information from the mesh; the section is small, so it
+  // is read with the stdio based reader
 
-  rewind(fp);
+  scanner.setPosition(scanner.begin());
+  str = "XXX";
 
   while(1) {
 
+    bool endOfFile = false;
     while(str[0] != '$'){
-      if(!fgets(str, sizeof(str), fp) || feof(fp))
+      if(!scanner.getLine(str)){
+        endOfFile = true;
         break;
+      }
     }
-    if(feof(fp))
+    if(endOfFile)
       break;
 
     if(!strncmp(&str[1], "Periodic",8) && strncmp(&str[1],"PeriodicNodes",13)) {
-      readMSHPeriodicNodes(fp,this);
+      FILE *fp = std::fopen(name.c_str(), "rb");
+      if(fp && !fseek(fp, (long)(scanner.position() - scanner.begin()), SEEK_SET))
+        readMSHPeriodicNodes(fp,this);
+      if(fp) fclose(fp);
       break;
     }
     do {
-      if(!fgets(str, sizeof(str), fp) || feof(fp))
+      if(!scanner.getLine(str)){
+        str.clear();
         break;
+      }
     } while(str[0] != '$');
   }
 
-  fclose(fp);
+  file.close();
 
   if(!CTX::instance()->mesh.ignorePeriodicity) alignPeriodicBoundaries();
 
@@ -725,7 +823,7 @@ int GModel::_readMSH2(const std::string &name)
 }
 
 template<class T>
-static void writeElementMSH(FILE *fp, GModel *model, T *ele, bool saveAll,
+static void writeElementMSH(BufferedWriter &out, GModel *model, T *ele, bool saveAll,
                             double version, bool binary, int &num, int elementary,
                             std::vector<int> &physicals, int parentNum = 0,
                             int dom1Num = 0, int dom2Num = 0)
@@ -741,12 +839,12 @@ static void writeElementMSH(FILE *fp, GModel *model, T *ele, bool saveAll,
   }
 
   if(saveAll)
-    ele->writeMSH2(fp, version, binary, ++num, elementary, 0,
+    ele->writeMSH2(out, version, binary, ++num, elementary, 0,
                    parentNum, dom1Num, dom2Num, &ghosts);
   else{
     if(parentNum) parentNum = parentNum - physicals.size() + 1;
     for(unsigned int j = 0; j < physicals.size(); j++){
-      ele->writeMSH2(fp, version, binary, ++num, elementary, physicals[j],
+      ele->writeMSH2(out, version, binary, ++num, elementary, physicals[j],
                      parentNum, dom1Num, dom2Num, &ghosts);
       if(parentNum) parentNum++;
     }
@@ -759,7 +857,7 @@ static void writeElementMSH(FILE *fp, GModel *model, T *ele, bool saveAll,
 }
 
 template<class T>
-static void writeElementsMSH(FILE *fp, GModel *model, std::vector<T*> &ele,
+static void writeElementsMSH(BufferedWriter &out, GModel *model, std::vector<T*> &ele,
                              bool saveAll, int saveSinglePartition, double version,
                              bool binary, int &num, int elementary,
                              std::vector<int> &physicals)
@@ -781,7 +879,7 @@ static void writeElementsMSH(FILE *fp, GModel *model, std::vector<T*> &ele,
         newPhysicals.push_back((maxPhysical - elementary) * offset);
       }
       ele[i]->setPartition(0);
-      writeElementMSH(fp, model, ele[i], saveAll, version, binary, num,
+      writeElementMSH(out, model, ele[i], saveAll, version, binary, num,
                       newElementary, newPhysicals);
     }
     return;
@@ -796,7 +894,7 @@ static void writeElementsMSH(FILE *fp, GModel *model, std::vector<T*> &ele,
     MElement *parent = ele[i]->getParent();
     if(parent)
       parentNum = model->getMeshElementIndex(parent);
-    writeElementMSH(fp, model, ele[i], saveAll, version, binary, num,
+    writeElementMSH(out, model, ele[i], saveAll, version, binary, num,
                     elementary, physicals, parentNum);
   }
 }
@@ -888,6 +986,8 @@ int GModel::_writeMSH2(const std::string &name, double version, bool binary,
     return 0;
   }
 
+  BufferedWriter out(fp);
+
   // binary format exists only in version 2
   if(version > 1 || binary)
     version = 2.2;
@@ -906,62 +1006,64 @@ int GModel::_writeMSH2(const std::string &name, double version, bool binary,
   int numElements = getNumElementsMSH(this, saveAll, saveSinglePartition);
 
   if(version >= 2.0){
-    fprintf(fp, "$MeshFormat\n");
-    fprintf(fp, "%g %d %d\n", version, binary ? 1 : 0, (int)sizeof(double));
+    out.putFormat("$MeshFormat\n");
+    out.putFormat("%g %d %d\n", version, binary ? 1 : 0, (int)sizeof(double));
     if(binary){
       int one = 1;
-      fwrite(&one, sizeof(int), 1, fp);
-      fprintf(fp, "\n");
+      out.putBinary(&one, sizeof(int));
+      out.putFormat("\n");
     }
-    fprintf(fp, "$EndMeshFormat\n");
+    out.putFormat("$EndMeshFormat\n");
 
     if(numPhysicalNames()){
-      fprintf(fp, "$PhysicalNames\n");
-      fprintf(fp, "%d\n", numPhysicalNames());
+      out.putFormat("$PhysicalNames\n");
+      out.putFormat("%d\n", numPhysicalNames());
       for(piter it = firstPhysicalName(); it != lastPhysicalName(); it++){
         std::string name = it->second;
         if(name.size() > 128) name.resize(128);
-        fprintf(fp, "%d %d \"%s\"\n", it->first.first, it->first.second,
+        out.putFormat("%d %d \"%s\"\n", it->first.first, it->first.second,
                 name.c_str());
       }
-      fprintf(fp, "$EndPhysicalNames\n");
+      out.putFormat("$EndPhysicalNames\n");
     }
 
-    if (CTX::instance()->mesh.saveTopology)
+    if (CTX::instance()->mesh.saveTopology){
+      out.flush();
       writeMSHEntities(fp, this);
+    }
 
     if (saveParametric)
-      fprintf(fp, "$ParametricNodes\n");
+      out.putFormat("$ParametricNodes\n");
     else
-      fprintf(fp, "$Nodes\n");
+      out.putFormat("$Nodes\n");
   }
   else
-    fprintf(fp, "$NOD\n");
+    out.putFormat("$NOD\n");
 
-  fprintf(fp, "%d\n", numVertices);
+  out.putFormat("%d\n", numVertices);
 
   std::vector<GEntity*> entities;
   getEntities(entities);
   for(unsigned int i = 0; i < entities.size(); i++)
     for(unsigned int j = 0; j < entities[i]->mesh_vertices.size(); j++)
-      entities[i]->mesh_vertices[j]->writeMSH2(fp, binary, saveParametric,
+      entities[i]->mesh_vertices[j]->writeMSH2(out, binary, saveParametric,
                                                scalingFactor);
 
-  if(binary) fprintf(fp, "\n");
+  if(binary) out.putFormat("\n");
 
   if(version >= 2.0){
     if(saveParametric)
-      fprintf(fp, "$EndParametricNodes\n");
+      out.putFormat("$EndParametricNodes\n");
     else
-      fprintf(fp, "$EndNodes\n");
-    fprintf(fp, "$Elements\n");
+      out.putFormat("$EndNodes\n");
+    out.putFormat("$Elements\n");
   }
   else{
-    fprintf(fp, "$ENDNOD\n");
-    fprintf(fp, "$ELM\n");
+    out.putFormat("$ENDNOD\n");
+    out.putFormat("$ELM\n");
   }
 
-  fprintf(fp, "%d\n", numElements);
+  out.putFormat("%d\n", numElements);
   int num = elementStartNum;
 
   _elementIndexCache.clear();
@@ -971,78 +1073,78 @@ int GModel::_writeMSH2(const std::string &name, double version, bool binary,
    for(viter it = firstVertex(); it != lastVertex(); ++it)
      for(unsigned int i = 0; i < (*it)->points.size(); i++)
        if((*it)->points[i]->ownsParent())
-         writeElementMSH(fp, this, (*it)->points[i]->getParent(),
+         writeElementMSH(out, this, (*it)->points[i]->getParent(),
                          saveAll, version, binary, num, (*it)->tag(), (*it)->physicals);
    for(eiter it = firstEdge(); it != lastEdge(); ++it)
      for(unsigned int i = 0; i < (*it)->lines.size(); i++)
        if((*it)->lines[i]->ownsParent())
-         writeElementMSH(fp, this, (*it)->lines[i]->getParent(),
+         writeElementMSH(out, this, (*it)->lines[i]->getParent(),
                          saveAll, version, binary, num, (*it)->tag(), (*it)->physicals);
    for(fiter it = firstFace(); it != lastFace(); ++it)
      for(unsigned int i = 0; i < (*it)->triangles.size(); i++)
        if((*it)->triangles[i]->ownsParent())
-         writeElementMSH(fp, this, (*it)->triangles[i]->getParent(),
+         writeElementMSH(out, this, (*it)->triangles[i]->getParent(),
                          saveAll, version, binary, num, (*it)->tag(), (*it)->physicals);
   /* for(riter it = firstRegion(); it != lastRegion(); ++it)
      for(unsigned int i = 0; i < (*it)->tetrahedra.size(); i++)
        if((*it)->tetrahedra[i]->ownsParent())
-         writeElementMSH(fp, this, (*it)->tetrahedra[i]->getParent(),
+         writeElementMSH(out, this, (*it)->tetrahedra[i]->getParent(),
                          saveAll, version, binary, num, (*it)->tag(), (*it)->physicals);*/
    for(fiter it = firstFace(); it != lastFace(); ++it)
      for(unsigned int i = 0; i < (*it)->polygons.size(); i++)
        if((*it)->polygons[i]->ownsParent())
-         writeElementMSH(fp, this, (*it)->polygons[i]->getParent(),
+         writeElementMSH(out, this, (*it)->polygons[i]->getParent(),
                          saveAll, version, binary, num, (*it)->tag(), (*it)->physicals);
   /* for(riter it = firstRegion(); it != lastRegion(); ++it)
      for(unsigned int i = 0; i < (*it)->polyhedra.size(); i++)
        if((*it)->polyhedra[i]->ownsParent())
-         writeElementMSH(fp, this, (*it)->polyhedra[i]->getParent(),
+         writeElementMSH(out, this, (*it)->polyhedra[i]->getParent(),
                          saveAll, version, binary, num, (*it)->tag(), (*it)->physicals);*/
   }
   // points
   for(viter it = firstVertex(); it != lastVertex(); ++it)
-    writeElementsMSH(fp, this, (*it)->points, saveAll, saveSinglePartition,
+    writeElementsMSH(out, this, (*it)->points, saveAll, saveSinglePartition,
                      version, binary, num, (*it)->tag(), (*it)->physicals);
   // lines
   for(eiter it = firstEdge(); it != lastEdge(); ++it)
-    writeElementsMSH(fp, this, (*it)->lines, saveAll, saveSinglePartition,
+    writeElementsMSH(out, this, (*it)->lines, saveAll, saveSinglePartition,
                      version, binary, num, (*it)->tag(), (*it)->physicals);
   // triangles
   for(fiter it = firstFace(); it != lastFace(); ++it)
-    writeElementsMSH(fp, this, (*it)->triangles, saveAll, saveSinglePartition,
+    writeElementsMSH(out, this, (*it)->triangles, saveAll, saveSinglePartition,
                      version, binary, num, (*it)->tag(), (*it)->physicals);
 
   // quads
   for(fiter it = firstFace(); it != lastFace(); ++it)
-    writeElementsMSH(fp, this, (*it)->quadrangles, saveAll, saveSinglePartition,
+    writeElementsMSH(out, this, (*it)->quadrangles, saveAll, saveSinglePartition,
                      version, binary, num, (*it)->tag(), (*it)->physicals);
   // polygons
   for(fiter it = firstFace(); it != lastFace(); it++)
-    writeElementsMSH(fp, this, (*it)->polygons, saveAll, saveSinglePartition,
+    writeElementsMSH(out, this, (*it)->polygons, saveAll, saveSinglePartition,
                      version, binary, num, (*it)->tag(), (*it)->physicals);
   // tets
  // for(riter it = firstRegion(); it != lastRegion(); ++it)
-  //  writeElementsMSH(fp, this, (*it)->tetrahedra, saveAll, saveSinglePartition,
+  //  writeElementsMSH(out, this, (*it)->tetrahedra, saveAll, saveSinglePartition,
   //                   version, binary, num, (*it)->tag(), (*it)->physicals);
 
   // hexas
 //  for(riter it = firstRegion(); it != lastRegion(); ++it)
- //   writeElementsMSH(fp, this, (*it)->hexahedra, saveAll, saveSinglePartition,
+ //   writeElementsMSH(out, this, (*it)->hexahedra, saveAll, saveSinglePartition,
  //                    version, binary, num, (*it)->tag(), (*it)->physicals);
 
   // prisms
  // for(riter it = firstRegion(); it != lastRegion(); ++it)
-//    writeElementsMSH(fp, this, (*it)->prisms, saveAll, saveSinglePartition,
+//    writeElementsMSH(out, this, (*it)->prisms, saveAll, saveSinglePartition,
  //                    version, binary, num, (*it)->tag(), (*it)->physicals);
 
   // pyramids
  // for(riter it = firstRegion(); it != lastRegion(); ++it)
- //   writeElementsMSH(fp, this, (*it)->pyramids, saveAll, saveSinglePartition,
+ //   writeElementsMSH(out, this, (*it)->pyramids, saveAll, saveSinglePartition,
  //                    version, binary, num, (*it)->tag(), (*it)->physicals);
 
   // polyhedra
 //  for(riter it = firstRegion(); it != lastRegion(); ++it)
- //   writeElementsMSH(fp, this, (*it)->polyhedra, saveAll, saveSinglePartition,
+ //   writeElementsMSH(out, this, (*it)->polyhedra, saveAll, saveSinglePartition,
  //                    version, binary, num, (*it)->tag(), (*it)->physicals);
 
   // level set faces
@@ -1050,7 +1152,7 @@ int GModel::_writeMSH2(const std::string &name, double version, bool binary,
     for(unsigned int i = 0; i < (*it)->triangles.size(); i++) {
       MTriangle *t = (*it)->triangles[i];
       if(t->getDomain(0))
-        writeElementMSH(fp, this, t, saveAll, version, binary, num,
+        writeElementMSH(out, this, t, saveAll, version, binary, num,
                         (*it)->tag(), (*it)->physicals, 0,
                         getMeshElementIndex(t->getDomain(0)),
                         getMeshElementIndex(t->getDomain(1)));
@@ -1058,7 +1160,7 @@ int GModel::_writeMSH2(const std::string &name, double version, bool binary,
     for(unsigned int i = 0; i < (*it)->polygons.size(); i++) {
       MPolygon *p = (*it)->polygons[i];
       if(p->getDomain(0))
-        writeElementMSH(fp, this, p, saveAll, version, binary, num,
+        writeElementMSH(out, this, p, saveAll, version, binary, num,
                         (*it)->tag(), (*it)->physicals, 0,
                         getMeshElementIndex(p->getDomain(0)),
                         getMeshElementIndex(p->getDomain(1)));
@@ -1069,47 +1171,234 @@ int GModel::_writeMSH2(const std::string &name, double version, bool binary,
     for(unsigned int i = 0; i < (*it)->lines.size(); i++) {
       MLine *l = (*it)->lines[i];
       if(l->getDomain(0))
-        writeElementMSH(fp, this, l, saveAll, version, binary, num,
+        writeElementMSH(out, this, l, saveAll, version, binary, num,
                         (*it)->tag(), (*it)->physicals, 0,
                         getMeshElementIndex(l->getDomain(0)),
                         getMeshElementIndex(l->getDomain(1)));
     }
   }
 
-  if(binary) fprintf(fp, "\n");
+  if(binary) out.putFormat("\n");
 
   if(version >= 2.0){
-    fprintf(fp, "$EndElements\n");
+    out.putFormat("$EndElements\n");
   }
   else{
-    fprintf(fp, "$ENDELM\n");
+    out.putFormat("$ENDELM\n");
   }
 
+  out.flush();
   writeMSHPeriodicNodes (fp, entities, renumberVertices);
 
   fclose(fp);
 
+  if(!out.good()){
+    Msg::Error("Error writing file '%s'", name.c_str());
+    return 0;
+  }
+
   return 1;
 }
 
+// An element of a partition file: the element, the entity it is saved with
+// and the number of its first record
+struct partitionElementMSH {
+  MElement *element;
+  GEntity *entity;
+  int num;
+};
+
+template<class T>
+static void addPartitionElementsMSH(GEntity *ge, std::vector<T*> &ele, bool saveAll,
+                                    std::map<int, int> &partitionIndex,
+                                    std::vector<std::vector<partitionElementMSH> > &owned)
+{
+  if(!saveAll && ge->physicals.empty()) return;
+  for(unsigned int i = 0; i < ele.size(); i++){
+    if(ele[i]->getDomain(0)) continue;
+    std::map<int, int>::iterator it = partitionIndex.find(ele[i]->getPartition());
+    if(it == partitionIndex.end()) continue;
+    partitionElementMSH pe = {ele[i], ge, 0};
+    owned[it->second].push_back(pe);
+  }
+}
+
+// number of element records and of element numbers used by an element, as
+// in writeElementMSH()
+static void getNumRecordsMSH(const partitionElementMSH &pe, bool saveAll,
+                             int &numRecords, int &numNumbers)
+{
+  int p = saveAll ? 1 : pe.entity->physicals.size();
+  int numChildren = CTX::instance()->mesh.saveTri ? pe.element->getNumChildren() : 0;
+  numRecords = numChildren ? p * numChildren : p;
+  numNumbers = numChildren ? p + numChildren - 1 : p;
+}
+
+static void writePartitionElementMSH(BufferedWriter &out, const partitionElementMSH &pe,
+                                     bool saveAll, bool binary,
+                                     std::vector<short> &ghosts)
+{
+  int num = pe.num;
+  if(saveAll)
+    pe.element->writeMSH2(out, 2.2, binary, num, pe.entity->tag(), 0, 0, 0, 0,
+                          &ghosts);
+  else
+    for(unsigned int j = 0; j < pe.entity->physicals.size(); j++)
+      pe.element->writeMSH2(out, 2.2, binary, num++, pe.entity->tag(),
+                            pe.entity->physicals[j], 0, 0, 0, &ghosts);
+}
+
 int GModel::_writePartitionedMSH2(const std::string &baseName, bool binary,
                                   bool saveAll, bool saveParametric,
                                   double scalingFactor)
 {
-  int numElements;
-  int startNum = 0;
-  for(std::set<int>::iterator it = meshPartitions.begin();
-      it != meshPartitions.end(); it++){
-    int partition = *it;
+  // The partitions are written concurrently, so everything that
+  // _writeMSH2() would change in the model (the vertex indices and the
+  // element numbers) is set up here once for all the partitions. The files
+  // are identical to the ones of _writeMSH2() with saveSinglePartition,
+  // except that the vertices keep their numbers across the partitions and
+  // that the ghost cells of each partition are appended to its elements.
+  if(noPhysicalGroups()) saveAll = true;
+
+  std::vector<int> partitions(meshPartitions.begin(), meshPartitions.end());
+  std::map<int, int> partitionIndex;
+  for(unsigned int i = 0; i < partitions.size(); i++)
+    partitionIndex[partitions[i]] = i;
+
+  indexMeshVertices(saveAll, 0, false);
+
+  // owned elements of each partition, in the order of _writeMSH2()
+  std::vector<std::vector<partitionElementMSH> > owned(partitions.size());
+  for(viter it = firstVertex(); it != lastVertex(); ++it)
+    addPartitionElementsMSH(*it, (*it)->points, saveAll, partitionIndex, owned);
+  for(eiter it = firstEdge(); it != lastEdge(); ++it)
+    addPartitionElementsMSH(*it, (*it)->lines, saveAll, partitionIndex, owned);
+  for(fiter it = firstFace(); it != lastFace(); ++it)
+    addPartitionElementsMSH(*it, (*it)->triangles, saveAll, partitionIndex, owned);
+  for(fiter it = firstFace(); it != lastFace(); ++it)
+    addPartitionElementsMSH(*it, (*it)->quadrangles, saveAll, partitionIndex, owned);
+  for(fiter it = firstFace(); it != lastFace(); ++it)
+    addPartitionElementsMSH(*it, (*it)->polygons, saveAll, partitionIndex, owned);
+
+  // the elements are numbered continuously from one partition to the next,
+  // so that a ghost cell has the same number in all the files
+  int num = 0;
+  std::vector<int> numRecords(partitions.size(), 0);
+  for(unsigned int i = 0; i < owned.size(); i++){
+    for(unsigned int j = 0; j < owned[i].size(); j++){
+      int records, numbers;
+      getNumRecordsMSH(owned[i][j], saveAll, records, numbers);
+      owned[i][j].num = num + 1;
+      num += numbers;
+      numRecords[i] += records;
+    }
+  }
+
+  // ghost cells of each partition, and the ghost partitions of each element
+  std::vector<std::vector<const partitionElementMSH*> > ghosts(partitions.size());
+  std::map<MElement*, std::vector<short> > elementGhosts;
+  if(_ghostCells.size()){
+    for(unsigned int i = 0; i < owned.size(); i++){
+      for(unsigned int j = 0; j < owned[i].size(); j++){
+        std::pair<std::multimap<MElement*, short>::iterator,
+                  std::multimap<MElement*, short>::iterator> itp =
+          _ghostCells.equal_range(owned[i][j].element);
+        for(std::multimap<MElement*, short>::iterator it = itp.first;
+            it != itp.second; it++){
+          elementGhosts[owned[i][j].element].push_back(it->second);
+          std::map<int, int>::iterator itg = partitionIndex.find(it->second);
+          if(itg == partitionIndex.end()) continue;
+          int records, numbers;
+          getNumRecordsMSH(owned[i][j], saveAll, records, numbers);
+          ghosts[itg->second].push_back(&owned[i][j]);
+          numRecords[itg->second] += records;
+        }
+      }
+    }
+  }
+
+  std::vector<GEntity*> entities;
+  getEntities(entities);
+  std::vector<int> written(partitions.size(), 1);
 
+#if defined(_OPENMP)
+#pragma omp parallel for schedule(dynamic, 1)
+#endif
+  for(int i = 0; i < (int)partitions.size(); i++){
     std::ostringstream sstream;
-    sstream << baseName << "_" << std::setw(6) << std::setfill('0') << partition;
+    sstream << baseName << "_" << std::setw(6) << std::setfill('0') << partitions[i];
+    FILE *fp = std::fopen(sstream.str().c_str(), binary ? "wb" : "w");
+    if(!fp){
+      written[i] = 0;
+      continue;
+    }
+    BufferedWriter out(fp);
+
+    // the vertices of the owned elements and of the ghost cells
+    std::vector<char> used(getMaxVertexNumber() + 1, 0);
+    int numVertices = 0;
+    for(unsigned int j = 0; j < owned[i].size() + ghosts[i].size(); j++){
+      MElement *e = (j < owned[i].size()) ? owned[i][j].element :
+        ghosts[i][j - owned[i].size()]->element;
+      for(int k = 0; k < e->getNumVertices(); k++){
+        MVertex *v = e->getVertex(k);
+        if(v->getNum() < (int)used.size() && !used[v->getNum()]){
+          used[v->getNum()] = 1;
+          numVertices++;
+        }
+      }
+    }
+
+    out.putFormat("$MeshFormat\n");
+    out.putFormat("%g %d %d\n", 2.2, binary ? 1 : 0, (int)sizeof(double));
+    if(binary){
+      int one = 1;
+      out.putBinary(&one, sizeof(int));
+      out.putFormat("\n");
+    }
+    out.putFormat("$EndMeshFormat\n");
 
-    numElements = getNumElementsMSH(this, saveAll, partition);
-    Msg::Info("Writing partition %d in file '%s'", partition, sstream.str().c_str());
-    _writeMSH2(sstream.str(), 2.2, binary, saveAll, saveParametric,
-               scalingFactor, startNum, partition, false, false); // NO RENUMBERING!
-    startNum += numElements; // update for next iteration in the loop
+    if(numPhysicalNames()){
+      out.putFormat("$PhysicalNames\n");
+      out.putFormat("%d\n", numPhysicalNames());
+      for(piter it = firstPhysicalName(); it != lastPhysicalName(); it++){
+        std::string name = it->second;
+        if(name.size() > 128) name.resize(128);
+        out.putFormat("%d %d \"%s\"\n", it->first.first, it->first.second,
+                      name.c_str());
+      }
+      out.putFormat("$EndPhysicalNames\n");
+    }
+
+    out.putFormat(saveParametric ? "$ParametricNodes\n" : "$Nodes\n");
+    out.putFormat("%d\n", numVertices);
+    for(unsigned int j = 0; j < entities.size(); j++)
+      for(unsigned int k = 0; k < entities[j]->mesh_vertices.size(); k++){
+        MVertex *v = entities[j]->mesh_vertices[k];
+        if(v->getNum() < (int)used.size() && used[v->getNum()])
+          v->writeMSH2(out, binary, saveParametric, scalingFactor);
+      }
+    if(binary) out.putFormat("\n");
+    out.putFormat(saveParametric ? "$EndParametricNodes\n" : "$EndNodes\n");
+
+    out.putFormat("$Elements\n");
+    out.putFormat("%d\n", numRecords[i]);
+    std::vector<short> noGhosts;
+    for(unsigned int j = 0; j < owned[i].size() + ghosts[i].size(); j++){
+      const partitionElementMSH &pe = (j < owned[i].size()) ? owned[i][j] :
+        *ghosts[i][j - owned[i].size()];
+      std::map<MElement*, std::vector<short> >::iterator it =
+        elementGhosts.find(pe.element);
+      writePartitionElementMSH(out, pe, saveAll, binary,
+                               (it != elementGhosts.end()) ? it->second : noGhosts);
+    }
+    if(binary) out.putFormat("\n");
+    out.putFormat("$EndElements\n");
+
+    out.flush();
+    writeMSHPeriodicNodes(fp, entities, false);
+
+    if(fclose(fp) || !out.good()) written[i] = -1;
   }
 
 #if 0
@@ -1125,5 +1414,20 @@ int GModel::_writePartitionedMSH2(const std::string &baseName, bool binary,
   }
 #endif
 
-  return 1;
+  int status = 1;
+  for(unsigned int i = 0; i < partitions.size(); i++){
+    std::ostringstream sstream;
+    sstream << baseName << "_" << std::setw(6) << std::setfill('0') << partitions[i];
+    if(written[i] == 1)
+      Msg::Info("Wrote partition %d in file '%s'", partitions[i], sstream.str().c_str());
+    else{
+      if(written[i] == 0)
+        Msg::Error("Unable to open file '%s'", sstream.str().c_str());
+      else
+        Msg::Error("Error writing file '%s'", sstream.str().c_str());
+      status = 0;
+    }
+  }
+
+  return status;
 }
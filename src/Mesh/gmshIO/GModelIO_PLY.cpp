@@ -6,6 +6,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include "Mesh/GMSH/GModel.h"
+#include "Mesh/meshFileWriter.h"
 #include "Mesh/GMSH/MTriangle.h"
 #include "common/OS.h"
 
@@ -239,33 +240,13 @@ int GModel::readPLY2(const std::string &name)
 
 int GModel::writePLY2(const std::string &name)
 {
-  FILE *fp = Fopen(name.c_str(), "w");
-  if(!fp){
-    Msg::Error("Unable to open file '%s'", name.c_str());
+  // the mesh is written from a snapshot by the same writer as the background
+  // mesh exports
+  std::string message;
+  if(!meshFileWriter::writeModel(this, meshExportFormat::PLY2, name, message)){
+    Msg::Error("%s", message.c_str());
     return 0;
   }
-
-  int numVertices = indexMeshVertices(true);
-  int numTriangles = 0;
-  for(fiter it = firstFace(); it != lastFace(); ++it){
-    numTriangles += (*it)->triangles.size();
-  }
-
-  fprintf(fp, "%d\n", numVertices);
-  fprintf(fp, "%d\n", numTriangles);
-
-  std::vector<GEntity*> entities;
-  getEntities(entities);
-  for(unsigned int i = 0; i < entities.size(); i++)
-    for(unsigned int j = 0; j < entities[i]->mesh_vertices.size(); j++)
-      entities[i]->mesh_vertices[j]->writePLY2(fp);
-
-  for(fiter it = firstFace(); it != lastFace(); ++it){
-      for(unsigned int i = 0; i < (*it)->triangles.size(); i++)
-        (*it)->triangles[i]->writePLY2(fp);
-  }
-
-  fclose(fp);
   return 1;
 }
 
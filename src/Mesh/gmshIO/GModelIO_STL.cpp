@@ -5,6 +5,7 @@
 
 #include <stdio.h>
 #include "Mesh/GMSH/GModel.h"
+#include "Mesh/meshFileWriter.h"
 #include "common/OS.h"
 #include "Mesh/GMSH/MLine.h"
 #include "Mesh/GMSH/MTriangle.h"
@@ -186,43 +187,14 @@ int GModel::readSTL(const std::string &name, double tolerance)
 int GModel::writeSTL(const std::string &name, bool binary, bool saveAll,
                      double scalingFactor)
 {
-  FILE *fp = Fopen(name.c_str(), binary ? "wb" : "w");
-  if(!fp){
-    Msg::Error("Unable to open file '%s'", name.c_str());
+  // the mesh is written from a snapshot by the same writer as the background
+  // mesh exports
+  std::string message;
+  if(!meshFileWriter::writeModel(this, meshExportFormat::STL, name, message,
+                                 binary, saveAll, scalingFactor)){
+    Msg::Error("%s", message.c_str());
     return 0;
   }
-
-  if(noPhysicalGroups()) saveAll = true;
-
-  if(!binary){
-    fprintf(fp, "solid Created by Gmsh\n");
-  }
-  else{
-    char header[80];
-    strncpy(header, "Created by Gmsh", 80);
-    fwrite(header, sizeof(char), 80, fp);
-    unsigned int nfacets = 0;
-    for(fiter it = firstFace(); it != lastFace(); ++it){
-      if(saveAll || (*it)->physicals.size()){
-        nfacets += (*it)->triangles.size() + 2 * (*it)->quadrangles.size();
-      }
-    }
-    fwrite(&nfacets, sizeof(unsigned int), 1, fp);
-  }
-
-  for(fiter it = firstFace(); it != lastFace(); ++it) {
-    if(saveAll || (*it)->physicals.size()){
-      for(unsigned int i = 0; i < (*it)->triangles.size(); i++)
-        (*it)->triangles[i]->writeSTL(fp, binary, scalingFactor);
-      for(unsigned int i = 0; i < (*it)->quadrangles.size(); i++)
-        (*it)->quadrangles[i]->writeSTL(fp, binary, scalingFactor);
-    }
-  }
-
-  if(!binary)
-    fprintf(fp, "endsolid Created by Gmsh\n");
-
-  fclose(fp);
   return 1;
 }
 
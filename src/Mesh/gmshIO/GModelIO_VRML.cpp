@@ -6,6 +6,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include "Mesh/GMSH/GModel.h"
+#include "Mesh/meshFileWriter.h"
 #include "common/OS.h"
 #include "Mesh/GMSH/MLine.h"
 #include "Mesh/GMSH/MTriangle.h"
@@ -190,58 +191,13 @@ int GModel::readVRML(const std::string &name)
 
 int GModel::writeVRML(const std::string &name, bool saveAll, double scalingFactor)
 {
-  FILE *fp = fopen(name.c_str(), "w");
-  if(!fp){
-    Msg::Error("Unable to open file '%s'", name.c_str());
+  // the mesh is written from a snapshot by the same writer as the background
+  // mesh exports
+  std::string message;
+  if(!meshFileWriter::writeModel(this, meshExportFormat::VRML, name, message,
+                                 false, saveAll, scalingFactor)){
+    Msg::Error("%s", message.c_str());
     return 0;
   }
-
-  if(noPhysicalGroups()) saveAll = true;
-
-  indexMeshVertices(saveAll);
-
-  fprintf(fp, "#VRML V1.0 ascii\n");
-  fprintf(fp, "#created by Gmsh\n");
-  fprintf(fp, "Coordinate3 {\n");
-  fprintf(fp, "  point [\n");
-
-  for(viter it = firstVertex(); it != lastVertex(); ++it)
-    for(unsigned int i = 0; i < (*it)->mesh_vertices.size(); i++)
-      (*it)->mesh_vertices[i]->writeVRML(fp, scalingFactor);
-  for(eiter it = firstEdge(); it != lastEdge(); ++it)
-    for(unsigned int i = 0; i < (*it)->mesh_vertices.size(); i++)
-      (*it)->mesh_vertices[i]->writeVRML(fp, scalingFactor);
-  for(fiter it = firstFace(); it != lastFace(); ++it)
-    for(unsigned int i = 0; i < (*it)->mesh_vertices.size(); i++)
-      (*it)->mesh_vertices[i]->writeVRML(fp, scalingFactor);
-
-  fprintf(fp, "  ]\n");
-  fprintf(fp, "}\n");
-
-  for(eiter it = firstEdge(); it != lastEdge(); ++it){
-    if(saveAll || (*it)->physicals.size()){
-      fprintf(fp, "DEF Curve%d IndexedLineSet {\n", (*it)->tag());
-      fprintf(fp, "  coordIndex [\n");
-      for(unsigned int i = 0; i < (*it)->lines.size(); i++)
-        (*it)->lines[i]->writeVRML(fp);
-      fprintf(fp, "  ]\n");
-      fprintf(fp, "}\n");
-    }
-  }
-
-  for(fiter it = firstFace(); it != lastFace(); ++it){
-    if(saveAll || (*it)->physicals.size()){
-      fprintf(fp, "DEF Surface%d IndexedFaceSet {\n", (*it)->tag());
-      fprintf(fp, "  coordIndex [\n");
-      for(unsigned int i = 0; i < (*it)->triangles.size(); i++)
-        (*it)->triangles[i]->writeVRML(fp);
-      for(unsigned int i = 0; i < (*it)->quadrangles.size(); i++)
-        (*it)->quadrangles[i]->writeVRML(fp);
-      fprintf(fp, "  ]\n");
-      fprintf(fp, "}\n");
-    }
-  }
-
-  fclose(fp);
   return 1;
 }
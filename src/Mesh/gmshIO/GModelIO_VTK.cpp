@@ -4,6 +4,7 @@
 // bugs and problems to the public mailing list <gmsh@onelab.info>.
 
 #include "Mesh/GMSH/GModel.h"
+#include "Mesh/meshFileWriter.h"
 #include "common/OS.h"
 #include "Mesh/GMSH/MPoint.h"
 #include "Mesh/GMSH/MLine.h"
@@ -18,89 +19,14 @@
 int GModel::writeVTK(const std::string &name, bool binary, bool saveAll,
                      double scalingFactor, bool bigEndian)
 {
-  FILE *fp = fopen(name.c_str(), binary ? "wb" : "w");
-  if(!fp){
-    Msg::Error("Unable to open file '%s'", name.c_str());
+  // the mesh is written from a snapshot by the same writer as the background
+  // mesh exports
+  std::string message;
+  if(!meshFileWriter::writeModel(this, meshExportFormat::VTK, name, message,
+                                 binary, saveAll, scalingFactor, bigEndian)){
+    Msg::Error("%s", message.c_str());
     return 0;
   }
-
-  if(noPhysicalGroups()) saveAll = true;
-
-  // get the number of vertices and index the vertices in a continuous
-  // sequence
-  int numVertices = indexMeshVertices(saveAll);
-
-  fprintf(fp, "# vtk DataFile Version 2.0\n");
-  fprintf(fp, "%s, Created by Gmsh\n", getName().c_str());
-  if(binary)
-    fprintf(fp, "BINARY\n");
-  else
-    fprintf(fp, "ASCII\n");
-  fprintf(fp, "DATASET UNSTRUCTURED_GRID\n");
-
-  // get all the entities in the model
-  std::vector<GEntity*> entities;
-  getEntities(entities);
-
-  // write mesh vertices
-  fprintf(fp, "POINTS %d double\n", numVertices);
-  for(unsigned int i = 0; i < entities.size(); i++)
-    for(unsigned int j = 0; j < entities[i]->mesh_vertices.size(); j++)
-      entities[i]->mesh_vertices[j]->writeVTK(fp, binary, scalingFactor, bigEndian);
-  fprintf(fp, "\n");
-
-  // loop over all elements we need to save and count vertices
-  int numElements = 0, totalNumInt = 0;
-	for(unsigned int i = 0; i < entities.size(); i++)
-	{
-		
-		if(entities[i]->physicals.size() || saveAll)
-		{
-			for(unsigned int j = 0; j < entities[i]->getNumMeshElements(); j++)
-			{
-				if(entities[i]->getMeshElement(j)->getTypeForVTK())
-				{
-					numElements++;
-					totalNumInt += entities[i]->getMeshElement(j)->getNumVertices() + 1;
-				}
-			}
-		}
-		
-	}
-
-  // print vertex indices in ascii or binary
-  fprintf(fp, "CELLS %d %d\n", numElements, totalNumInt);
-  for(unsigned int i = 0; i < entities.size(); i++){
-    if(entities[i]->physicals.size() || saveAll){
-		int temp = entities[i]->getNumMeshElements();
-      for(unsigned int j = 0; j < entities[i]->getNumMeshElements(); j++){
-        if(entities[i]->getMeshElement(j)->getTypeForVTK())
-          entities[i]->getMeshElement(j)->writeVTK(fp, binary, bigEndian);
-      }
-    }
-  }
-  fprintf(fp, "\n");
-
-  // print element types in ascii or binary
-  fprintf(fp, "CELL_TYPES %d\n", numElements);
-  for(unsigned int i = 0; i < entities.size(); i++){
-    if(entities[i]->physicals.size() || saveAll){
-      for(unsigned int j = 0; j < entities[i]->getNumMeshElements(); j++){
-        int type = entities[i]->getMeshElement(j)->getTypeForVTK();
-        if(type){
-          if(binary){
-            // VTK always expects big endian binary data
-            if(!bigEndian) SwapBytes((char*)&type, sizeof(int), 1);
-            fwrite(&type, sizeof(int), 1, fp);
-          }
-          else
-            fprintf(fp, "%d\n", type);
-        }
-      }
-    }
-  }
-
-  fclose(fp);
   return 1;
 }
 
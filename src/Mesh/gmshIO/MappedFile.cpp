@@ -0,0 +1,215 @@
+// Gmsh - Copyright (C) 1997-2017 C. Geuzaine, J.-F. Remacle
+//
+// See the LICENSE.txt file for license information. Please report all
+// bugs and problems to the public mailing list <gmsh@onelab.info>.
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include "Mesh/gmshIO/MappedFile.h"
+
+#if !defined(WIN32) || defined(__CYGWIN__)
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#define HAVE_MMAP
+#endif
+
+bool MappedFile::open(const std::string &name)
+{
+  close();
+#if defined(HAVE_MMAP)
+  int fd = ::open(name.c_str(), O_RDONLY);
+  if(fd < 0) return false;
+  struct stat st;
+  if(fstat(fd, &st) != 0){
+    ::close(fd);
+    return false;
+  }
+  _size = st.st_size;
+  if(_size){
+    void *data = mmap(0, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if(data != MAP_FAILED){
+      // the file is read from the front to the back
+      madvise(data, _size, MADV_SEQUENTIAL);
+      _data = (const char*)data;
+      _mapped = true;
+      ::close(fd);
+      return true;
+    }
+  }
+  ::close(fd);
+#endif
+  FILE *fp = fopen(name.c_str(), "rb");
+  if(!fp) return false;
+  fseek(fp, 0, SEEK_END);
+  long size = ftell(fp);
+  fseek(fp, 0, SEEK_SET);
+  _buffer.resize(size > 0 ? size : 0);
+  if(size > 0 && fread(&_buffer[0], 1, size, fp) != (std::size_t)size){
+    fclose(fp);
+    _buffer.clear();
+    return false;
+  }
+  fclose(fp);
+  _size = _buffer.size();
+  _data = _size ? &_buffer[0] : 0;
+  return true;
+}
+
+void MappedFile::close()
+{
+#if defined(HAVE_MMAP)
+  if(_mapped) munmap((void*)_data, _size);
+#endif
+  _mapped = false;
+  _data = 0;
+  _size = 0;
+  std::vector<char>().swap(_buffer);
+}
+
+bool TextScanner::getLine(std::string &line)
+{
+  if(_pos >= _end) return false;
+  const char *eol = (const char*)memchr(_pos, '\n', _end - _pos);
+  const char *next = eol ? eol + 1 : _end;
+  line.assign(_pos, next);
+  _pos = next;
+  return true;
+}
+
+const char *TextScanner::find(const char *str) const
+{
+  std::size_t length = strlen(str);
+  const char *found = std::search(_pos, _end, str, str + length);
+  return found;
+}
+
+bool TextScanner::getBinary(void *data, std::size_t size)
+{
+  if((std::size_t)(_end - _pos) < size) return false;
+  memcpy(data, _pos, size);
+  _pos += size;
+  return true;
+}
+
+static inline bool isSeparator(const char *pos, const char *end)
+{
+  return (pos >= end || *pos == ' ' || *pos == '\n' || *pos == '\r' ||
+          *pos == '\t' || *pos == '\f' || *pos == '\v');
+}
+
+bool TextScanner::parseInt(const char *&pos, const char *end, int &value)
+{
+  const char *p = pos;
+  bool negative = false;
+  if(p < end && (*p == '-' || *p == '+')){
+    negative = (*p == '-');
+    p++;
+  }
+  if(p >= end || *p < '0' || *p > '9') return false;
+  long long v = 0;
+  while(p < end && *p >= '0' && *p <= '9'){
+    v = v * 10 + (*p - '0');
+    if(v > 2147483648LL) return false;
+    p++;
+  }
+  if(negative) v = -v;
+  if(v > 2147483647LL || !isSeparator(p, end)) return false;
+  value = (int)v;
+  pos = p;
+  return true;
+}
+
+// powers of ten that are exactly representable as doubles
+static const double exactPowersOfTen[23] = {
+  1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12, 1e13,
+  1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+bool TextScanner::parseDouble(const char *&pos, const char *end, double &value)
+{
+  const char *p = pos;
+  bool negative = false, exact = true, anyDigit = false;
+  unsigned long long mantissa = 0;
+  int numDigits = 0, exponent = 0;
+
+  if(p < end && (*p == '-' || *p == '+')){
+    negative = (*p == '-');
+    p++;
+  }
+  while(p < end && *p >= '0' && *p <= '9'){
+    if(numDigits < 19){
+      mantissa = mantissa * 10 + (*p - '0');
+      if(mantissa) numDigits++;
+    }
+    else{
+      exact = false;
+      exponent++;
+    }
+    anyDigit = true;
+    p++;
+  }
+  if(p < end && *p == '.'){
+    p++;
+    while(p < end && *p >= '0' && *p <= '9'){
+      if(numDigits < 19){
+        mantissa = mantissa * 10 + (*p - '0');
+        if(mantissa) numDigits++;
+        exponent--;
+      }
+      else
+        exact = false;
+      anyDigit = true;
+      p++;
+    }
+  }
+  if(anyDigit && p < end && (*p == 'e' || *p == 'E')){
+    const char *q = p + 1;
+    bool negativeExponent = false;
+    if(q < end && (*q == '-' || *q == '+')){
+      negativeExponent = (*q == '-');
+      q++;
+    }
+    if(q < end && *q >= '0' && *q <= '9'){
+      int e = 0;
+      while(q < end && *q >= '0' && *q <= '9'){
+        if(e < 100000) e = e * 10 + (*q - '0');
+        q++;
+      }
+      exponent += negativeExponent ? -e : e;
+      p = q;
+    }
+    else
+      exact = false;
+  }
+
+  if(anyDigit && exact && isSeparator(p, end) &&
+     mantissa < (1ULL << 53) && exponent >= -22 && exponent <= 22){
+    // both operands are exact, so the result is correctly rounded
+    double v = (double)mantissa;
+    if(exponent < 0)
+      v /= exactPowersOfTen[-exponent];
+    else
+      v *= exactPowersOfTen[exponent];
+    value = negative ? -v : v;
+    pos = p;
+    return true;
+  }
+
+  // slow path for long mantissas, large exponents, inf, nan, ...
+  const char *tokenEnd = pos;
+  while(!isSeparator(tokenEnd, end)) tokenEnd++;
+  char token[128];
+  std::size_t length = tokenEnd - pos;
+  if(length == 0 || length >= sizeof(token)) return false;
+  memcpy(token, pos, length);
+  token[length] = '\0';
+  char *parsedEnd;
+  double v = strtod(token, &parsedEnd);
+  if(parsedEnd != token + length) return false;
+  value = v;
+  pos = tokenEnd;
+  return true;
+}
@@ -0,0 +1,126 @@
+#include <Mesh/meshCache.h>
+
+#include <sstream>
+#include <cstring>
+
+#include <boost/archive/binary_oarchive.hpp>
+
+#include <Mesh/GMSH/GModel.h>
+
+
+uint64_t meshCache::computeKey(plf::colony<node> *nodeList, plf::colony<edgeLineShape> *lineList, plf::colony<arcShape> *arcList,
+								plf::colony<blockLabel> *blockLabelList, meshSettings *settings)
+{
+	std::ostringstream stream(std::ios::out | std::ios::binary);
+
+	{
+		// The header of the archive contains the version of boost which does not change the mesh
+		boost::archive::binary_oarchive archive(stream, boost::archive::no_header);
+
+		uint32_t version = p_keyVersion;
+		std::size_t numberNodes = nodeList->size();
+		std::size_t numberLines = lineList->size();
+		std::size_t numberArcs = arcList->size();
+		std::size_t numberLabels = blockLabelList->size();
+
+		archive << version;
+
+		archive << numberNodes;
+		for(auto nodeIterator = nodeList->begin(); nodeIterator != nodeList->end(); nodeIterator++)
+		{
+			const node &savedNode = *nodeIterator;
+			archive << savedNode;
+		}
+
+		archive << numberLines;
+		for(auto lineIterator = lineList->begin(); lineIterator != lineList->end(); lineIterator++)
+		{
+			const edgeLineShape &savedLine = *lineIterator;
+			archive << savedLine;
+		}
+
+		archive << numberArcs;
+		for(auto arcIterator = arcList->begin(); arcIterator != arcList->end(); arcIterator++)
+		{
+			const arcShape &savedArc = *arcIterator;
+			archive << savedArc;
+		}
+
+		archive << numberLabels;
+		for(auto blockIterator = blockLabelList->begin(); blockIterator != blockLabelList->end(); blockIterator++)
+		{
+			const blockLabel &savedLabel = *blockIterator;
+			archive << savedLabel;
+		}
+
+		const bool structuredState = settings->getStructuredState();
+		const int arrangement = (int)settings->getMeshArrangment();
+		const int algorithm = (int)settings->getMeshAlgorithm();
+		const bool blossomState = settings->getBlossomRecombinationState();
+		const bool autoRemeshState = settings->getAutoRemeshingState();
+		const int remeshParameter = (int)settings->getRemeshParameter();
+		const unsigned int smoothingSteps = settings->getSmoothingSteps();
+		const double sizeFactor = settings->getElementSizeFactor();
+		const double minSize = settings->getMinElementSize();
+		const double maxSize = settings->getMaxElementSize();
+		const unsigned int order = settings->getElementOrder();
+		const unsigned int multiplePasses = settings->getMultiplePasses();
+		const unsigned int lloydSteps = settings->getLlyodSmoothingSteps();
+		const double cornerFactor = settings->getCornerRefinementFactor();
+
+		archive << structuredState << arrangement << algorithm << blossomState << autoRemeshState << remeshParameter;
+		archive << smoothingSteps << sizeFactor << minSize << maxSize << order << multiplePasses << lloydSteps << cornerFactor;
+	}
+
+	const std::string data = stream.str();
+	uint64_t key = 0xcbf29ce484222325ULL;
+
+	for(std::size_t i = 0; i < data.size(); i++)
+	{
+		key ^= (unsigned char)data[i];
+		key *= 0x100000001b3ULL;
+	}
+
+	return key;
+}
+
+
+
+bool meshCache::load(GModel *mesh, uint64_t key, meshRegionTable &regions)
+{
+	projectFile file;
+	std::string data;
+	std::string errorMessage;
+
+	if(!file.open(p_filePath, errorMessage))
+		return false;
+
+	if(!file.readChunk(projectChunk::MESH_KEY, data, errorMessage) || data.size() != sizeof(uint64_t))
+		return false;
+
+	uint64_t cachedKey;
+	memcpy(&cachedKey, data.data(), sizeof(uint64_t));
+
+	if(cachedKey != key)
+		return false;
+
+	if(!file.readArchiveChunk(projectChunk::MESH_REGIONS, [&](boost::archive::binary_iarchive &ar){ ar >> regions; }, errorMessage))
+		return false;
+
+	return file.readMesh(mesh, errorMessage);
+}
+
+
+
+bool meshCache::store(GModel *mesh, uint64_t key, const meshRegionTable &regions, std::string &errorMessage)
+{
+	projectFile file;
+
+	file.addChunk(projectChunk::MESH_KEY, std::string(reinterpret_cast<const char*>(&key), sizeof(uint64_t)));
+	file.addArchiveChunk(projectChunk::MESH_REGIONS, [&](boost::archive::binary_oarchive &ar){ ar << regions; });
+
+	if(!file.addMesh(mesh, p_filePath, errorMessage))
+		return false;
+
+	return file.write(p_filePath, errorMessage);
+}
@@ -0,0 +1,80 @@
+#include <Mesh/meshExporter.h>
+
+#include <wx/app.h>
+
+#include <common/OmniFEMMessage.h>
+
+
+int meshExporter::p_activeExports = 0;
+
+std::mutex meshExporter::p_exportMutex;
+
+std::condition_variable meshExporter::p_exportFinished;
+
+
+void meshExporter::runExport(std::shared_ptr<const meshSnapshot> snapshot, exportFile file)
+{
+	meshFileWriter writer(snapshot);
+	std::string message;
+
+	writer.setSaveAllState(file.saveAll);
+	writer.setCompressionState(file.compress);
+
+	const bool isError = !writer.write(file.format, file.filePath, message);
+
+	if(!isError)
+		message = "Saved " + file.filePath;
+
+	// The message windows can only be accessed from the main thread
+	if(wxTheApp)
+	{
+		wxTheApp->CallAfter([message, isError]()
+		{
+			if(isError)
+				OmniFEMMsg::instance()->MsgError(message);
+			else
+				OmniFEMMsg::instance()->MsgStatus(message);
+		});
+	}
+
+	std::lock_guard<std::mutex> exportLock(p_exportMutex);
+	p_activeExports--;
+	p_exportFinished.notify_all();
+}
+
+
+
+void meshExporter::start()
+{
+	for(auto exportIterator = p_exports.begin(); exportIterator != p_exports.end(); exportIterator++)
+	{
+		{
+			std::lock_guard<std::mutex> exportLock(p_exportMutex);
+			p_activeExports++;
+		}
+
+		exportIterator->compress = p_compress;
+
+		std::thread(runExport, p_snapshot, *exportIterator).detach();
+	}
+
+	p_exports.clear();
+}
+
+
+
+bool meshExporter::isExporting()
+{
+	std::lock_guard<std::mutex> exportLock(p_exportMutex);
+
+	return p_activeExports > 0;
+}
+
+
+
+void meshExporter::waitForExports()
+{
+	std::unique_lock<std::mutex> exportLock(p_exportMutex);
+
+	p_exportFinished.wait(exportLock, []() { return p_activeExports == 0; });
+}
@@ -0,0 +1,731 @@
+#include <Mesh/meshFileWriter.h>
+
+#include <cstring>
+#include <vector>
+
+#include <Mesh/vtuWriter.h>
+#include <Mesh/GMSH/GmshDefines.h>
+#include <Mesh/GMSH/Numeric.h>
+#include <Mesh/GMSH/StringUtils.h>
+
+
+void meshFileWriter::writeCoordinates(unsigned int node)
+{
+	p_output->putDouble(p_snapshot->getNodeX()[node] * p_scalingFactor);
+	p_output->putChar(' ');
+	p_output->putDouble(p_snapshot->getNodeY()[node] * p_scalingFactor);
+	p_output->putChar(' ');
+	p_output->putDouble(p_snapshot->getNodeZ()[node] * p_scalingFactor);
+}
+
+
+
+void meshFileWriter::writeVTK(bool saveAll)
+{
+	const meshSnapshot &snapshot = *p_snapshot;
+	const std::vector<meshSnapshot::snapshotEntity> &entities = snapshot.getEntities();
+	std::vector<int> cell;
+	int numberElements = 0;
+	int totalNumberIntegers = 0;
+
+	p_output->putString("# vtk DataFile Version 2.0\n");
+	p_output->putFormat("%s, Created by Gmsh\n", snapshot.getName().c_str());
+	p_output->putString(p_binary ? "BINARY\n" : "ASCII\n");
+	p_output->putString("DATASET UNSTRUCTURED_GRID\n");
+
+	p_output->putFormat("POINTS %d double\n", snapshot.getNumberSavedNodes(saveAll));
+
+	for(unsigned int i = 0; i < snapshot.getNumberNodes(); i++)
+	{
+		if(snapshot.getNodeIndex(i, saveAll) <= 0)
+			continue;
+
+		if(p_binary)
+		{
+			double coordinates[3] = {snapshot.getNodeX()[i] * p_scalingFactor, snapshot.getNodeY()[i] * p_scalingFactor, snapshot.getNodeZ()[i] * p_scalingFactor};
+
+			// VTK always expects big endian binary data
+			if(!p_bigEndian)
+				SwapBytes((char*)coordinates, sizeof(double), 3);
+
+			p_output->putBinary(coordinates, 3 * sizeof(double));
+		}
+		else
+		{
+			writeCoordinates(i);
+			p_output->putChar('\n');
+		}
+	}
+
+	p_output->putString("\n");
+
+	for(auto entityIterator = entities.begin(); entityIterator != entities.end(); entityIterator++)
+	{
+		if(!isEntitySaved(*entityIterator, saveAll))
+			continue;
+
+		for(unsigned int i = entityIterator->firstElement; i < entityIterator->firstElement + entityIterator->numberElements; i++)
+		{
+			if(snapshot.getElementType(i).vtkType)
+			{
+				numberElements++;
+				totalNumberIntegers += snapshot.getElementType(i).numberNodes + 1;
+			}
+		}
+	}
+
+	p_output->putFormat("CELLS %d %d\n", numberElements, totalNumberIntegers);
+
+	for(auto entityIterator = entities.begin(); entityIterator != entities.end(); entityIterator++)
+	{
+		if(!isEntitySaved(*entityIterator, saveAll))
+			continue;
+
+		for(unsigned int i = entityIterator->firstElement; i < entityIterator->firstElement + entityIterator->numberElements; i++)
+		{
+			const meshSnapshot::snapshotElementType &type = snapshot.getElementType(i);
+			const unsigned int *nodes = snapshot.getElementNodes(i);
+
+			if(!type.vtkType)
+				continue;
+
+			if(p_binary)
+			{
+				cell.resize(type.numberNodes + 1);
+				cell[0] = type.numberNodes;
+
+				for(int j = 0; j < type.numberNodes; j++)
+					cell[j + 1] = snapshot.getNodeIndex(nodes[type.vtkOrder[j]], saveAll) - 1;
+
+				if(!p_bigEndian)
+					SwapBytes((char*)cell.data(), sizeof(int), cell.size());
+
+				p_output->putBinary(cell.data(), cell.size() * sizeof(int));
+			}
+			else
+			{
+				p_output->putInt(type.numberNodes);
+
+				for(int j = 0; j < type.numberNodes; j++)
+				{
+					p_output->putChar(' ');
+					p_output->putInt(snapshot.getNodeIndex(nodes[type.vtkOrder[j]], saveAll) - 1);
+				}
+
+				p_output->putChar('\n');
+			}
+		}
+	}
+
+	p_output->putString("\n");
+
+	p_output->putFormat("CELL_TYPES %d\n", numberElements);
+
+	for(auto entityIterator = entities.begin(); entityIterator != entities.end(); entityIterator++)
+	{
+		if(!isEntitySaved(*entityIterator, saveAll))
+			continue;
+
+		for(unsigned int i = entityIterator->firstElement; i < entityIterator->firstElement + entityIterator->numberElements; i++)
+		{
+			int vtkType = snapshot.getElementType(i).vtkType;
+
+			if(!vtkType)
+				continue;
+
+			if(p_binary)
+			{
+				if(!p_bigEndian)
+					SwapBytes((char*)&vtkType, sizeof(int), 1);
+
+				p_output->putBinary(&vtkType, sizeof(int));
+			}
+			else
+			{
+				p_output->putInt(vtkType);
+				p_output->putChar('\n');
+			}
+		}
+	}
+}
+
+
+
+void meshFileWriter::writeSTL(bool saveAll)
+{
+	const meshSnapshot &snapshot = *p_snapshot;
+	const std::vector<meshSnapshot::snapshotEntity> &entities = snapshot.getEntities();
+	const double *x = snapshot.getNodeX();
+	const double *y = snapshot.getNodeY();
+	const double *z = snapshot.getNodeZ();
+	const int quadrangleSplit[3] = {0, 2, 3};
+
+	if(p_binary)
+	{
+		char header[80];
+		unsigned int numberFacets = 0;
+
+		strncpy(header, "Created by Gmsh", 80);
+		p_output->putBinary(header, 80);
+
+		for(auto entityIterator = entities.begin(); entityIterator != entities.end(); entityIterator++)
+		{
+			if(entityIterator->dimension != 2 || !isEntitySaved(*entityIterator, saveAll))
+				continue;
+
+			for(unsigned int i = entityIterator->firstElement; i < entityIterator->firstElement + entityIterator->numberElements; i++)
+			{
+				const meshSnapshot::snapshotElementType &type = snapshot.getElementType(i);
+
+				if(type.elementClass == TYPE_TRI || type.elementClass == TYPE_QUA)
+					numberFacets += (type.numberNodes == 4) ? 2 : 1;
+			}
+		}
+
+		p_output->putBinary(&numberFacets, sizeof(unsigned int));
+	}
+	else
+		p_output->putString("solid Created by Gmsh\n");
+
+	for(auto entityIterator = entities.begin(); entityIterator != entities.end(); entityIterator++)
+	{
+		if(entityIterator->dimension != 2 || !isEntitySaved(*entityIterator, saveAll))
+			continue;
+
+		for(unsigned int i = entityIterator->firstElement; i < entityIterator->firstElement + entityIterator->numberElements; i++)
+		{
+			const meshSnapshot::snapshotElementType &type = snapshot.getElementType(i);
+			const unsigned int *nodes = snapshot.getElementNodes(i);
+			const int numberFacets = (type.numberNodes == 4) ? 2 : 1;
+			double normal[3];
+
+			if(type.elementClass != TYPE_TRI && type.elementClass != TYPE_QUA)
+				continue;
+
+			normal3points(x[nodes[0]], y[nodes[0]], z[nodes[0]], x[nodes[1]], y[nodes[1]], z[nodes[1]],
+							x[nodes[2]], y[nodes[2]], z[nodes[2]], normal);
+
+			// Linear quadrangles are written as two triangles with the normal of the first one
+			for(int facet = 0; facet < numberFacets; facet++)
+			{
+				if(p_binary)
+				{
+					char data[50];
+					float *coordinates = (float*)data;
+
+					coordinates[0] = (float)normal[0];
+					coordinates[1] = (float)normal[1];
+					coordinates[2] = (float)normal[2];
+
+					for(int j = 0; j < 3; j++)
+					{
+						unsigned int node = nodes[(facet == 0) ? j : quadrangleSplit[j]];
+						coordinates[3 + 3 * j] = (float)(x[node] * p_scalingFactor);
+						coordinates[3 + 3 * j + 1] = (float)(y[node] * p_scalingFactor);
+						coordinates[3 + 3 * j + 2] = (float)(z[node] * p_scalingFactor);
+					}
+
+					data[48] = data[49] = 0;
+					p_output->putBinary(data, 50);
+				}
+				else
+				{
+					p_output->putFormat("facet normal %g %g %g\n", normal[0], normal[1], normal[2]);
+					p_output->putString("  outer loop\n");
+
+					for(int j = 0; j < 3; j++)
+					{
+						unsigned int node = nodes[(facet == 0) ? j : quadrangleSplit[j]];
+						p_output->putFormat("    vertex %g %g %g\n", x[node] * p_scalingFactor, y[node] * p_scalingFactor, z[node] * p_scalingFactor);
+					}
+
+					p_output->putString("  endloop\n");
+					p_output->putString("endfacet\n");
+				}
+			}
+		}
+	}
+
+	if(!p_binary)
+		p_output->putString("endsolid Created by Gmsh\n");
+}
+
+
+
+void meshFileWriter::writePLY2()
+{
+	const meshSnapshot &snapshot = *p_snapshot;
+	const std::vector<meshSnapshot::snapshotEntity> &entities = snapshot.getEntities();
+	int numberTriangles = 0;
+
+	for(auto entityIterator = entities.begin(); entityIterator != entities.end(); entityIterator++)
+	{
+		if(entityIterator->dimension != 2)
+			continue;
+
+		for(unsigned int i = entityIterator->firstElement; i < entityIterator->firstElement + entityIterator->numberElements; i++)
+		{
+			if(snapshot.getElementType(i).elementClass == TYPE_TRI)
+				numberTriangles++;
+		}
+	}
+
+	p_output->putInt(snapshot.getNumberNodes());
+	p_output->putChar('\n');
+	p_output->putInt(numberTriangles);
+	p_output->putChar('\n');
+
+	for(unsigned int i = 0; i < snapshot.getNumberNodes(); i++)
+	{
+		writeCoordinates(i);
+		p_output->putChar('\n');
+	}
+
+	for(auto entityIterator = entities.begin(); entityIterator != entities.end(); entityIterator++)
+	{
+		if(entityIterator->dimension != 2)
+			continue;
+
+		for(unsigned int i = entityIterator->firstElement; i < entityIterator->firstElement + entityIterator->numberElements; i++)
+		{
+			const meshSnapshot::snapshotElementType &type = snapshot.getElementType(i);
+			const unsigned int *nodes = snapshot.getElementNodes(i);
+
+			if(type.elementClass != TYPE_TRI)
+				continue;
+
+			p_output->putString("3 ");
+
+			for(int j = 0; j < type.numberNodes; j++)
+			{
+				p_output->putChar(' ');
+				p_output->putInt(nodes[j]);
+			}
+
+			p_output->putChar('\n');
+		}
+	}
+}
+
+
+
+void meshFileWriter::writeVRML(bool saveAll)
+{
+	const meshSnapshot &snapshot = *p_snapshot;
+	const std::vector<meshSnapshot::snapshotEntity> &entities = snapshot.getEntities();
+
+	p_output->putString("#VRML V1.0 ascii\n");
+	p_output->putString("#created by Gmsh\n");
+	p_output->putString("Coordinate3 {\n");
+	p_output->putString("  point [\n");
+
+	for(unsigned int i = 0; i < snapshot.getNumberNodes(); i++)
+	{
+		if(snapshot.getNodeIndex(i, saveAll) <= 0)
+			continue;
+
+		writeCoordinates(i);
+		p_output->putString(",\n");
+	}
+
+	p_output->putString("  ]\n");
+	p_output->putString("}\n");
+
+	// The curves are written first followed by the surfaces
+	for(int dimension = 1; dimension <= 2; dimension++)
+	{
+		for(auto entityIterator = entities.begin(); entityIterator != entities.end(); entityIterator++)
+		{
+			if(entityIterator->dimension != dimension || !isEntitySaved(*entityIterator, saveAll))
+				continue;
+
+			p_output->putString((dimension == 1) ? "DEF Curve" : "DEF Surface");
+			p_output->putInt(entityIterator->tag);
+			p_output->putString((dimension == 1) ? " IndexedLineSet {\n" : " IndexedFaceSet {\n");
+			p_output->putString("  coordIndex [\n");
+
+			for(unsigned int i = entityIterator->firstElement; i < entityIterator->firstElement + entityIterator->numberElements; i++)
+			{
+				const meshSnapshot::snapshotElementType &type = snapshot.getElementType(i);
+				const unsigned int *nodes = snapshot.getElementNodes(i);
+
+				if(dimension == 2 && type.elementClass != TYPE_TRI && type.elementClass != TYPE_QUA)
+					continue;
+
+				for(int j = 0; j < type.numberNodes; j++)
+				{
+					p_output->putInt(snapshot.getNodeIndex(nodes[j], saveAll) - 1);
+					p_output->putChar(',');
+				}
+
+				p_output->putString("-1,\n");
+			}
+
+			p_output->putString("  ]\n");
+			p_output->putString("}\n");
+		}
+	}
+}
+
+
+
+void meshFileWriter::writeMESH(bool saveAll)
+{
+	const meshSnapshot &snapshot = *p_snapshot;
+	const std::vector<meshSnapshot::snapshotEntity> &entities = snapshot.getEntities();
+	const double *x = snapshot.getNodeX();
+	const double *y = snapshot.getNodeY();
+	const double *z = snapshot.getNodeZ();
+	const int elementClasses[3] = {TYPE_LIN, TYPE_TRI, TYPE_QUA};
+	const int elementDimensions[3] = {1, 2, 2};
+	int numberElements[3] = {0, 0, 0};
+
+	p_output->putString(" MeshVersionFormatted 2\n");
+	p_output->putString(" Dimension\n");
+	p_output->putString(" 3\n");
+
+	p_output->putString(" Vertices\n");
+	p_output->putFormat(" %d\n", snapshot.getNumberSavedNodes(saveAll));
+
+	for(auto entityIterator = entities.begin(); entityIterator != entities.end(); entityIterator++)
+	{
+		for(unsigned int i = entityIterator->firstNode; i < entityIterator->firstNode + entityIterator->numberNodes; i++)
+		{
+			if(snapshot.getNodeIndex(i, saveAll) > 0)
+				p_output->putFormat(" %20.14G      %20.14G      %20.14G      %d\n", x[i] * p_scalingFactor, y[i] * p_scalingFactor,
+									z[i] * p_scalingFactor, entityIterator->tag);
+		}
+	}
+
+	for(auto entityIterator = entities.begin(); entityIterator != entities.end(); entityIterator++)
+	{
+		if(!isEntitySaved(*entityIterator, saveAll))
+			continue;
+
+		for(unsigned int i = entityIterator->firstElement; i < entityIterator->firstElement + entityIterator->numberElements; i++)
+		{
+			for(int j = 0; j < 3; j++)
+			{
+				if(entityIterator->dimension == elementDimensions[j] && snapshot.getElementType(i).elementClass == elementClasses[j])
+					numberElements[j]++;
+			}
+		}
+	}
+
+	for(int j = 0; j < 3; j++)
+	{
+		if(numberElements[j] == 0)
+			continue;
+
+		if(elementClasses[j] == TYPE_LIN)
+			p_output->putString((snapshot.getMeshOrder() == 2) ? " EdgesP2\n" : " Edges\n");
+		else if(elementClasses[j] == TYPE_TRI)
+			p_output->putString((snapshot.getMeshOrder() == 2) ? " TrianglesP2\n" : " Triangles\n");
+		else
+			p_output->putString(" Quadrilaterals\n");
+
+		p_output->putFormat(" %d\n", numberElements[j]);
+
+		for(auto entityIterator = entities.begin(); entityIterator != entities.end(); entityIterator++)
+		{
+			if(entityIterator->dimension != elementDimensions[j] || !isEntitySaved(*entityIterator, saveAll))
+				continue;
+
+			// The elements of entities with a negative physical group are not reversed
+			const int physical = entityIterator->physicals.size() ? std::abs(entityIterator->physicals[0]) : 0;
+
+			for(unsigned int i = entityIterator->firstElement; i < entityIterator->firstElement + entityIterator->numberElements; i++)
+			{
+				const meshSnapshot::snapshotElementType &type = snapshot.getElementType(i);
+				const unsigned int *nodes = snapshot.getElementNodes(i);
+
+				if(type.elementClass != elementClasses[j])
+					continue;
+
+				for(int k = 0; k < type.numberNodes; k++)
+				{
+					p_output->putChar(' ');
+					p_output->putInt(snapshot.getNodeIndex(nodes[k], saveAll));
+				}
+
+				p_output->putChar(' ');
+
+				if(p_elementTagType == 3)
+					p_output->putInt(snapshot.getElementPartition(i));
+				else if(p_elementTagType == 2)
+					p_output->putInt(physical);
+				else
+					p_output->putInt(entityIterator->tag);
+
+				p_output->putChar('\n');
+			}
+		}
+	}
+
+	p_output->putString(" End\n");
+}
+
+
+
+void meshFileWriter::writeMAIL(bool saveAll)
+{
+	const meshSnapshot &snapshot = *p_snapshot;
+	const std::vector<meshSnapshot::snapshotEntity> &entities = snapshot.getEntities();
+	const double *x = snapshot.getNodeX();
+	const double *y = snapshot.getNodeY();
+	const double *z = snapshot.getNodeZ();
+	int numberTriangles = 0;
+
+	for(auto entityIterator = entities.begin(); entityIterator != entities.end(); entityIterator++)
+	{
+		if(entityIterator->dimension != 2 || !isEntitySaved(*entityIterator, saveAll))
+			continue;
+
+		for(unsigned int i = entityIterator->firstElement; i < entityIterator->firstElement + entityIterator->numberElements; i++)
+		{
+			if(snapshot.getElementType(i).elementClass == TYPE_TRI)
+				numberTriangles++;
+		}
+	}
+
+	p_output->putFormat(" %d %d\n", snapshot.getNumberSavedNodes(saveAll), numberTriangles);
+
+	for(unsigned int i = 0; i < snapshot.getNumberNodes(); i++)
+	{
+		if(snapshot.getNodeIndex(i, saveAll) > 0)
+			p_output->putFormat(" %19.10E %19.10E %19.10E\n", x[i] * p_scalingFactor, y[i] * p_scalingFactor, z[i] * p_scalingFactor);
+	}
+
+	for(auto entityIterator = entities.begin(); entityIterator != entities.end(); entityIterator++)
+	{
+		if(entityIterator->dimension != 2 || !isEntitySaved(*entityIterator, saveAll))
+			continue;
+
+		for(unsigned int i = entityIterator->firstElement; i < entityIterator->firstElement + entityIterator->numberElements; i++)
+		{
+			const unsigned int *nodes = snapshot.getElementNodes(i);
+
+			if(snapshot.getElementType(i).elementClass != TYPE_TRI)
+				continue;
+
+			for(int j = 0; j < 3; j++)
+			{
+				p_output->putChar(' ');
+				p_output->putInt(snapshot.getNodeIndex(nodes[j], saveAll));
+			}
+
+			p_output->putChar('\n');
+		}
+	}
+
+	// The edges of the triangulation are not saved
+	for(int i = 0; i < numberTriangles; i++)
+		p_output->putString(" 0 0 0\n");
+}
+
+
+
+bool meshFileWriter::writeSU2(bool saveAll)
+{
+	const meshSnapshot &snapshot = *p_snapshot;
+	const int dimension = snapshot.getDimension();
+	const std::vector<meshSnapshot::snapshotEntity> &entities = snapshot.getEntities();
+	int numberElements = 0;
+	int elementNumber = 0;
+
+	if(dimension != 2 && dimension != 3)
+		return false;
+
+	// Writes the type and the nodes of an element in the order of VTK
+	auto writeElement = [&](unsigned int element)
+	{
+		const meshSnapshot::snapshotElementType &type = snapshot.getElementType(element);
+		const unsigned int *nodes = snapshot.getElementNodes(element);
+
+		p_output->putInt(type.vtkType);
+		p_output->putChar(' ');
+
+		for(int j = 0; j < type.numberNodes; j++)
+		{
+			p_output->putInt(snapshot.getNodeIndex(nodes[type.vtkOrder[j]], saveAll) - 1);
+			p_output->putChar(' ');
+		}
+	};
+
+	p_output->putFormat("NDIME= %d\n", dimension);
+
+	// All of the interior elements are written in one section. There are no volumes in the model so a 3D model
+	// has no interior elements
+	for(auto entityIterator = entities.begin(); entityIterator != entities.end(); entityIterator++)
+	{
+		if(dimension == 2 && entityIterator->dimension == 2 && isEntitySaved(*entityIterator, saveAll))
+			numberElements += entityIterator->numberElements;
+	}
+
+	p_output->putFormat("NELEM= %d\n", numberElements);
+
+	for(auto entityIterator = entities.begin(); entityIterator != entities.end(); entityIterator++)
+	{
+		if(dimension != 2 || entityIterator->dimension != 2 || !isEntitySaved(*entityIterator, saveAll))
+			continue;
+
+		for(unsigned int i = entityIterator->firstElement; i < entityIterator->firstElement + entityIterator->numberElements; i++)
+		{
+			writeElement(i);
+			p_output->putInt(elementNumber++);
+			p_output->putChar('\n');
+		}
+	}
+
+	p_output->putFormat("NPOIN= %d\n", snapshot.getNumberSavedNodes(saveAll));
+
+	for(unsigned int i = 0; i < snapshot.getNumberNodes(); i++)
+	{
+		const int index = snapshot.getNodeIndex(i, saveAll);
+
+		if(index <= 0)
+			continue;
+
+		p_output->putDouble(snapshot.getNodeX()[i] * p_scalingFactor);
+		p_output->putChar(' ');
+		p_output->putDouble(snapshot.getNodeY()[i] * p_scalingFactor);
+		p_output->putChar(' ');
+
+		if(dimension == 3)
+		{
+			p_output->putDouble(snapshot.getNodeZ()[i] * p_scalingFactor);
+			p_output->putChar(' ');
+		}
+
+		p_output->putInt(index - 1);
+		p_output->putChar('\n');
+	}
+
+	// The markers are the physical groups of the boundary
+	std::map<int, std::vector<unsigned int>> groups = snapshot.getPhysicalGroups(dimension - 1);
+
+	if(groups.size() == 0)
+		return true;
+
+	p_output->putFormat("NMARK= %d\n", (int)groups.size());
+
+	for(auto groupIterator = groups.begin(); groupIterator != groups.end(); groupIterator++)
+	{
+		int numberMarkerElements = 0;
+
+		for(auto entityIterator = groupIterator->second.begin(); entityIterator != groupIterator->second.end(); entityIterator++)
+			numberMarkerElements += entities[*entityIterator].numberElements;
+
+		if(numberMarkerElements == 0)
+			continue;
+
+		p_output->putFormat("MARKER_TAG= %s\n", snapshot.getPhysicalName(dimension - 1, groupIterator->first).c_str());
+		p_output->putFormat("MARKER_ELEMS= %d\n", numberMarkerElements);
+
+		for(auto entityIterator = groupIterator->second.begin(); entityIterator != groupIterator->second.end(); entityIterator++)
+		{
+			const meshSnapshot::snapshotEntity &entity = entities[*entityIterator];
+
+			for(unsigned int i = entity.firstElement; i < entity.firstElement + entity.numberElements; i++)
+			{
+				writeElement(i);
+				p_output->putChar('\n');
+			}
+		}
+	}
+
+	return true;
+}
+
+
+
+bool meshFileWriter::write(meshExportFormat format, std::string filePath, std::string &errorMessage)
+{
+	const bool saveAll = p_saveAll || !p_snapshot->hasPhysicalGroups();
+
+	if(format == meshExportFormat::VTU)
+	{
+		vtuWriter writer(p_snapshot);
+
+		writer.setCompressionState(p_compress);
+
+		return writer.write(filePath, errorMessage);
+	}
+
+	if(format == meshExportFormat::SU2 && p_snapshot->getDimension() != 2 && p_snapshot->getDimension() != 3)
+	{
+		errorMessage = "SU2 mesh output valid only for 2D or 3D models (not " + std::to_string(p_snapshot->getDimension()) + "D)";
+		return false;
+	}
+
+	FILE *file = fopen(filePath.c_str(), p_binary ? "wb" : "w");
+
+	if(!file)
+	{
+		errorMessage = "Unable to open file " + filePath;
+		return false;
+	}
+
+	BufferedWriter output(file);
+
+	p_output = &output;
+
+	switch(format)
+	{
+		case meshExportFormat::VTK:
+			writeVTK(saveAll);
+			break;
+		case meshExportFormat::STL:
+			writeSTL(saveAll);
+			break;
+		case meshExportFormat::PLY2:
+			writePLY2();
+			break;
+		case meshExportFormat::VRML:
+			writeVRML(saveAll);
+			break;
+		case meshExportFormat::MESH:
+			writeMESH(saveAll);
+			break;
+		case meshExportFormat::MAIL:
+			writeMAIL(saveAll);
+			break;
+		case meshExportFormat::SU2:
+			writeSU2(saveAll);
+			break;
+		case meshExportFormat::VTU:
+			break;
+	}
+
+	output.flush();
+	p_output = nullptr;
+
+	const bool isWritten = output.good();
+
+	fclose(file);
+
+	if(!isWritten)
+		errorMessage = "Unable to write file " + filePath;
+
+	return isWritten;
+}
+
+
+
+bool meshFileWriter::writeModel(GModel *model, meshExportFormat format, std::string filePath, std::string &errorMessage, bool binary,
+								bool saveAll, double scalingFactor, bool bigEndian, int elementTagType)
+{
+	std::shared_ptr<meshSnapshot> snapshot(new meshSnapshot());
+
+	snapshot->create(model);
+
+	meshFileWriter writer(snapshot);
+
+	writer.setBinaryState(binary);
+	writer.setSaveAllState(saveAll);
+	writer.setScalingFactor(scalingFactor);
+	writer.setBigEndianState(bigEndian);
+	writer.setElementTagType(elementTagType);
+
+	return writer.write(format, filePath, errorMessage);
+}
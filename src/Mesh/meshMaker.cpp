@@ -258,6 +258,25 @@ void meshMaker::mesh()
 	CTX::instance()->mesh.nProc = 0;
 	CTX::instance()->mesh.nbProc = 0;
 	
+	// The key is computed before the meshing changes the state of the geometry
+	meshCache cache(p_folderPath.ToStdString(), p_simulationName.ToStdString());
+	uint64_t meshKey = meshCache::computeKey(p_nodeList, p_lineList, p_arcList, p_blockLabelList, p_settings);
+	
+	if(cache.load(p_meshModel, meshKey, p_regions))
+	{
+		OmniFEMMsg::instance()->MsgStatus("Geometry is unchanged. Loaded mesh from " + cache.getFilePath());
+		
+		p_regions.applyPhysicalGroups(p_meshModel);
+		
+		exportMesh();
+		
+		if(p_meshModel->getNumMeshVertices() > 0)
+			p_meshModel->indexMeshVertices(true);
+		
+		OmniFEMMsg::instance()->MsgStatus("Meshing Finished");
+		return;
+	}
+	
 	p_meshModel->setFactory("Gmsh");
 	
 	//! This section will compute the value for LC
@@ -594,77 +613,24 @@ void meshMaker::mesh()
 				pathIterator++;
 		}
 		
+		OmniFEMMsg::instance()->MsgStatus("Computing the mesh size from the geometry");
+		
+		p_sizing.compute(p_closedContourPaths, CTX::instance()->lc);
+		
 		createGMSHGeometry();
 		
-		OmniFEMMsg::instance()->MsgStatus("Meshing GMSH geometry");
+		createSizeFields();
 		
-		for(int i = 0; i < CTX::instance()->mesh.multiplePasses; i++)
-		{
-			OmniFEMMsg::instance()->MsgStatus("Performing pass " + std::to_string(i + 1) + " of " + std::to_string(CTX::instance()->mesh.multiplePasses));
-			p_meshModel->mesh(2);
-		}
+		OmniFEMMsg::instance()->MsgStatus("Meshing GMSH geometry");
 		
-		// Next set any output mesh options
-		// such as different files to output the mesh. Be it VTK or some other format
-		OmniFEMMsg::instance()->MsgStatus("Saving Mesh file");
+		meshPasses();
 		
-		wxDir validDir;
+		std::string errorMessage;
 		
-		if(p_settings->getDirString() != wxString("") && validDir.Open(p_settings->getDirString()))
-		{
-			validDir.Close();
-			
-			if(p_settings->getSaveVTKState())
-				p_meshModel->writeVTK(p_settings->getDirString().ToStdString() + "/" + p_simulationName.ToStdString() + ".vtk");
-			
-			if(p_settings->getSaveBDFState())
-				p_meshModel->writeBDF(p_settings->getDirString().ToStdString() + "/" + p_simulationName.ToStdString() + ".bdf"); // double check this one
-			
-			if(p_settings->getSaveCELUMState())
-				p_meshModel->writeCELUM(p_settings->getDirString().ToStdString() + "/" + p_simulationName.ToStdString() + ".celum", false, 1.0);
-				
-			if(p_settings->getSaveDIFFPACKSate())
-				p_meshModel->writeDIFF(p_settings->getDirString().ToStdString() + "/" + p_simulationName.ToStdString() + ".diff", false, false, 1.0);
-				
-			if(p_settings->getSaveGEOState())
-				p_meshModel->writeGEO(p_settings->getDirString().ToStdString() + "/" + p_simulationName.ToStdString() + ".geo", true, false);
-				
-			if(p_settings->getSaveINPState())
-				p_meshModel->writeINP(p_settings->getDirString().ToStdString() + "/" + p_simulationName.ToStdString() + ".inp", false, false, 1.0);
-			
-			if(p_settings->getSaveIR3State())
-				p_meshModel->writeIR3(p_settings->getDirString().ToStdString() + "/" + p_simulationName.ToStdString() + ".ir3", 0, true, 1.0);
-				
-			if(p_settings->getSaveMAILState())
-				p_meshModel->writeMAIL(p_settings->getDirString().ToStdString() + "/" + p_simulationName.ToStdString() + ".mail", true, 1.0);
-				
-			if(p_settings->getSaveMESHState())
-				p_meshModel->writeMESH(p_settings->getDirString().ToStdString() + "/" + p_simulationName.ToStdString() + ".mesh", 1, false, 1.0);
+		if(p_meshModel->getNumMeshVertices() > 0 && !cache.store(p_meshModel, meshKey, p_regions, errorMessage))
+			OmniFEMMsg::instance()->MsgWarning("Unable to cache the mesh: " + errorMessage);
 		
-			if(p_settings->getSaveP3DState())
-				p_meshModel->writeP3D(p_settings->getDirString().ToStdString() + "/" + p_simulationName.ToStdString() + ".p3d", false, 1.0);
-
-			if(p_settings->getSavePartitionedMeshState())
-				p_meshModel->writePartitionedMSH(p_settings->getDirString().ToStdString() + "/" + p_simulationName.ToStdString() + ".mesh", 2.2, false, false, false, 1.0);
-				
-			if(p_settings->getSavePLY2State())
-				p_meshModel->writePLY2(p_settings->getDirString().ToStdString() + "/" + p_simulationName.ToStdString() + ".ply2");
-				
-			if(p_settings->getSaveSTLState())
-				p_meshModel->writeSTL(p_settings->getDirString().ToStdString() + "/" + p_simulationName.ToStdString() + ".stl", false, false, 1.0);
-				
-			if(p_settings->getSaveTochnogState())
-				p_meshModel->writeTOCHNOG(p_settings->getDirString().ToStdString() + "/" + p_simulationName.ToStdString() + ".toc", false, false, 1.0);
-				
-			if(p_settings->getSaveSU2State())
-				p_meshModel->writeSU2(p_settings->getDirString().ToStdString() + "/" + p_simulationName.ToStdString() + ".su2", true, 1.0);
-				
-			if(p_settings->getSaveUNVState())
-				p_meshModel->writeUNV(p_settings->getDirString().ToStdString() + "/" + p_simulationName.ToStdString() + ".unv", false, false, 1.0);
-				
-			if(p_settings->getSaveVRMLState())
-				p_meshModel->writeVRML(p_settings->getDirString().ToStdString() + "/" + p_simulationName.ToStdString() + ".vrml", true, 1.0);
-		}
+		exportMesh();
 	}
 	else
 	{
@@ -699,6 +665,324 @@ void meshMaker::mesh()
 
 
 
+void meshMaker::meshPasses()
+{
+	const int numberPasses = CTX::instance()->mesh.multiplePasses;
+	const int subdivide = CTX::instance()->mesh.algoSubdivide;
+	const int order = CTX::instance()->mesh.order;
+	const int firstAlgorithm = (CTX::instance()->mesh.algo2d == ALGO_2D_AUTO) ? ALGO_2D_DELAUNAY : CTX::instance()->mesh.algo2d;
+	const int meshAlgorithms[] = {ALGO_2D_FRONTAL, ALGO_2D_DELAUNAY, ALGO_2D_MESHADAPT};
+	std::vector<int> remeshAlgorithms;
+	std::vector<int> remeshedFaceTags;
+	std::vector<GFace*> remeshFaces;
+	double lastWorstQuality = 0;
+	double lastMeanQuality = 0;
+	
+	// Meshing a face again with the same algorithm and the same edge meshes gives the same mesh. So, the faces
+	// that are meshed again use the meshing algorithms that were not used yet, one for each pass. The automatic
+	// algorithm meshes the plane faces with the Delaunay algorithm
+	for(unsigned int i = 0; i < sizeof(meshAlgorithms) / sizeof(meshAlgorithms[0]); i++)
+	{
+		if(meshAlgorithms[i] != firstAlgorithm)
+			remeshAlgorithms.push_back(meshAlgorithms[i]);
+	}
+	
+	// The subdivision is applied to the whole model. If the passes subdivided the mesh, the faces that keep their mesh
+	// would be subdivided again in every pass
+	CTX::instance()->mesh.algoSubdivide = 0;
+	CTX::instance()->mesh.order = 1;
+	
+	for(int i = 0; i < numberPasses; i++)
+	{
+		const auto startTime = std::chrono::steady_clock::now();
+		std::vector<faceMesh> previousMeshes(remeshFaces.size());
+		std::size_t previousFaceVertices = 0;
+		std::size_t newFaceVertices = 0;
+		
+		OmniFEMMsg::instance()->MsgStatus("Performing pass " + std::to_string(i + 1) + " of " + std::to_string(numberPasses));
+		
+		// After the first pass, only the faces without a mesh are meshed. The mesh of the other faces is kept.
+		// The previous mesh of the faces that are meshed again is set aside until the new mesh is measured
+		for(unsigned int j = 0; j < remeshFaces.size(); j++)
+		{
+			double sumQuality;
+			
+			previousMeshes[j].face = remeshFaces[j];
+			faceQuality(remeshFaces[j], previousMeshes[j].worstQuality, sumQuality);
+			previousFaceVertices += remeshFaces[j]->mesh_vertices.size();
+			previousMeshes[j].triangles.swap(remeshFaces[j]->triangles);
+			previousMeshes[j].quadrangles.swap(remeshFaces[j]->quadrangles);
+			previousMeshes[j].vertices.swap(remeshFaces[j]->mesh_vertices);
+			remeshFaces[j]->deleteVertexArrays();
+			remeshFaces[j]->setMeshingAlgo(remeshAlgorithms[i - 1]);
+			remeshedFaceTags.push_back(remeshFaces[j]->tag());
+		}
+		
+		if(!previousMeshes.empty())
+			p_meshModel->destroyMeshCaches();
+		
+		CTX::instance()->mesh.meshOnlyEmpty = (i > 0);
+		p_meshModel->mesh(2);
+		CTX::instance()->mesh.meshOnlyEmpty = 0;
+		
+		unsigned int numberRestored = 0;
+		
+		for(auto meshIterator = previousMeshes.begin(); meshIterator != previousMeshes.end(); meshIterator++)
+		{
+			GFace *face = meshIterator->face;
+			double worstQuality;
+			double sumQuality;
+			
+			faceQuality(face, worstQuality, sumQuality);
+			newFaceVertices += face->mesh_vertices.size();
+			
+			if(face->getNumMeshElements() > 0 && worstQuality >= meshIterator->worstQuality)
+			{
+				for(auto triangleIterator = meshIterator->triangles.begin(); triangleIterator != meshIterator->triangles.end(); triangleIterator++)
+					delete *triangleIterator;
+				
+				for(auto quadIterator = meshIterator->quadrangles.begin(); quadIterator != meshIterator->quadrangles.end(); quadIterator++)
+					delete *quadIterator;
+				
+				for(auto vertexIterator = meshIterator->vertices.begin(); vertexIterator != meshIterator->vertices.end(); vertexIterator++)
+					delete *vertexIterator;
+			}
+			else
+			{
+				// The new mesh is worse. The face keeps the mesh of the previous pass
+				face->deleteMesh();
+				face->triangles.swap(meshIterator->triangles);
+				face->quadrangles.swap(meshIterator->quadrangles);
+				face->mesh_vertices.swap(meshIterator->vertices);
+				numberRestored++;
+			}
+		}
+		
+		if(numberRestored > 0)
+		{
+			p_meshModel->destroyMeshCaches();
+			OmniFEMMsg::instance()->MsgStatus("Kept the previous mesh of " + std::to_string(numberRestored) + " faces whose new mesh is worse");
+		}
+		
+		const double passTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+		double worstQuality = 1;
+		double sumQuality = 0;
+		unsigned int numberElements = 0;
+		unsigned int numberFaces = 0;
+		
+		remeshFaces.clear();
+		
+		for(GModel::fiter faceIterator = p_meshModel->firstFace(); faceIterator != p_meshModel->lastFace(); faceIterator++)
+		{
+			double faceWorstQuality;
+			double faceSumQuality;
+			const unsigned int faceElements = faceQuality(*faceIterator, faceWorstQuality, faceSumQuality);
+			
+			if(faceElements == 0)
+				continue;
+			
+			worstQuality = std::min(worstQuality, faceWorstQuality);
+			sumQuality += faceSumQuality;
+			numberElements += faceElements;
+			numberFaces++;
+			
+			if(faceWorstQuality < p_targetQuality)
+				remeshFaces.push_back(*faceIterator);
+		}
+		
+		const double meanQuality = (numberElements > 0) ? sumQuality / numberElements : 0;
+		const std::size_t numberVertices = p_meshModel->getNumMeshVertices();
+		
+		OmniFEMMsg::instance()->MsgStatus("Pass " + std::to_string(i + 1) + ": " + std::to_string(numberElements) + " elements, " +
+											std::to_string(numberVertices) + " vertices, worst quality " + std::to_string(worstQuality) +
+											", mean quality " + std::to_string(meanQuality) + " (" + std::to_string(passTime) + " s)");
+		
+		if(i + 1 == numberPasses || numberElements == 0)
+			break;
+		
+		if(i > 0)
+		{
+			// Only the faces that were meshed again can change. The change is measured on the new meshes of these faces
+			const double vertexChange = std::fabs((double)newFaceVertices - (double)previousFaceVertices) / std::max<std::size_t>(previousFaceVertices, 1);
+			
+			if(vertexChange < p_minimumVertexChange)
+			{
+				OmniFEMMsg::instance()->MsgStatus("Stopping after pass " + std::to_string(i + 1) + ": the number of vertices did not change");
+				break;
+			}
+			
+			if(worstQuality - lastWorstQuality < p_minimumImprovement && meanQuality - lastMeanQuality < p_minimumImprovement)
+			{
+				OmniFEMMsg::instance()->MsgStatus("Stopping after pass " + std::to_string(i + 1) + ": the quality did not improve");
+				break;
+			}
+		}
+		
+		if(remeshFaces.empty())
+		{
+			OmniFEMMsg::instance()->MsgStatus("Stopping after pass " + std::to_string(i + 1) + ": all faces reach the target quality");
+			break;
+		}
+		
+		if((unsigned int)i >= remeshAlgorithms.size())
+		{
+			OmniFEMMsg::instance()->MsgStatus("Stopping after pass " + std::to_string(i + 1) + ": all of the meshing algorithms were used");
+			break;
+		}
+		
+		OmniFEMMsg::instance()->MsgStatus("Meshing " + std::to_string(remeshFaces.size()) + " of " + std::to_string(numberFaces) +
+											" faces again that are below the target quality");
+		
+		lastWorstQuality = worstQuality;
+		lastMeanQuality = meanQuality;
+	}
+	
+	CTX::instance()->mesh.algoSubdivide = subdivide;
+	CTX::instance()->mesh.order = order;
+	
+	for(auto tagIterator = remeshedFaceTags.begin(); tagIterator != remeshedFaceTags.end(); tagIterator++)
+		CTX::instance()->mesh.algo2d_per_face.erase(*tagIterator);
+	
+	// Every face now has a mesh and is not meshed again. Only the subdivision and the high order elements are applied
+	if(subdivide == 1 || order > 1)
+	{
+		CTX::instance()->mesh.meshOnlyEmpty = 1;
+		p_meshModel->mesh(2);
+		CTX::instance()->mesh.meshOnlyEmpty = 0;
+	}
+}
+
+
+
+unsigned int meshMaker::faceQuality(GFace *face, double &worstQuality, double &sumQuality)
+{
+	qmElementArrays elements;
+	std::vector<double> quality;
+	
+	worstQuality = 1;
+	sumQuality = 0;
+	
+	elements.gather(face->triangles);
+	quality.resize(face->triangles.size());
+	qmTriangle::gamma(quality.size(), elements.nodes.data(), elements.x.data(), elements.y.data(), elements.z.data(), quality.data());
+	
+	for(auto qualityIterator = quality.begin(); qualityIterator != quality.end(); qualityIterator++)
+	{
+		worstQuality = std::min(worstQuality, *qualityIterator);
+		sumQuality += *qualityIterator;
+	}
+	
+	elements.gather(face->quadrangles);
+	quality.resize(face->quadrangles.size());
+	qmQuadrangle::eta(quality.size(), elements.nodes.data(), elements.x.data(), elements.y.data(), elements.z.data(), quality.data());
+	
+	for(auto qualityIterator = quality.begin(); qualityIterator != quality.end(); qualityIterator++)
+	{
+		worstQuality = std::min(worstQuality, *qualityIterator);
+		sumQuality += *qualityIterator;
+	}
+	
+	return face->triangles.size() + face->quadrangles.size();
+}
+
+
+
+void meshMaker::exportMesh()
+{
+	// Next set any output mesh options
+	// such as different files to output the mesh. Be it VTK or some other format
+	OmniFEMMsg::instance()->MsgStatus("Saving Mesh file");
+	
+	wxDir validDir;
+	
+	if(p_settings->getDirString() != wxString("") && validDir.Open(p_settings->getDirString()))
+	{
+		validDir.Close();
+		
+		std::string filePath = p_settings->getDirString().ToStdString() + "/" + p_simulationName.ToStdString();
+		
+		// The formats that only need the nodes and the elements are written by background threads from a snapshot
+		// of the mesh. This way, the mesh is ready for the UI as soon as the threads are started
+		std::shared_ptr<meshSnapshot> snapshot(new meshSnapshot());
+		snapshot->create(p_meshModel);
+		
+		meshExporter exporter(snapshot);
+		
+		exporter.setCompressionState(p_settings->getCompressVTUState());
+		
+		if(p_settings->getSaveVTKState())
+			exporter.addExport(meshExportFormat::VTK, filePath + ".vtk");
+			
+		if(p_settings->getSaveMAILState())
+			exporter.addExport(meshExportFormat::MAIL, filePath + ".mail", true);
+			
+		if(p_settings->getSaveMESHState())
+			exporter.addExport(meshExportFormat::MESH, filePath + ".mesh");
+			
+		if(p_settings->getSavePLY2State())
+			exporter.addExport(meshExportFormat::PLY2, filePath + ".ply2");
+			
+		if(p_settings->getSaveSTLState())
+			exporter.addExport(meshExportFormat::STL, filePath + ".stl");
+			
+		if(p_settings->getSaveSU2State())
+			exporter.addExport(meshExportFormat::SU2, filePath + ".su2", true);
+			
+		if(p_settings->getSaveVRMLState())
+			exporter.addExport(meshExportFormat::VRML, filePath + ".vrml", true);
+			
+		if(p_settings->getSaveVTUState())
+			exporter.addExport(meshExportFormat::VTU, filePath + ".vtu");
+			
+		exporter.start();
+		
+		// The remaining formats need the geometry or data of the GMSH elements that is not in the snapshot. These are
+		// written from the model while the background threads are running
+		if(p_settings->getSaveBDFState())
+			p_meshModel->writeBDF(filePath + ".bdf"); // double check this one
+		
+		if(p_settings->getSaveCELUMState())
+			p_meshModel->writeCELUM(filePath + ".celum", false, 1.0);
+			
+		if(p_settings->getSaveDIFFPACKSate())
+			p_meshModel->writeDIFF(filePath + ".diff", false, false, 1.0);
+			
+		if(p_settings->getSaveGEOState())
+			p_meshModel->writeGEO(filePath + ".geo", true, false);
+			
+		if(p_settings->getSaveINPState())
+			p_meshModel->writeINP(filePath + ".inp", false, false, 1.0);
+		
+		if(p_settings->getSaveIR3State())
+			p_meshModel->writeIR3(filePath + ".ir3", 0, true, 1.0);
+	
+		if(p_settings->getSaveP3DState())
+			p_meshModel->writeP3D(filePath + ".p3d", false, 1.0);
+
+		if(p_settings->getSavePartitionedMeshState())
+		{
+			// The partitions are only kept while the files are written so that the other formats and the
+			// solver see the whole mesh. The partition files are MSH files; the .mesh name belongs to the
+			// MESH format that may be written by the exporter at the same time
+			if(p_meshModel->partitionMesh(p_settings->getNumberPartitions()))
+				p_meshModel->writePartitionedMSH(filePath + ".msh", 2.2, false, false, false, 1.0);
+			else
+				OmniFEMMsg::instance()->MsgError("Unable to partition the mesh");
+			
+			p_meshModel->deleteMeshPartitions();
+			p_meshModel->getGhostCells().clear();
+		}
+			
+		if(p_settings->getSaveTochnogState())
+			p_meshModel->writeTOCHNOG(filePath + ".toc", false, false, 1.0);
+			
+		if(p_settings->getSaveUNVState())
+			p_meshModel->writeUNV(filePath + ".unv", false, false, 1.0);
+	}
+}
+
+
+
 void meshMaker::createGMSHGeometry(std::vector<closedPath> *pathContour)
 {
 	// At this point, the pathContour is all set up ready to go
@@ -707,6 +991,9 @@ void meshMaker::createGMSHGeometry(std::vector<closedPath> *pathContour)
 	std::vector<closedPath> *pathToOperate = nullptr;
 	std::vector<GFace*> addedFaces;
 	
+	p_autoSizedEdges.clear();
+	p_edgeTags.clear();
+	
 	if(pathContour == nullptr)
 		pathToOperate = &p_closedContourPaths;
 	else
@@ -742,33 +1029,10 @@ void meshMaker::createGMSHGeometry(std::vector<closedPath> *pathContour)
 				}
 				
 				// Add in the mesh settings of the line
-				if(pathIterator->getProperty()->getMeshsizeType() != meshSize::MESH_NONE_)
-				{
-					if((*lineIterator)->getSegmentProperty()->getMeshAutoState())
-					{
-						// If the mesh spacing is set to auto for the line, then the mesh size of the GEdge will inherit the
-						// mesh size specified by the user in the block label
-						if(!pathIterator->getProperty()->getAutoMeshState())
-						{
-							addedEdge->meshAttributes.meshSize = pathIterator->getProperty()->getMeshSize();
-						}
-						else
-						{
-							std::string temp = pathIterator->getProperty()->getMaterialName();
-							std::transform(temp.begin(), temp.end(), temp.begin(), ::tolower);
-							
-							if(temp == "air")
-								addedEdge->meshAttributes.meshSize = 0.25;
-							else
-								addedEdge->meshAttributes.meshSize = 0.1;
-						}
-					}
-					else if(!(*lineIterator)->getSegmentProperty()->getMeshAutoState())
-					{
-						// In this case, the user has specificially specified that they need the line's mesh size set to a specific value
-						addedEdge->meshAttributes.meshSize = (*lineIterator)->getSegmentProperty()->getElementSizeAlongLine();
-					}
-				}
+				setEdgeMeshSize(addedEdge, *lineIterator, pathIterator->getProperty());
+				
+				if((*lineIterator)->getSegmentProperty()->getBoundaryName() != "None")
+					p_regions.setEdgeBoundary(addedEdge->tag(), (*lineIterator)->getSegmentProperty()->getBoundaryName());
 				
 				addLineVector.push_back(addedEdge);
 			}
@@ -802,33 +1066,10 @@ void meshMaker::createGMSHGeometry(std::vector<closedPath> *pathContour)
 							addedEdge = p_meshModel->addLine(firstNode, secondNode);
 						}
 						
-						if(pathIterator->getProperty()->getMeshsizeType() != meshSize::MESH_NONE_)
-						{
-							if((*lineIterator)->getSegmentProperty()->getMeshAutoState())
-							{
-								// If the mesh spacing is set to auto for the line, then the mesh size of the GEdge will inherit the
-								// mesh size specified by the user in the block label
-								if(!pathIterator->getProperty()->getAutoMeshState())
-								{
-									addedEdge->meshAttributes.meshSize = pathIterator->getProperty()->getMeshSize();
-								}
-								else
-								{
-									std::string temp = pathIterator->getProperty()->getMaterialName();
-									std::transform(temp.begin(), temp.end(), temp.begin(), ::tolower);
-									
-									if(temp == "air")
-										addedEdge->meshAttributes.meshSize = 0.25;
-									else
-										addedEdge->meshAttributes.meshSize = 0.1;
-								}
-							}
-							else if(!(*lineIterator)->getSegmentProperty()->getMeshAutoState())
-							{
-								// In this case, the user has specificially specified that they need the line's mesh size set to a specific value
-								addedEdge->meshAttributes.meshSize = (*lineIterator)->getSegmentProperty()->getElementSizeAlongLine();
-							}
-						}
+						setEdgeMeshSize(addedEdge, *lineIterator, pathIterator->getProperty());
+						
+						if((*lineIterator)->getSegmentProperty()->getBoundaryName() != "None")
+							p_regions.setEdgeBoundary(addedEdge->tag(), (*lineIterator)->getSegmentProperty()->getBoundaryName());
 				
 						addLineVector.push_back(addedEdge);
 					}
@@ -840,9 +1081,14 @@ void meshMaker::createGMSHGeometry(std::vector<closedPath> *pathContour)
 			addedFace->meshAttributes.method = 2;
 			addedFace->meshAttributes.transfiniteArrangement = 0;
 			addedFaces.push_back(addedFace);
+			
+			p_regions.setFaceMaterial(addedFace->tag(), pathIterator->getProperty()->getMaterialName());
 		}
 	}
 	
+	// The faces are tagged with their material and the edges with their boundary condition
+	p_regions.applyPhysicalGroups(p_meshModel);
+	
 /*	for(auto faceIterator = addedFaces.begin(); faceIterator != addedFaces.end(); faceIterator++)
 	{
 		GFace *aFace = *faceIterator;
@@ -888,6 +1134,310 @@ void meshMaker::createGMSHGeometry(std::vector<closedPath> *pathContour)
 
 
 
+void meshMaker::setEdgeMeshSize(GEdge *addedEdge, edgeLineShape *edge, blockProperty *property)
+{
+	p_edgeTags[edge] = addedEdge->tag();
+	
+	if(property->getMeshsizeType() == meshSize::MESH_NONE_)
+		return;
+	
+	if(edge->getSegmentProperty()->getMeshAutoState())
+	{
+		// If the mesh spacing is set to auto for the line, then the mesh size of the GEdge will inherit the
+		// mesh size specified by the user in the block label
+		if(!property->getAutoMeshState())
+			addedEdge->meshAttributes.meshSize = property->getMeshSize();
+		else
+		{
+			// The mesh size of a GEdge is relative to the size of the model (see BGM_MeshSize)
+			const double edgeSize = p_sizing.getEdgeSize(edge);
+			
+			if(edgeSize > 0)
+			{
+				addedEdge->meshAttributes.meshSize = edgeSize / CTX::instance()->lc;
+				p_autoSizedEdges[addedEdge->tag()] = edge;
+			}
+		}
+	}
+	else
+	{
+		// In this case, the user has specificially specified that they need the line's mesh size set to a specific value
+		addedEdge->meshAttributes.meshSize = edge->getSegmentProperty()->getElementSizeAlongLine();
+	}
+}
+
+
+
+void meshMaker::createSizeFields()
+{
+	FieldManager *fields = p_meshModel->getFields();
+	std::list<int> sizeFields;
+	
+	// The fields of a previous mesh are removed
+	fields->reset();
+	fields->setBackgroundFieldId(-1);
+	
+	// The fields are evaluated in the current GMSH model
+	p_meshModel->setAsCurrent();
+	
+	const int cornerField = addCornerRefinement();
+	
+	if(cornerField >= 0)
+		sizeFields.push_back(cornerField);
+	
+	addGapRefinement(sizeFields);
+	
+	addVertexGrading(sizeFields);
+	
+	if(sizeFields.size() == 1)
+		fields->setBackgroundFieldId(sizeFields.front());
+	else if(sizeFields.size() > 1)
+	{
+		Field *minimum = fields->newField(fields->newId(), "Min");
+		minimum->options["FieldsList"]->list(sizeFields);
+		
+		fields->setBackgroundFieldId(minimum->id);
+	}
+}
+
+
+
+int meshMaker::addCornerRefinement()
+{
+	const double factor = p_settings->getCornerRefinementFactor();
+	FieldManager *fields = p_meshModel->getFields();
+	
+	if(factor >= 1.0)
+		return -1;
+	
+	// The corners grouped by the relative mesh size of their edges
+	std::map<double, std::list<int>> cornerGroups;
+	unsigned int numberCorners = 0;
+	
+	for(GModel::viter vertexIterator = p_meshModel->firstVertex(); vertexIterator != p_meshModel->lastVertex(); vertexIterator++)
+	{
+		GVertex *vertex = *vertexIterator;
+		std::list<GEdge*> edges = vertex->edges();
+		std::vector<SVector3> directions;
+		double edgeSize = MAX_LC;
+		
+		// The direction in which each edge leaves the vertex. Edges that are shared between faces are duplicated in the
+		// GMSH geometry and leave the vertex in the same direction
+		for(auto edgeIterator = edges.begin(); edgeIterator != edges.end(); edgeIterator++)
+		{
+			GEdge *edge = *edgeIterator;
+			Range<double> bounds = edge->parBounds(0);
+			const bool atBegin = (edge->getBeginVertex() == vertex);
+			SVector3 direction = edge->firstDer(atBegin ? bounds.low() : bounds.high());
+			
+			if(!atBegin)
+				direction *= -1.0;
+			
+			direction.normalize();
+			
+			bool isNewDirection = true;
+			
+			for(auto directionIterator = directions.begin(); directionIterator != directions.end(); directionIterator++)
+			{
+				if(dot(*directionIterator, direction) > 0.999)
+				{
+					isNewDirection = false;
+					break;
+				}
+			}
+			
+			if(isNewDirection)
+				directions.push_back(direction);
+			
+			edgeSize = std::min(edgeSize, edge->meshAttributes.meshSize);
+		}
+		
+		// Two edges that continue each other in a (nearly) straight line do not form a corner
+		if(directions.size() == 1 || directions.size() > 2 || (directions.size() == 2 && dot(directions[0], directions[1]) > -0.9))
+		{
+			cornerGroups[edgeSize].push_back(vertex->tag());
+			numberCorners++;
+		}
+	}
+	
+	if(numberCorners == 0)
+		return -1;
+	
+	OmniFEMMsg::instance()->MsgStatus("Refining the mesh at " + std::to_string(numberCorners) + " corners");
+	
+	// The value of the fields is multiplied by the lc factor and the mesh size of the edge or face (see BGM_MeshSize).
+	// A value of lc leaves the element size unchanged
+	const double lc = CTX::instance()->lc;
+	std::list<int> thresholds;
+	double smallestDistance = MAX_LC;
+	
+	for(auto groupIterator = cornerGroups.begin(); groupIterator != cornerGroups.end(); groupIterator++)
+	{
+		// The element size at the corners without refinement
+		const double elementSize = lc * CTX::instance()->mesh.lcFactor * groupIterator->first;
+		const double distanceMin = factor * elementSize;
+		const double distanceMax = distanceMin + 3.0 * (1.0 - factor) * elementSize;
+		
+		Field *distance = fields->newField(fields->newId(), "Distance");
+		distance->options["NodesList"]->list(groupIterator->second);
+		
+		Field *threshold = fields->newField(fields->newId(), "Threshold");
+		threshold->options["IField"]->numericalValue(distance->id);
+		threshold->options["LcMin"]->numericalValue(factor * lc);
+		threshold->options["LcMax"]->numericalValue(lc);
+		threshold->options["DistMin"]->numericalValue(distanceMin);
+		threshold->options["DistMax"]->numericalValue(distanceMax);
+		
+		thresholds.push_back(threshold->id);
+		smallestDistance = std::min(smallestDistance, distanceMin);
+	}
+	
+	Field *minimum = fields->newField(fields->newId(), "Min");
+	minimum->options["FieldsList"]->list(thresholds);
+	
+	Field *cache = fields->newField(fields->newId(), "Cache");
+	cache->options["IField"]->numericalValue(minimum->id);
+	cache->options["Size"]->numericalValue(smallestDistance / 2.0);
+	
+	return cache->id;
+}
+
+
+
+void meshMaker::addGapRefinement(std::list<int> &sizeFields)
+{
+	FieldManager *fields = p_meshModel->getFields();
+	const double lc = CTX::instance()->lc;
+	const double elementsAcrossGap = p_sizing.getElementsAcrossGap();
+	std::map<edgeLineShape*, std::list<int>> gapEdges;
+	
+	// Edges that are shared between faces are duplicated in the GMSH geometry and are refined together
+	for(auto edgeIterator = p_autoSizedEdges.begin(); edgeIterator != p_autoSizedEdges.end(); edgeIterator++)
+	{
+		if(p_sizing.getGapWidth(edgeIterator->second) > 0)
+			gapEdges[edgeIterator->second].push_back(edgeIterator->first);
+	}
+	
+	if(gapEdges.empty())
+		return;
+	
+	OmniFEMMsg::instance()->MsgStatus("Refining the mesh in the gaps of " + std::to_string(gapEdges.size()) + " edges");
+	
+	for(auto gapIterator = gapEdges.begin(); gapIterator != gapEdges.end(); gapIterator++)
+	{
+		const double edgeSize = p_sizing.getEdgeSize(gapIterator->first);
+		const double gapWidth = p_sizing.getGapWidth(gapIterator->first);
+		std::list<int> nearEdges;
+		std::list<int> nearNodes;
+		double nearLength = 0;
+		
+		for(edgeLineShape *nearEdge : p_sizing.getGapEdges(gapIterator->first))
+		{
+			auto found = p_edgeTags.find(nearEdge);
+			
+			// The edges of the faces without a mesh are not in the GMSH geometry
+			if(found == p_edgeTags.end())
+				continue;
+			
+			nearEdges.push_back(found->second);
+			nearNodes.push_back(nearEdge->getFirstNode()->getGModalTagNumber());
+			nearNodes.push_back(nearEdge->getSecondNode()->getGModalTagNumber());
+			nearLength = std::max(nearLength, std::fabs(nearEdge->getDistance()));
+		}
+		
+		if(nearEdges.empty())
+			continue;
+		
+		// The distance field replaces the edges by equidistant nodes. The nodes are spaced by half of the gap at most
+		Field *distance = fields->newField(fields->newId(), "Distance");
+		distance->options["EdgesList"]->list(nearEdges);
+		distance->options["NodesList"]->list(nearNodes);
+		distance->options["NNodesByEdge"]->numericalValue(std::min(2000.0, std::max(20.0, std::ceil(2.0 * nearLength / gapWidth) + 2.0)));
+		
+		// The value of the field is multiplied by the mesh size of the edge (see BGM_MeshSize). Between the distances,
+		// the element size is the distance divided by the number of elements across the gap
+		Field *threshold = fields->newField(fields->newId(), "Threshold");
+		threshold->options["IField"]->numericalValue(distance->id);
+		threshold->options["LcMin"]->numericalValue(lc * gapWidth / (elementsAcrossGap * edgeSize));
+		threshold->options["LcMax"]->numericalValue(lc);
+		threshold->options["DistMin"]->numericalValue(gapWidth);
+		threshold->options["DistMax"]->numericalValue(elementsAcrossGap * edgeSize);
+		
+		Field *restriction = fields->newField(fields->newId(), "Restrict");
+		restriction->options["IField"]->numericalValue(threshold->id);
+		restriction->options["EdgesList"]->list(gapIterator->second);
+		
+		sizeFields.push_back(restriction->id);
+	}
+}
+
+
+
+void meshMaker::addVertexGrading(std::list<int> &sizeFields)
+{
+	FieldManager *fields = p_meshModel->getFields();
+	const double lc = CTX::instance()->lc;
+	const double gradation = p_sizing.getGradation();
+	unsigned int numberGraded = 0;
+	
+	for(GModel::viter vertexIterator = p_meshModel->firstVertex(); vertexIterator != p_meshModel->lastVertex(); vertexIterator++)
+	{
+		GVertex *vertex = *vertexIterator;
+		std::list<GEdge*> edges = vertex->edges();
+		double vertexSize = p_sizing.getNodeSize(vertex->tag());
+		
+		// The centers of the arcs are not on any edge
+		if(edges.empty() || vertexSize <= 0)
+			continue;
+		
+		for(auto edgeIterator = edges.begin(); edgeIterator != edges.end(); edgeIterator++)
+			vertexSize = std::min(vertexSize, (*edgeIterator)->meshAttributes.meshSize * lc);
+		
+		// The edges that are much coarser than the vertex grouped by their relative mesh size. Edges that are shared
+		// between faces are duplicated in the GMSH geometry and are graded together
+		std::map<double, std::list<int>> gradedEdges;
+		
+		for(auto edgeIterator = edges.begin(); edgeIterator != edges.end(); edgeIterator++)
+		{
+			GEdge *edge = *edgeIterator;
+			
+			if(p_autoSizedEdges.count(edge->tag()) && edge->meshAttributes.meshSize * lc > 1.5 * vertexSize)
+				gradedEdges[edge->meshAttributes.meshSize].push_back(edge->tag());
+		}
+		
+		if(gradedEdges.empty())
+			continue;
+		
+		Field *distance = fields->newField(fields->newId(), "Distance");
+		distance->options["NodesList"]->list(std::list<int>(1, vertex->tag()));
+		
+		for(auto groupIterator = gradedEdges.begin(); groupIterator != gradedEdges.end(); groupIterator++)
+		{
+			// The value of the field is multiplied by the mesh size of the edge (see BGM_MeshSize)
+			const double edgeSize = groupIterator->first * lc;
+			
+			Field *threshold = fields->newField(fields->newId(), "Threshold");
+			threshold->options["IField"]->numericalValue(distance->id);
+			threshold->options["LcMin"]->numericalValue(lc * vertexSize / edgeSize);
+			threshold->options["LcMax"]->numericalValue(lc);
+			threshold->options["DistMin"]->numericalValue(0.0);
+			threshold->options["DistMax"]->numericalValue((edgeSize - vertexSize) / gradation);
+			
+			Field *restriction = fields->newField(fields->newId(), "Restrict");
+			restriction->options["IField"]->numericalValue(threshold->id);
+			restriction->options["EdgesList"]->list(groupIterator->second);
+			
+			sizeFields.push_back(restriction->id);
+			numberGraded += groupIterator->second.size();
+		}
+	}
+	
+	if(numberGraded > 0)
+		OmniFEMMsg::instance()->MsgStatus("Grading the mesh size of " + std::to_string(numberGraded) + " edges at their vertices");
+}
+
+
+
 closedPath meshMaker::recreatePath(closedPath &path, closedPath holeIterator, std::vector<edgeLineShape*> commonEdges)
 {
 	std::vector<edgeLineShape*> newEdgesForPath;
@@ -0,0 +1,34 @@
+#include <Mesh/meshRegionTable.h>
+
+#include <Mesh/GMSH/GModel.h>
+#include <Mesh/GMSH/GFace.h>
+#include <Mesh/GMSH/GEdge.h>
+
+
+void meshRegionTable::applyPhysicalGroups(GModel *model) const
+{
+	for(auto faceIterator = p_faceMaterials.begin(); faceIterator != p_faceMaterials.end(); faceIterator++)
+	{
+		GFace *face = model->getFaceByTag(faceIterator->first);
+
+		if(face)
+		{
+			face->physicals.clear();
+
+			// Faces without a material are in the group "None". The writers only write the elements of the
+			// physical groups, so a face without a group would be missing from the exported mesh
+			face->addPhysicalEntity(model->setPhysicalName(faceIterator->second, 2));
+		}
+	}
+
+	for(auto edgeIterator = p_edgeBoundaries.begin(); edgeIterator != p_edgeBoundaries.end(); edgeIterator++)
+	{
+		GEdge *edge = model->getEdgeByTag(edgeIterator->first);
+
+		if(edge)
+		{
+			edge->physicals.clear();
+			edge->addPhysicalEntity(model->setPhysicalName(edgeIterator->second, 1));
+		}
+	}
+}
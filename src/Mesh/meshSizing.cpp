@@ -0,0 +1,355 @@
+#include <Mesh/meshSizing.h>
+
+#include <cmath>
+#include <algorithm>
+
+
+/**
+ * @brief Computes the distance between a point and a segment
+ * @param x The x coordinate of the point
+ * @param y The y coordinate of the point
+ * @param x0 The x coordinate of the start of the segment
+ * @param y0 The y coordinate of the start of the segment
+ * @param x1 The x coordinate of the end of the segment
+ * @param y1 The y coordinate of the end of the segment
+ * @return Returns the distance between the point and the segment
+ */
+static double pointSegmentDistance(double x, double y, double x0, double y0, double x1, double y1)
+{
+	const double dx = x1 - x0;
+	const double dy = y1 - y0;
+	const double lengthSquared = dx * dx + dy * dy;
+	double t = 0;
+
+	if(lengthSquared > 0)
+		t = std::max(0.0, std::min(1.0, ((x - x0) * dx + (y - y0) * dy) / lengthSquared));
+
+	return std::hypot(x - (x0 + t * dx), y - (y0 + t * dy));
+}
+
+
+
+/**
+ * @brief Computes the distance between two segments
+ * @param a0x The x coordinate of the start of the first segment
+ * @param a0y The y coordinate of the start of the first segment
+ * @param a1x The x coordinate of the end of the first segment
+ * @param a1y The y coordinate of the end of the first segment
+ * @param b0x The x coordinate of the start of the second segment
+ * @param b0y The y coordinate of the start of the second segment
+ * @param b1x The x coordinate of the end of the second segment
+ * @param b1y The y coordinate of the end of the second segment
+ * @return Returns the distance between the segments. Returns 0 if the segments cross
+ */
+static double segmentDistance(double a0x, double a0y, double a1x, double a1y, double b0x, double b0y, double b1x, double b1y)
+{
+	// The segments cross if the ends of each segment are on either side of the other segment
+	const double d0 = (a1x - a0x) * (b0y - a0y) - (a1y - a0y) * (b0x - a0x);
+	const double d1 = (a1x - a0x) * (b1y - a0y) - (a1y - a0y) * (b1x - a0x);
+	const double d2 = (b1x - b0x) * (a0y - b0y) - (b1y - b0y) * (a0x - b0x);
+	const double d3 = (b1x - b0x) * (a1y - b0y) - (b1y - b0y) * (a1x - b0x);
+
+	if(((d0 > 0 && d1 < 0) || (d0 < 0 && d1 > 0)) && ((d2 > 0 && d3 < 0) || (d2 < 0 && d3 > 0)))
+		return 0;
+
+	return std::min(std::min(pointSegmentDistance(a0x, a0y, b0x, b0y, b1x, b1y), pointSegmentDistance(a1x, a1y, b0x, b0y, b1x, b1y)),
+					std::min(pointSegmentDistance(b0x, b0y, a0x, a0y, a1x, a1y), pointSegmentDistance(b1x, b1y, a0x, a0y, a1x, a1y)));
+}
+
+
+
+void meshSizing::addEdge(edgeLineShape *edge)
+{
+	if(p_edgeIndex.find(edge) != p_edgeIndex.end())
+		return;
+
+	const unsigned int index = p_edges.size();
+	const double x0 = edge->getFirstNode()->getCenterXCoordinate();
+	const double y0 = edge->getFirstNode()->getCenterYCoordinate();
+	const double x1 = edge->getSecondNode()->getCenterXCoordinate();
+	const double y1 = edge->getSecondNode()->getCenterYCoordinate();
+
+	p_edgeIndex[edge] = index;
+	p_edges.push_back(edge);
+
+	const double radius = std::hypot(x0 - edge->getCenterXCoordinate(), y0 - edge->getCenterYCoordinate());
+	const double arcLength = std::fabs(edge->getDistance());
+
+	if(!edge->isArc() || radius <= 0 || arcLength <= 0)
+	{
+		p_pieces.push_back({index, x0, y0, x1, y1});
+		return;
+	}
+
+	// The arc is split into pieces of at most 15 degrees. The direction of the arc is given by its midpoint
+	const double centerX = edge->getCenterXCoordinate();
+	const double centerY = edge->getCenterYCoordinate();
+	const double cross = (x0 - centerX) * (edge->getMidPoint().y - centerY) - (y0 - centerY) * (edge->getMidPoint().x - centerX);
+	const double angle = (cross < 0 ? -1.0 : 1.0) * arcLength / radius;
+	const double startAngle = std::atan2(y0 - centerY, x0 - centerX);
+	const int numberPieces = std::max(1, (int)std::ceil(std::fabs(angle) / (M_PI / 12.0)));
+	double lastX = x0;
+	double lastY = y0;
+
+	for(int i = 1; i <= numberPieces; i++)
+	{
+		double x = x1;
+		double y = y1;
+
+		if(i < numberPieces)
+		{
+			x = centerX + radius * std::cos(startAngle + angle * i / numberPieces);
+			y = centerY + radius * std::sin(startAngle + angle * i / numberPieces);
+		}
+
+		p_pieces.push_back({index, lastX, lastY, x, y});
+		lastX = x;
+		lastY = y;
+	}
+}
+
+
+
+void meshSizing::createGrid()
+{
+	double xmin = p_pieces[0].x0, xmax = xmin;
+	double ymin = p_pieces[0].y0, ymax = ymin;
+
+	for(auto pieceIterator = p_pieces.begin(); pieceIterator != p_pieces.end(); pieceIterator++)
+	{
+		xmin = std::min(xmin, std::min(pieceIterator->x0, pieceIterator->x1));
+		xmax = std::max(xmax, std::max(pieceIterator->x0, pieceIterator->x1));
+		ymin = std::min(ymin, std::min(pieceIterator->y0, pieceIterator->y1));
+		ymax = std::max(ymax, std::max(pieceIterator->y0, pieceIterator->y1));
+	}
+
+	// About one piece per cell. The cells are square
+	const double lx = xmax - xmin;
+	const double ly = ymax - ymin;
+	const double numberPieces = p_pieces.size();
+
+	p_cellSize = std::max(std::sqrt(lx * ly / numberPieces), std::max(lx, ly) / numberPieces);
+
+	if(p_cellSize <= 0)
+		p_cellSize = 1;
+
+	p_gridXMin = xmin;
+	p_gridYMin = ymin;
+	p_gridNx = (int)(lx / p_cellSize) + 1;
+	p_gridNy = (int)(ly / p_cellSize) + 1;
+
+	std::vector<int> range(4 * p_pieces.size());
+
+	p_gridStart.assign(p_gridNx * p_gridNy + 1, 0);
+
+	for(unsigned int i = 0; i < p_pieces.size(); i++)
+	{
+		const edgePiece &piece = p_pieces[i];
+		int *r = &range[4 * i];
+
+		r[0] = std::min(p_gridNx - 1, (int)((std::min(piece.x0, piece.x1) - p_gridXMin) / p_cellSize));
+		r[1] = std::min(p_gridNx - 1, (int)((std::max(piece.x0, piece.x1) - p_gridXMin) / p_cellSize));
+		r[2] = std::min(p_gridNy - 1, (int)((std::min(piece.y0, piece.y1) - p_gridYMin) / p_cellSize));
+		r[3] = std::min(p_gridNy - 1, (int)((std::max(piece.y0, piece.y1) - p_gridYMin) / p_cellSize));
+
+		for(int iy = r[2]; iy <= r[3]; iy++)
+		{
+			for(int ix = r[0]; ix <= r[1]; ix++)
+				p_gridStart[iy * p_gridNx + ix + 1]++;
+		}
+	}
+
+	for(int i = 0; i < p_gridNx * p_gridNy; i++)
+		p_gridStart[i + 1] += p_gridStart[i];
+
+	p_gridList.resize(p_gridStart.back());
+
+	std::vector<unsigned int> fill(p_gridStart.begin(), p_gridStart.end() - 1);
+
+	for(unsigned int i = 0; i < p_pieces.size(); i++)
+	{
+		const int *r = &range[4 * i];
+
+		for(int iy = r[2]; iy <= r[3]; iy++)
+		{
+			for(int ix = r[0]; ix <= r[1]; ix++)
+				p_gridList[fill[iy * p_gridNx + ix]++] = i;
+		}
+	}
+}
+
+
+
+template<class Distance>
+double meshSizing::findPieces(double xmin, double ymin, double xmax, double ymax, double searchDistance, node *firstNode, node *secondNode,
+								Distance distance, std::vector<unsigned int> *nearEdges) const
+{
+	// Every piece that is closer to the box than the search distance overlaps one of the cells
+	const int ix0 = std::max(0, (int)std::floor((xmin - searchDistance - p_gridXMin) / p_cellSize));
+	const int ix1 = std::min(p_gridNx - 1, (int)std::floor((xmax + searchDistance - p_gridXMin) / p_cellSize));
+	const int iy0 = std::max(0, (int)std::floor((ymin - searchDistance - p_gridYMin) / p_cellSize));
+	const int iy1 = std::min(p_gridNy - 1, (int)std::floor((ymax + searchDistance - p_gridYMin) / p_cellSize));
+	double nearest = -1;
+
+	for(int iy = iy0; iy <= iy1; iy++)
+	{
+		for(int ix = ix0; ix <= ix1; ix++)
+		{
+			const int cell = iy * p_gridNx + ix;
+
+			for(unsigned int i = p_gridStart[cell]; i < p_gridStart[cell + 1]; i++)
+			{
+				const edgePiece &piece = p_pieces[p_gridList[i]];
+				edgeLineShape *edge = p_edges[piece.edge];
+
+				if(edge->getFirstNode() == firstNode || edge->getSecondNode() == firstNode ||
+					edge->getFirstNode() == secondNode || edge->getSecondNode() == secondNode)
+					continue;
+
+				const double pieceDistance = distance(piece);
+
+				if(pieceDistance >= searchDistance)
+					continue;
+
+				if(nearest < 0 || pieceDistance < nearest)
+					nearest = pieceDistance;
+
+				if(nearEdges)
+					nearEdges->push_back(piece.edge);
+			}
+		}
+	}
+
+	return nearest;
+}
+
+
+
+void meshSizing::compute(std::vector<closedPath> &paths, double modelSize)
+{
+	p_edges.clear();
+	p_edgeSizes.clear();
+	p_gapWidths.clear();
+	p_gapEdges.clear();
+	p_nodeSizes.clear();
+	p_edgeIndex.clear();
+	p_pieces.clear();
+	p_gridStart.clear();
+	p_gridList.clear();
+
+	for(auto pathIterator = paths.begin(); pathIterator != paths.end(); pathIterator++)
+	{
+		for(auto lineIterator = pathIterator->getClosedPath()->begin(); lineIterator != pathIterator->getClosedPath()->end(); lineIterator++)
+			addEdge(*lineIterator);
+
+		for(auto holeIterator = pathIterator->getHoles()->begin(); holeIterator != pathIterator->getHoles()->end(); holeIterator++)
+		{
+			for(auto lineIterator = holeIterator->getClosedPath()->begin(); lineIterator != holeIterator->getClosedPath()->end(); lineIterator++)
+				addEdge(*lineIterator);
+		}
+	}
+
+	if(p_pieces.empty())
+		return;
+
+	createGrid();
+
+	const double maxSize = p_maxSizeFraction * modelSize;
+	std::map<node*, double> nodeSizes;
+	unsigned int firstPiece = 0;
+
+	p_edgeSizes.resize(p_edges.size());
+	p_gapWidths.resize(p_edges.size());
+	p_gapEdges.resize(p_edges.size());
+
+	for(unsigned int i = 0; i < p_edges.size(); i++)
+	{
+		edgeLineShape *edge = p_edges[i];
+		const double length = std::fabs(edge->getDistance());
+		double size = std::min(maxSize, length / p_elementsAlongEdge);
+
+		// The pieces of an edge follow each other
+		unsigned int lastPiece = firstPiece;
+		double xmin = p_pieces[firstPiece].x0, xmax = xmin;
+		double ymin = p_pieces[firstPiece].y0, ymax = ymin;
+
+		for(; lastPiece < p_pieces.size() && p_pieces[lastPiece].edge == i; lastPiece++)
+		{
+			xmin = std::min(xmin, p_pieces[lastPiece].x1);
+			xmax = std::max(xmax, p_pieces[lastPiece].x1);
+			ymin = std::min(ymin, p_pieces[lastPiece].y1);
+			ymax = std::max(ymax, p_pieces[lastPiece].y1);
+		}
+
+		if(edge->isArc() && lastPiece - firstPiece > 1)
+		{
+			const double radius = std::hypot(edge->getFirstNode()->getCenterXCoordinate() - edge->getCenterXCoordinate(),
+											edge->getFirstNode()->getCenterYCoordinate() - edge->getCenterYCoordinate());
+
+			size = std::min(size, 2.0 * M_PI * radius / p_elementsPerCircle);
+		}
+
+		// Only the edges that are closer than this distance make the elements smaller than the size of the edge
+		std::vector<unsigned int> nearEdges;
+		const double gap = findPieces(xmin, ymin, xmax, ymax, p_elementsAcrossGap * size, edge->getFirstNode(), edge->getSecondNode(),
+										[&](const edgePiece &other)
+		{
+			double pieceDistance = -1;
+
+			for(unsigned int j = firstPiece; j < lastPiece; j++)
+			{
+				const edgePiece &piece = p_pieces[j];
+				const double d = segmentDistance(piece.x0, piece.y0, piece.x1, piece.y1, other.x0, other.y0, other.x1, other.y1);
+
+				if(pieceDistance < 0 || d < pieceDistance)
+					pieceDistance = d;
+			}
+
+			return pieceDistance;
+		}, &nearEdges);
+
+		// Edges that touch without sharing a node do not limit the size
+		if(gap > 0)
+		{
+			std::sort(nearEdges.begin(), nearEdges.end());
+			nearEdges.erase(std::unique(nearEdges.begin(), nearEdges.end()), nearEdges.end());
+
+			p_gapWidths[i] = gap;
+
+			for(auto nearIterator = nearEdges.begin(); nearIterator != nearEdges.end(); nearIterator++)
+				p_gapEdges[i].push_back(p_edges[*nearIterator]);
+		}
+
+		p_edgeSizes[i] = size;
+		firstPiece = lastPiece;
+
+		node *edgeNodes[2] = {edge->getFirstNode(), edge->getSecondNode()};
+
+		for(int j = 0; j < 2; j++)
+		{
+			auto found = nodeSizes.find(edgeNodes[j]);
+
+			if(found == nodeSizes.end())
+				nodeSizes[edgeNodes[j]] = size;
+			else
+				found->second = std::min(found->second, size);
+		}
+	}
+
+	for(auto nodeIterator = nodeSizes.begin(); nodeIterator != nodeSizes.end(); nodeIterator++)
+	{
+		const double x = nodeIterator->first->getCenterXCoordinate();
+		const double y = nodeIterator->first->getCenterYCoordinate();
+
+		const double gap = findPieces(x, y, x, y, p_elementsAcrossGap * nodeIterator->second, nodeIterator->first, nodeIterator->first,
+										[&](const edgePiece &other)
+		{
+			return pointSegmentDistance(x, y, other.x0, other.y0, other.x1, other.y1);
+		});
+
+		if(gap > 0)
+			nodeIterator->second = std::min(nodeIterator->second, gap / p_elementsAcrossGap);
+
+		p_nodeSizes[nodeIterator->first->getGModalTagNumber()] = nodeIterator->second;
+	}
+}
@@ -0,0 +1,321 @@
+#include <Mesh/meshSnapshot.h>
+
+
+int meshSnapshot::addElementType(MElement *element)
+{
+	int mshType = element->getTypeForMSH();
+	auto typeIterator = p_elementTypeIndex.find(mshType);
+
+	if(typeIterator != p_elementTypeIndex.end())
+		return typeIterator->second;
+
+	snapshotElementType newType;
+
+	newType.mshType = mshType;
+	newType.elementClass = element->getType();
+	newType.vtkType = element->getTypeForVTK();
+	newType.numberNodes = element->getNumVertices();
+	newType.vtkOrder.resize(newType.numberNodes);
+
+	// The VTK ordering of the nodes is only available as a permutation of the vertex pointers. The permutation is
+	// the same for every element of the type which is why it is looked up once on the first element
+	for(int i = 0; i < newType.numberNodes; i++)
+	{
+		MVertex *vtkVertex = element->getVertexVTK(i);
+
+		for(int j = 0; j < newType.numberNodes; j++)
+		{
+			if(element->getVertex(j) == vtkVertex)
+			{
+				newType.vtkOrder[i] = j;
+				break;
+			}
+		}
+	}
+
+	p_elementTypes.push_back(newType);
+	p_elementTypeIndex[mshType] = p_elementTypes.size() - 1;
+
+	return p_elementTypes.size() - 1;
+}
+
+
+
+void meshSnapshot::create(GModel *model)
+{
+	std::vector<GEntity*> entities;
+	std::vector<int> physicalIndex;
+	unsigned int vertexPosition = 0;
+	unsigned int numberElements = 0;
+	unsigned int numberElementNodes = 0;
+
+	model->getEntities(entities);
+
+	p_name = model->getName();
+	p_dimension = model->getDim();
+	p_meshOrder = CTX::instance()->mesh.order;
+	p_hasPhysicalGroups = !model->noPhysicalGroups();
+
+	p_nodeX.clear();
+	p_nodeY.clear();
+	p_nodeZ.clear();
+	p_nodePhysicalIndex.clear();
+	p_entities.clear();
+	p_elementTypeIndex.clear();
+	p_elementTypes.clear();
+	p_elementType.clear();
+	p_elementNumber.clear();
+	p_elementPartition.clear();
+	p_elementRegion.clear();
+	p_elementNodeOffset.assign(1, 0);
+	p_elementNodes.clear();
+	p_physicalNames.clear();
+	p_boundaryEdges.clear();
+
+	// The first indexing only tags the nodes of the elements that belong to a physical group
+	p_numberPhysicalNodes = model->indexMeshVertices(false);
+
+	for(unsigned int i = 0; i < entities.size(); i++)
+	{
+		for(unsigned int j = 0; j < entities[i]->mesh_vertices.size(); j++)
+			physicalIndex.push_back(entities[i]->mesh_vertices[j]->getIndex());
+
+		numberElements += entities[i]->getNumMeshElements();
+
+		for(unsigned int j = 0; j < entities[i]->getNumMeshElements(); j++)
+			numberElementNodes += entities[i]->getMeshElement(j)->getNumVertices();
+	}
+
+	// The second indexing numbers the nodes of all of the elements in the order of the entities. The index of
+	// a node is therefore its position in the node arrays + 1
+	unsigned int numberNodes = model->indexMeshVertices(true);
+
+	p_nodeX.reserve(numberNodes);
+	p_nodeY.reserve(numberNodes);
+	p_nodeZ.reserve(numberNodes);
+	p_nodePhysicalIndex.reserve(numberNodes);
+	p_elementType.reserve(numberElements);
+	p_elementNumber.reserve(numberElements);
+	p_elementPartition.reserve(numberElements);
+	p_elementRegion.reserve(numberElements);
+	p_elementNodeOffset.reserve(numberElements + 1);
+	p_elementNodes.reserve(numberElementNodes);
+
+	for(unsigned int i = 0; i < entities.size(); i++)
+	{
+		snapshotEntity newEntity;
+		int region = entities[i]->physicals.empty() ? -1 : std::abs(entities[i]->physicals[0]);
+
+		newEntity.dimension = entities[i]->dim();
+		newEntity.tag = entities[i]->tag();
+		newEntity.physicals = entities[i]->physicals;
+		newEntity.firstNode = p_nodeX.size();
+		newEntity.firstElement = p_elementType.size();
+		newEntity.numberElements = entities[i]->getNumMeshElements();
+
+		for(unsigned int j = 0; j < entities[i]->mesh_vertices.size(); j++, vertexPosition++)
+		{
+			MVertex *vertex = entities[i]->mesh_vertices[j];
+
+			if(vertex->getIndex() <= 0)
+				continue;
+
+			p_nodeX.push_back(vertex->x());
+			p_nodeY.push_back(vertex->y());
+			p_nodeZ.push_back(vertex->z());
+			p_nodePhysicalIndex.push_back(physicalIndex[vertexPosition]);
+		}
+
+		newEntity.numberNodes = p_nodeX.size() - newEntity.firstNode;
+
+		for(unsigned int j = 0; j < newEntity.numberElements; j++)
+		{
+			MElement *element = entities[i]->getMeshElement(j);
+			int type = addElementType(element);
+
+			p_elementTypes[type].elements.push_back(p_elementType.size());
+			p_elementType.push_back(type);
+			p_elementNumber.push_back(element->getNum());
+			p_elementPartition.push_back(element->getPartition());
+			p_elementRegion.push_back(region);
+
+			for(int k = 0; k < element->getNumVertices(); k++)
+				p_elementNodes.push_back(element->getVertex(k)->getIndex() - 1);
+
+			p_elementNodeOffset.push_back(p_elementNodes.size());
+		}
+
+		for(auto physicalIterator = newEntity.physicals.begin(); physicalIterator != newEntity.physicals.end(); physicalIterator++)
+		{
+			std::pair<int, int> key(newEntity.dimension, std::abs(*physicalIterator));
+
+			if(p_physicalNames.find(key) == p_physicalNames.end())
+				p_physicalNames[key] = model->getPhysicalName(key.first, key.second);
+		}
+
+		p_entities.push_back(newEntity);
+	}
+
+	findSharedNodes();
+	findBoundaryEdges();
+}
+
+
+
+void meshSnapshot::findSharedNodes()
+{
+	std::map<std::pair<long long, long long>, unsigned int> cellNode;
+	double diagonal = 0;
+
+	p_sharedNode.resize(p_nodeX.size());
+
+	if(p_nodeX.empty())
+		return;
+
+	auto rangeX = std::minmax_element(p_nodeX.begin(), p_nodeX.end());
+	auto rangeY = std::minmax_element(p_nodeY.begin(), p_nodeY.end());
+	auto rangeZ = std::minmax_element(p_nodeZ.begin(), p_nodeZ.end());
+
+	diagonal = std::sqrt(std::pow(*rangeX.second - *rangeX.first, 2) + std::pow(*rangeY.second - *rangeY.first, 2) +
+							std::pow(*rangeZ.second - *rangeZ.first, 2));
+
+	const double tolerance = 1.0e-9 * std::max(diagonal, 1.0e-12);
+
+	for(unsigned int i = 0; i < p_nodeX.size(); i++)
+	{
+		// Two coincident nodes can be rounded into neighbouring cells, so these cells are searched as well
+		std::pair<long long, long long> key(std::llround(p_nodeX[i] / tolerance), std::llround(p_nodeY[i] / tolerance));
+
+		p_sharedNode[i] = i;
+
+		for(long long cellX = key.first - 1; cellX <= key.first + 1 && p_sharedNode[i] == i; cellX++)
+		{
+			for(long long cellY = key.second - 1; cellY <= key.second + 1; cellY++)
+			{
+				auto cellIterator = cellNode.find(std::pair<long long, long long>(cellX, cellY));
+
+				if(cellIterator != cellNode.end())
+				{
+					unsigned int node = cellIterator->second;
+
+					if(std::fabs(p_nodeX[node] - p_nodeX[i]) <= tolerance && std::fabs(p_nodeY[node] - p_nodeY[i]) <= tolerance &&
+						std::fabs(p_nodeZ[node] - p_nodeZ[i]) <= tolerance)
+					{
+						p_sharedNode[i] = node;
+						break;
+					}
+				}
+			}
+		}
+
+		if(p_sharedNode[i] == i)
+			cellNode[key] = i;
+	}
+}
+
+
+
+void meshSnapshot::findBoundaryEdges()
+{
+	std::map<std::pair<unsigned int, unsigned int>, int> lineUses;
+
+	// The end nodes of a line element are its first two nodes. The line elements of the duplicated edges connect
+	// the same shared nodes
+	for(unsigned int i = 0; i < p_entities.size(); i++)
+	{
+		if(p_entities[i].dimension != 1)
+			continue;
+
+		for(unsigned int j = p_entities[i].firstElement; j < p_entities[i].firstElement + p_entities[i].numberElements; j++)
+		{
+			const unsigned int *nodes = getElementNodes(j);
+			unsigned int first = p_sharedNode[nodes[0]];
+			unsigned int second = p_sharedNode[nodes[1]];
+
+			lineUses[std::make_pair(std::min(first, second), std::max(first, second))]++;
+		}
+	}
+
+	for(unsigned int i = 0; i < p_entities.size(); i++)
+	{
+		if(p_entities[i].dimension != 1)
+			continue;
+
+		for(unsigned int j = p_entities[i].firstElement; j < p_entities[i].firstElement + p_entities[i].numberElements; j++)
+		{
+			const unsigned int *nodes = getElementNodes(j);
+			unsigned int first = p_sharedNode[nodes[0]];
+			unsigned int second = p_sharedNode[nodes[1]];
+			snapshotBoundaryEdge newEdge;
+
+			newEdge.element = j;
+			newEdge.edgeTag = p_entities[i].tag;
+			newEdge.condition = p_elementRegion[j];
+			newEdge.isOuter = (lineUses[std::make_pair(std::min(first, second), std::max(first, second))] == 1);
+
+			if(newEdge.isOuter || newEdge.condition >= 0)
+				p_boundaryEdges.push_back(newEdge);
+		}
+	}
+}
+
+
+
+int meshSnapshot::findEntity(int dimension, int tag) const
+{
+	for(unsigned int i = 0; i < p_entities.size(); i++)
+	{
+		if(p_entities[i].dimension == dimension && p_entities[i].tag == tag)
+			return i;
+	}
+
+	return -1;
+}
+
+
+
+std::map<int, std::vector<unsigned int>> meshSnapshot::getPhysicalGroups(int dimension) const
+{
+	std::map<int, std::vector<unsigned int>> groups;
+
+	for(unsigned int i = 0; i < p_entities.size(); i++)
+	{
+		if(p_entities[i].dimension != dimension)
+			continue;
+
+		for(auto physicalIterator = p_entities[i].physicals.begin(); physicalIterator != p_entities[i].physicals.end(); physicalIterator++)
+		{
+			std::vector<unsigned int> &group = groups[std::abs(*physicalIterator)];
+
+			if(group.size() == 0 || group.back() != i)
+				group.push_back(i);
+		}
+	}
+
+	return groups;
+}
+
+
+
+std::string meshSnapshot::getPhysicalName(int dimension, int number) const
+{
+	std::string name;
+	auto nameIterator = p_physicalNames.find(std::make_pair(dimension, number));
+
+	if(nameIterator != p_physicalNames.end())
+		name = nameIterator->second;
+
+	if(name.empty())
+	{
+		if(dimension == 3)
+			name = "PhysicalVolume" + std::to_string(number);
+		else if(dimension == 2)
+			name = "PhysicalSurface" + std::to_string(number);
+		else
+			name = "PhysicalLine" + std::to_string(number);
+	}
+
+	std::replace(name.begin(), name.end(), ' ', '_');
+
+	return name;
+}
@@ -0,0 +1,362 @@
+#include <Mesh/vtuWriter.h>
+
+#include <algorithm>
+#include <limits>
+#include <cinttypes>
+
+#if defined(HAVE_LIBZ)
+#include <zlib.h>
+#endif
+
+
+void vtuWriter::beginArray(uint64_t numberBytes)
+{
+	if(p_compress)
+	{
+		const uint64_t numberBlocks = (numberBytes + p_blockSize - 1) / p_blockSize;
+		const uint64_t zero = 0;
+
+		p_compressionHeader.clear();
+		p_compressionHeader.push_back(numberBlocks);
+		p_compressionHeader.push_back(p_blockSize);
+		p_compressionHeader.push_back(numberBytes % p_blockSize);
+		p_compressionHeaderOffset = p_appendedSize;
+
+		// The compressed sizes of the blocks are filled in at the end
+		for(uint64_t i = 0; i < numberBlocks + 3; i++)
+			p_output->putBinary(&zero, sizeof(uint64_t));
+
+		p_appendedSize += (numberBlocks + 3) * sizeof(uint64_t);
+		p_block.clear();
+	}
+	else
+	{
+		p_output->putBinary(&numberBytes, sizeof(uint64_t));
+		p_appendedSize += sizeof(uint64_t);
+	}
+}
+
+
+
+void vtuWriter::appendData(const void *data, std::size_t size)
+{
+	if(!p_compress)
+	{
+		p_output->putBinary(data, size);
+		p_appendedSize += size;
+		return;
+	}
+
+	const char *bytes = static_cast<const char*>(data);
+
+	while(size > 0)
+	{
+		std::size_t count = std::min<std::size_t>(size, p_blockSize - p_block.size());
+
+		p_block.insert(p_block.end(), bytes, bytes + count);
+		bytes += count;
+		size -= count;
+
+		if(p_block.size() == p_blockSize)
+			writeBlock();
+	}
+}
+
+
+
+void vtuWriter::writeBlock()
+{
+#if defined(HAVE_LIBZ)
+	// The fastest level compresses the mesh arrays almost as well as the default level in less than half the time
+	uLongf compressedSize = compressBound(p_block.size());
+
+	p_compressedBlock.resize(compressedSize);
+
+	if(compress2(p_compressedBlock.data(), &compressedSize, reinterpret_cast<const Bytef*>(p_block.data()), p_block.size(), Z_BEST_SPEED) != Z_OK)
+	{
+		p_compressionFailed = true;
+		compressedSize = 0;
+	}
+
+	p_output->putBinary(p_compressedBlock.data(), compressedSize);
+	p_appendedSize += compressedSize;
+	p_compressionHeader.push_back(compressedSize);
+#else
+	p_compressionFailed = true;
+#endif
+
+	p_block.clear();
+}
+
+
+
+void vtuWriter::endArray()
+{
+	if(!p_compress)
+		return;
+
+	if(p_block.size() > 0)
+		writeBlock();
+
+	vtuPatch headerPatch;
+
+	headerPatch.position = p_appendedStart + p_compressionHeaderOffset;
+	headerPatch.data.assign(reinterpret_cast<const char*>(p_compressionHeader.data()), p_compressionHeader.size() * sizeof(uint64_t));
+
+	p_patches.push_back(headerPatch);
+}
+
+
+
+bool vtuWriter::write(std::string filePath, std::string &errorMessage)
+{
+	const meshSnapshot &snapshot = *p_snapshot;
+	const bool saveAll = !snapshot.hasPhysicalGroups();
+	const uint16_t byteOrderTest = 1;
+	const bool isLittleEndian = (*reinterpret_cast<const unsigned char*>(&byteOrderTest) == 1);
+	const uint64_t numberPoints = snapshot.getNumberSavedNodes(saveAll);
+	const double *x = snapshot.getNodeX();
+	const double *y = snapshot.getNodeY();
+	const double *z = snapshot.getNodeZ();
+	uint64_t numberCells = 0;
+	uint64_t numberConnectivity = 0;
+	std::string header;
+	std::vector<std::size_t> offsetPositions;
+	unsigned int arrayNumber = 0;
+	bool isWritten = true;
+
+#if !defined(HAVE_LIBZ)
+	p_compress = false;
+#endif
+
+	forEachCell(saveAll, [&](const meshSnapshot::snapshotEntity &entity, unsigned int element)
+	{
+		numberCells++;
+		numberConnectivity += snapshot.getElementType(element).numberNodes;
+	});
+
+	if(numberConnectivity > (uint64_t)std::numeric_limits<int32_t>::max())
+	{
+		errorMessage = "The mesh has too many nodes to be saved as " + filePath;
+		return false;
+	}
+
+	// Every array of the appended section is declared in the header. The offset of each array is reserved with
+	// 20 digits and filled in once the array is written
+	auto declareArray = [&](std::string type, std::string name, int numberComponents)
+	{
+		header += "        <DataArray type=\"" + type + "\"";
+
+		if(!name.empty())
+			header += " Name=\"" + name + "\"";
+
+		if(numberComponents > 1)
+			header += " NumberOfComponents=\"" + std::to_string(numberComponents) + "\"";
+
+		header += " format=\"appended\" offset=\"";
+		offsetPositions.push_back(header.size());
+		header += std::string(20, '0') + "\"/>\n";
+	};
+
+	header += "<?xml version=\"1.0\"?>\n";
+	header += "<VTKFile type=\"UnstructuredGrid\" version=\"1.0\" byte_order=\"";
+	header += isLittleEndian ? "LittleEndian" : "BigEndian";
+	header += "\" header_type=\"UInt64\"";
+
+	if(p_compress)
+		header += " compressor=\"vtkZLibDataCompressor\"";
+
+	header += ">\n";
+	header += "  <UnstructuredGrid>\n";
+	header += "    <Piece NumberOfPoints=\"" + std::to_string(numberPoints) + "\" NumberOfCells=\"" + std::to_string(numberCells) + "\">\n";
+
+	if(p_pointFields.size() > 0)
+	{
+		header += "      <PointData>\n";
+
+		for(auto fieldIterator = p_pointFields.begin(); fieldIterator != p_pointFields.end(); fieldIterator++)
+			declareArray("Float64", fieldIterator->name, fieldIterator->numberComponents);
+
+		header += "      </PointData>\n";
+	}
+
+	header += "      <CellData>\n";
+	declareArray("Int32", "RegionID", 1);
+	declareArray("Int32", "PhysicalID", 1);
+
+	for(auto fieldIterator = p_cellFields.begin(); fieldIterator != p_cellFields.end(); fieldIterator++)
+		declareArray("Float64", fieldIterator->name, fieldIterator->numberComponents);
+
+	header += "      </CellData>\n";
+	header += "      <Points>\n";
+	declareArray("Float64", "", 3);
+	header += "      </Points>\n";
+	header += "      <Cells>\n";
+	declareArray("Int32", "connectivity", 1);
+	declareArray("Int32", "offsets", 1);
+	declareArray("UInt8", "types", 1);
+	header += "      </Cells>\n";
+	header += "    </Piece>\n";
+	header += "  </UnstructuredGrid>\n";
+	header += "  <AppendedData encoding=\"raw\">\n";
+	header += "_";
+
+	FILE *file = fopen(filePath.c_str(), "wb");
+
+	if(!file)
+	{
+		errorMessage = "Unable to open file " + filePath;
+		return false;
+	}
+
+	BufferedWriter output(file);
+
+	p_output = &output;
+	p_appendedStart = header.size();
+	p_appendedSize = 0;
+	p_patches.clear();
+	p_compressionFailed = false;
+
+	output.putString(header);
+
+	// Records the offset of the next array and writes its header
+	auto startArray = [&](uint64_t numberBytes)
+	{
+		char offset[32];
+		vtuPatch offsetPatch;
+
+		snprintf(offset, sizeof(offset), "%020" PRIu64, p_appendedSize);
+		offsetPatch.position = offsetPositions[arrayNumber++];
+		offsetPatch.data = offset;
+		p_patches.push_back(offsetPatch);
+
+		beginArray(numberBytes);
+	};
+
+	for(auto fieldIterator = p_pointFields.begin(); fieldIterator != p_pointFields.end(); fieldIterator++)
+	{
+		const std::size_t pointSize = fieldIterator->numberComponents * sizeof(double);
+
+		startArray(numberPoints * pointSize);
+
+		if(saveAll)
+			appendData(fieldIterator->values, numberPoints * pointSize);
+		else
+		{
+			for(unsigned int i = 0; i < snapshot.getNumberNodes(); i++)
+			{
+				if(snapshot.getNodeIndex(i, saveAll) > 0)
+					appendData(fieldIterator->values + (std::size_t)i * fieldIterator->numberComponents, pointSize);
+			}
+		}
+
+		endArray();
+	}
+
+	startArray(numberCells * sizeof(int32_t));
+	forEachCell(saveAll, [&](const meshSnapshot::snapshotEntity &entity, unsigned int element)
+	{
+		int32_t region = entity.tag;
+		appendData(&region, sizeof(int32_t));
+	});
+	endArray();
+
+	startArray(numberCells * sizeof(int32_t));
+	forEachCell(saveAll, [&](const meshSnapshot::snapshotEntity &entity, unsigned int element)
+	{
+		int32_t physical = (entity.physicals.size() > 0) ? entity.physicals[0] : 0;
+		appendData(&physical, sizeof(int32_t));
+	});
+	endArray();
+
+	for(auto fieldIterator = p_cellFields.begin(); fieldIterator != p_cellFields.end(); fieldIterator++)
+	{
+		const std::size_t cellSize = fieldIterator->numberComponents * sizeof(double);
+
+		startArray(numberCells * cellSize);
+		forEachCell(saveAll, [&](const meshSnapshot::snapshotEntity &entity, unsigned int element)
+		{
+			appendData(fieldIterator->values + (std::size_t)element * fieldIterator->numberComponents, cellSize);
+		});
+		endArray();
+	}
+
+	startArray(numberPoints * 3 * sizeof(double));
+
+	for(unsigned int i = 0; i < snapshot.getNumberNodes(); i++)
+	{
+		if(snapshot.getNodeIndex(i, saveAll) > 0)
+		{
+			double point[3] = {x[i], y[i], z[i]};
+			appendData(point, sizeof(point));
+		}
+	}
+
+	endArray();
+
+	startArray(numberConnectivity * sizeof(int32_t));
+	forEachCell(saveAll, [&](const meshSnapshot::snapshotEntity &entity, unsigned int element)
+	{
+		const meshSnapshot::snapshotElementType &type = snapshot.getElementType(element);
+		const unsigned int *nodes = snapshot.getElementNodes(element);
+
+		for(int j = 0; j < type.numberNodes; j++)
+		{
+			int32_t node = snapshot.getNodeIndex(nodes[type.vtkOrder[j]], saveAll) - 1;
+			appendData(&node, sizeof(int32_t));
+		}
+	});
+	endArray();
+
+	int32_t cellOffset = 0;
+
+	startArray(numberCells * sizeof(int32_t));
+	forEachCell(saveAll, [&](const meshSnapshot::snapshotEntity &entity, unsigned int element)
+	{
+		cellOffset += snapshot.getElementType(element).numberNodes;
+		appendData(&cellOffset, sizeof(int32_t));
+	});
+	endArray();
+
+	startArray(numberCells * sizeof(uint8_t));
+	forEachCell(saveAll, [&](const meshSnapshot::snapshotEntity &entity, unsigned int element)
+	{
+		uint8_t type = snapshot.getElementType(element).vtkType;
+		appendData(&type, sizeof(uint8_t));
+	});
+	endArray();
+
+	output.putString("\n  </AppendedData>\n</VTKFile>\n");
+	output.flush();
+
+	// Fill in the offsets and the compression headers
+	for(auto patchIterator = p_patches.begin(); patchIterator != p_patches.end(); patchIterator++)
+	{
+		if(fseek(file, (long)patchIterator->position, SEEK_SET) != 0 ||
+			fwrite(patchIterator->data.data(), 1, patchIterator->data.size(), file) != patchIterator->data.size())
+		{
+			isWritten = false;
+			break;
+		}
+	}
+
+	if(fclose(file) != 0 || !output.good())
+		isWritten = false;
+
+	p_output = nullptr;
+	p_patches.clear();
+
+	if(p_compressionFailed)
+	{
+		errorMessage = "Unable to compress the data of " + filePath;
+		return false;
+	}
+
+	if(!isWritten)
+	{
+		errorMessage = "Unable to write file " + filePath;
+		return false;
+	}
+
+	return true;
+}
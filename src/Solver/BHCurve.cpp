@@ -0,0 +1,237 @@
+#include <Solver/BHCurve.h>
+
+
+/**
+ * @brief Evaluates the difference between coth(x) and 1/x. This is the Langevin function
+ * 			that the anhysteretic magnetization is based upon.
+ * @param x The argument of the function
+ * @return Returns coth(x) - 1/x
+ */
+static double langevin(double x)
+{
+	if(std::fabs(x) < 1.0e-4)
+		return x / 3.0 - x * x * x / 45.0;
+	else
+		return 1.0 / std::tanh(x) - 1.0 / x;
+}
+
+
+
+void bhCurve::setData(std::vector<double> H, std::vector<double> B)
+{
+	std::vector<std::pair<double, double>> points;
+
+	for(unsigned int i = 0; i < H.size() && i < B.size(); i++)
+		points.push_back(std::pair<double, double>(std::fabs(B[i]), std::fabs(H[i])));
+
+	std::sort(points.begin(), points.end());
+
+	p_B.clear();
+	p_H.clear();
+
+	// The curve always starts at the origin
+	p_B.push_back(0);
+	p_H.push_back(0);
+
+	for(auto pointIterator = points.begin(); pointIterator != points.end(); pointIterator++)
+	{
+		// The spline requires strictly increasing flux densities and a field intensity that does not decrease
+		if(pointIterator->first > p_B.back() && pointIterator->second >= p_H.back())
+		{
+			p_B.push_back(pointIterator->first);
+			p_H.push_back(pointIterator->second);
+		}
+	}
+
+	computeSlopes();
+
+	p_reluctivityTable.clear();
+	p_derivativeTable.clear();
+}
+
+
+
+bool bhCurve::createFromJilesAtherton(jilesAthertonParameters parameters, unsigned int numberPoints)
+{
+	const double Ms = parameters.getSaturationMagnetization();
+	const double a = parameters.getAParam();
+	const double alpha = parameters.getAlpha();
+
+	if(Ms <= 0 || a <= 0 || numberPoints < 3)
+		return false;
+
+	std::vector<double> H, B;
+
+	// Most of the curvature of the anhysteretic curve is located at low fields. A quadratic spacing
+	// of the field intensity places more points in the knee of the curve
+	const double Hmax = 200.0 * a;
+
+	for(unsigned int i = 0; i < numberPoints; i++)
+	{
+		double ratio = (double)i / (double)(numberPoints - 1);
+		double fieldIntensity = Hmax * ratio * ratio;
+
+		// Solve M = Ms * L((H + alpha * M) / a) with bisection. The residual is negative
+		// at M = 0 and positive at M = Ms
+		double lowerM = 0;
+		double upperM = Ms;
+
+		for(int j = 0; j < 60; j++)
+		{
+			double M = 0.5 * (lowerM + upperM);
+
+			if(M - Ms * langevin((fieldIntensity + alpha * M) / a) > 0)
+				upperM = M;
+			else
+				lowerM = M;
+		}
+
+		H.push_back(fieldIntensity);
+		B.push_back(MU_0 * (fieldIntensity + 0.5 * (lowerM + upperM)));
+	}
+
+	setData(H, B);
+
+	return p_B.size() > 2;
+}
+
+
+
+void bhCurve::computeSlopes()
+{
+	const unsigned int size = p_B.size();
+
+	p_slope.assign(size, 1.0 / MU_0);
+
+	if(size < 2)
+		return;
+
+	std::vector<double> secant(size - 1);
+
+	for(unsigned int i = 0; i < size - 1; i++)
+		secant[i] = (p_H[i + 1] - p_H[i]) / (p_B[i + 1] - p_B[i]);
+
+	p_slope[0] = secant[0];
+	p_slope[size - 1] = secant[size - 2];
+
+	for(unsigned int i = 1; i < size - 1; i++)
+	{
+		if(secant[i - 1] * secant[i] <= 0)
+			p_slope[i] = 0;
+		else
+			p_slope[i] = 0.5 * (secant[i - 1] + secant[i]);
+	}
+
+	// Limit the slopes so that the cubic segments stay monotone
+	for(unsigned int i = 0; i < size - 1; i++)
+	{
+		if(secant[i] == 0)
+		{
+			p_slope[i] = 0;
+			p_slope[i + 1] = 0;
+		}
+		else
+		{
+			double alpha = p_slope[i] / secant[i];
+			double beta = p_slope[i + 1] / secant[i];
+			double magnitude = alpha * alpha + beta * beta;
+
+			if(magnitude > 9.0)
+			{
+				double tau = 3.0 / std::sqrt(magnitude);
+				p_slope[i] = tau * alpha * secant[i];
+				p_slope[i + 1] = tau * beta * secant[i];
+			}
+		}
+	}
+}
+
+
+
+double bhCurve::evaluateSpline(double B) const
+{
+	if(B >= p_B.back())
+		return p_H.back() + (B - p_B.back()) / MU_0;
+
+	unsigned int upper = std::upper_bound(p_B.begin(), p_B.end(), B) - p_B.begin();
+	unsigned int lower = upper - 1;
+
+	double h = p_B[upper] - p_B[lower];
+	double t = (B - p_B[lower]) / h;
+	double t2 = t * t;
+	double t3 = t2 * t;
+
+	return	(2 * t3 - 3 * t2 + 1) * p_H[lower] + (t3 - 2 * t2 + t) * h * p_slope[lower] +
+			(-2 * t3 + 3 * t2) * p_H[upper] + (t3 - t2) * h * p_slope[upper];
+}
+
+
+
+void bhCurve::buildLookupTable(unsigned int tableSize)
+{
+	p_reluctivityTable.clear();
+	p_derivativeTable.clear();
+
+	if(p_B.size() < 2 || tableSize < 1)
+		return;
+
+	const double maxBsquared = p_B.back() * p_B.back();
+
+	p_tableStep = maxBsquared / tableSize;
+	p_inverseTableStep = 1.0 / p_tableStep;
+
+	p_reluctivityTable.resize(tableSize + 1);
+	p_derivativeTable.resize(tableSize + 1);
+
+	// At the origin, the reluctivity is the initial slope of the curve
+	p_reluctivityTable[0] = (p_slope[0] > 0) ? p_slope[0] : 1.0 / MU_0;
+
+	for(unsigned int i = 1; i <= tableSize; i++)
+	{
+		double B = std::sqrt(i * p_tableStep);
+		p_reluctivityTable[i] = evaluateSpline(B) / B;
+	}
+
+	for(unsigned int i = 0; i < tableSize; i++)
+		p_derivativeTable[i] = (p_reluctivityTable[i + 1] - p_reluctivityTable[i]) * p_inverseTableStep;
+
+	p_derivativeTable[tableSize] = p_derivativeTable[tableSize - 1];
+}
+
+
+
+void bhCurve::evaluateReluctivity(const double *Bsquared, double *reluctivity, double *derivative, unsigned int count) const
+{
+	const int lastInterval = (int)p_reluctivityTable.size() - 1;
+	const double tableEnd = lastInterval * p_tableStep;
+	const double *table = p_reluctivityTable.data();
+	const double *tableDerivative = p_derivativeTable.data();
+
+	for(unsigned int i = 0; i < count; i++)
+	{
+		const double b2 = Bsquared[i];
+
+		if(b2 < tableEnd)
+		{
+			double position = b2 * p_inverseTableStep;
+			int index = std::min((int)position, lastInterval - 1);
+			double fraction = position - index;
+
+			reluctivity[i] = table[index] + fraction * (table[index + 1] - table[index]);
+
+			if(derivative)
+				derivative[i] = tableDerivative[index];
+		}
+		else
+		{
+			// Past the last data point, the material is fully saturated and behaves like free space
+			double B = std::sqrt(b2);
+			double H = p_H.back() + (B - p_B.back()) / MU_0;
+
+			reluctivity[i] = H / B;
+
+			if(derivative)
+				derivative[i] = (B / MU_0 - H) / (2.0 * b2 * B);
+		}
+	}
+}
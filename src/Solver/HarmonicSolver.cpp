@@ -0,0 +1,707 @@
+#include <Solver/HarmonicSolver.h>
+
+
+/**
+ * @brief Computes the permeability of a lamination stack for fields along the laminations. The eddy currents in
+ * 			the laminations push the flux towards the surface of each lamination which reduces the effective
+ * 			permeability and introduces a loss component
+ * @param permeability The complex permeability of the lamination material in H/m
+ * @param conductivity The conductivity of the lamination material in S/m
+ * @param thickness The thickness of one lamination in m
+ * @param fillFactor The fraction of the stack that is filled by the lamination material
+ * @param omega The angular frequency in rad/s
+ * @return Returns the effective complex permeability of the stack in H/m
+ */
+static std::complex<double> laminationPermeability(std::complex<double> permeability, double conductivity, double thickness, double fillFactor, double omega)
+{
+	std::complex<double> laminationPart = permeability;
+
+	if(thickness > 0 && conductivity > 0 && omega > 0)
+	{
+		std::complex<double> x = 0.5 * thickness * std::sqrt(std::complex<double>(0, omega * conductivity) * permeability);
+
+		// For small arguments, tanh(x) / x approaches 1 and the direct formula looses all of its digits
+		if(std::abs(x) > 1.0e-4)
+			laminationPart = permeability * std::tanh(x) / x;
+		else
+			laminationPart = permeability * (1.0 - x * x / 3.0);
+	}
+
+	return fillFactor * laminationPart + (1.0 - fillFactor) * MU_0;
+}
+
+
+
+void harmonicSolver::computeRegionProperties()
+{
+	const double omega = 2.0 * M_PI * p_frequency;
+
+	p_regions.clear();
+
+	for(unsigned int i = 0; i < p_mesh->getNumberFaces(); i++)
+	{
+		magneticMaterial &material = p_faceMaterials[p_mesh->getFaceTag(i)];
+		harmonicRegion newRegion;
+
+		const double conductivity = material.getSigma() * 1.0e6;
+		double fillFactor = material.getLaminationFillFactor();
+
+		if(fillFactor <= 0 || fillFactor > 1)
+			fillFactor = 1.0;
+
+		if(!material.getBHState() && p_isVerbose)
+			OmniFEMMsg::instance()->MsgWarning("Material " + material.getName() + " is nonlinear. The linear permeability is used for the AC solve");
+
+		// The hysteresis lag angle is stored in degrees
+		std::complex<double> permeabilityX = MU_0 * std::polar((material.getMUrX() > 0) ? material.getMUrX() : 1.0, -material.getPhiX() * M_PI / 180.0);
+		std::complex<double> permeabilityY = MU_0 * std::polar((material.getMUrY() > 0) ? material.getMUrY() : 1.0, -material.getPhiY() * M_PI / 180.0);
+
+		newRegion.currentDensity = material.getCurrentDensity() * 1.0e6;
+		newRegion.firstElement = p_mesh->getFaceFirstElement(i);
+		newRegion.lastElement = p_mesh->getFaceLastElement(i);
+
+		switch(material.getSpecialAttribute())
+		{
+			case lamWireEnum::LAMINATED_IN_PLANE:
+			{
+				// The laminations are stacked along the depth of the problem. The eddy currents flow inside
+				// of each lamination and are accounted for by the complex permeability. There are no
+				// eddy currents in the out of plane direction
+				const double thickness = material.getLaminationThickness() * 1.0e-3;
+
+				newRegion.reluctivityX = 1.0 / laminationPermeability(permeabilityX, conductivity, thickness, fillFactor, omega);
+				newRegion.reluctivityY = 1.0 / laminationPermeability(permeabilityY, conductivity, thickness, fillFactor, omega);
+				newRegion.conductivity = 0;
+				break;
+			}
+			case lamWireEnum::LAMINATED_PARALLEL_X_OR_R_AXISYMMETRIC:
+				// Flux along the x-axis flows along the laminations and flux along the y-axis crosses the insulation
+				newRegion.reluctivityX = 1.0 / (fillFactor * permeabilityX + (1.0 - fillFactor) * MU_0);
+				newRegion.reluctivityY = fillFactor / permeabilityY + (1.0 - fillFactor) / MU_0;
+				newRegion.conductivity = fillFactor * conductivity;
+				break;
+			case lamWireEnum::LAMINATED_PARALLEL_Y_OR_Z_AXISYMMETRIC:
+				newRegion.reluctivityX = fillFactor / permeabilityX + (1.0 - fillFactor) / MU_0;
+				newRegion.reluctivityY = 1.0 / (fillFactor * permeabilityY + (1.0 - fillFactor) * MU_0);
+				newRegion.conductivity = fillFactor * conductivity;
+				break;
+			case lamWireEnum::MAGNET_WIRE:
+			case lamWireEnum::PLAIN_STRANDED_WIRE:
+			case lamWireEnum::LITZ_WIRE:
+			case lamWireEnum::SQUARE_WIRE:
+			case lamWireEnum::CCA_10:
+			case lamWireEnum::CCA_15:
+			{
+				// The winding carries the source current in insulated strands. The strands do not carry a net eddy current
+				// in the out of plane direction. The eddy currents that the field induces inside of each strand (proximity
+				// effect) are represented by an imaginary reluctivity. For a strand that is small compared to the skin depth,
+				// the loss density of a round strand is fill * sigma * omega^2 * d^2 * B^2 / 32. A square strand is treated
+				// as a lamination with a loss density of fill * sigma * omega^2 * d^2 * B^2 / 24
+				const double diameter = material.getStrandDiameter() * 1.0e-3;
+				const double lossCoefficient = (material.getSpecialAttribute() == lamWireEnum::SQUARE_WIRE) ? 12.0 : 16.0;
+
+				newRegion.reluctivityX = 1.0 / (fillFactor * permeabilityX + (1.0 - fillFactor) * MU_0);
+				newRegion.reluctivityY = 1.0 / (fillFactor * permeabilityY + (1.0 - fillFactor) * MU_0);
+				newRegion.conductivity = 0;
+				newRegion.wireConductivity = conductivity;
+				newRegion.fillFactor = fillFactor;
+
+				if(diameter > 0 && conductivity > 0 && omega > 0)
+				{
+					const std::complex<double> proximityTerm(0, fillFactor * conductivity * diameter * diameter * omega / lossCoefficient);
+
+					newRegion.reluctivityX += proximityTerm;
+					newRegion.reluctivityY += proximityTerm;
+
+					if(diameter > std::sqrt(2.0 / (omega * conductivity * MU_0)) && p_isVerbose)
+						OmniFEMMsg::instance()->MsgWarning("The strand diameter of material " + material.getName() + " is larger then the skin depth. The proximity losses are overestimated");
+				}
+
+				break;
+			}
+			default:
+				newRegion.reluctivityX = 1.0 / permeabilityX;
+				newRegion.reluctivityY = 1.0 / permeabilityY;
+				newRegion.conductivity = conductivity;
+				break;
+		}
+
+		newRegion.eddyCoefficient = omega * newRegion.conductivity;
+
+		p_regions.push_back(newRegion);
+	}
+}
+
+
+
+void harmonicSolver::computeElementMatrices()
+{
+	const std::vector<int> &nodeOffset = p_mesh->getElementNodeOffset();
+	const std::vector<int> &elementNodes = p_mesh->getElementNodes();
+	const std::vector<int> &pointOffset = p_mesh->getElementPointOffset();
+	const std::vector<int> &shapeOffset = p_mesh->getElementShapeOffset();
+	const std::vector<double> &pointWeight = p_mesh->getPointWeight();
+	const std::vector<double> &shapeValue = p_mesh->getShapeValue();
+	const std::vector<double> &gradientXValues = p_mesh->getGradientX();
+	const std::vector<double> &gradientYValues = p_mesh->getGradientY();
+	const std::vector<char> &isFixed = p_mesh->getIsFixed();
+	const unsigned int numberElements = p_mesh->getNumberElements();
+
+	p_integrals = std::make_shared<elementIntegrals>();
+	p_integrals->matrixOffset.assign(numberElements + 1, 0);
+
+	for(unsigned int i = 0; i < numberElements; i++)
+	{
+		const int numberShapeFunctions = nodeOffset[i + 1] - nodeOffset[i];
+		p_integrals->matrixOffset[i + 1] = p_integrals->matrixOffset[i] + numberShapeFunctions * numberShapeFunctions;
+	}
+
+	p_integrals->stiffnessX.assign(p_integrals->matrixOffset.back(), 0);
+	p_integrals->stiffnessY.assign(p_integrals->matrixOffset.back(), 0);
+	p_integrals->mass.assign(p_integrals->matrixOffset.back(), 0);
+	p_integrals->position.assign(p_integrals->matrixOffset.back(), -1);
+	p_integrals->load.assign(elementNodes.size(), 0);
+
+#if defined(_OPENMP)
+	#pragma omp parallel for schedule(static)
+#endif
+	for(int i = 0; i < (int)numberElements; i++)
+	{
+		const int firstNode = nodeOffset[i];
+		const int numberShapeFunctions = nodeOffset[i + 1] - firstNode;
+		const int firstEntry = p_integrals->matrixOffset[i];
+		double *stiffnessX = &p_integrals->stiffnessX[firstEntry];
+		double *stiffnessY = &p_integrals->stiffnessY[firstEntry];
+		double *mass = &p_integrals->mass[firstEntry];
+		double *load = &p_integrals->load[firstNode];
+		int shapePosition = shapeOffset[i];
+
+		for(int j = pointOffset[i]; j < pointOffset[i + 1]; j++)
+		{
+			const double *gradientX = &gradientXValues[shapePosition];
+			const double *gradientY = &gradientYValues[shapePosition];
+			const double *shape = &shapeValue[shapePosition];
+
+			for(int k = 0; k < numberShapeFunctions; k++)
+			{
+				const double weightX = pointWeight[j] * gradientX[k];
+				const double weightY = pointWeight[j] * gradientY[k];
+				const double weightShape = pointWeight[j] * shape[k];
+
+				load[k] += weightShape;
+
+				for(int m = 0; m < numberShapeFunctions; m++)
+				{
+					stiffnessX[k * numberShapeFunctions + m] += weightX * gradientX[m];
+					stiffnessY[k * numberShapeFunctions + m] += weightY * gradientY[m];
+					mass[k * numberShapeFunctions + m] += weightShape * shape[m];
+				}
+			}
+
+			shapePosition += numberShapeFunctions;
+		}
+
+		for(int k = 0; k < numberShapeFunctions; k++)
+		{
+			const int row = elementNodes[firstNode + k];
+
+			if(isFixed[row])
+				continue;
+
+			for(int m = 0; m < numberShapeFunctions; m++)
+				p_integrals->position[firstEntry + k * numberShapeFunctions + m] = p_matrix.getPosition(row, elementNodes[firstNode + m]);
+		}
+	}
+
+	// Nothing is assembled yet. The first assembly adds the full coefficients of every region
+	p_assembledRegions.clear();
+
+	for(unsigned int i = 0; i < p_mesh->getNumberFaces(); i++)
+	{
+		harmonicRegion emptyRegion;
+
+		emptyRegion.reluctivityX = 0;
+		emptyRegion.reluctivityY = 0;
+		emptyRegion.firstElement = p_mesh->getFaceFirstElement(i);
+		emptyRegion.lastElement = p_mesh->getFaceLastElement(i);
+
+		p_assembledRegions.push_back(emptyRegion);
+	}
+
+	p_matrix.zeroMatrix();
+	p_rightHandSide.assign(p_mesh->getNumberNodes(), 0);
+
+	for(unsigned int i = 0; i < p_mesh->getNumberNodes(); i++)
+	{
+		if(isFixed[i])
+		{
+			p_matrix.addToDiagonal(i, 1.0);
+			p_rightHandSide[i] = p_mesh->getFixedValue()[i];
+		}
+	}
+}
+
+
+
+void harmonicSolver::assemble()
+{
+	const std::vector<int> &nodeOffset = p_mesh->getElementNodeOffset();
+	const std::vector<int> &elementNodes = p_mesh->getElementNodes();
+	const std::vector<char> &isFixed = p_mesh->getIsFixed();
+	const std::vector<double> &fixedValue = p_mesh->getFixedValue();
+	const double scaleSquared = p_lengthScale * p_lengthScale;
+
+	std::vector<std::complex<double>> &values = p_matrix.getValues();
+
+	for(unsigned int i = 0; i < p_regions.size(); i++)
+	{
+		const harmonicRegion &region = p_regions[i];
+		harmonicRegion &assembledRegion = p_assembledRegions[i];
+
+		// The reluctivity in x multiplies the y-derivatives and the reluctivity in y multiplies the x-derivatives
+		const std::complex<double> deltaX = region.reluctivityY - assembledRegion.reluctivityY;
+		const std::complex<double> deltaY = region.reluctivityX - assembledRegion.reluctivityX;
+		const std::complex<double> deltaMass(0, (region.eddyCoefficient - assembledRegion.eddyCoefficient) * scaleSquared);
+		const double deltaSource = (region.currentDensity - assembledRegion.currentDensity) * scaleSquared;
+
+		if(deltaX == 0.0 && deltaY == 0.0 && deltaMass == 0.0 && deltaSource == 0)
+			continue;
+
+		for(unsigned int j = region.firstElement; j < region.lastElement; j++)
+		{
+			const int firstNode = nodeOffset[j];
+			const int numberShapeFunctions = nodeOffset[j + 1] - firstNode;
+			const int firstEntry = p_integrals->matrixOffset[j];
+
+			for(int k = 0; k < numberShapeFunctions; k++)
+			{
+				const int row = elementNodes[firstNode + k];
+
+				if(isFixed[row])
+					continue;
+
+				p_rightHandSide[row] += deltaSource * p_integrals->load[firstNode + k];
+
+				for(int m = 0; m < numberShapeFunctions; m++)
+				{
+					const int entry = firstEntry + k * numberShapeFunctions + m;
+					const std::complex<double> value = deltaX * p_integrals->stiffnessX[entry] + deltaY * p_integrals->stiffnessY[entry] + deltaMass * p_integrals->mass[entry];
+
+					// The columns of the fixed degrees of freedom are moved to the right hand side
+					if(p_integrals->position[entry] >= 0)
+						values[p_integrals->position[entry]] += value;
+					else
+						p_rightHandSide[row] -= value * fixedValue[elementNodes[firstNode + m]];
+				}
+			}
+		}
+
+		assembledRegion = region;
+	}
+}
+
+
+
+void harmonicSolver::createBlockMatrix()
+{
+	const std::vector<int> &rowPointer = p_matrix.getRowPointer();
+	const std::vector<int> &columnIndex = p_matrix.getColumnIndex();
+	const std::vector<std::complex<double>> &values = p_matrix.getValues();
+
+	if(p_blockMatrix.getSize() != 2 * p_matrix.getSize())
+	{
+		std::vector<std::vector<int>> rowColumns(2 * p_matrix.getSize());
+
+		for(unsigned int i = 0; i < p_matrix.getSize(); i++)
+		{
+			for(int j = rowPointer[i]; j < rowPointer[i + 1]; j++)
+			{
+				for(int k = 0; k < 2; k++)
+				{
+					rowColumns[2 * i + k].push_back(2 * columnIndex[j]);
+					rowColumns[2 * i + k].push_back(2 * columnIndex[j] + 1);
+				}
+			}
+		}
+
+		p_blockMatrix.createPattern(rowColumns);
+	}
+
+	// The real and imaginary part of each degree of freedom are interleaved. Every complex entry a + jb
+	// becomes the 2x2 block [a -b; b a]. Since the columns of the complex matrix are sorted, the entries of
+	// the block rows are in the same order
+	std::vector<double> &blockValues = p_blockMatrix.getValues();
+
+	for(unsigned int i = 0; i < p_matrix.getSize(); i++)
+	{
+		const int rowLength = 2 * (rowPointer[i + 1] - rowPointer[i]);
+		const int realRow = 4 * rowPointer[i];
+		const int imaginaryRow = realRow + rowLength;
+
+		for(int j = rowPointer[i]; j < rowPointer[i + 1]; j++)
+		{
+			const int offset = 2 * (j - rowPointer[i]);
+
+			blockValues[realRow + offset] = values[j].real();
+			blockValues[realRow + offset + 1] = -values[j].imag();
+			blockValues[imaginaryRow + offset] = values[j].imag();
+			blockValues[imaginaryRow + offset + 1] = values[j].real();
+		}
+	}
+}
+
+
+
+int harmonicSolver::solveBlockReal(double &residual)
+{
+	const unsigned int numberNodes = p_mesh->getNumberNodes();
+	std::vector<double> blockRightHandSide(2 * numberNodes);
+	std::vector<double> blockSolution(2 * numberNodes);
+
+	createBlockMatrix();
+	p_blockPreconditioner.compute(p_blockMatrix);
+
+	for(unsigned int i = 0; i < numberNodes; i++)
+	{
+		blockRightHandSide[2 * i] = p_rightHandSide[i].real();
+		blockRightHandSide[2 * i + 1] = p_rightHandSide[i].imag();
+		blockSolution[2 * i] = p_solution[i].real();
+		blockSolution[2 * i + 1] = p_solution[i].imag();
+	}
+
+	int iterations = biConjugateGradientStabilized(p_blockMatrix, blockRightHandSide, blockSolution, &p_blockPreconditioner,
+													p_tolerance, 20 * numberNodes + 200, residual);
+
+	if(iterations >= 0)
+	{
+		for(unsigned int i = 0; i < numberNodes; i++)
+			p_solution[i] = std::complex<double>(blockSolution[2 * i], blockSolution[2 * i + 1]);
+	}
+
+	return iterations;
+}
+
+
+
+void harmonicSolver::copySetup(const harmonicSolver &prototype)
+{
+	p_snapshot = prototype.p_snapshot;
+	p_faceMaterials = prototype.p_faceMaterials;
+	p_dirichletEdges = prototype.p_dirichletEdges;
+	p_lengthScale = prototype.p_lengthScale;
+	p_frequency = prototype.p_frequency;
+	p_solverMode = prototype.p_solverMode;
+	p_tolerance = prototype.p_tolerance;
+	p_reusePreconditioner = prototype.p_reusePreconditioner;
+	p_isMatrixFree = prototype.p_isMatrixFree;
+	p_useOperator = prototype.p_useOperator;
+	p_isSetup = prototype.p_isSetup;
+	p_regions = prototype.p_regions;
+	p_assembledRegions = prototype.p_assembledRegions;
+	p_mesh = prototype.p_mesh;
+	p_integrals = prototype.p_integrals;
+	p_matrix = prototype.p_matrix;
+	p_operator = prototype.p_operator;
+	p_rightHandSide = prototype.p_rightHandSide;
+	p_solution = prototype.p_solution;
+
+	// The preconditioners store pointers to the matrix of the prototype. They are recomputed on the first solve
+	p_preconditioner = iluPreconditioner<std::complex<double>>();
+	p_jacobiPreconditioner = jacobiPreconditioner<std::complex<double>>();
+	p_blockPreconditioner = iluPreconditioner<double>();
+	p_blockMatrix = sparseMatrix<double>();
+	p_baselineIterations = 0;
+}
+
+
+
+bool harmonicSolver::setup()
+{
+	if(!p_isSetup)
+	{
+		if(p_isVerbose)
+			OmniFEMMsg::instance()->MsgStatus("Creating the degree of freedom map");
+
+		std::vector<int> faceTags;
+		std::vector<std::vector<int>> rowColumns;
+
+		for(auto materialIterator = p_faceMaterials.begin(); materialIterator != p_faceMaterials.end(); materialIterator++)
+			faceTags.push_back(materialIterator->first);
+
+		// A new mesh object is created as the previous one might be shared with other solvers. The matrix free
+		// operator computes its own geometric factors
+		p_mesh = std::make_shared<solverMesh>(p_snapshot);
+		p_mesh->create(faceTags, true, !p_isMatrixFree);
+		p_mesh->applyBoundaryConditions(p_dirichletEdges);
+		p_useOperator = false;
+
+		if(p_isMatrixFree)
+		{
+			p_useOperator = p_operator.create(p_mesh, true);
+
+			if(!p_useOperator)
+			{
+				if(p_isVerbose)
+					OmniFEMMsg::instance()->MsgWarning("The mesh contains elements that are not supported by the matrix free mode. The system matrix is assembled");
+
+				p_mesh->create(faceTags, true);
+				p_mesh->applyBoundaryConditions(p_dirichletEdges);
+			}
+		}
+
+		if(p_useOperator)
+		{
+			p_matrix = sparseMatrix<std::complex<double>>();
+			p_integrals.reset();
+			p_assembledRegions.clear();
+		}
+		else
+		{
+			p_mesh->getMatrixPattern(rowColumns);
+			p_matrix.createPattern(rowColumns);
+			p_operator = matrixFreeOperator<std::complex<double>>();
+
+			computeElementMatrices();
+		}
+
+		p_jacobiPreconditioner = jacobiPreconditioner<std::complex<double>>();
+		p_preconditioner = iluPreconditioner<std::complex<double>>();
+		p_blockMatrix = sparseMatrix<double>();
+		p_solution.assign(p_mesh->getNumberNodes(), 0);
+		p_isSetup = true;
+	}
+
+	return p_mesh->getNumberNodes() > 0;
+}
+
+
+
+int harmonicSolver::solveComplex(double &residual)
+{
+	const int maxIterations = 10 * p_mesh->getNumberNodes() + 100;
+	int iterations = -1;
+
+	if(p_solverMode == complexSolverMode::COCG)
+	{
+		iterations = conjugateGradient(p_matrix, p_rightHandSide, p_solution, &p_preconditioner, p_tolerance, maxIterations, residual);
+
+		if(iterations < 0 && p_isVerbose)
+			OmniFEMMsg::instance()->MsgWarning("COCG did not converge. Residual: " + std::to_string(residual) + ". Trying BiCGStab");
+	}
+
+	if(iterations < 0)
+	{
+		iterations = biConjugateGradientStabilized(p_matrix, p_rightHandSide, p_solution, &p_preconditioner, p_tolerance, maxIterations, residual);
+
+		if(iterations < 0 && p_isVerbose)
+			OmniFEMMsg::instance()->MsgWarning("BiCGStab did not converge. Residual: " + std::to_string(residual));
+	}
+
+	return iterations;
+}
+
+
+
+void harmonicSolver::updateOperator()
+{
+	const double scaleSquared = p_lengthScale * p_lengthScale;
+	std::vector<std::complex<double>> diagonal;
+
+	// The reluctivity in x multiplies the y-derivatives and the reluctivity in y multiplies the x-derivatives
+	for(unsigned int i = 0; i < p_regions.size(); i++)
+	{
+		const harmonicRegion &region = p_regions[i];
+
+		p_operator.setRegionCoefficients(i, region.reluctivityY, region.reluctivityX, std::complex<double>(0, region.eddyCoefficient * scaleSquared),
+											region.currentDensity * scaleSquared);
+	}
+
+	p_operator.computeRightHandSide(p_rightHandSide);
+	p_operator.computeDiagonal(diagonal);
+	p_jacobiPreconditioner.compute(diagonal);
+}
+
+
+
+int harmonicSolver::solveMatrixFree(double &residual)
+{
+	const int maxIterations = 10 * p_mesh->getNumberNodes() + 100;
+	int iterations = -1;
+
+	if(p_solverMode != complexSolverMode::BICGSTAB)
+	{
+		iterations = conjugateGradient(p_operator, p_rightHandSide, p_solution, &p_jacobiPreconditioner, p_tolerance, maxIterations, residual);
+
+		if(iterations < 0 && p_isVerbose)
+			OmniFEMMsg::instance()->MsgWarning("COCG did not converge. Residual: " + std::to_string(residual) + ". Trying BiCGStab");
+	}
+
+	if(iterations < 0)
+		iterations = biConjugateGradientStabilized(p_operator, p_rightHandSide, p_solution, &p_jacobiPreconditioner, p_tolerance, maxIterations, residual);
+
+	return iterations;
+}
+
+
+
+bool harmonicSolver::solve()
+{
+	if(!setup())
+	{
+		if(p_isVerbose)
+			OmniFEMMsg::instance()->MsgError("No mesh elements with a material were found");
+
+		return false;
+	}
+
+	if(p_solution.size() != p_mesh->getNumberNodes())
+		p_solution.assign(p_mesh->getNumberNodes(), 0);
+
+	computeRegionProperties();
+
+	double residual = 1.0;
+	int iterations = -1;
+
+	if(p_useOperator)
+		updateOperator();
+	else
+		assemble();
+
+	if(p_useOperator)
+		iterations = solveMatrixFree(residual);
+	else if(p_solverMode != complexSolverMode::BLOCK_REAL)
+	{
+		std::vector<std::complex<double>> initialGuess(p_solution);
+		bool freshPreconditioner = false;
+
+		if(!p_reusePreconditioner || !p_preconditioner.isComputed() || p_baselineIterations == 0)
+		{
+			p_preconditioner.compute(p_matrix);
+			freshPreconditioner = true;
+		}
+
+		iterations = solveComplex(residual);
+
+		if(iterations < 0 && !freshPreconditioner)
+		{
+			// The stale preconditioner was not good enough. Try again with a fresh one
+			p_preconditioner.compute(p_matrix);
+			freshPreconditioner = true;
+			p_solution = initialGuess;
+			iterations = solveComplex(residual);
+		}
+
+		// The preconditioner is recomputed on the next solve once the linear solver
+		// needs much more iterations then it did with a fresh preconditioner
+		if(freshPreconditioner)
+			p_baselineIterations = std::max(iterations, 1);
+		else if(iterations > 2 * p_baselineIterations)
+			p_baselineIterations = 0;
+
+		if(iterations < 0)
+		{
+			if(p_isVerbose)
+				OmniFEMMsg::instance()->MsgWarning("Trying the equivalent real system");
+
+			p_solution = initialGuess;
+		}
+	}
+
+	if(iterations < 0 && !p_useOperator)
+		iterations = solveBlockReal(residual);
+
+	p_iterationsPerformed = iterations;
+
+	if(iterations < 0)
+	{
+		if(p_isVerbose)
+			OmniFEMMsg::instance()->MsgError("Linear solver did not converge. Residual: " + std::to_string(residual));
+
+		return false;
+	}
+
+	if(p_isVerbose)
+		OmniFEMMsg::instance()->MsgStatus("AC solve at " + std::to_string(p_frequency) + " Hz converged in " + std::to_string(iterations) + " iterations");
+
+	return true;
+}
+
+
+
+int harmonicSolver::evaluateElement(unsigned int element, double *weight, std::complex<double> *potential, std::complex<double> *dAdx, std::complex<double> *dAdy)
+{
+	if(p_useOperator)
+		return p_operator.evaluatePoints(element, p_solution, weight, potential, dAdx, dAdy);
+
+	const std::vector<int> &nodeOffset = p_mesh->getElementNodeOffset();
+	const std::vector<int> &elementNodes = p_mesh->getElementNodes();
+	const std::vector<int> &pointOffset = p_mesh->getElementPointOffset();
+	const std::vector<double> &pointWeight = p_mesh->getPointWeight();
+	const std::vector<double> &shapeValue = p_mesh->getShapeValue();
+	const std::vector<double> &gradientX = p_mesh->getGradientX();
+	const std::vector<double> &gradientY = p_mesh->getGradientY();
+	const int numberShapeFunctions = nodeOffset[element + 1] - nodeOffset[element];
+	int shapePosition = p_mesh->getElementShapeOffset()[element];
+
+	for(int k = 0; k < pointOffset[element + 1] - pointOffset[element]; k++)
+	{
+		weight[k] = pointWeight[pointOffset[element] + k];
+		potential[k] = 0;
+		dAdx[k] = 0;
+		dAdy[k] = 0;
+
+		for(int m = 0; m < numberShapeFunctions; m++)
+		{
+			const std::complex<double> value = p_solution[elementNodes[nodeOffset[element] + m]];
+			potential[k] += shapeValue[shapePosition + m] * value;
+			dAdx[k] += gradientX[shapePosition + m] * value;
+			dAdy[k] += gradientY[shapePosition + m] * value;
+		}
+
+		shapePosition += numberShapeFunctions;
+	}
+
+	return pointOffset[element + 1] - pointOffset[element];
+}
+
+
+
+double harmonicSolver::getLosses(int faceTag)
+{
+	const double scaleSquared = p_lengthScale * p_lengthScale;
+	const double omega = 2.0 * M_PI * p_frequency;
+	double weight[256];
+	std::complex<double> potential[256], dAdx[256], dAdy[256];
+	double losses = 0;
+
+	for(unsigned int i = 0; i < p_regions.size() && i < p_mesh->getNumberFaces(); i++)
+	{
+		if(p_mesh->getFaceTag(i) != faceTag)
+			continue;
+
+		const harmonicRegion &region = p_regions[i];
+
+		for(unsigned int j = region.firstElement; j < region.lastElement; j++)
+		{
+			const int numberPoints = evaluateElement(j, weight, potential, dAdx, dAdy);
+
+			for(int k = 0; k < numberPoints; k++)
+			{
+				// Magnetic losses of the homogenised materials. Bx = dA/dy and By = -dA/dx
+				double lossDensity = 0.5 * omega * (region.reluctivityX.imag() * std::norm(dAdy[k]) + region.reluctivityY.imag() * std::norm(dAdx[k])) / scaleSquared;
+
+				if(region.conductivity > 0)
+				{
+					const std::complex<double> currentDensity = region.currentDensity - std::complex<double>(0, omega * region.conductivity) * potential[k];
+					lossDensity += 0.5 * std::norm(currentDensity) / region.conductivity;
+				}
+				else if(region.wireConductivity > 0)
+					lossDensity += 0.5 * region.currentDensity * region.currentDensity / (region.wireConductivity * region.fillFactor);
+
+				losses += lossDensity * weight[k] * scaleSquared;
+			}
+		}
+	}
+
+	return losses;
+}
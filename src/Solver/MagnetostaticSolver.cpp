@@ -0,0 +1,423 @@
+#include <Solver/MagnetostaticSolver.h>
+
+
+void magnetostaticSolver::createRegions()
+{
+	std::vector<int> faceTags;
+
+	for(auto materialIterator = p_faceMaterials.begin(); materialIterator != p_faceMaterials.end(); materialIterator++)
+		faceTags.push_back(materialIterator->first);
+
+	p_mesh.create(faceTags, false);
+
+	p_regions.clear();
+
+	for(unsigned int i = 0; i < p_mesh.getNumberFaces(); i++)
+	{
+		magneticMaterial &material = p_faceMaterials[p_mesh.getFaceTag(i)];
+		solverRegion newRegion;
+
+		newRegion.currentDensity = material.getCurrentDensity() * 1.0e6;
+
+		if(!material.getBHState())
+		{
+			newRegion.isNonlinear = newRegion.curve.createFromJilesAtherton(material.getJilesAtherton());
+
+			if(newRegion.isNonlinear)
+				newRegion.curve.buildLookupTable();
+			else
+				OmniFEMMsg::instance()->MsgWarning("Material " + material.getName() + " has no valid B-H curve. Using the linear permeability");
+		}
+
+		if(material.getMUrX() > 0)
+			newRegion.reluctivityX = 1.0 / (MU_0 * material.getMUrX());
+
+		if(material.getMUrY() > 0)
+			newRegion.reluctivityY = 1.0 / (MU_0 * material.getMUrY());
+
+		newRegion.firstElement = p_mesh.getFaceFirstElement(i);
+		newRegion.lastElement = p_mesh.getFaceLastElement(i);
+
+		p_regions.push_back(newRegion);
+	}
+
+	const std::vector<int> &pointOffset = p_mesh.getElementPointOffset();
+	const unsigned int numberPoints = p_mesh.getNumberPoints();
+
+	p_Bsquared.assign(numberPoints, 0);
+	p_reluctivityX.assign(numberPoints, 1.0 / MU_0);
+	p_reluctivityY.assign(numberPoints, 1.0 / MU_0);
+	p_reluctivityDerivative.assign(numberPoints, 0);
+
+	for(auto regionIterator = p_regions.begin(); regionIterator != p_regions.end(); regionIterator++)
+	{
+		for(int j = pointOffset[regionIterator->firstElement]; j < pointOffset[regionIterator->lastElement]; j++)
+		{
+			p_reluctivityX[j] = regionIterator->reluctivityX;
+			p_reluctivityY[j] = regionIterator->reluctivityY;
+		}
+	}
+}
+
+
+
+void magnetostaticSolver::computeSource()
+{
+	const std::vector<int> &nodeOffset = p_mesh.getElementNodeOffset();
+	const std::vector<int> &elementNodes = p_mesh.getElementNodes();
+	const std::vector<int> &pointOffset = p_mesh.getElementPointOffset();
+	const std::vector<int> &shapeOffset = p_mesh.getElementShapeOffset();
+	const std::vector<double> &pointWeight = p_mesh.getPointWeight();
+	const std::vector<double> &shapeValue = p_mesh.getShapeValue();
+
+	// The source vector does not change between iterations
+	p_source.assign(p_mesh.getNumberNodes(), 0);
+
+	for(auto regionIterator = p_regions.begin(); regionIterator != p_regions.end(); regionIterator++)
+	{
+		if(regionIterator->currentDensity == 0)
+			continue;
+
+		for(unsigned int i = regionIterator->firstElement; i < regionIterator->lastElement; i++)
+		{
+			const int numberShapeFunctions = nodeOffset[i + 1] - nodeOffset[i];
+			int shapePosition = shapeOffset[i];
+
+			for(int j = pointOffset[i]; j < pointOffset[i + 1]; j++)
+			{
+				const double weight = pointWeight[j] * p_lengthScale * p_lengthScale * regionIterator->currentDensity;
+
+				for(int k = 0; k < numberShapeFunctions; k++)
+					p_source[elementNodes[nodeOffset[i] + k]] += weight * shapeValue[shapePosition + k];
+
+				shapePosition += numberShapeFunctions;
+			}
+		}
+	}
+}
+
+
+
+void magnetostaticSolver::updateReluctivity(const std::vector<double> &potential)
+{
+	const double inverseScaleSquared = 1.0 / (p_lengthScale * p_lengthScale);
+	const std::vector<int> &nodeOffset = p_mesh.getElementNodeOffset();
+	const std::vector<int> &elementNodes = p_mesh.getElementNodes();
+	const std::vector<int> &pointOffset = p_mesh.getElementPointOffset();
+	const std::vector<int> &shapeOffset = p_mesh.getElementShapeOffset();
+	const std::vector<double> &gradientXValues = p_mesh.getGradientX();
+	const std::vector<double> &gradientYValues = p_mesh.getGradientY();
+
+	for(auto regionIterator = p_regions.begin(); regionIterator != p_regions.end(); regionIterator++)
+	{
+		if(!regionIterator->isNonlinear)
+			continue;
+
+#if defined(_OPENMP)
+		#pragma omp parallel for schedule(static)
+#endif
+		for(int i = regionIterator->firstElement; i < (int)regionIterator->lastElement; i++)
+		{
+			const int firstNode = nodeOffset[i];
+			const int numberShapeFunctions = nodeOffset[i + 1] - firstNode;
+			int gradientPosition = shapeOffset[i];
+
+			for(int j = pointOffset[i]; j < pointOffset[i + 1]; j++)
+			{
+				double dAdx = 0;
+				double dAdy = 0;
+
+				for(int k = 0; k < numberShapeFunctions; k++)
+				{
+					const double value = potential[elementNodes[firstNode + k]];
+					dAdx += gradientXValues[gradientPosition + k] * value;
+					dAdy += gradientYValues[gradientPosition + k] * value;
+				}
+
+				p_Bsquared[j] = (dAdx * dAdx + dAdy * dAdy) * inverseScaleSquared;
+				gradientPosition += numberShapeFunctions;
+			}
+		}
+
+		// All of the integration points of the region are stored contiguously which means that the
+		// reluctivity of the entire region is computed in one pass over the lookup table
+		const int firstPoint = pointOffset[regionIterator->firstElement];
+		const int numberPoints = pointOffset[regionIterator->lastElement] - firstPoint;
+
+		regionIterator->curve.evaluateReluctivity(&p_Bsquared[firstPoint], &p_reluctivityX[firstPoint], &p_reluctivityDerivative[firstPoint], numberPoints);
+
+		std::copy(p_reluctivityX.begin() + firstPoint, p_reluctivityX.begin() + firstPoint + numberPoints, p_reluctivityY.begin() + firstPoint);
+	}
+}
+
+
+
+double magnetostaticSolver::assemble(const std::vector<double> &potential, bool assembleJacobian)
+{
+	const double inverseScaleSquared = 1.0 / (p_lengthScale * p_lengthScale);
+	double elementDerivativeX[256];
+	double elementDerivativeY[256];
+	double projection[256];
+	int rowPosition[256];
+	const std::vector<int> &nodeOffset = p_mesh.getElementNodeOffset();
+	const std::vector<int> &elementNodes = p_mesh.getElementNodes();
+	const std::vector<int> &pointOffset = p_mesh.getElementPointOffset();
+	const std::vector<int> &shapeOffset = p_mesh.getElementShapeOffset();
+	const std::vector<double> &pointWeight = p_mesh.getPointWeight();
+	const std::vector<double> &gradientXValues = p_mesh.getGradientX();
+	const std::vector<double> &gradientYValues = p_mesh.getGradientY();
+	const std::vector<char> &isFixed = p_mesh.getIsFixed();
+
+	updateReluctivity(potential);
+
+	if(assembleJacobian)
+		p_jacobian.zeroMatrix();
+
+	p_residual.assign(p_mesh.getNumberNodes(), 0);
+
+	std::vector<double> &values = p_jacobian.getValues();
+
+	for(auto regionIterator = p_regions.begin(); regionIterator != p_regions.end(); regionIterator++)
+	{
+		for(unsigned int i = regionIterator->firstElement; i < regionIterator->lastElement; i++)
+		{
+			const int firstNode = nodeOffset[i];
+			const int numberShapeFunctions = nodeOffset[i + 1] - firstNode;
+			int gradientPosition = shapeOffset[i];
+
+			for(int j = pointOffset[i]; j < pointOffset[i + 1]; j++)
+			{
+				const double *gradientX = &gradientXValues[gradientPosition];
+				const double *gradientY = &gradientYValues[gradientPosition];
+				double dAdx = 0;
+				double dAdy = 0;
+
+				for(int k = 0; k < numberShapeFunctions; k++)
+				{
+					const double value = potential[elementNodes[firstNode + k]];
+					dAdx += gradientX[k] * value;
+					dAdy += gradientY[k] * value;
+				}
+
+				const double weightX = pointWeight[j] * p_reluctivityX[j];
+				const double weightY = pointWeight[j] * p_reluctivityY[j];
+
+				for(int k = 0; k < numberShapeFunctions; k++)
+				{
+					elementDerivativeX[k] = weightY * gradientX[k];
+					elementDerivativeY[k] = weightX * gradientY[k];
+					p_residual[elementNodes[firstNode + k]] += elementDerivativeX[k] * dAdx + elementDerivativeY[k] * dAdy;
+				}
+
+				if(assembleJacobian)
+				{
+					const double tangent = 2.0 * pointWeight[j] * p_reluctivityDerivative[j] * inverseScaleSquared;
+
+					if(regionIterator->isNonlinear)
+					{
+						for(int k = 0; k < numberShapeFunctions; k++)
+							projection[k] = gradientX[k] * dAdx + gradientY[k] * dAdy;
+					}
+
+					for(int k = 0; k < numberShapeFunctions; k++)
+					{
+						const int row = elementNodes[firstNode + k];
+
+						if(isFixed[row])
+							continue;
+
+						if(j == pointOffset[i])
+						{
+							for(int m = 0; m < numberShapeFunctions; m++)
+								rowPosition[k * numberShapeFunctions + m] = p_jacobian.getPosition(row, elementNodes[firstNode + m]);
+						}
+
+						for(int m = 0; m < numberShapeFunctions; m++)
+						{
+							const int position = rowPosition[k * numberShapeFunctions + m];
+
+							if(position < 0)
+								continue;
+
+							double value = elementDerivativeX[k] * gradientX[m] + elementDerivativeY[k] * gradientY[m];
+
+							if(regionIterator->isNonlinear)
+								value += tangent * projection[k] * projection[m];
+
+							values[position] += value;
+						}
+					}
+				}
+
+				gradientPosition += numberShapeFunctions;
+			}
+		}
+	}
+
+	for(unsigned int i = 0; i < p_mesh.getNumberNodes(); i++)
+	{
+		if(isFixed[i])
+		{
+			p_residual[i] = 0;
+
+			if(assembleJacobian)
+				p_jacobian.addToDiagonal(i, 1.0);
+		}
+		else
+			p_residual[i] -= p_source[i];
+	}
+
+	return vectorNorm(p_residual);
+}
+
+
+
+bool magnetostaticSolver::solve()
+{
+	if(!p_isSetup)
+	{
+		OmniFEMMsg::instance()->MsgStatus("Creating the degree of freedom map");
+
+		std::vector<std::vector<int>> rowColumns;
+
+		createRegions();
+		computeSource();
+		p_mesh.applyBoundaryConditions(p_dirichletEdges);
+		p_mesh.getMatrixPattern(rowColumns);
+		p_jacobian.createPattern(rowColumns);
+
+		p_solution.assign(p_mesh.getNumberNodes(), 0);
+		p_isSetup = true;
+	}
+
+	const unsigned int numberNodes = p_mesh.getNumberNodes();
+	const std::vector<char> &isFixed = p_mesh.getIsFixed();
+	const std::vector<double> &fixedValue = p_mesh.getFixedValue();
+
+	if(numberNodes == 0)
+	{
+		OmniFEMMsg::instance()->MsgError("No mesh elements with a material were found");
+		return false;
+	}
+
+	for(unsigned int i = 0; i < numberNodes; i++)
+	{
+		if(isFixed[i])
+			p_solution[i] = fixedValue[i];
+	}
+
+	std::vector<double> update(numberNodes);
+	std::vector<double> trialSolution(numberNodes);
+	std::vector<double> rightHandSide(numberNodes);
+
+	double residualNorm = assemble(p_solution, true);
+	double referenceNorm = std::max(vectorNorm(p_source), residualNorm);
+	double relaxation = 1.0;
+	bool refreshPreconditioner = true;
+	int baselineLinearIterations = 0;
+	bool converged = false;
+
+	if(referenceNorm == 0)
+		referenceNorm = 1.0;
+
+	p_iterationsPerformed = 0;
+
+	for(unsigned int iteration = 1; iteration <= p_maxIterations; iteration++)
+	{
+		if(residualNorm / referenceNorm < p_tolerance)
+		{
+			converged = true;
+			break;
+		}
+
+		p_iterationsPerformed = iteration;
+
+		if(p_newtonMode == newtonMode::FULL_NEWTON || refreshPreconditioner || !p_preconditioner.isComputed())
+		{
+			p_preconditioner.compute(p_jacobian);
+			refreshPreconditioner = true;
+		}
+
+		for(unsigned int i = 0; i < numberNodes; i++)
+			rightHandSide[i] = -p_residual[i];
+
+		std::fill(update.begin(), update.end(), 0);
+
+		double linearResidual;
+		double linearTolerance = std::min(1.0e-2, 0.1 * p_tolerance * referenceNorm / residualNorm);
+		int linearIterations = conjugateGradient(p_jacobian, rightHandSide, update, &p_preconditioner, linearTolerance, 10 * numberNodes + 100, linearResidual);
+
+		if(linearIterations < 0 && !refreshPreconditioner)
+		{
+			// The stale preconditioner was not good enough. Try again with a fresh one
+			p_preconditioner.compute(p_jacobian);
+			refreshPreconditioner = true;
+			std::fill(update.begin(), update.end(), 0);
+			linearIterations = conjugateGradient(p_jacobian, rightHandSide, update, &p_preconditioner, linearTolerance, 10 * numberNodes + 100, linearResidual);
+		}
+
+		if(linearIterations < 0)
+		{
+			OmniFEMMsg::instance()->MsgError("Linear solver did not converge. Residual: " + std::to_string(linearResidual));
+			break;
+		}
+
+		// In the modified Newton mode, the preconditioner is kept as long as the linear solver
+		// does not need much more iterations then it did with a fresh preconditioner
+		if(refreshPreconditioner)
+			baselineLinearIterations = std::max(linearIterations, 1);
+
+		refreshPreconditioner = (linearIterations > 2 * baselineLinearIterations);
+
+		// Adaptive relaxation. The step is halved until the residual decreases. Only the residual is
+		// assembled for the trial steps, the Jacobian is assembled once a step is accepted
+		double trialNorm = residualNorm;
+
+		for(int attempt = 0; attempt < 8; attempt++)
+		{
+			for(unsigned int i = 0; i < numberNodes; i++)
+				trialSolution[i] = p_solution[i] + relaxation * update[i];
+
+			trialNorm = assemble(trialSolution, false);
+
+			if(trialNorm < residualNorm || relaxation < 0.01)
+				break;
+
+			relaxation *= 0.5;
+		}
+
+		if(trialNorm >= residualNorm)
+			OmniFEMMsg::instance()->MsgWarning("Newton iteration " + std::to_string(iteration) + ": the residual did not decrease with a relaxation of " +
+												std::to_string(relaxation) + ". The step is accepted with a larger residual");
+
+		p_solution.swap(trialSolution);
+
+		double updateNorm = relaxation * vectorNorm(update);
+		double solutionNorm = vectorNorm(p_solution);
+
+		OmniFEMMsg::instance()->MsgStatus("Newton iteration " + std::to_string(iteration) + ": residual " + std::to_string(trialNorm / referenceNorm) +
+											", relaxation " + std::to_string(relaxation) + ", linear iterations " + std::to_string(linearIterations));
+
+		// Once the residual decreases again, the relaxation factor is grown back towards a full Newton step
+		if(trialNorm < residualNorm)
+			relaxation = std::min(1.0, 2.0 * relaxation);
+
+		residualNorm = trialNorm;
+
+		if(residualNorm / referenceNorm < p_tolerance || (solutionNorm > 0 && updateNorm / solutionNorm < 0.01 * p_tolerance))
+		{
+			converged = true;
+			break;
+		}
+
+		if(iteration < p_maxIterations)
+			residualNorm = assemble(p_solution, true);
+	}
+
+	if(converged)
+		OmniFEMMsg::instance()->MsgStatus("Solver converged in " + std::to_string(p_iterationsPerformed) + " iterations");
+	else
+		OmniFEMMsg::instance()->MsgError("Solver did not converge in " + std::to_string(p_maxIterations) + " iterations");
+
+	return converged;
+}
@@ -0,0 +1,181 @@
+#include <Solver/ParameterSweep.h>
+
+#if defined(_OPENMP)
+#include <omp.h>
+#endif
+
+
+void parameterSweep::applyParameter(harmonicSolver &solver, double value)
+{
+	if(p_parameter == sweepParameter::FREQUENCY)
+	{
+		solver.setFrequency(value);
+		return;
+	}
+
+	auto materialIterator = p_faceMaterials.find(p_sweepFace);
+
+	if(materialIterator == p_faceMaterials.end())
+		return;
+
+	magneticMaterial material = materialIterator->second;
+
+	switch(p_parameter)
+	{
+		case sweepParameter::CURRENT_DENSITY:
+			material.setCurrentDensity(value);
+			break;
+		case sweepParameter::CONDUCTIVITY:
+			material.setSigma(value);
+			break;
+		case sweepParameter::RELATIVE_PERMEABILITY:
+			material.setMUrX(value);
+			material.setMUrY(value);
+			break;
+		default:
+			break;
+	}
+
+	solver.setFaceMaterial(p_sweepFace, material);
+}
+
+
+
+void parameterSweep::writeSolution(harmonicSolver &solver, std::string filePath)
+{
+	std::ofstream solutionFile(filePath);
+	const solverMesh &mesh = solver.getMesh();
+	const std::vector<std::complex<double>> &solution = solver.getSolution();
+
+	solutionFile.precision(12);
+	solutionFile << "# x y real(A) imag(A)\n";
+
+	for(unsigned int i = 0; i < mesh.getNumberNodes(); i++)
+		solutionFile << mesh.getNodeX()[i] << " " << mesh.getNodeY()[i] << " " << solution[i].real() << " " << solution[i].imag() << "\n";
+}
+
+
+
+bool parameterSweep::run(std::string outputPath)
+{
+	if(p_values.size() == 0)
+		return true;
+
+	if(p_parameter != sweepParameter::FREQUENCY && p_faceMaterials.find(p_sweepFace) == p_faceMaterials.end())
+	{
+		OmniFEMMsg::instance()->MsgError("The face of the parameter sweep has no material");
+		return false;
+	}
+
+	std::ofstream outputFile(outputPath);
+
+	if(!outputFile.is_open())
+	{
+		OmniFEMMsg::instance()->MsgError("Unable to open " + outputPath);
+		return false;
+	}
+
+	// The prototype creates the degree of freedom map, the sparsity pattern and the element integrals once
+	harmonicSolver prototype(p_snapshot);
+
+	for(auto materialIterator = p_faceMaterials.begin(); materialIterator != p_faceMaterials.end(); materialIterator++)
+		prototype.setFaceMaterial(materialIterator->first, materialIterator->second);
+
+	for(auto edgeIterator = p_dirichletEdges.begin(); edgeIterator != p_dirichletEdges.end(); edgeIterator++)
+		prototype.setDirichletEdge(edgeIterator->first, edgeIterator->second);
+
+	prototype.setLengthScale(p_lengthScale);
+	prototype.setFrequency(p_frequency);
+	prototype.setReusePreconditioner(true);
+
+	if(!prototype.setup())
+	{
+		OmniFEMMsg::instance()->MsgError("No mesh elements with a material were found");
+		return false;
+	}
+
+	const solverMesh &mesh = prototype.getMesh();
+
+	outputFile.precision(12);
+	outputFile << "# index value converged iterations";
+
+	for(unsigned int i = 0; i < mesh.getNumberFaces(); i++)
+		outputFile << " loss_face_" << mesh.getFaceTag(i);
+
+	outputFile << "\n";
+	outputFile.flush();
+
+	const int numberBlocks = (p_values.size() + p_blockSize - 1) / p_blockSize;
+	int numberThreads = 1;
+	int pointsFailed = 0;
+
+#if defined(_OPENMP)
+	numberThreads = (p_numberThreads > 0) ? p_numberThreads : omp_get_max_threads();
+#endif
+
+	numberThreads = std::max(1, std::min(numberThreads, numberBlocks));
+
+	OmniFEMMsg::instance()->MsgStatus("Solving " + std::to_string(p_values.size()) + " sweep points on " + std::to_string(numberThreads) + " threads");
+
+	// Each thread creates one solver and keeps it for all of the blocks that it solves. The solution and the
+	// preconditioner of the previous point are carried over to the next point
+#if defined(_OPENMP)
+	#pragma omp parallel num_threads(numberThreads) reduction(+:pointsFailed)
+#endif
+	{
+		harmonicSolver worker(p_snapshot);
+
+		worker.copySetup(prototype);
+		worker.setVerbose(false);
+
+#if defined(_OPENMP)
+		#pragma omp for schedule(dynamic, 1)
+#endif
+		for(int block = 0; block < numberBlocks; block++)
+		{
+			const unsigned int firstPoint = block * p_blockSize;
+			const unsigned int lastPoint = std::min<unsigned int>(firstPoint + p_blockSize, p_values.size());
+
+			for(unsigned int point = firstPoint; point < lastPoint; point++)
+			{
+				applyParameter(worker, p_values[point]);
+
+				bool converged = worker.solve();
+				char pointValue[32];
+
+				snprintf(pointValue, sizeof(pointValue), "%.12g", p_values[point]);
+
+				std::string resultLine = std::to_string(point) + " " + pointValue + " " + std::to_string((int)converged) + " " +
+											std::to_string(worker.getNumberIterations());
+
+				if(!converged)
+					pointsFailed++;
+
+				for(unsigned int i = 0; i < mesh.getNumberFaces(); i++)
+				{
+					char lossValue[32];
+					snprintf(lossValue, sizeof(lossValue), " %.12g", converged ? worker.getLosses(mesh.getFaceTag(i)) : 0.0);
+					resultLine += lossValue;
+				}
+
+				if(p_writeSolutions && converged)
+					writeSolution(worker, outputPath + "_" + std::to_string(point) + ".txt");
+
+#if defined(_OPENMP)
+				#pragma omp critical(sweepOutput)
+#endif
+				{
+					outputFile << resultLine << "\n";
+					outputFile.flush();
+				}
+			}
+		}
+	}
+
+	if(pointsFailed > 0)
+		OmniFEMMsg::instance()->MsgError(std::to_string(pointsFailed) + " of " + std::to_string(p_values.size()) + " sweep points did not converge");
+	else
+		OmniFEMMsg::instance()->MsgStatus("Parameter sweep finished. The results are written to " + outputPath);
+
+	return pointsFailed == 0;
+}
@@ -0,0 +1,61 @@
+#include <Solver/ReferenceElement.h>
+
+
+referenceElement::referenceElement(int elementType, int integrationOrder)
+{
+	const nodalBasis *basis = BasisFactory::getNodalBasis(elementType);
+	const bool isTriangle = (ElementType::ParentTypeFromTag(elementType) == TYPE_TRI);
+	IntPt *points = isTriangle ? getGQTPts(integrationOrder) : getGQQPts(integrationOrder);
+	double gradients[256][3];
+
+	p_elementType = elementType;
+	p_numberShapeFunctions = basis->getNumShapeFunctions();
+	p_numberPoints = isTriangle ? getNGQTPts(integrationOrder) : getNGQQPts(integrationOrder);
+
+	p_weight.resize(p_numberPoints);
+	p_shapeValue.resize(p_numberPoints * p_numberShapeFunctions);
+	p_gradientU.resize(p_numberPoints * p_numberShapeFunctions);
+	p_gradientV.resize(p_numberPoints * p_numberShapeFunctions);
+
+	for(int i = 0; i < p_numberPoints; i++)
+	{
+		p_weight[i] = points[i].weight;
+
+		basis->f(points[i].pt[0], points[i].pt[1], points[i].pt[2], &p_shapeValue[i * p_numberShapeFunctions]);
+		basis->df(points[i].pt[0], points[i].pt[1], points[i].pt[2], gradients);
+
+		for(int j = 0; j < p_numberShapeFunctions; j++)
+		{
+			p_gradientU[i * p_numberShapeFunctions + j] = gradients[j][0];
+			p_gradientV[i * p_numberShapeFunctions + j] = gradients[j][1];
+		}
+	}
+}
+
+
+
+const referenceElement *referenceElement::get(int elementType, int integrationOrder)
+{
+	static std::map<std::pair<int, int>, referenceElement*> elementTables;
+	referenceElement *table = nullptr;
+
+	if(!isSupported(elementType))
+		return nullptr;
+
+	// The tables are created once. The nodal bases of GMSH are created on demand as well which is why
+	// the creation is done inside of the critical section
+#if defined(_OPENMP)
+	#pragma omp critical(referenceElementTables)
+#endif
+	{
+		std::pair<int, int> key(elementType, integrationOrder);
+		auto tableIterator = elementTables.find(key);
+
+		if(tableIterator == elementTables.end())
+			tableIterator = elementTables.insert(std::make_pair(key, new referenceElement(elementType, integrationOrder))).first;
+
+		table = tableIterator->second;
+	}
+
+	return table;
+}
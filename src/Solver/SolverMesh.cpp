@@ -0,0 +1,378 @@
+#include <Solver/SolverMesh.h>
+
+
+void solverMesh::create(const std::vector<int> &faceTags, bool exactMass, bool computeFactors)
+{
+	const std::vector<meshSnapshot::snapshotEntity> &entities = p_snapshot->getEntities();
+
+	p_faceTags.clear();
+
+	for(auto tagIterator = faceTags.begin(); tagIterator != faceTags.end(); tagIterator++)
+	{
+		int entity = p_snapshot->findEntity(2, *tagIterator);
+
+		if(entity >= 0 && entities[entity].numberElements > 0)
+			p_faceTags.push_back(*tagIterator);
+	}
+
+	createDOFMap();
+
+	if(computeFactors)
+		computeGeometricFactors(exactMass);
+	else
+	{
+		p_elementPointOffset.clear();
+		p_elementShapeOffset.clear();
+		p_pointWeight.clear();
+		p_shapeValue.clear();
+		p_gradientX.clear();
+		p_gradientY.clear();
+	}
+
+	p_isFixed.assign(p_nodeX.size(), 0);
+	p_fixedValue.assign(p_nodeX.size(), 0);
+}
+
+
+
+void solverMesh::createDOFMap()
+{
+	const std::vector<meshSnapshot::snapshotEntity> &entities = p_snapshot->getEntities();
+	const double *snapshotX = p_snapshot->getNodeX();
+	const double *snapshotY = p_snapshot->getNodeY();
+
+	p_nodeX.clear();
+	p_nodeY.clear();
+	p_nodeIndex.assign(p_snapshot->getNumberNodes(), -1);
+	p_elements.clear();
+	p_elementType.clear();
+	p_faceElementOffset.assign(1, 0);
+	p_elementNodeOffset.assign(1, 0);
+	p_elementNodes.clear();
+
+	for(auto tagIterator = p_faceTags.begin(); tagIterator != p_faceTags.end(); tagIterator++)
+	{
+		const meshSnapshot::snapshotEntity &face = entities[p_snapshot->findEntity(2, *tagIterator)];
+
+		for(unsigned int i = face.firstElement; i < face.firstElement + face.numberElements; i++)
+		{
+			const meshSnapshot::snapshotElementType &type = p_snapshot->getElementType(i);
+			const unsigned int *nodes = p_snapshot->getElementNodes(i);
+
+			for(int j = 0; j < type.numberNodes; j++)
+			{
+				// Edges that are shared between faces are duplicated in the GMSH geometry. The coincident
+				// nodes of the duplicated edges share the degree of freedom of the first node at their position
+				const unsigned int sharedNode = p_snapshot->getSharedNode(nodes[j]);
+
+				if(p_nodeIndex[sharedNode] < 0)
+				{
+					p_nodeIndex[sharedNode] = p_nodeX.size();
+					p_nodeX.push_back(snapshotX[sharedNode]);
+					p_nodeY.push_back(snapshotY[sharedNode]);
+				}
+
+				p_nodeIndex[nodes[j]] = p_nodeIndex[sharedNode];
+				p_elementNodes.push_back(p_nodeIndex[sharedNode]);
+			}
+
+			p_elements.push_back(i);
+			p_elementType.push_back(type.mshType);
+			p_elementNodeOffset.push_back(p_elementNodes.size());
+		}
+
+		p_faceElementOffset.push_back(p_elements.size());
+	}
+
+	// The nodes of the duplicated edges of the faces that are not part of the mesh can still coincide with a degree of freedom
+	for(unsigned int i = 0; i < p_nodeIndex.size(); i++)
+	{
+		if(p_nodeIndex[i] < 0)
+			p_nodeIndex[i] = p_nodeIndex[p_snapshot->getSharedNode(i)];
+	}
+}
+
+
+
+void solverMesh::computeBatchFactors(const referenceElement *table, const unsigned int *elementIndices, int count, double *factors) const
+{
+	const int numberShapeFunctions = table->getNumberShapeFunctions();
+	const double *referenceWeight = table->getWeight();
+	double x[MAX_BATCH_NODES * ELEMENT_BATCH_SIZE];
+	double y[MAX_BATCH_NODES * ELEMENT_BATCH_SIZE];
+	double dxdu[ELEMENT_BATCH_SIZE], dydu[ELEMENT_BATCH_SIZE], dxdv[ELEMENT_BATCH_SIZE], dydv[ELEMENT_BATCH_SIZE];
+
+	// The coordinates are stored node major so that the loops over the elements of the batch have unit stride.
+	// Unused slots of a partial batch are filled with the coordinates of the first element
+	for(int b = 0; b < ELEMENT_BATCH_SIZE; b++)
+	{
+		const int *nodes = &p_elementNodes[p_elementNodeOffset[elementIndices[(b < count) ? b : 0]]];
+
+		for(int k = 0; k < numberShapeFunctions; k++)
+		{
+			x[k * ELEMENT_BATCH_SIZE + b] = p_nodeX[nodes[k]];
+			y[k * ELEMENT_BATCH_SIZE + b] = p_nodeY[nodes[k]];
+		}
+	}
+
+	for(int q = 0; q < table->getNumberPoints(); q++)
+	{
+		const double *gradientU = table->getGradientU(q);
+		const double *gradientV = table->getGradientV(q);
+		double *pointFactors = &factors[q * GEOMETRIC_FACTOR_COUNT * ELEMENT_BATCH_SIZE];
+
+		for(int b = 0; b < ELEMENT_BATCH_SIZE; b++)
+		{
+			dxdu[b] = 0;
+			dydu[b] = 0;
+			dxdv[b] = 0;
+			dydv[b] = 0;
+		}
+
+		for(int k = 0; k < numberShapeFunctions; k++)
+		{
+			const double *nodeX = &x[k * ELEMENT_BATCH_SIZE];
+			const double *nodeY = &y[k * ELEMENT_BATCH_SIZE];
+
+			for(int b = 0; b < ELEMENT_BATCH_SIZE; b++)
+			{
+				dxdu[b] += gradientU[k] * nodeX[b];
+				dydu[b] += gradientU[k] * nodeY[b];
+				dxdv[b] += gradientV[k] * nodeX[b];
+				dydv[b] += gradientV[k] * nodeY[b];
+			}
+		}
+
+		for(int b = 0; b < ELEMENT_BATCH_SIZE; b++)
+		{
+			const double determinant = dxdu[b] * dydv[b] - dydu[b] * dxdv[b];
+			const double inverseDeterminant = (determinant != 0) ? 1.0 / determinant : 0;
+
+			pointFactors[b] = referenceWeight[q] * std::fabs(determinant);
+			pointFactors[ELEMENT_BATCH_SIZE + b] = dydv[b] * inverseDeterminant;
+			pointFactors[2 * ELEMENT_BATCH_SIZE + b] = -dydu[b] * inverseDeterminant;
+			pointFactors[3 * ELEMENT_BATCH_SIZE + b] = -dxdv[b] * inverseDeterminant;
+			pointFactors[4 * ELEMENT_BATCH_SIZE + b] = dxdu[b] * inverseDeterminant;
+		}
+	}
+}
+
+
+
+void solverMesh::computeElementBatch(const referenceElement *table, const unsigned int *elementIndices, int count)
+{
+	const int numberShapeFunctions = table->getNumberShapeFunctions();
+	std::vector<double> factors(table->getNumberPoints() * GEOMETRIC_FACTOR_COUNT * ELEMENT_BATCH_SIZE);
+
+	computeBatchFactors(table, elementIndices, count, factors.data());
+
+	for(int q = 0; q < table->getNumberPoints(); q++)
+	{
+		const double *gradientU = table->getGradientU(q);
+		const double *gradientV = table->getGradientV(q);
+		const double *shapeValue = table->getShapeValue(q);
+		const double *pointFactors = &factors[q * GEOMETRIC_FACTOR_COUNT * ELEMENT_BATCH_SIZE];
+
+		for(int b = 0; b < count; b++)
+		{
+			const unsigned int element = elementIndices[b];
+			const int shapePosition = p_elementShapeOffset[element] + q * numberShapeFunctions;
+			const double inverse00 = pointFactors[ELEMENT_BATCH_SIZE + b];
+			const double inverse01 = pointFactors[2 * ELEMENT_BATCH_SIZE + b];
+			const double inverse10 = pointFactors[3 * ELEMENT_BATCH_SIZE + b];
+			const double inverse11 = pointFactors[4 * ELEMENT_BATCH_SIZE + b];
+
+			p_pointWeight[p_elementPointOffset[element] + q] = pointFactors[b];
+
+			for(int k = 0; k < numberShapeFunctions; k++)
+			{
+				p_shapeValue[shapePosition + k] = shapeValue[k];
+				p_gradientX[shapePosition + k] = inverse00 * gradientU[k] + inverse01 * gradientV[k];
+				p_gradientY[shapePosition + k] = inverse10 * gradientU[k] + inverse11 * gradientV[k];
+			}
+		}
+	}
+}
+
+
+
+void solverMesh::computeGeometricFactors(bool exactMass)
+{
+	const unsigned int numberElements = p_elements.size();
+	std::map<const referenceElement*, std::vector<unsigned int>> elementGroups;
+	std::vector<unsigned int> largeElements;
+	unsigned int numberUnsupported = 0;
+
+	p_elementPointOffset.assign(numberElements + 1, 0);
+	p_elementShapeOffset.assign(numberElements + 1, 0);
+
+	// The number of integration points of every element is known up front. This allows the
+	// geometric factors of the elements to be computed in any order
+	for(unsigned int i = 0; i < numberElements; i++)
+	{
+		const referenceElement *table = referenceElement::get(p_elementType[i], getIntegrationOrder(p_elementType[i], exactMass));
+		int numberPoints = 0;
+		int numberShapeFunctions = 0;
+
+		if(table)
+		{
+			numberPoints = table->getNumberPoints();
+			numberShapeFunctions = table->getNumberShapeFunctions();
+
+			if(numberShapeFunctions <= MAX_BATCH_NODES)
+				elementGroups[table].push_back(i);
+			else
+				largeElements.push_back(i);
+		}
+		else
+			numberUnsupported++;
+
+		p_elementPointOffset[i + 1] = p_elementPointOffset[i] + numberPoints;
+		p_elementShapeOffset[i + 1] = p_elementShapeOffset[i] + numberPoints * numberShapeFunctions;
+	}
+
+	if(numberUnsupported > 0)
+		OmniFEMMsg::instance()->MsgWarning(std::to_string(numberUnsupported) + " elements are not triangles or quadrangles and are not solved");
+
+	p_pointWeight.resize(p_elementPointOffset.back());
+	p_shapeValue.resize(p_elementShapeOffset.back());
+	p_gradientX.resize(p_elementShapeOffset.back());
+	p_gradientY.resize(p_elementShapeOffset.back());
+
+	// The elements of the same type are processed in batches with the tables of the reference element
+	for(auto groupIterator = elementGroups.begin(); groupIterator != elementGroups.end(); groupIterator++)
+	{
+		const std::vector<unsigned int> &group = groupIterator->second;
+		const int numberBatches = (group.size() + ELEMENT_BATCH_SIZE - 1) / ELEMENT_BATCH_SIZE;
+
+#if defined(_OPENMP)
+		#pragma omp parallel for schedule(static)
+#endif
+		for(int i = 0; i < numberBatches; i++)
+		{
+			const int count = std::min<int>(ELEMENT_BATCH_SIZE, group.size() - i * ELEMENT_BATCH_SIZE);
+			computeElementBatch(groupIterator->first, &group[i * ELEMENT_BATCH_SIZE], count);
+		}
+	}
+
+	// The elements with more nodes then a batch can hold are evaluated one at a time
+	for(auto elementIterator = largeElements.begin(); elementIterator != largeElements.end(); elementIterator++)
+	{
+		const unsigned int element = *elementIterator;
+		const referenceElement *table = referenceElement::get(p_elementType[element], getIntegrationOrder(p_elementType[element], exactMass));
+		const int numberShapeFunctions = table->getNumberShapeFunctions();
+		const int *nodes = &p_elementNodes[p_elementNodeOffset[element]];
+		int shapePosition = p_elementShapeOffset[element];
+
+		for(int q = 0; q < table->getNumberPoints(); q++)
+		{
+			const double *gradientU = table->getGradientU(q);
+			const double *gradientV = table->getGradientV(q);
+			const double *shapeValue = table->getShapeValue(q);
+			double dxdu = 0, dydu = 0, dxdv = 0, dydv = 0;
+
+			for(int k = 0; k < numberShapeFunctions; k++)
+			{
+				dxdu += gradientU[k] * p_nodeX[nodes[k]];
+				dydu += gradientU[k] * p_nodeY[nodes[k]];
+				dxdv += gradientV[k] * p_nodeX[nodes[k]];
+				dydv += gradientV[k] * p_nodeY[nodes[k]];
+			}
+
+			const double determinant = dxdu * dydv - dydu * dxdv;
+			const double inverseDeterminant = (determinant != 0) ? 1.0 / determinant : 0;
+
+			p_pointWeight[p_elementPointOffset[element] + q] = table->getWeight()[q] * std::fabs(determinant);
+
+			for(int k = 0; k < numberShapeFunctions; k++)
+			{
+				p_shapeValue[shapePosition] = shapeValue[k];
+				p_gradientX[shapePosition] = (dydv * gradientU[k] - dydu * gradientV[k]) * inverseDeterminant;
+				p_gradientY[shapePosition] = (-dxdv * gradientU[k] + dxdu * gradientV[k]) * inverseDeterminant;
+				shapePosition++;
+			}
+		}
+	}
+}
+
+
+
+void solverMesh::applyBoundaryConditions(const std::map<int, double> &dirichletEdges)
+{
+	const std::vector<meshSnapshot::snapshotEntity> &entities = p_snapshot->getEntities();
+
+	p_isFixed.assign(p_nodeX.size(), 0);
+	p_fixedValue.assign(p_nodeX.size(), 0);
+
+	if(dirichletEdges.size() > 0)
+	{
+		for(auto edgeIterator = dirichletEdges.begin(); edgeIterator != dirichletEdges.end(); edgeIterator++)
+		{
+			int entity = p_snapshot->findEntity(1, edgeIterator->first);
+
+			if(entity < 0)
+				continue;
+
+			for(unsigned int i = entities[entity].firstElement; i < entities[entity].firstElement + entities[entity].numberElements; i++)
+			{
+				const unsigned int *nodes = p_snapshot->getElementNodes(i);
+
+				for(int j = 0; j < p_snapshot->getElementType(i).numberNodes; j++)
+				{
+					int index = p_nodeIndex[nodes[j]];
+
+					if(index >= 0)
+					{
+						p_isFixed[index] = 1;
+						p_fixedValue[index] = edgeIterator->second;
+					}
+				}
+			}
+		}
+	}
+	else
+	{
+		const std::vector<meshSnapshot::snapshotBoundaryEdge> &boundaryEdges = p_snapshot->getBoundaryEdges();
+
+		for(auto edgeIterator = boundaryEdges.begin(); edgeIterator != boundaryEdges.end(); edgeIterator++)
+		{
+			if(!edgeIterator->isOuter)
+				continue;
+
+			const unsigned int *nodes = p_snapshot->getElementNodes(edgeIterator->element);
+
+			for(int j = 0; j < p_snapshot->getElementType(edgeIterator->element).numberNodes; j++)
+			{
+				int index = p_nodeIndex[nodes[j]];
+
+				if(index >= 0)
+					p_isFixed[index] = 1;
+			}
+		}
+	}
+}
+
+
+
+void solverMesh::getMatrixPattern(std::vector<std::vector<int>> &rowColumns) const
+{
+	rowColumns.assign(p_nodeX.size(), std::vector<int>());
+
+	for(unsigned int i = 0; i < p_elements.size(); i++)
+	{
+		for(int j = p_elementNodeOffset[i]; j < p_elementNodeOffset[i + 1]; j++)
+		{
+			int row = p_elementNodes[j];
+
+			if(p_isFixed[row])
+				continue;
+
+			for(int k = p_elementNodeOffset[i]; k < p_elementNodeOffset[i + 1]; k++)
+			{
+				if(!p_isFixed[p_elementNodes[k]])
+					rowColumns[row].push_back(p_elementNodes[k]);
+			}
+		}
+	}
+}
+
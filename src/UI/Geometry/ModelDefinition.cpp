@@ -45,11 +45,7 @@ void modelDefinition::deleteSelection()
     {
         if(nodeIterator->getIsSelectedState())
         {
-			// Check to make sure that the mesh exists before deleting it
-			if(p_modelMesh->getNumMeshVertices() > 0)
-			{
-				deleteMesh();
-			}
+			geometryChanged();
 			
             /* Need to cycle through the entire line list and arc list in order to determine which arc/line the node is associated with and delete that arc/line by selecting i.
              * The deletion of the arc/line occurs later in the code*/
@@ -97,11 +93,7 @@ void modelDefinition::deleteSelection()
     {
         if(arcIterator->getIsSelectedState())
         {
-			// Check to make sure that the mesh exists before deleting it
-			if(p_modelMesh->getNumMeshVertices() > 0)
-			{
-				deleteMesh();
-			}
+			geometryChanged();
 			
             if(arcIterator == _editor.getArcList()->back())
             {
@@ -124,11 +116,7 @@ void modelDefinition::deleteSelection()
     {
         if(lineIterator->getIsSelectedState())
         {
-			// Check to make sure that the mesh exists before deleting it
-			if(p_modelMesh->getNumMeshVertices() > 0)
-			{
-				deleteMesh();
-			}
+			geometryChanged();
 			
             /* Bug fix: At first the code did not check if the line iterator was on the back
              * This causes problems becuase if the last iterator was deleted, then we are incrementing an invalidated iterator
@@ -156,11 +144,7 @@ void modelDefinition::deleteSelection()
     {
         if(blockIterator->getIsSelectedState())
         {
-			// Check to make sure that the mesh exists before deleting it
-			if(p_modelMesh->getNumMeshVertices() > 0)
-			{
-				deleteMesh();
-			}
+			geometryChanged();
 			
             if(blockIterator == _editor.getBlockLabelList()->back())
             {
@@ -245,7 +229,7 @@ void modelDefinition::editSelection()
         if(dialog->ShowModal() == wxID_OK)
         {
             if(dialog->getSegmentProperty(selectedProperty))
-				deleteMesh();
+				geometryChanged();
             
             for(plf::colony<edgeLineShape>::iterator lineIterator = _editor.getLineList()->begin(); lineIterator != _editor.getLineList()->end(); ++lineIterator)
             {
@@ -278,7 +262,7 @@ void modelDefinition::editSelection()
         if(dialog->ShowModal() == wxID_OK)
         {
             if(dialog->getSegmentProperty(selectedProperty))
-				deleteMesh();
+				geometryChanged();
             
             for(plf::colony<arcShape>::iterator arcIterator = _editor.getArcList()->begin(); arcIterator != _editor.getArcList()->end(); ++arcIterator)
             {
@@ -315,7 +299,7 @@ void modelDefinition::editSelection()
             bool firstIsSet = false;
 			
             if(dialog->getBlockProperty(selectedBlockLabel))
-				deleteMesh();
+				geometryChanged();
 				
 			selectedBlock->setPorperty(selectedBlockLabel);
             
@@ -396,6 +380,8 @@ void modelDefinition::editSelection()
 
 void modelDefinition::updateProperties(EditProperty property)
 {
+    p_editGeneration++;
+    
     switch(property)
     {
         case EditProperty::EDIT_CONDUCTOR:
@@ -751,11 +737,7 @@ void modelDefinition::moveTranslateSelection(double horizontalShift, double vert
 {
     // First, we are going to scan through all of the lines/arcs and check the nodes that are to be moved (and uncheck all of the lines/arcs)
     
-	// Check to make sure that the mesh exists before deleting it
-	if(p_modelMesh->getNumMeshVertices() > 0)
-	{
-		deleteMesh();
-	}
+	geometryChanged();
 	
     if(!_geometryGroupIsSelected)
     {
@@ -880,11 +862,7 @@ void modelDefinition::moveTranslateSelection(double horizontalShift, double vert
 
 void modelDefinition::moveRotateSelection(double angularShift, wxRealPoint aboutPoint)
 {
-	// Check to make sure that the mesh exists before deleting it
-	if(p_modelMesh->getNumMeshVertices() > 0)
-	{
-		deleteMesh();
-	}
+	geometryChanged();
 	
     if(!_geometryGroupIsSelected)
     {
@@ -1028,11 +1006,7 @@ void modelDefinition::moveRotateSelection(double angularShift, wxRealPoint about
 
 void modelDefinition::scaleSelection(double scalingFactor, wxRealPoint basePoint)
 {
-	// Check to make sure that the mesh exists before deleting it
-	if(p_modelMesh->getNumMeshVertices() > 0)
-	{
-		deleteMesh();
-	}
+	geometryChanged();
 	
     // This function was based off of the FEMM function located in CbeladrawDoc::ScaleMove
     if(_nodesAreSelected)
@@ -1163,11 +1137,7 @@ void modelDefinition::scaleSelection(double scalingFactor, wxRealPoint basePoint
 
 void modelDefinition::mirrorSelection(wxRealPoint pointOne, wxRealPoint pointTwo)
 {
-	// Check to make sure that the mesh exists before deleting it
-	if(p_modelMesh->getNumMeshVertices() > 0)
-	{
-		deleteMesh();
-	}
+	geometryChanged();
     /*
      * Currently, there are three cases that we need to consider.
      * First, if the slope of the mirror line is 0 (this is a horizontal line).
@@ -1746,11 +1716,7 @@ void modelDefinition::mirrorSelection(wxRealPoint pointOne, wxRealPoint pointTwo
 
 void modelDefinition::copyTranslateSelection(double horizontalShift, double verticalShift, unsigned int numberOfCopies)
 {
-	// Check to make sure that the mesh exists before deleting it
-	if(p_modelMesh->getNumMeshVertices() > 0)
-	{
-		deleteMesh();
-	}
+	geometryChanged();
 	
     if(_linesAreSelected || _geometryGroupIsSelected)
     {
@@ -1953,11 +1919,7 @@ void modelDefinition::copyTranslateSelection(double horizontalShift, double vert
 
 void modelDefinition::copyRotateSelection(double angularShift, wxRealPoint aboutPoint, unsigned int numberOfCopies)
 {
-	// Check to make sure that the mesh exists before deleting it
-	if(p_modelMesh->getNumMeshVertices() > 0)
-	{
-		deleteMesh();
-	}
+	geometryChanged();
 	
     if(_linesAreSelected || _geometryGroupIsSelected)
     {
@@ -2201,11 +2163,7 @@ unsigned long modelDefinition::displayDanglingNodes()
 
 void modelDefinition::createOpenBoundary(unsigned int numberLayers, double radius, wxRealPoint centerPoint, OpenBoundaryEdge boundaryType)
 {
-	// Check to make sure that the mesh exists before deleting it
-	if(p_modelMesh->getNumMeshVertices() > 0)
-	{
-		deleteMesh();
-	}
+	geometryChanged();
 	
     for(unsigned int i = 0; i < numberLayers + 1; i++)
     {
@@ -2461,11 +2419,7 @@ void modelDefinition::createFillet(double filletRadius)
     if(filletRadius < 0)
         return;
 		
-	// Check to make sure that the mesh exists before deleting it
-	if(p_modelMesh->getNumMeshVertices() > 0)
-	{
-		deleteMesh();
-	}
+	geometryChanged();
 	
     _editor.createFillet(filletRadius);
     this->Refresh();
@@ -3018,6 +2972,7 @@ void modelDefinition::onMouseLeftDown(wxMouseEvent &event)
                         {
                             //Create the line
                             _editor.addLine();
+                            p_editGeneration++;
                             _geometryIsSelected = false;
                             clearSelection();
                             this->Refresh();
@@ -3101,6 +3056,7 @@ void modelDefinition::onMouseLeftDown(wxMouseEvent &event)
                 arcShape tempShape;
                 newArcDialog->getArcParameter(tempShape);
                 _editor.addArc(tempShape, getTolerance(), true);
+                p_editGeneration++;
                 this->Refresh();
                 clearSelection();
                 return;
@@ -3117,6 +3073,7 @@ void modelDefinition::onMouseLeftDown(wxMouseEvent &event)
                 arcShape tempShape;
                 newArcDialog->getArcParameter(tempShape);
                 _editor.addArc(tempShape, getTolerance(), true);
+                p_editGeneration++;
                 this->Refresh();
                 clearSelection();
                 return;
@@ -3159,7 +3116,7 @@ void modelDefinition::onMouseLeftUp(wxMouseEvent &event)
                 _editor.getNodeList()->erase(_editor.getLastNodeAdd());
                 _editor.addNode(tempX, tempY, getTolerance() / 8.0);
 				
-				deleteMesh();
+				geometryChanged();
             }
         }
         else
@@ -3178,7 +3135,7 @@ void modelDefinition::onMouseLeftUp(wxMouseEvent &event)
                     _editor.addBlockLabel(tempX, tempY, getTolerance() / 10);
                 }
                 
-				deleteMesh();
+				geometryChanged();
 				
                 /* Now we want to scan through the entire block label list to finc if there is one that is
                  * set to defualt, if there is, then copy the settings to the newly created label
@@ -29,7 +29,9 @@
 
 
 #include <common/GridPreferences.h>
+#include <common/ProjectFile.h>
 #include <UI/GeometryEditor2D.h>
+#include <UI/ProjectSnapshot.h>
 
 
 
@@ -78,7 +80,18 @@ void OmniFEMMainFrame::onOpenFile(wxCommandEvent &event)
 		this->SetTitle(appendedTitle);
 		_saveFilePath = openFileDialog.GetPath();
 		_problemDefinition.defintionClear();
-		load(openFileDialog.GetPath().ToStdString());
+		
+		// An autosave that is newer than the project file is left over from a session that did not save its changes
+		std::string loadPath = openFileDialog.GetPath().ToStdString();
+		std::string autosavePath = getAutosavePath();
+		
+		if(wxFileExists(autosavePath) && wxFileModificationTime(autosavePath) > wxFileModificationTime(loadPath))
+		{
+			if(wxMessageBox("An autosave of this project is newer than the saved file. Recover the autosave?", "Open File", wxYES_NO | wxICON_QUESTION) == wxYES)
+				loadPath = autosavePath;
+		}
+		
+		load(loadPath);
 		
 		_model->Refresh(true);
 //		_model->Update();
@@ -154,34 +167,108 @@ void OmniFEMMainFrame::save(string filePath)
 	
 	if(!pathName.Contains(wxString(".omniFEM")))
 		pathName += wxString(".omniFEM");
+		
+	projectFile file;
+	std::string errorMessage;
+	projectSnapshot snapshot(_problemDefinition, _model);
+	unsigned long generation = _model->getEditGeneration();
+	bool isSaved = true;
 	
-	std::ofstream ofs(pathName.ToStdString());
+	snapshot.addChunks(file);
 	
-	if(ofs.is_open())// TODO: Check to see if is_open will return true if another program has the filde already opened
+	if(_model->getSavedMesh())
 	{
-		boost::archive::text_oarchive oa(ofs);
-		oa << _problemDefinition;
-		gridPreferences tempPreferences;
-		geometryEditor2D tempEditor;
-		std::vector<double> tempSomething;
-		_model->getParameters(tempPreferences, tempEditor, tempSomething);
-		//oa << _model;
-		oa << tempPreferences;
-		oa << tempEditor;
-		oa << tempSomething;
+		// The mesh was never displayed so it is copied over from the file that it was loaded from
+		std::string meshData;
+		
+		if(_model->getSavedMesh()->readChunk(projectChunk::MESH, meshData, errorMessage))
+			file.addChunk(projectChunk::MESH, meshData);
+		else
+			isSaved = false;
+		
+		if(isSaved && _model->getSavedMesh()->hasChunk(projectChunk::MESH_REGIONS))
+		{
+			if(_model->getSavedMesh()->readChunk(projectChunk::MESH_REGIONS, meshData, errorMessage))
+				file.addChunk(projectChunk::MESH_REGIONS, meshData);
+			else
+				isSaved = false;
+		}
 	}
-	else
+	else if(_model->getMeshModel()->getNumMeshVertices() > 0)
 	{
-		wxMessageBox("Please close all instances of the file before saving");
+		// The physical groups are not stored in the mesh. They are created again from the regions once the mesh is read
+		file.addArchiveChunk(projectChunk::MESH_REGIONS, [&](boost::archive::binary_oarchive &ar){ ar << _model->getMeshRegions(); });
+		isSaved = file.addMesh(_model->getMeshModel(), pathName.ToStdString(), errorMessage);
 	}
+		
+	if(isSaved)
+		isSaved = file.write(pathName.ToStdString(), errorMessage);
 	
-	ofs.close();
+	if(!isSaved)
+	{
+		wxMessageBox(errorMessage + "\nPlease close all instances of the file before saving");
+		return;
+	}
+	
+	// The autosave is now older than the project file
+	p_autosave.setSavedGeneration(generation);
+	p_autosave.removeAutosave(getAutosavePath());
+	
+	// The offsets of the mesh that is not read yet are now in the new file
+	if(_model->getSavedMesh())
+	{
+		std::shared_ptr<projectFile> savedFile = std::make_shared<projectFile>();
+		
+		if(savedFile->open(pathName.ToStdString(), errorMessage))
+			_model->setSavedMesh(savedFile);
+		else
+			_model->setSavedMesh(nullptr);
+	}
 }
 
 
 
 void OmniFEMMainFrame::load(string filePath)
 {
+	gridPreferences tempPreferences;
+	geometryEditor2D tempEditor;
+	std::vector<double> tempSomething;
+	
+	if(projectFile::isProjectFile(filePath))
+	{
+		std::shared_ptr<projectFile> file = std::make_shared<projectFile>();
+		std::string errorMessage;
+		
+		/*
+		 * Only the geometry is read here. The mesh is read once it is displayed
+		 */ 
+		bool isLoaded = file->open(filePath, errorMessage) &&
+			file->readArchiveChunk(projectChunk::PROBLEM_SETTINGS, [&](boost::archive::binary_iarchive &ar){ _problemDefinition.serializeSettings(ar); }, errorMessage) &&
+			file->readArchiveChunk(projectChunk::MATERIAL_LIBRARY, [&](boost::archive::binary_iarchive &ar){ _problemDefinition.serializeMaterials(ar); }, errorMessage) &&
+			file->readArchiveChunk(projectChunk::VIEW_SETTINGS, [&](boost::archive::binary_iarchive &ar){ ar >> tempPreferences; ar >> tempSomething; }, errorMessage) &&
+			file->readArchiveChunk(projectChunk::NODES, [&](boost::archive::binary_iarchive &ar){ tempEditor.loadNodes(ar); }, errorMessage) &&
+			file->readArchiveChunk(projectChunk::SEGMENTS, [&](boost::archive::binary_iarchive &ar){ tempEditor.loadSegments(ar); }, errorMessage) &&
+			file->readArchiveChunk(projectChunk::LABELS, [&](boost::archive::binary_iarchive &ar){ tempEditor.loadLabels(ar); }, errorMessage);
+			
+		if(!isLoaded)
+		{
+			wxMessageBox(errorMessage, "Open File", wxOK | wxICON_ERROR);
+			return;
+		}
+		
+		_model->setParameters(tempPreferences, tempEditor, tempSomething);
+		
+		if(file->hasChunk(projectChunk::MESH))
+			_model->setSavedMesh(file);
+			
+		p_autosave.setSavedGeneration(_model->getEditGeneration());
+		
+		_model->Refresh();
+		
+		return;
+	}
+	
+	// Projects that were saved before the binary format are text archives
 	std::ifstream loadFile(filePath);
 	
 	if(loadFile.is_open())
@@ -189,9 +276,6 @@ void OmniFEMMainFrame::load(string filePath)
 		//modelDefinition temp(this, wxPoint(6, 6), this->GetClientSize(), _problemDefinition, this->GetStatusBar());
 		//modelDefinition tempDefintion = (*_model);
 		boost::archive::text_iarchive ia(loadFile);
-		gridPreferences tempPreferences;
-		geometryEditor2D tempEditor;
-		std::vector<double> tempSomething;
 		
 		ia >> _problemDefinition;
 		ia >> tempPreferences;
@@ -200,6 +284,8 @@ void OmniFEMMainFrame::load(string filePath)
 		
 		_model->setParameters(tempPreferences, tempEditor, tempSomething);
 		
+		p_autosave.setSavedGeneration(_model->getEditGeneration());
+		
 		_model->Refresh();
 	}
 }
\ No newline at end of file
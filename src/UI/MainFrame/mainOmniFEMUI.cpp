@@ -42,6 +42,10 @@ OmniFEMMainFrame::OmniFEMMainFrame(const wxString &title, const wxPoint &pos) :
 	_menuFile->Append(FileMenuID::ID_OPEN, "&Open");
     _menuFile->AppendSeparator();
     _menuFile->Append(wxID_EXIT);
+	
+	/* The autosave runs for the entire time that the program is open */
+	p_autosaveTimer.SetOwner(this, FileMenuID::ID_AUTOSAVE_TIMER);
+	p_autosaveTimer.Start(p_autosaveInterval);
     
     /* Creating the menu listinging of the Edit Menu */
     _menuEdit->Append(EditMenuID::ID_UNDO, "&Undo\tCtrl-Z");
@@ -296,6 +300,7 @@ void OmniFEMMainFrame::createModelDefiningClient()
     
     wxBoxSizer *topSizer = new wxBoxSizer(wxVERTICAL);
 	_model = new modelDefinition(this, wxPoint(6, 6), this->GetClientSize(), _problemDefinition, this->GetStatusBar());
+	p_autosave.setSavedGeneration(_model->getEditGeneration());
     
     enableToolMenuBar(true);
     createTopToolBar();
@@ -422,10 +427,20 @@ void OmniFEMMainFrame::createTopToolBar()
 
 void OmniFEMMainFrame::OnExit(wxCommandEvent &event)
 {
+    meshExporter::waitForExports();
+	p_autosave.waitForAutosave();
     Close(true);
 }
 
 
+
+void OmniFEMMainFrame::onAutosaveTimer(wxTimerEvent &event)
+{
+	if(_UIState == systemState::MODEL_DEFINING)
+		p_autosave.start(_problemDefinition, _model, getAutosavePath());
+}
+
+
 	/********************
 	 * Event Procedures *
 	 ********************/
@@ -599,6 +614,7 @@ wxBEGIN_EVENT_TABLE(OmniFEMMainFrame, wxFrame)
     
     /* Everything Else */
     EVT_MENU(wxID_EXIT,  OmniFEMMainFrame::OnExit)
+	EVT_TIMER(FileMenuID::ID_AUTOSAVE_TIMER, OmniFEMMainFrame::onAutosaveTimer)
 	EVT_SIZE(OmniFEMMainFrame::onResize)
   //  EVT_KEY_DOWN(OmniFEMMainFrame::onKeyDown)
 	
@@ -15,10 +15,13 @@ void OmniFEMMainFrame::onCreateMesh(wxCommandEvent &event)
 			{
 				if(_model->displayDanglingNodes() == 0)
 				{
+					// The files of the previous mesh may still be written in the background
+					meshExporter::waitForExports();
 					_model->deleteMesh();
 					meshMaker mesher(_problemDefinition, _model);
 					OmniFEMMsg::instance()->displayWindow(Status_Windows::MESH_STATUS_WINDOW);
 					mesher.mesh();
+					_model->setMeshRegions(mesher.getRegions());
 					if(_model->checkModelIsValid())
 						_model->Refresh();
 				}
@@ -38,6 +41,17 @@ void OmniFEMMainFrame::onCreateMesh(wxCommandEvent &event)
 
 void OmniFEMMainFrame::onShowMesh(wxCommandEvent &event)
 {
+	// The mesh that was saved with the project is only read once it is displayed
+	if(!_model->getShowMeshState() && _model->getSavedMesh())
+	{
+		std::string errorMessage;
+		
+		if(_model->loadSavedMesh(errorMessage))
+			OmniFEMMsg::instance()->MsgStatus("Mesh loaded from the project file");
+		else
+			OmniFEMMsg::instance()->MsgError(errorMessage);
+	}
+	
 	_model->toggleMesh();
 	OmniFEMMsg::instance()->MsgStatus("Display mesh toggled to " + std::to_string(_model->getShowMeshState()));
 	_model->Refresh();
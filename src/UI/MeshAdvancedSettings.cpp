@@ -11,6 +11,8 @@ meshAdvanced::meshAdvanced(wxWindow *par, meshSettings &settings) : wxDialog(par
 	wxBoxSizer *multiplePassesSizer = new wxBoxSizer(wxHORIZONTAL);
 	wxBoxSizer *smoothingSizer = new wxBoxSizer(wxHORIZONTAL);
 	wxBoxSizer *meshFactorSizer = new wxBoxSizer(wxHORIZONTAL);
+	wxBoxSizer *partitionsSizer = new wxBoxSizer(wxHORIZONTAL);
+	wxBoxSizer *cornerSizer = new wxBoxSizer(wxHORIZONTAL);
 	wxStaticBoxSizer *meshFormatsSizer = new wxStaticBoxSizer(wxVERTICAL, this, "Mesh File Save Formats");
 	wxBoxSizer *meshDirSelectionSizer = new wxBoxSizer(wxHORIZONTAL);
 	wxBoxSizer *intermediateSizer = new wxBoxSizer(wxHORIZONTAL);
@@ -64,6 +66,27 @@ meshAdvanced::meshAdvanced(wxWindow *par, meshSettings &settings) : wxDialog(par
 	meshFactorSizer->Add(54, 0, 0);
 	meshFactorSizer->Add(p_factorTextCtrl, 0, wxCENTER | wxBOTTOM | wxRIGHT, 6);
 	
+	wxStaticText *partitionsText = new wxStaticText(this, wxID_ANY, "Number of Partitions: ");
+	partitionsText->SetFont(font);
+	
+	p_partitionsTextCtrl->Create(this, wxID_ANY, std::to_string(p_meshSettings->getNumberPartitions()), wxDefaultPosition, wxDefaultSize, 0, greaterThenZeroVal);
+	p_partitionsTextCtrl->SetFont(font);
+	
+	partitionsSizer->Add(partitionsText, 0, wxCENTER | wxLEFT | wxRIGHT | wxBOTTOM, 6);
+	partitionsSizer->Add(30, 0, 0);
+	partitionsSizer->Add(p_partitionsTextCtrl, 0, wxCENTER | wxBOTTOM | wxRIGHT, 6);
+	
+	wxStaticText *cornerText = new wxStaticText(this, wxID_ANY, "Corner Refinement Factor: ");
+	cornerText->SetFont(font);
+	
+	p_cornerTextCtrl->Create(this, wxID_ANY, std::to_string(p_meshSettings->getCornerRefinementFactor()), wxDefaultPosition, wxDefaultSize, 0, doubleGreaterThenZeroVal);
+	p_cornerTextCtrl->SetValue(std::to_string(p_meshSettings->getCornerRefinementFactor()));
+	p_cornerTextCtrl->SetFont(font);
+	
+	cornerSizer->Add(cornerText, 0, wxCENTER | wxLEFT | wxRIGHT | wxBOTTOM, 6);
+	cornerSizer->Add(6, 0, 0);
+	cornerSizer->Add(p_cornerTextCtrl, 0, wxCENTER | wxBOTTOM | wxRIGHT, 6);
+	
 	p_meshFileDirectory->Create(meshFormatsSizer->GetStaticBox(), wxID_APPLY, p_meshSettings->getDirString(), wxDefaultPosition, wxSize(275, 23), wxTE_PROCESS_ENTER);
 	p_meshFileDirectory->SetFont(font);
 	
@@ -164,10 +187,20 @@ meshAdvanced::meshAdvanced(wxWindow *par, meshSettings &settings) : wxDialog(par
 	p_saveAsVRML->SetFont(font);
 	p_saveAsVRML->SetValue(p_meshSettings->getSaveVRMLState());
 	
+	p_saveAsVTU->Create(meshFormatsSizer->GetStaticBox(), wxID_ANY, "VTU");
+	p_saveAsVTU->SetFont(font);
+	p_saveAsVTU->SetValue(p_meshSettings->getSaveVTUState());
+	
+	p_compressVTU->Create(meshFormatsSizer->GetStaticBox(), wxID_ANY, "Compress VTU");
+	p_compressVTU->SetFont(font);
+	p_compressVTU->SetValue(p_meshSettings->getCompressVTUState());
+	
 	columnFourSize->Add(p_saveAsSU2, 0, wxTOP | wxBOTTOM | wxLEFT, 6);
 	columnFourSize->Add(p_saveAsTochnog, 0, wxBOTTOM | wxLEFT, 6);
 	columnFourSize->Add(p_saveAsUNV, 0, wxBOTTOM | wxLEFT, 6);
 	columnFourSize->Add(p_saveAsVRML, 0, wxBOTTOM | wxLEFT, 6);
+	columnFourSize->Add(p_saveAsVTU, 0, wxBOTTOM | wxLEFT, 6);
+	columnFourSize->Add(p_compressVTU, 0, wxBOTTOM | wxLEFT, 6);
 	
 	intermediateSizer->Add(columnOneSize);
 	intermediateSizer->Add(columnTwoSize);
@@ -189,6 +222,8 @@ meshAdvanced::meshAdvanced(wxWindow *par, meshSettings &settings) : wxDialog(par
 	topSizer->Add(multiplePassesSizer);
 	topSizer->Add(smoothingSizer);
 	topSizer->Add(meshFactorSizer);
+	topSizer->Add(partitionsSizer);
+	topSizer->Add(cornerSizer);
 	topSizer->Add(meshFormatsSizer, 0, wxLEFT | wxRIGHT | wxBOTTOM, 6);
 	topSizer->Add(footerSizer, 0, wxALIGN_RIGHT);
 	
@@ -211,6 +246,12 @@ void meshAdvanced::setSettings()
 	p_factorTextCtrl->GetValue().ToDouble(&doubleValue);
 	p_meshSettings->setElementSizeFactor(doubleValue);
 	
+	p_partitionsTextCtrl->GetValue().ToLong(&longValue);
+	p_meshSettings->setNumberPartitions((unsigned int)longValue);
+	
+	p_cornerTextCtrl->GetValue().ToDouble(&doubleValue);
+	p_meshSettings->setCornerRefinementFactor(doubleValue);
+	
 	p_meshSettings->setSaveVTKState(p_saveAsVTK->GetValue());
 	p_meshSettings->setSaveBDFState(p_saveAsBDF->GetValue());
 	p_meshSettings->setSaveCELUMState(p_saveAsCELUM->GetValue());
@@ -230,6 +271,8 @@ void meshAdvanced::setSettings()
 	p_meshSettings->setSaveTochnogState(p_saveAsTochnog->GetValue());
 	p_meshSettings->setSaveUNVState(p_saveAsUNV->GetValue());
 	p_meshSettings->setSaveVRMLState(p_saveAsVRML->GetValue());
+	p_meshSettings->setSaveVTUState(p_saveAsVTU->GetValue());
+	p_meshSettings->setCompressVTUState(p_compressVTU->GetValue());
 	
 	p_meshSettings->setDirString(p_meshFileDirectory->GetValue());
 }
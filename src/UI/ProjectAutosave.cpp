@@ -0,0 +1,90 @@
+#include <UI/ProjectAutosave.h>
+
+#include <cstdio>
+
+#include <wx/app.h>
+#include <wx/filename.h>
+
+#include <common/OmniFEMMessage.h>
+
+
+std::string projectAutosave::getAutosavePath(std::string filePath, std::string name)
+{
+	if(filePath.empty())
+		return wxFileName(wxFileName::GetTempDir(), wxString(name + ".omniFEM.autosave")).GetFullPath().ToStdString();
+
+	if(filePath.find(".omniFEM") == std::string::npos)
+		filePath += ".omniFEM";
+
+	return filePath + ".autosave";
+}
+
+
+
+bool projectAutosave::start(problemDefinition &problem, modelDefinition *model, std::string filePath)
+{
+	unsigned long generation = model->getEditGeneration();
+
+	if(generation == p_savedGeneration)
+		return false;
+
+	if(p_isWriting)
+		return false;
+
+	// The previous thread has finished writing
+	if(p_autosaveThread.joinable())
+		p_autosaveThread.join();
+
+	std::shared_ptr<projectSnapshot> snapshot = std::make_shared<projectSnapshot>(problem, model);
+
+	p_savedGeneration = generation;
+	p_isWriting = true;
+	p_autosaveThread = std::thread(&projectAutosave::runAutosave, this, snapshot, filePath);
+
+	return true;
+}
+
+
+
+void projectAutosave::runAutosave(std::shared_ptr<projectSnapshot> snapshot, std::string filePath)
+{
+	projectFile file;
+	std::string errorMessage;
+
+	snapshot->addChunks(file);
+
+	const bool isError = !file.write(filePath, errorMessage);
+	const std::string message = isError ? "Autosave failed: " + errorMessage : "Autosaved project to " + filePath;
+
+	// The message windows can only be accessed from the main thread
+	if(wxTheApp)
+	{
+		wxTheApp->CallAfter([message, isError]()
+		{
+			if(isError)
+				OmniFEMMsg::instance()->MsgError(message);
+			else
+				OmniFEMMsg::instance()->MsgStatus(message);
+		});
+	}
+
+	p_isWriting = false;
+}
+
+
+
+void projectAutosave::waitForAutosave()
+{
+	if(p_autosaveThread.joinable())
+		p_autosaveThread.join();
+}
+
+
+
+void projectAutosave::removeAutosave(std::string filePath)
+{
+	// A background thread that is still writing would create the file again
+	waitForAutosave();
+
+	remove(filePath.c_str());
+}
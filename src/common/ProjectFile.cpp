@@ -0,0 +1,388 @@
+#include <common/ProjectFile.h>
+
+#include <cstdio>
+#include <cstring>
+
+#include <Mesh/GMSH/GModel.h>
+
+#if defined(HAVE_LIBZ)
+#include <zlib.h>
+#endif
+
+#if defined(WIN32) && !defined(__CYGWIN__)
+#include <windows.h>
+#endif
+
+//! The magic string at the start of every binary project file
+static const char projectMagic[8] = {'O', 'm', 'n', 'i', 'F', 'E', 'M', '\0'};
+
+//! The number of bytes of the header: the magic string, the version, the number of chunks and the checksum of the directory
+static const std::size_t headerSize = sizeof(projectMagic) + 3 * sizeof(uint32_t);
+
+//! The number of bytes of an entry of the directory
+static const std::size_t entrySize = 2 * sizeof(uint32_t) + 2 * sizeof(uint64_t);
+
+
+/**
+ * @brief 	Moves a file onto the target path. An existing file at the target path is replaced. On Windows,
+ * 			rename fails if the target exists, so MoveFileEx is used there
+ * @param sourcePath The path of the file that is moved
+ * @param targetPath The path that the file is moved to
+ * @return Returns true if the file was moved
+ */
+static bool replaceFile(const std::string &sourcePath, const std::string &targetPath)
+{
+#if defined(WIN32) && !defined(__CYGWIN__)
+	return (MoveFileExA(sourcePath.c_str(), targetPath.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0);
+#else
+	return (rename(sourcePath.c_str(), targetPath.c_str()) == 0);
+#endif
+}
+
+
+uint32_t projectFile::computeChecksum(const void *data, std::size_t size)
+{
+#if defined(HAVE_LIBZ)
+	uLong checksum = crc32(0L, Z_NULL, 0);
+	const Bytef *bytes = static_cast<const Bytef*>(data);
+
+	// crc32 takes the size as a 32 bit integer
+	while(size > 0)
+	{
+		uInt count = (size > 0x40000000) ? 0x40000000 : (uInt)size;
+		checksum = crc32(checksum, bytes, count);
+		bytes += count;
+		size -= count;
+	}
+
+	return (uint32_t)checksum;
+#else
+	static uint32_t table[256];
+	static bool isTableCreated = false;
+
+	if(!isTableCreated)
+	{
+		for(uint32_t i = 0; i < 256; i++)
+		{
+			uint32_t value = i;
+
+			for(int j = 0; j < 8; j++)
+				value = (value & 1) ? (0xEDB88320 ^ (value >> 1)) : (value >> 1);
+
+			table[i] = value;
+		}
+
+		isTableCreated = true;
+	}
+
+	const unsigned char *bytes = static_cast<const unsigned char*>(data);
+	uint32_t checksum = 0xFFFFFFFF;
+
+	for(std::size_t i = 0; i < size; i++)
+		checksum = table[(checksum ^ bytes[i]) & 0xFF] ^ (checksum >> 8);
+
+	return checksum ^ 0xFFFFFFFF;
+#endif
+}
+
+
+
+bool projectFile::isProjectFile(std::string filePath)
+{
+	FILE *file = fopen(filePath.c_str(), "rb");
+
+	if(!file)
+		return false;
+
+	char magic[sizeof(projectMagic)];
+	bool isProject = (fread(magic, 1, sizeof(magic), file) == sizeof(magic) && memcmp(magic, projectMagic, sizeof(magic)) == 0);
+
+	fclose(file);
+
+	return isProject;
+}
+
+
+
+void projectFile::addChunk(projectChunk id, std::string data)
+{
+	for(unsigned int i = 0; i < p_chunkIDs.size(); i++)
+	{
+		if(p_chunkIDs[i] == id)
+		{
+			p_chunkData[i].swap(data);
+			return;
+		}
+	}
+
+	p_chunkIDs.push_back(id);
+	p_chunkData.push_back(std::string());
+	p_chunkData.back().swap(data);
+}
+
+
+
+bool projectFile::addMesh(GModel *mesh, std::string filePath, std::string &errorMessage)
+{
+	std::string meshPath = filePath + ".msh.tmp";
+	std::string data;
+	bool isAdded = false;
+
+	if(mesh->writeMSH(meshPath, 2.2, true, true, false, 1.0, 0, 0, false))
+	{
+		FILE *file = fopen(meshPath.c_str(), "rb");
+
+		if(file)
+		{
+			fseek(file, 0, SEEK_END);
+			long size = ftell(file);
+			fseek(file, 0, SEEK_SET);
+
+			if(size > 0)
+			{
+				data.resize(size);
+				isAdded = (fread(&data[0], 1, size, file) == (std::size_t)size);
+			}
+
+			fclose(file);
+		}
+	}
+
+	remove(meshPath.c_str());
+
+	if(!isAdded)
+	{
+		errorMessage = "Unable to store the mesh in " + filePath;
+		return false;
+	}
+
+	addChunk(projectChunk::MESH, data);
+
+	return true;
+}
+
+
+
+bool projectFile::write(std::string filePath, std::string &errorMessage)
+{
+	std::string temporaryPath = filePath + ".tmp";
+	std::string header(headerSize, '\0');
+	std::string directory;
+	const uint32_t version = p_version;
+	uint32_t numberChunks = p_chunkIDs.size();
+	uint64_t position = headerSize + numberChunks * entrySize;
+	bool isWritten = true;
+
+	for(unsigned int i = 0; i < p_chunkIDs.size(); i++)
+	{
+		uint32_t id = (uint32_t)p_chunkIDs[i];
+		uint32_t checksum = computeChecksum(p_chunkData[i].data(), p_chunkData[i].size());
+		uint64_t size = p_chunkData[i].size();
+
+		directory.append(reinterpret_cast<const char*>(&id), sizeof(uint32_t));
+		directory.append(reinterpret_cast<const char*>(&checksum), sizeof(uint32_t));
+		directory.append(reinterpret_cast<const char*>(&position), sizeof(uint64_t));
+		directory.append(reinterpret_cast<const char*>(&size), sizeof(uint64_t));
+
+		position += size;
+	}
+
+	uint32_t directoryChecksum = computeChecksum(directory.data(), directory.size());
+
+	memcpy(&header[0], projectMagic, sizeof(projectMagic));
+	memcpy(&header[sizeof(projectMagic)], &version, sizeof(uint32_t));
+	memcpy(&header[sizeof(projectMagic) + sizeof(uint32_t)], &numberChunks, sizeof(uint32_t));
+	memcpy(&header[sizeof(projectMagic) + 2 * sizeof(uint32_t)], &directoryChecksum, sizeof(uint32_t));
+
+	FILE *file = fopen(temporaryPath.c_str(), "wb");
+
+	if(!file)
+	{
+		errorMessage = "Unable to open file " + temporaryPath;
+		return false;
+	}
+
+	if(fwrite(header.data(), 1, header.size(), file) != header.size() ||
+		fwrite(directory.data(), 1, directory.size(), file) != directory.size())
+		isWritten = false;
+
+	for(unsigned int i = 0; i < p_chunkData.size() && isWritten; i++)
+	{
+		if(fwrite(p_chunkData[i].data(), 1, p_chunkData[i].size(), file) != p_chunkData[i].size())
+			isWritten = false;
+	}
+
+	if(fclose(file) != 0)
+		isWritten = false;
+
+	if(!isWritten || !replaceFile(temporaryPath, filePath))
+	{
+		remove(temporaryPath.c_str());
+		errorMessage = "Unable to write file " + filePath;
+		return false;
+	}
+
+	return true;
+}
+
+
+
+bool projectFile::open(std::string filePath, std::string &errorMessage)
+{
+	FILE *file = fopen(filePath.c_str(), "rb");
+	char header[headerSize];
+	uint32_t version, numberChunks, directoryChecksum;
+
+	p_filePath = filePath;
+	p_directory.clear();
+
+	if(!file)
+	{
+		errorMessage = "Unable to open file " + filePath;
+		return false;
+	}
+
+	if(fread(header, 1, headerSize, file) != headerSize || memcmp(header, projectMagic, sizeof(projectMagic)) != 0)
+	{
+		fclose(file);
+		errorMessage = filePath + " is not an Omni-FEM project file";
+		return false;
+	}
+
+	memcpy(&version, &header[sizeof(projectMagic)], sizeof(uint32_t));
+	memcpy(&numberChunks, &header[sizeof(projectMagic) + sizeof(uint32_t)], sizeof(uint32_t));
+	memcpy(&directoryChecksum, &header[sizeof(projectMagic) + 2 * sizeof(uint32_t)], sizeof(uint32_t));
+
+	if(version > p_version)
+	{
+		fclose(file);
+		errorMessage = filePath + " was saved by a newer version of Omni-FEM";
+		return false;
+	}
+
+	fseek(file, 0, SEEK_END);
+	uint64_t fileSize = ftell(file);
+	fseek(file, headerSize, SEEK_SET);
+
+	std::string directory(numberChunks * entrySize, '\0');
+
+	if(numberChunks > (fileSize - headerSize) / entrySize ||
+		(directory.size() > 0 && fread(&directory[0], 1, directory.size(), file) != directory.size()) ||
+		computeChecksum(directory.data(), directory.size()) != directoryChecksum)
+	{
+		fclose(file);
+		errorMessage = "The directory of " + filePath + " is corrupted";
+		return false;
+	}
+
+	fclose(file);
+
+	for(uint32_t i = 0; i < numberChunks; i++)
+	{
+		chunkEntry entry;
+		const char *data = directory.data() + i * entrySize;
+
+		memcpy(&entry.id, data, sizeof(uint32_t));
+		memcpy(&entry.checksum, data + sizeof(uint32_t), sizeof(uint32_t));
+		memcpy(&entry.position, data + 2 * sizeof(uint32_t), sizeof(uint64_t));
+		memcpy(&entry.size, data + 2 * sizeof(uint32_t) + sizeof(uint64_t), sizeof(uint64_t));
+
+		if(entry.position > fileSize || entry.size > fileSize - entry.position)
+		{
+			p_directory.clear();
+			errorMessage = "The directory of " + filePath + " is corrupted";
+			return false;
+		}
+
+		p_directory.push_back(entry);
+	}
+
+	return true;
+}
+
+
+
+const projectFile::chunkEntry *projectFile::findChunk(projectChunk id) const
+{
+	for(auto entryIterator = p_directory.begin(); entryIterator != p_directory.end(); entryIterator++)
+	{
+		if(entryIterator->id == (uint32_t)id)
+			return &(*entryIterator);
+	}
+
+	return nullptr;
+}
+
+
+
+bool projectFile::readChunk(projectChunk id, std::string &data, std::string &errorMessage) const
+{
+	const chunkEntry *entry = findChunk(id);
+
+	if(!entry)
+	{
+		errorMessage = p_filePath + " does not contain chunk " + std::to_string((uint32_t)id);
+		return false;
+	}
+
+	FILE *file = fopen(p_filePath.c_str(), "rb");
+
+	if(!file)
+	{
+		errorMessage = "Unable to open file " + p_filePath;
+		return false;
+	}
+
+	data.resize(entry->size);
+
+	bool isRead = (fseek(file, (long)entry->position, SEEK_SET) == 0 &&
+					(entry->size == 0 || fread(&data[0], 1, entry->size, file) == entry->size));
+
+	fclose(file);
+
+	if(!isRead)
+	{
+		errorMessage = "Unable to read chunk " + std::to_string((uint32_t)id) + " of " + p_filePath;
+		return false;
+	}
+
+	if(computeChecksum(data.data(), data.size()) != entry->checksum)
+	{
+		errorMessage = "Chunk " + std::to_string((uint32_t)id) + " of " + p_filePath + " is corrupted";
+		return false;
+	}
+
+	return true;
+}
+
+
+
+bool projectFile::readMesh(GModel *mesh, std::string &errorMessage) const
+{
+	std::string data;
+
+	if(!readChunk(projectChunk::MESH, data, errorMessage))
+		return false;
+
+	std::string meshPath = p_filePath + ".msh.tmp";
+	FILE *file = fopen(meshPath.c_str(), "wb");
+	bool isRead = false;
+
+	if(file)
+	{
+		bool isWritten = (fwrite(data.data(), 1, data.size(), file) == data.size());
+
+		if(fclose(file) == 0 && isWritten)
+			isRead = (mesh->readMSH(meshPath) != 0);
+
+		remove(meshPath.c_str());
+	}
+
+	if(!isRead)
+	{
+		errorMessage = "Unable to read the mesh of " + p_filePath;
+		return false;
+	}
+
+	return true;
+}